@@ -0,0 +1,170 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FCL_BVH_COMPACT_H
+#define FCL_BVH_COMPACT_H
+
+#include "fcl/BVH/BVH_model.h"
+#include "fcl/BV/AABB.h"
+#include <vector>
+
+namespace fcl
+{
+
+/// @brief Compressed, read-only version of a triangle BVHModel. It keeps the hierarchy of the source model, but
+/// every node only stores its AABB quantized to 16 bits per coordinate relative to the decoded box of its parent,
+/// so a node takes 16 bytes whatever the source BV type. Vertices are stored in single precision and triangle
+/// indices in 16 bits when the mesh has few enough vertices, 32 bits otherwise.
+/// The quantization always rounds outwards, so a decoded box contains the node's triangles and the overlap
+/// tests stay conservative.
+class CompactBVHModel : public CollisionGeometry
+{
+public:
+  /// @brief Compact node: quantized bounds relative to the parent, and the first child, or -(primitive + 1) for a leaf
+  struct Node
+  {
+    FCL_UINT16 lower[3];
+    FCL_UINT16 upper[3];
+    FCL_INT32 first_child;
+
+    inline bool isLeaf() const { return first_child < 0; }
+    inline int primitiveId() const { return -(first_child + 1); }
+    inline int leftChild() const { return first_child; }
+    inline int rightChild() const { return first_child + 1; }
+  };
+
+  /// @brief Largest quantized coordinate
+  static const FCL_UINT16 QUANTIZATION_MAX = 65535;
+
+  CompactBVHModel();
+
+  /// @brief Compress a triangle model whose hierarchy has been built
+  template<typename BV>
+  explicit CompactBVHModel(const BVHModel<BV>& model)
+  {
+    std::vector<int> first_child(model.getNumBVs());
+    for(int i = 0; i < model.getNumBVs(); ++i)
+      first_child[i] = model.getBV(i).first_child;
+
+    if(model.getModelType() != BVH_MODEL_TRIANGLES || model.build_state != BVH_BUILD_STATE_PROCESSED)
+      first_child.clear();
+
+    build(model.vertices, model.num_vertices, model.tri_indices, model.num_tris, first_child);
+
+    cost_density = model.cost_density;
+    threshold_occupied = model.threshold_occupied;
+    threshold_free = model.threshold_free;
+  }
+
+  /// @brief Decode the box of a child given the decoded box of its parent; the root box is getRootBox()
+  inline void decodeBox(const Node& node, const AABB& parent, AABB& box) const
+  {
+    for(int i = 0; i < 3; ++i)
+    {
+      box.min_[i] = decodeCoordinate(node.lower[i], parent.min_[i], parent.max_[i]);
+      box.max_[i] = decodeCoordinate(node.upper[i], parent.min_[i], parent.max_[i]);
+    }
+  }
+
+  /// @brief Decoded box of the root node
+  const AABB& getRootBox() const { return root_box; }
+
+  const Node& getNode(int id) const { return nodes[id]; }
+
+  int getNumNodes() const { return (int)nodes.size(); }
+
+  int getNumVertices() const { return (int)(vertices.size() / 3); }
+
+  int getNumTriangles() const { return num_tris; }
+
+  /// @brief Whether triangle indices are stored in 16 bits
+  bool hasShortIndices() const { return !tri_indices16.empty(); }
+
+  /// @brief Decode the vertex id
+  inline Vec3f getVertex(int id) const
+  {
+    const float* v = &vertices[3 * id];
+    return Vec3f(v[0], v[1], v[2]);
+  }
+
+  /// @brief Decode the vertices of triangle id
+  inline void getTriangle(int id, Vec3f& p1, Vec3f& p2, Vec3f& p3) const
+  {
+    if(!tri_indices16.empty())
+    {
+      const FCL_UINT16* t = &tri_indices16[3 * id];
+      p1 = getVertex(t[0]); p2 = getVertex(t[1]); p3 = getVertex(t[2]);
+    }
+    else
+    {
+      const FCL_UINT32* t = &tri_indices32[3 * id];
+      p1 = getVertex(t[0]); p2 = getVertex(t[1]); p3 = getVertex(t[2]);
+    }
+  }
+
+  /// @brief Compute the AABB of the model in its local frame, used for broad-phase collision
+  void computeLocalAABB();
+
+  /// @brief Number of bytes used by the model; with msg, print the usage and the bytes per triangle
+  int memUsage(int msg) const;
+
+  /// @brief Get the object type: it is a BVH
+  OBJECT_TYPE getObjectType() const { return OT_BVH; }
+
+  /// @brief Get the node type: a compact quantized hierarchy
+  NODE_TYPE getNodeType() const { return BV_COMPACT; }
+
+private:
+  void build(const Vec3f* vertices, int num_vertices, const Triangle* triangles, int num_triangles, const std::vector<int>& first_child);
+
+  /// @brief Decoding shared by the encoder, so that the rounding of both sides matches
+  static inline FCL_REAL decodeCoordinate(FCL_UINT16 q, FCL_REAL lo, FCL_REAL hi)
+  {
+    if(q == 0) return lo;
+    if(q == QUANTIZATION_MAX) return hi;
+    return lo + (hi - lo) * ((FCL_REAL)q / QUANTIZATION_MAX);
+  }
+
+  std::vector<Node> nodes;
+  AABB root_box;
+  std::vector<float> vertices;
+  std::vector<FCL_UINT16> tri_indices16;
+  std::vector<FCL_UINT32> tri_indices32;
+  int num_tris;
+};
+
+}
+
+#endif
@@ -67,7 +67,8 @@ enum BVHReturnCode
     BVH_ERR_UNSUPPORTED_FUNCTION = -5,          /// BVH funtion is not supported
     BVH_ERR_UNUPDATED_MODEL = -6,               /// BVH model update failed
     BVH_ERR_INCORRECT_DATA = -7,                /// BVH data is not valid
-    BVH_ERR_UNKNOWN = -8                        /// Unknown failure
+    BVH_ERR_UNKNOWN = -8,                       /// Unknown failure
+    BVH_ERR_FILE_IO = -9                        /// Reading or writing a model file failed
   };
 
 /// @brief BVH model type
@@ -42,12 +42,70 @@
 #include "fcl/BV/BV_node.h"
 #include "fcl/BVH/BV_splitter.h"
 #include "fcl/BVH/BV_fitter.h"
+#include "fcl/BVH/BVH_triangle_cache.h"
 #include <vector>
+#include <string>
 #include <boost/shared_ptr.hpp>
 
+namespace boost
+{
+class barrier;
+}
+
 namespace fcl
 {
 
+template<typename BV>
+class BVHModel;
+
+template<typename BV>
+int saveBVHModel(const BVHModel<BV>& model, const std::string& file_name);
+
+template<typename BV>
+int loadBVHModel(const std::string& file_name, BVHModel<BV>& model);
+
+namespace details
+{
+
+/// @brief Immutable geometry and hierarchy arrays shared by the copies of a built BVHModel. The arrays are deleted
+/// with the last copy, unless they point into mapping (e.g. a memory mapped file), which is released instead
+template<typename BV>
+struct BVHSharedStorage
+{
+  BVHSharedStorage() : vertices(NULL),
+                       tri_indices(NULL),
+                       prev_vertices(NULL),
+                       primitive_indices(NULL),
+                       bvs(NULL)
+  {
+  }
+
+  ~BVHSharedStorage()
+  {
+    if(mapping) return;
+
+    delete [] vertices;
+    delete [] tri_indices;
+    delete [] prev_vertices;
+    delete [] primitive_indices;
+    delete [] bvs;
+  }
+
+  Vec3f* vertices;
+  Triangle* tri_indices;
+  Vec3f* prev_vertices;
+  unsigned int* primitive_indices;
+  BVNode<BV>* bvs;
+
+  boost::shared_ptr<const void> mapping;
+};
+
+/// @brief Parent links, leaf of each primitive, primitives of each vertex and nodes per depth of a built hierarchy,
+/// used to refit only the ancestors of moved vertices and to refit level by level in parallel
+struct BVHRefitTopology;
+
+}
+
 /// @brief A class describing the bounding hierarchy of a mesh model or a point cloud model (which is viewed as a degraded version of mesh)
 template<typename BV>
 class BVHModel : public CollisionGeometry
@@ -74,28 +132,30 @@ public:
                build_state(BVH_BUILD_STATE_EMPTY),
                bv_splitter(new BVSplitter<BV>(SPLIT_METHOD_MEAN)),
                bv_fitter(new BVFitter<BV>()),
+               use_triangle_cache(false),
+               refit_num_threads(0),
+               rebuild_threshold(0),
                num_tris_allocated(0),
                num_vertices_allocated(0),
                num_bvs_allocated(0),
                num_vertex_updated(0),
                primitive_indices(NULL),
                bvs(NULL),
-               num_bvs(0)
+               num_bvs(0),
+               all_vertices_dirty(true),
+               tree_size_sum(0),
+               built_tree_cost(-1)
   {
   }
 
-  /// @brief copy from another BVH
+  /// @brief copy from another BVH. A built model shares its arrays with the copy, so copying costs O(1) memory until
+  /// one of the models is modified
   BVHModel(const BVHModel& other);
 
   /// @brief deconstruction, delete mesh data related.
   ~BVHModel()
   {
-    delete [] vertices;
-    delete [] tri_indices;
-    delete [] bvs;
-
-    delete [] prev_vertices;
-    delete [] primitive_indices;
+    releaseData();
   }
 
   /// @brief We provide getBV() and getNumBVs() because BVH may be compressed (in future), so we must provide some flexibility here
@@ -106,9 +166,10 @@ public:
     return bvs[id];
   }
 
-  /// @brief Access the bv giving the its index
+  /// @brief Access the bv giving the its index. The model stops sharing its arrays with its copies first
   BVNode<BV>& getBV(int id)
   {
+    if(shared_storage) detachSharedStorage();
     return bvs[id];
   }
 
@@ -127,6 +188,10 @@ public:
   /// @brief Compute the AABB for the BVH, used for broad-phase collision
   void computeLocalAABB();
 
+  /// @brief Compute the AABB in world space of the model placed at tf. Oriented root BVs (OBB, RSS, OBBRSS, kIOS)
+  /// are rotated as well, which is tighter for models that are not aligned with their local axes
+  void computeAABB(const Transform3f& tf, AABB& aabb) const;
+
   /// @brief Begin a new BVH model
   int beginModel(int num_tris = 0, int num_vertices = 0);
 
@@ -178,19 +243,28 @@ public:
   /// @brief End BVH model update, will also refit or rebuild the bounding volume hierarchy
   int endUpdateModel(bool refit = true, bool bottomup = true);
 
-  /// @brief Check the number of memory used
+  /// @brief Number of bytes used by the model; with msg, print the usage and the bytes per triangle
   int memUsage(int msg) const;
 
+  /// @brief Cost of the hierarchy (the sum of the BV sizes relative to the size of the root) after the last refit,
+  /// divided by the cost right after the last build. Only tracked while rebuild_threshold is set, 1 otherwise
+  FCL_REAL getRelativeTreeCost() const;
+
   /// @brief This is a special acceleration: BVH_model default stores the BV's transform in world coordinate. However, we can also store each BV's transform related to its parent 
   /// BV node. When traversing the BVH, this can save one matrix transformation.
   void makeParentRelative()
   {
+    detachSharedStorage();
+
     Vec3f I[3] = {Vec3f(1, 0, 0), Vec3f(0, 1, 0), Vec3f(0, 0, 1)};
     makeParentRelativeRecurse(0, I, Vec3f());
+
+    shareStorage();
   }
 
 public:
-  /// @brief Geometry point data
+  /// @brief Geometry point data. Once the model is built, the array may be shared with copies of the model and must
+  /// only be changed through beginReplaceModel() or beginUpdateModel()
   Vec3f* vertices;
 
   /// @brief Geometry triangle index data, will be NULL for point clouds
@@ -214,6 +288,20 @@ public:
   /// @brief Fitting rule to fit a BV node to a set of geometry primitives
   boost::shared_ptr<BVFitterBase<BV> > bv_fitter;
 
+  /// @brief Whether endModel(), endReplaceModel() and endUpdateModel() precompute the triangle planes used by the mesh-mesh leaf tests
+  bool use_triangle_cache;
+
+  /// @brief Precomputed triangle planes, empty unless use_triangle_cache is set
+  TriangleCache triangle_cache;
+
+  /// @brief Number of threads refitting large hierarchies bottom-up, 0 means one per hardware thread
+  int refit_num_threads;
+
+  /// @brief endReplaceModel() and endUpdateModel() rebuild the hierarchy instead of only refitting it once
+  /// getRelativeTreeCost() exceeds this value; 0 never rebuilds. A rebuild renumbers the BV nodes, so front lists
+  /// kept for the model become invalid
+  FCL_REAL rebuild_threshold;
+
 private:
 
   int num_tris_allocated;
@@ -229,6 +317,73 @@ private:
   /// @brief Number of BV nodes in bounding volume hierarchy
   int num_bvs;
 
+  /// @brief When set, vertices, tri_indices, prev_vertices, primitive_indices and bvs are owned by this storage,
+  /// which may be shared with copies of the model or point into a memory mapped file; they are copied before the
+  /// model is modified
+  boost::shared_ptr<details::BVHSharedStorage<BV> > shared_storage;
+
+  /// @brief Delete the arrays owned by the model, or drop the reference to the shared storage
+  void releaseData();
+
+  /// @brief Move the arrays of a built model into a shared storage, so that copies of the model can reference them
+  void shareStorage();
+
+  /// @brief Take over the arrays of the shared storage, copying them unless the model is their only user, so that
+  /// they can be modified
+  void detachSharedStorage();
+
+  /// @brief Number of entries of primitive_indices
+  int getNumPrimitives() const;
+
+  /// @brief Vertices whose position changed since beginReplaceModel() or beginUpdateModel()
+  std::vector<int> dirty_vertices;
+
+  /// @brief Whether every leaf has to be refit, because the previous positions are not known
+  bool all_vertices_dirty;
+
+  /// @brief Built on demand for the current hierarchy and shared with copies of the model
+  boost::shared_ptr<const details::BVHRefitTopology> refit_topology;
+
+  /// @brief Marks of the nodes visited by the selective refit, all cleared between refits
+  std::vector<unsigned char> refit_marks;
+
+  /// @brief Sum of the BV sizes, maintained while rebuild_threshold is set
+  FCL_REAL tree_size_sum;
+
+  /// @brief Tree cost right after the last build, negative if unknown
+  FCL_REAL built_tree_cost;
+
+  /// @brief Store a replaced or updated vertex and remember whether it moved
+  void setNextVertex(const Vec3f& p);
+
+  /// @brief Refit the nodes above the dirty vertices, or the whole hierarchy when many vertices moved, and rebuild
+  /// it when its cost degraded past rebuild_threshold
+  int refitDirtyTree(bool bottomup);
+
+  /// @brief Build refit_topology for the current hierarchy if needed
+  void buildRefitTopology();
+
+  /// @brief Fit a leaf to its primitive, covering the previous positions as well during an update
+  int refitLeaf(int bv_id);
+
+  /// @brief Refit one node from its primitive or its children
+  void refitNode_bottomup(int bv_id);
+
+  /// @brief Worker of the parallel bottom-up refit: refit a share of each level, deepest level first
+  void refitLevels(int thread_id, int num_threads, boost::barrier* barrier);
+
+  /// @brief Recompute tree_size_sum and, if unknown, built_tree_cost
+  void updateTreeCost(bool after_build);
+
+  /// @brief Sum of the BV sizes relative to the size of the root, from tree_size_sum
+  FCL_REAL computeTreeCost() const;
+
+  template<typename T>
+  friend int saveBVHModel(const BVHModel<T>& model, const std::string& file_name);
+
+  template<typename T>
+  friend int loadBVHModel(const std::string& file_name, BVHModel<T>& model);
+
   /// @brief Build the bounding volume hierarchy
   int buildTree();
 
@@ -241,6 +396,9 @@ private:
   /// @brief Refit the bounding volume hierarchy in a bottom-up way (fast but less compact)
   int refitTree_bottomup();
 
+  /// @brief Recompute the triangle planes after the vertices changed, or drop them when the cache is disabled
+  void updateTriangleCache();
+
   /// @brief Recursive kernel for hierarchy construction
   int recursiveBuildTree(int bv_id, int first_primitive, int num_primitives);
 
@@ -0,0 +1,107 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FCL_BVH_SERIALIZATION_H
+#define FCL_BVH_SERIALIZATION_H
+
+#include "fcl/BVH/BVH_model.h"
+#include <string>
+
+namespace fcl
+{
+
+/// @brief Binary file format of a built BVHModel. The file starts with a BVHFileHeader, followed by the vertices,
+/// triangles, primitive indices and BV nodes as they are laid out in memory, each array aligned to
+/// BVH_FILE_ALIGNMENT bytes. The format is tied to the BV type, the floating point precision and the byte order of
+/// the machine that wrote it; the header records them and loading rejects a file that does not match.
+static const FCL_UINT32 BVH_FILE_VERSION = 1;
+
+static const FCL_UINT64 BVH_FILE_ALIGNMENT = 64;
+
+struct BVHFileHeader
+{
+  /// @brief "FCLBVH" followed by two zero bytes
+  char magic[8];
+  FCL_UINT32 version;
+
+  /// @brief 0x01020304 as written by the saving machine, to detect a different byte order
+  FCL_UINT32 byte_order;
+
+  /// @brief NODE_TYPE of the model and the sizes of the stored types
+  FCL_INT32 node_type;
+  FCL_UINT32 real_size;
+  FCL_UINT32 vertex_size;
+  FCL_UINT32 triangle_size;
+  FCL_UINT32 node_size;
+
+  FCL_INT32 num_vertices;
+  FCL_INT32 num_tris;
+  FCL_INT32 num_primitives;
+  FCL_INT32 num_bvs;
+
+  /// @brief Byte offsets of the arrays from the start of the file, and the file size
+  FCL_UINT64 vertices_offset;
+  FCL_UINT64 tri_indices_offset;
+  FCL_UINT64 primitive_indices_offset;
+  FCL_UINT64 bvs_offset;
+  FCL_UINT64 file_size;
+
+  /// @brief Local AABB of the model, so that loading does not touch the vertices
+  FCL_REAL aabb_min[3];
+  FCL_REAL aabb_max[3];
+  FCL_REAL aabb_center[3];
+  FCL_REAL aabb_radius;
+
+  FCL_REAL cost_density;
+  FCL_REAL threshold_occupied;
+  FCL_REAL threshold_free;
+};
+
+/// @brief Write a model whose hierarchy has been built (endModel() was called) to file_name
+template<typename BV>
+int saveBVHModel(const BVHModel<BV>& model, const std::string& file_name);
+
+/// @brief Load a file written by saveBVHModel() for the same BV type. The file is memory mapped read-only and the
+/// model references the mapped arrays directly, without parsing or copying them, so processes that load the same
+/// file share its pages. The mapping lives as long as the model uses it: beginReplaceModel(), beginUpdateModel()
+/// and makeParentRelative() first copy the arrays into memory owned by the model. Any previous content of the
+/// model is dropped. The triangle cache is rebuilt when use_triangle_cache is set. The file must not be overwritten
+/// while a model still maps it
+template<typename BV>
+int loadBVHModel(const std::string& file_name, BVHModel<BV>& model);
+
+}
+
+#endif
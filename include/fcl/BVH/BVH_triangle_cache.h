@@ -0,0 +1,107 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FCL_BVH_TRIANGLE_CACHE_H
+#define FCL_BVH_TRIANGLE_CACHE_H
+
+#include "fcl/math/vec_3f.h"
+#include "fcl/data_types.h"
+#include <boost/shared_array.hpp>
+
+namespace fcl
+{
+
+/// @brief Precomputed supporting planes n * x = t of the triangles of a mesh, used by the mesh-mesh leaf tests.
+/// The plane components are stored as separate arrays (structure of arrays), each aligned to ALIGNMENT bytes.
+/// Triangles that are degenerate get a zero normal and are tested without the cache.
+/// Copies share the planes; build() allocates new arrays when the current ones are shared.
+class TriangleCache
+{
+public:
+  static const int ALIGNMENT = 32;
+
+  TriangleCache();
+
+  TriangleCache(const TriangleCache& other);
+
+  TriangleCache& operator = (const TriangleCache& other);
+
+  /// @brief Compute the planes of the triangles
+  void build(const Vec3f* vertices, const Triangle* triangles, int num_triangles);
+
+  /// @brief Release the cached data
+  void clear();
+
+  /// @brief Number of cached triangles
+  inline int size() const { return num_tris; }
+
+  inline bool empty() const { return num_tris == 0; }
+
+  /// @brief Unit normal of triangle i, zero if the triangle is degenerate
+  inline Vec3f normal(int i) const
+  {
+    return Vec3f(normal_x()[i], normal_y()[i], normal_z()[i]);
+  }
+
+  /// @brief Plane offset of triangle i
+  inline FCL_REAL offset(int i) const { return offset_data()[i]; }
+
+  /// @brief Whether triangle i has a valid plane
+  inline bool valid(int i) const
+  {
+    return normal_x()[i] != 0 || normal_y()[i] != 0 || normal_z()[i] != 0;
+  }
+
+  inline const FCL_REAL* normal_x() const { return data; }
+  inline const FCL_REAL* normal_y() const { return data + stride; }
+  inline const FCL_REAL* normal_z() const { return data + 2 * stride; }
+  inline const FCL_REAL* offset_data() const { return data + 3 * stride; }
+
+  /// @brief Number of bytes used by the cache
+  int memUsage() const;
+
+private:
+  /// @brief Allocate the aligned arrays for n triangles, unless the current ones fit and are not shared
+  void allocate(int n);
+
+  boost::shared_array<FCL_REAL> buffer;
+  FCL_REAL* data;
+  int stride;
+  int num_tris;
+};
+
+}
+
+#endif
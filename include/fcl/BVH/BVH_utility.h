@@ -85,6 +85,9 @@ void getRadiusAndOriginAndRectangleSize(Vec3f* ps, Vec3f* ps2, Triangle* ts, uns
 /// @brief Compute the bounding volume extent and center for a set or subset of points, given the BV axises.
 void getExtentAndCenter(Vec3f* ps, Vec3f* ps2, Triangle* ts, unsigned int* indices, int n, Vec3f axis[3], Vec3f& center, Vec3f& extent);
 
+/// @brief Grow the box [min, max] to contain a set or subset of points. if ts = null, then indices refer to points directly; otherwise refer to triangles
+void getBoundingBox(Vec3f* ps, Vec3f* ps2, Triangle* ts, unsigned int* indices, int n, Vec3f& min, Vec3f& max);
+
 /// @brief Compute the center and radius for a triangle's circumcircle
 void circumCircleComputation(const Vec3f& a, const Vec3f& b, const Vec3f& c, Vec3f& center, FCL_REAL& radius);
 
@@ -39,6 +39,7 @@
 #define FCL_BV_FITTER_H
 
 #include "fcl/BVH/BVH_internal.h"
+#include "fcl/BV/AABB.h"
 #include "fcl/BV/kIOS.h"
 #include "fcl/BV/OBBRSS.h"
 #include <iostream>
@@ -170,6 +171,51 @@ private:
 };
 
 
+/// @brief Specification of BVFitter for AABB bounding volume
+template<>
+class BVFitter<AABB> : public BVFitterBase<AABB>
+{
+public:
+  /// @brief Prepare the geometry primitive data for fitting
+  void set(Vec3f* vertices_, Triangle* tri_indices_, BVHModelType type_)
+  {
+    vertices = vertices_;
+    prev_vertices = NULL;
+    tri_indices = tri_indices_;
+    type = type_;
+  }
+
+  /// @brief Prepare the geometry primitive data for fitting, for deformable mesh
+  void set(Vec3f* vertices_, Vec3f* prev_vertices_, Triangle* tri_indices_, BVHModelType type_)
+  {
+    vertices = vertices_;
+    prev_vertices = prev_vertices_;
+    tri_indices = tri_indices_;
+    type = type_;
+  }
+
+  /// @brief Compute a bounding volume that fits a set of primitives (points or triangles).
+  /// The primitive data was set by set function and primitive_indices is the primitive index relative to the data.
+  AABB fit(unsigned int* primitive_indices, int num_primitives);
+
+  /// brief Clear the geometry primitive data
+  void clear()
+  {
+    vertices = NULL;
+    prev_vertices = NULL;
+    tri_indices = NULL;
+    type = BVH_MODEL_UNKNOWN;
+  }
+
+private:
+
+  Vec3f* vertices;
+  Vec3f* prev_vertices;
+  Triangle* tri_indices;
+  BVHModelType type;
+};
+
+
 /// @brief Specification of BVFitter for OBB bounding volume
 template<>
 class BVFitter<OBB> : public BVFitterBase<OBB>
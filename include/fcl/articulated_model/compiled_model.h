@@ -0,0 +1,135 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \author Dalibor Matura, Jia Pan */
+
+#ifndef FCL_ARTICULATED_MODEL_COMPILED_MODEL_H
+#define FCL_ARTICULATED_MODEL_COMPILED_MODEL_H
+
+#include "fcl/articulated_model/joint.h"
+#include "fcl/math/transform.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fcl
+{
+
+class Model;
+class ModelConfig;
+
+/// @brief Global poses of all the joints of a CompiledModel, indexed by joint id. The pose of a link is the pose of
+/// its parent joint
+struct KinematicsResult
+{
+  std::vector<Matrix3f> rotations;
+  std::vector<Vec3f> translations;
+
+  inline Transform3f getTransform(int joint_id) const
+  {
+    return Transform3f(rotations[joint_id], translations[joint_id]);
+  }
+};
+
+/// @brief Flat form of a Model for repeated forward kinematics. Joints get integer ids in topological order (a parent
+/// joint always has a smaller id than its children), the joint data is kept in plain arrays and a configuration is a
+/// dense vector of DOF values, so evaluating all the joints is a single pass without name lookups or shared pointers.
+/// The name based accessors are meant for setting up a query, not for the inner loops
+class CompiledModel
+{
+public:
+  /// @brief Compile the model, which must have been initialized with Model::initTree(). Throws ModelParseError if
+  /// some joint is not reachable from the root link
+  CompiledModel(const Model& model);
+
+  inline std::size_t getNumJoints() const { return parents_.size(); }
+
+  inline std::size_t getNumDofs() const { return num_dofs_; }
+
+  /// @brief Id of the joint with the given name, -1 if there is none
+  int getJointId(const std::string& name) const;
+
+  /// @brief Id of the parent joint of the link with the given name, -1 for the root link or an unknown link
+  int getLinkJointId(const std::string& name) const;
+
+  inline const std::string& getJointName(int joint_id) const { return names_[joint_id]; }
+
+  /// @brief Id of the parent joint, -1 for the joints attached to the root link
+  inline int getParent(int joint_id) const { return parents_[joint_id]; }
+
+  inline JointType getJointType(int joint_id) const { return types_[joint_id]; }
+
+  /// @brief Index of the first DOF of the joint in a configuration vector
+  inline std::size_t getDofOffset(int joint_id) const { return dof_offsets_[joint_id]; }
+
+  inline std::size_t getJointNumDofs(int joint_id) const { return dof_offsets_[joint_id + 1] - dof_offsets_[joint_id]; }
+
+  /// @brief Copy the joint values of a ModelConfig into a configuration vector
+  void getDofs(const ModelConfig& model_cfg, std::vector<FCL_REAL>& dofs) const;
+
+  /// @brief Copy a configuration vector back into the joint values of a ModelConfig
+  void setDofs(const std::vector<FCL_REAL>& dofs, ModelConfig& model_cfg) const;
+
+  /// @brief Compute the global poses of all the joints for the configuration vector dofs
+  void forwardKinematics(const FCL_REAL* dofs, KinematicsResult& result) const;
+
+  inline void forwardKinematics(const std::vector<FCL_REAL>& dofs, KinematicsResult& result) const
+  {
+    forwardKinematics(&dofs[0], result);
+  }
+
+private:
+  std::vector<int> parents_;
+  std::vector<JointType> types_;
+
+  /// @brief Fixed transforms to the parent frames, stored as rotation matrix and translation
+  std::vector<Matrix3f> rotations_to_parent_;
+  std::vector<Vec3f> translations_to_parent_;
+
+  /// @brief Joint axes; for prismatic joints already rotated into the parent frame
+  std::vector<Vec3f> axes_;
+
+  /// @brief dof_offsets_[i] is the first DOF of joint i, the last entry is the total number of DOFs
+  std::vector<std::size_t> dof_offsets_;
+  std::size_t num_dofs_;
+
+  std::vector<std::string> names_;
+  std::map<std::string, int> joint_ids_;
+  std::map<std::string, int> link_joint_ids_;
+};
+
+}
+
+#endif
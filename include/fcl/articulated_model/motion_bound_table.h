@@ -0,0 +1,87 @@
+#ifndef FCL_MOTION_BOUND_TABLE_H
+#define FCL_MOTION_BOUND_TABLE_H
+
+#include "fcl/data_types.h"
+#include "fcl/math/vec_3f.h"
+#include "fcl/articulated_model/compiled_model.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace fcl
+{
+
+class Movement;
+
+/// @brief Motion bounds of all the links of a Movement over a set of time sub-intervals, evaluated in one pass.
+/// The interval k is [times[k], times[k + 1]]. For each interval the joints are processed in the topological order
+/// of a CompiledModel, so the accumulated angular bounds and the chain bounds of a joint are computed once from its
+/// parent and shared by all the links below it. A query is then a few table lookups and gives the same value as
+/// LinkBound::getMotionBound() for the same link, interval and direction
+class MotionBoundTable
+{
+public:
+	/// @brief times must be sorted and contain at least two values
+	MotionBoundTable(boost::shared_ptr<const Movement> movement, const std::vector<FCL_REAL>& times);
+
+	/// @brief Uniform sub-intervals of [0, 1]
+	MotionBoundTable(boost::shared_ptr<const Movement> movement, std::size_t num_intervals);
+
+	const CompiledModel& getCompiledModel() const { return compiled_model_; }
+
+	std::size_t getNumIntervals() const { return times_.size() - 1; }
+
+	std::size_t getNumJoints() const { return num_joints_; }
+
+	const std::vector<FCL_REAL>& getTimes() const { return times_; }
+
+	/// @brief Index of the interval that contains time, clamped to the valid range
+	std::size_t getIntervalIndex(FCL_REAL time) const;
+
+	/// @brief Motion bound of the link whose parent joint is joint_id over interval k; direction must be normalized
+	/// or zero for the direction independent bound
+	FCL_REAL getMotionBound(int joint_id, std::size_t k,
+		const Vec3f& direction, FCL_REAL max_distance_from_joint_center = 0) const;
+
+	/// @brief Motion bound over [start_time, end_time], the largest bound of the intervals it overlaps
+	FCL_REAL getMotionBound(int joint_id, FCL_REAL start_time, FCL_REAL end_time,
+		const Vec3f& direction, FCL_REAL max_distance_from_joint_center = 0) const;
+
+	/// @brief Motion bounds of all the joints for all the intervals, bounds[k * getNumJoints() + joint_id]
+	void getMotionBounds(const Vec3f& direction, FCL_REAL max_distance_from_joint_center,
+		std::vector<FCL_REAL>& bounds) const;
+
+private:
+	void init(const Movement& movement);
+
+	inline std::size_t index(int joint_id, std::size_t k) const { return k * num_joints_ + joint_id; }
+
+private:
+	CompiledModel compiled_model_;
+	std::size_t num_joints_;
+
+	std::vector<FCL_REAL> times_;
+
+	/// @brief Root joint of the chain of each joint
+	std::vector<int> chain_roots_;
+
+	/// @brief Per interval and joint: velocity bounds of the joint itself
+	std::vector<Vec3f> linear_velocity_bounds_;
+	std::vector<Vec3f> angular_velocity_bounds_;
+	std::vector<FCL_REAL> absolute_linear_velocity_bounds_;
+	std::vector<FCL_REAL> absolute_angular_velocity_bounds_;
+
+	/// @brief Per interval and joint: angular bound accumulated from the root joint down to the joint (inclusive)
+	std::vector<FCL_REAL> accumulated_angular_bounds_;
+
+	/// @brief Per interval and joint: motion bound of the joint frame caused by its ancestors
+	std::vector<FCL_REAL> chain_motion_bounds_;
+
+	/// @brief Per joint: sum of the child-parent distance bounds along the chain, used for the directional bounds
+	std::vector<FCL_REAL> chain_distance_bounds_;
+};
+
+}
+
+#endif
@@ -40,6 +40,8 @@
 #define FCL_BROAD_PHASE_H
 
 #include "fcl/collision_object.h"
+#include "fcl/collision_data.h"
+#include "fcl/broadphase/pose_update.h"
 #include <set>
 #include <vector>
 
@@ -58,7 +60,8 @@ typedef bool (*DistanceCallBack)(CollisionObject* o1, CollisionObject* o2, void*
 class BroadPhaseCollisionManager
 {
 public:
-  BroadPhaseCollisionManager() : enable_tested_set_(false)
+  BroadPhaseCollisionManager() : enable_tested_set_(false),
+                                 enable_statistics_(false)
   {
   }
 
@@ -95,6 +98,24 @@ public:
     update();
   }
 
+  /// @brief set the poses of n registered objects and recompute their AABBs in batches (see setPoses()), then update
+  /// the manager once with the objects whose AABB changed
+  void updatePoses(CollisionObject* const* objs, const Quaternion3f* rotations, const Vec3f* translations, std::size_t n)
+  {
+    std::vector<CollisionObject*> changed_objs;
+    if(setPoses(objs, rotations, translations, n, changed_objs) > 0)
+      update(changed_objs);
+  }
+
+  /// @brief set the poses of n registered objects and recompute their AABBs in batches (see setPoses()), then update
+  /// the manager once with the objects whose AABB changed
+  void updatePoses(CollisionObject* const* objs, const Matrix3f* rotations, const Vec3f* translations, std::size_t n)
+  {
+    std::vector<CollisionObject*> changed_objs;
+    if(setPoses(objs, rotations, translations, n, changed_objs) > 0)
+      update(changed_objs);
+  }
+
   /// @brief clear the manager
   virtual void clear() = 0;
 
@@ -125,12 +146,73 @@ public:
   /// @brief the number of objects managed by the manager
   virtual size_t size() const = 0;
 
+  /// @brief exclude the pair of objects from the pairs reported to collision callbacks, whatever their category and mask.
+  /// Collision between two managers may be filtered by the pairs disabled in either of them
+  void disablePair(CollisionObject* a, CollisionObject* b)
+  {
+    if(a < b) disabled_pairs.insert(std::make_pair(a, b));
+    else disabled_pairs.insert(std::make_pair(b, a));
+  }
+
+  /// @brief report the pair of objects to collision callbacks again, if their category and mask bits match
+  void enablePair(CollisionObject* a, CollisionObject* b)
+  {
+    if(a < b) disabled_pairs.erase(std::make_pair(a, b));
+    else disabled_pairs.erase(std::make_pair(b, a));
+  }
+
+  /// @brief enable all the pairs disabled by disablePair()
+  void clearDisabledPairs()
+  {
+    disabled_pairs.clear();
+  }
+
+  /// @brief whether the pair of objects was disabled by disablePair()
+  bool isPairDisabled(CollisionObject* a, CollisionObject* b) const
+  {
+    if(disabled_pairs.empty()) return false;
+    if(a < b) return disabled_pairs.find(std::make_pair(a, b)) != disabled_pairs.end();
+    else return disabled_pairs.find(std::make_pair(b, a)) != disabled_pairs.end();
+  }
+
+  /// @brief whether the pair of objects passes the collision filter: the category of each object is in the mask of the
+  /// other and the pair is not disabled. Pairs failing it are never reported to collision callbacks
+  inline bool canCollide(CollisionObject* a, CollisionObject* b) const
+  {
+    return CollisionObject::canCollide(a, b) && !isPairDisabled(a, b);
+  }
+
+  /// @brief whether the collision and distance queries of the manager gather statistics: their time, and the counters
+  /// of the collide() and distance() calls made by the callbacks, whether or not those request statistics themselves
+  void enableStatistics(bool enable)
+  {
+    enable_statistics_ = enable;
+  }
+
+  /// @brief statistics gathered since the last clearStatistics()
+  const QueryStatistics& getStatistics() const
+  {
+    return statistics_;
+  }
+
+  void clearStatistics()
+  {
+    statistics_.clear();
+  }
+
 protected:
 
+  /// @brief pairs of objects excluded from collision, stored as in tested_set
+  std::set<std::pair<CollisionObject*, CollisionObject*> > disabled_pairs;
+
   /// @brief tools help to avoid repeating collision or distance callback for the pairs of objects tested before. It can be useful for some of the broadphase algorithms.
   mutable std::set<std::pair<CollisionObject*, CollisionObject*> > tested_set;
   mutable bool enable_tested_set_;
 
+  /// @brief statistics of the queries, gathered if enable_statistics_ is set
+  bool enable_statistics_;
+  mutable QueryStatistics statistics_;
+
   bool inTestedSet(CollisionObject* a, CollisionObject* b) const
   {
     if(a < b) return tested_set.find(std::make_pair(a, b)) != tested_set.end();
@@ -146,6 +228,38 @@ protected:
 };
 
 
+namespace details
+{
+
+/// @brief Data of filteredCollisionCallback(): a collision callback and its data, called only for the pairs that the
+/// query object makes with objects of the manager and that pass the collision filter of the manager
+struct FilteredCollisionData
+{
+  FilteredCollisionData(const BroadPhaseCollisionManager* manager_, CollisionObject* query_, void* cdata_, CollisionCallBack callback_) : manager(manager_),
+                                                                                                                                          query(query_),
+                                                                                                                                          cdata(cdata_),
+                                                                                                                                          callback(callback_)
+  {
+  }
+
+  const BroadPhaseCollisionManager* manager;
+  CollisionObject* query;
+  void* cdata;
+  CollisionCallBack callback;
+};
+
+/// @brief Collision callback filtering the pairs whose second object stands for a part of the query object, e.g. an
+/// octree cell, by the filter between the first object and the query. cdata is a FilteredCollisionData
+inline bool filteredCollisionCallback(CollisionObject* o1, CollisionObject* o2, void* cdata)
+{
+  FilteredCollisionData* data = static_cast<FilteredCollisionData*>(cdata);
+  if(!data->manager->canCollide(o1, data->query)) return false;
+  return data->callback(o1, o2, data->cdata);
+}
+
+}
+
+
 /// @brief Callback for continuous collision between two objects. Return value is whether can stop now.
 typedef bool (*ContinuousCollisionCallBack)(ContinuousCollisionObject* o1, ContinuousCollisionObject* o2, void* cdata);
 
@@ -73,6 +73,7 @@ public:
     tree_topdown_level = 0;
     tree_init_level = 0;
     setup_ = false;
+    filter_dirty_ = true;
 
     // from experiment, this is the optimal setting
     octree_as_geometry_collide = true;
@@ -105,6 +106,7 @@ public:
   {
     dtree.clear();
     table.clear();
+    filter_dirty_ = true;
   }
 
   /// @brief return the objects managed by the manager
@@ -117,6 +119,10 @@ public:
   /// @brief perform collision test between one object and all the objects belonging to the manager
   void collide(CollisionObject* obj, void* cdata, CollisionCallBack callback) const;
 
+  /// @brief perform collision test between one octree object and all the objects belonging to the manager, only for the
+  /// cells of the octree that are dirty (see OcTree::collectChanges). Other objects are tested as in collide()
+  void collideDirty(CollisionObject* obj, void* cdata, CollisionCallBack callback) const;
+
   /// @brief perform distance computation between one object and all the objects belonging to the manager
   void distance(CollisionObject* obj, void* cdata, DistanceCallBack callback) const;
 
@@ -153,7 +159,13 @@ private:
 
   bool setup_;
 
+  /// @brief whether the category and mask of the tree nodes must be recomputed before the next collision query
+  mutable bool filter_dirty_;
+
   void update_(CollisionObject* updated_obj);  
+
+  /// @brief recompute the category and mask of the tree nodes if the tree or the objects changed
+  void refreshFilter_() const;
 };
 
 
@@ -0,0 +1,170 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#ifndef FCL_BROAD_PHASE_DYNAMIC_AABB_TREE_CONTINUES_H
+#define FCL_BROAD_PHASE_DYNAMIC_AABB_TREE_CONTINUES_H
+
+#include "fcl/broadphase/broadphase.h"
+#include "fcl/collision_data.h"
+#include "fcl/broadphase/hierarchy_tree.h"
+#include "fcl/BV/BV.h"
+#include <boost/unordered_map.hpp>
+#include <boost/bind.hpp>
+#include <limits>
+
+
+namespace fcl
+{
+
+/// @brief Continuous collision manager keeping the swept AABBs of the objects (ContinuousCollisionObject::getAABB, the box
+/// covering the whole motion) in a dynamic AABB tree.
+/// Besides the callback based queries of BroadPhaseContinuousCollisionManager, it can search for the earliest time of
+/// contact among all pairs of its objects, running the conservative advancement of the candidate pairs in parallel
+class DynamicAABBTreeContinuousCollisionManager : public BroadPhaseContinuousCollisionManager
+{
+public:
+  typedef NodeBase<AABB> DynamicAABBNode;
+  typedef boost::unordered_map<ContinuousCollisionObject*, DynamicAABBNode*> DynamicAABBTable;
+
+  int max_tree_nonbalanced_level;
+  int tree_incremental_balance_pass;
+  int& tree_topdown_balance_threshold;
+  int& tree_topdown_level;
+  int tree_init_level;
+
+  /// @brief number of threads used by collideEarliest(), 0 means one per hardware thread
+  int num_threads;
+
+  DynamicAABBTreeContinuousCollisionManager() : tree_topdown_balance_threshold(dtree.bu_threshold),
+                                                tree_topdown_level(dtree.topdown_level)
+  {
+    max_tree_nonbalanced_level = 10;
+    tree_incremental_balance_pass = 10;
+    tree_topdown_balance_threshold = 2;
+    tree_topdown_level = 0;
+    tree_init_level = 0;
+    num_threads = 0;
+    setup_ = false;
+  }
+
+  /// @brief add objects to the manager
+  void registerObjects(const std::vector<ContinuousCollisionObject*>& other_objs);
+
+  /// @brief add one object to the manager
+  void registerObject(ContinuousCollisionObject* obj);
+
+  /// @brief remove one object from the manager
+  void unregisterObject(ContinuousCollisionObject* obj);
+
+  /// @brief initialize the manager, related with the specific type of manager
+  void setup();
+
+  /// @brief update the condition of manager
+  void update();
+
+  /// @brief update the manager by explicitly given the object updated
+  void update(ContinuousCollisionObject* updated_obj);
+
+  /// @brief update the manager by explicitly given the set of objects update
+  void update(const std::vector<ContinuousCollisionObject*>& updated_objs);
+
+  /// @brief clear the manager
+  void clear()
+  {
+    dtree.clear();
+    table.clear();
+  }
+
+  /// @brief return the objects managed by the manager
+  void getObjects(std::vector<ContinuousCollisionObject*>& objs) const
+  {
+    objs.resize(this->size());
+    std::transform(table.begin(), table.end(), objs.begin(), boost::bind(&DynamicAABBTable::value_type::first, _1));
+  }
+
+  /// @brief perform collision test between one object and all the objects belonging to the manager
+  void collide(ContinuousCollisionObject* obj, void* cdata, ContinuousCollisionCallBack callback) const;
+
+  /// @brief perform distance computation between one object and all the objects belonging to the manager
+  void distance(ContinuousCollisionObject* obj, void* cdata, ContinuousDistanceCallBack callback) const;
+
+  /// @brief perform collision test for the objects belonging to the manager (i.e., N^2 self collision)
+  void collide(void* cdata, ContinuousCollisionCallBack callback) const;
+
+  /// @brief perform distance test for the objects belonging to the manager (i.e., N^2 self distance)
+  void distance(void* cdata, ContinuousDistanceCallBack callback) const;
+
+  /// @brief perform collision test with objects belonging to another manager
+  void collide(BroadPhaseContinuousCollisionManager* other_manager_, void* cdata, ContinuousCollisionCallBack callback) const;
+
+  /// @brief perform distance test with objects belonging to another manager
+  void distance(BroadPhaseContinuousCollisionManager* other_manager_, void* cdata, ContinuousDistanceCallBack callback) const;
+
+  /// @brief find the earliest contact in [request.start_time, request.end_time] among all pairs of objects of the manager
+  /// whose swept AABBs overlap (respecting outer geometries). The pairs are ordered by a lower bound of their time of
+  /// contact and advanced on num_threads threads, each pair only up to the earliest contact found so far. Pairs with an
+  /// articular motion share state with other objects of their model, so they are advanced on the calling thread.
+  /// result receives the contact and its time, o1 and o2 the pair (NULL without contact). Returns the number of contacts
+  /// (0 or 1)
+  int collideEarliest(const ContinuousCollisionRequest& request, ContinuousCollisionResult& result,
+                      ContinuousCollisionObject*& o1, ContinuousCollisionObject*& o2) const;
+
+  /// @brief whether the manager is empty
+  bool empty() const
+  {
+    return dtree.empty();
+  }
+
+  /// @brief the number of objects managed by the manager
+  size_t size() const
+  {
+    return dtree.size();
+  }
+
+  const HierarchyTree<AABB>& getTree() const { return dtree; }
+
+private:
+  HierarchyTree<AABB> dtree;
+  boost::unordered_map<ContinuousCollisionObject*, DynamicAABBNode*> table;
+
+  bool setup_;
+
+  void update_(ContinuousCollisionObject* updated_obj);
+};
+
+
+}
+
+#endif
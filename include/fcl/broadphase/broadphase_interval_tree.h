@@ -137,6 +137,9 @@ protected:
   };
 
 
+  /// @brief move the intervals of updated_obj in the interval trees to its current AABB, returning the previous one
+  void updateIntervals_(CollisionObject* updated_obj, AABB& old_aabb);
+
   bool checkColl(std::deque<SimpleInterval*>::const_iterator pos_start, std::deque<SimpleInterval*>::const_iterator pos_end, CollisionObject* obj, void* cdata, CollisionCallBack callback) const;
 
   bool checkDist(std::deque<SimpleInterval*>::const_iterator pos_start, std::deque<SimpleInterval*>::const_iterator pos_end, CollisionObject* obj, void* cdata, DistanceCallBack callback, FCL_REAL& min_dist) const;
@@ -40,6 +40,7 @@
 #include "fcl/broadphase/broadphase.h"
 #include "fcl/broadphase/hash.h"
 #include "fcl/BV/AABB.h"
+#include "fcl/probe.h"
 #include <list>
 #include <map>
 
@@ -168,6 +168,9 @@ void SpatialHashingCollisionManager<HashTable>::getObjects(std::vector<Collision
 template<typename HashTable>
 void SpatialHashingCollisionManager<HashTable>::collide(CollisionObject* obj, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
   collide_(obj, cdata, callback);
 }
@@ -175,6 +178,9 @@ void SpatialHashingCollisionManager<HashTable>::collide(CollisionObject* obj, vo
 template<typename HashTable>
 void SpatialHashingCollisionManager<HashTable>::distance(CollisionObject* obj, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
   distance_(obj, cdata, callback, min_dist);
@@ -193,7 +199,7 @@ bool SpatialHashingCollisionManager<HashTable>::collide_(CollisionObject* obj, v
       for(std::list<CollisionObject*>::const_iterator it = objs_outside_scene_limit.begin(), end = objs_outside_scene_limit.end(); 
           it != end; ++it)
       {
-        if(obj == *it) continue;
+        if(obj == *it || !canCollide(obj, *it)) continue;
         if(callback(obj, *it, cdata)) return true; 
       }
     }
@@ -201,7 +207,7 @@ bool SpatialHashingCollisionManager<HashTable>::collide_(CollisionObject* obj, v
     std::vector<CollisionObject*> query_result = hash_table->query(overlap_aabb);
     for(unsigned int i = 0; i < query_result.size(); ++i)
     {
-      if(obj == query_result[i]) continue;
+      if(obj == query_result[i] || !canCollide(obj, query_result[i])) continue;
       if(callback(obj, query_result[i], cdata)) return true;
     }
   }
@@ -211,7 +217,7 @@ bool SpatialHashingCollisionManager<HashTable>::collide_(CollisionObject* obj, v
     for(std::list<CollisionObject*>::const_iterator it = objs_outside_scene_limit.begin(), end = objs_outside_scene_limit.end(); 
         it != end; ++it)
     {
-      if(obj == *it) continue;
+      if(obj == *it || !canCollide(obj, *it)) continue;
       if(callback(obj, *it, cdata)) return true;
     }
   }
@@ -338,6 +344,9 @@ bool SpatialHashingCollisionManager<HashTable>::distance_(CollisionObject* obj,
 template<typename HashTable>
 void SpatialHashingCollisionManager<HashTable>::collide(void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   for(std::list<CollisionObject*>::const_iterator it1 = objs.begin(), end1 = objs.end(); 
@@ -353,14 +362,14 @@ void SpatialHashingCollisionManager<HashTable>::collide(void* cdata, CollisionCa
         for(std::list<CollisionObject*>::const_iterator it2 = objs_outside_scene_limit.begin(), end2 = objs_outside_scene_limit.end(); 
             it2 != end2; ++it2)
         {
-          if(*it1 < *it2) { if(callback(*it1, *it2, cdata)) return; }
+          if(*it1 < *it2 && canCollide(*it1, *it2)) { if(callback(*it1, *it2, cdata)) return; }
         }
       }
 
       std::vector<CollisionObject*> query_result = hash_table->query(overlap_aabb);
       for(unsigned int i = 0; i < query_result.size(); ++i)
       {
-        if(*it1 < query_result[i]) { if(callback(*it1, query_result[i], cdata)) return; }
+        if(*it1 < query_result[i] && canCollide(*it1, query_result[i])) { if(callback(*it1, query_result[i], cdata)) return; }
       }
     }
     else
@@ -368,7 +377,7 @@ void SpatialHashingCollisionManager<HashTable>::collide(void* cdata, CollisionCa
       for(std::list<CollisionObject*>::const_iterator it2 = objs_outside_scene_limit.begin(), end2 = objs_outside_scene_limit.end(); 
           it2 != end2; ++it2)
       {
-        if(*it1 < *it2) { if(callback(*it1, *it2, cdata)) return; }
+        if(*it1 < *it2 && canCollide(*it1, *it2)) { if(callback(*it1, *it2, cdata)) return; }
       }
     }
   }
@@ -377,6 +386,9 @@ void SpatialHashingCollisionManager<HashTable>::collide(void* cdata, CollisionCa
 template<typename HashTable>
 void SpatialHashingCollisionManager<HashTable>::distance(void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   enable_tested_set_ = true;
@@ -394,6 +406,9 @@ void SpatialHashingCollisionManager<HashTable>::distance(void* cdata, DistanceCa
 template<typename HashTable>
 void SpatialHashingCollisionManager<HashTable>::collide(BroadPhaseCollisionManager* other_manager_, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   SpatialHashingCollisionManager<HashTable>* other_manager = static_cast<SpatialHashingCollisionManager<HashTable>* >(other_manager_);
 
   if((size() == 0) || (other_manager->size() == 0)) return;
@@ -419,6 +434,9 @@ void SpatialHashingCollisionManager<HashTable>::collide(BroadPhaseCollisionManag
 template<typename HashTable>
 void SpatialHashingCollisionManager<HashTable>::distance(BroadPhaseCollisionManager* other_manager_, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   SpatialHashingCollisionManager<HashTable>* other_manager = static_cast<SpatialHashingCollisionManager<HashTable>* >(other_manager_);
 
   if((size() == 0) || (other_manager->size() == 0)) return;
@@ -41,6 +41,7 @@
 #include <map>
 #include "fcl/BV/AABB.h"
 #include "fcl/broadphase/morton.h"
+#include "fcl/broadphase/node_pool.h"
 #include <boost/bind.hpp>
 #include <boost/iterator/zip_iterator.hpp>
 
@@ -73,11 +74,19 @@ struct NodeBase
   /// @brief morton code for current BV
   FCL_UINT32 code;
 
+  /// @brief union of the collision categories of the objects in the subtree, for the managers filtering pairs
+  FCL_UINT32 category;
+
+  /// @brief union of the collision masks of the objects in the subtree
+  FCL_UINT32 mask;
+
   NodeBase()
   {
     parent = NULL;
     children[0] = NULL;
     children[1] = NULL;
+    category = ~FCL_UINT32(0);
+    mask = ~FCL_UINT32(0);
   }
 };
 
@@ -138,8 +147,12 @@ public:
   ~HierarchyTree();
   
   /// @brief Initialize the tree by a set of leaves using algorithm with a given level.
+  /// The leaves must be created by createLeaf(); the nodes of the previous tree are released.
   void init(std::vector<NodeType*>& leaves, int level = 0);
 
+  /// @brief Create a leaf node for init(), allocated from the node pool of the tree
+  NodeType* createLeaf(const BV& bv, void* data);
+
   /// @brief Insest a node
   NodeType* insert(const BV& bv, void* data);
 
@@ -289,8 +302,9 @@ protected:
 
   unsigned int opath;
 
-  /// This is a one NodeType cache, the reason is that we need to remove a node and then add it again frequently. 
-  NodeType* free_node; 
+  /// @brief all the nodes of the tree are allocated from the pool, so that removing and inserting nodes again does not
+  /// go to the heap and the nodes built together are stored together
+  NodePool<NodeType> node_pool;
 
   int max_lookahead_level;
   
@@ -331,6 +345,12 @@ struct NodeBase
   };
 
   FCL_UINT32 code;
+
+  /// @brief union of the collision categories of the objects in the subtree, for the managers filtering pairs
+  FCL_UINT32 category;
+
+  /// @brief union of the collision masks of the objects in the subtree
+  FCL_UINT32 mask;
   
   bool isLeaf() const { return (children[1] == (size_t)(-1)); }
   bool isInternal() const { return !isLeaf(); }
@@ -42,7 +42,6 @@ HierarchyTree<BV>::HierarchyTree(int bu_threshold_, int topdown_level_)
 {
   root_node = NULL;
   n_leaves = 0;
-  free_node = NULL;
   max_lookahead_level = -1;
   opath = 0;
   bu_threshold = bu_threshold_;
@@ -52,7 +51,6 @@ HierarchyTree<BV>::HierarchyTree(int bu_threshold_, int topdown_level_)
 template<typename BV>
 HierarchyTree<BV>::~HierarchyTree()
 {
-  clear();
 }
 
 template<typename BV>
@@ -77,6 +75,12 @@ void HierarchyTree<BV>::init(std::vector<NodeType*>& leaves, int level)
   }
 }
 
+template<typename BV>
+typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::createLeaf(const BV& bv, void* data)
+{
+  return createNode(NULL, bv, data);
+}
+
 template<typename BV>
 typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::insert(const BV& bv, void* data)
 {
@@ -97,11 +101,9 @@ void HierarchyTree<BV>::remove(NodeType* leaf)
 template<typename BV>
 void HierarchyTree<BV>::clear()
 {
-  if(root_node)
-    recurseDeleteNode(root_node);
+  root_node = NULL;
+  node_pool.clear();
   n_leaves = 0;
-  delete free_node;
-  free_node = NULL;
   max_lookahead_level = -1;
   opath = 0;
 }
@@ -460,7 +462,9 @@ typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::topdown_1(const NodeVec
 template<typename BV>
 void HierarchyTree<BV>::init_0(std::vector<NodeType*>& leaves)
 {
-  clear();
+  // the leaves come from the pool too, so only the nodes of the previous tree are released
+  if(root_node)
+    recurseDeleteNode(root_node);
   root_node = topdown(leaves.begin(), leaves.end());
   n_leaves = leaves.size();
   max_lookahead_level = -1;
@@ -470,7 +474,8 @@ void HierarchyTree<BV>::init_0(std::vector<NodeType*>& leaves)
 template<typename BV>
 void HierarchyTree<BV>::init_1(std::vector<NodeType*>& leaves)
 {
-  clear();
+  if(root_node)
+    recurseDeleteNode(root_node);
      
   BV bound_bv;
   if(leaves.size() > 0)
@@ -499,7 +504,8 @@ void HierarchyTree<BV>::init_1(std::vector<NodeType*>& leaves)
 template<typename BV>
 void HierarchyTree<BV>::init_2(std::vector<NodeType*>& leaves)
 {
-  clear();
+  if(root_node)
+    recurseDeleteNode(root_node);
      
   BV bound_bv;
   if(leaves.size() > 0)
@@ -528,7 +534,8 @@ void HierarchyTree<BV>::init_2(std::vector<NodeType*>& leaves)
 template<typename BV>
 void HierarchyTree<BV>::init_3(std::vector<NodeType*>& leaves)
 {
-  clear();
+  if(root_node)
+    recurseDeleteNode(root_node);
      
   BV bound_bv;
   if(leaves.size() > 0)
@@ -848,14 +855,7 @@ typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::createNode(NodeType* pa
 template<typename BV>
 typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::createNode(NodeType* parent, void* data)
 {
-  NodeType* node = NULL;
-  if(free_node)
-  {
-    node = free_node;
-    free_node = NULL;
-  }
-  else
-    node = new NodeType();
+  NodeType* node = node_pool.allocate();
   node->parent = parent;
   node->data = data;
   node->children[1] = 0;
@@ -865,11 +865,7 @@ typename HierarchyTree<BV>::NodeType* HierarchyTree<BV>::createNode(NodeType* pa
 template<typename BV>
 void HierarchyTree<BV>::deleteNode(NodeType* node)
 {
-  if(free_node != node)
-  {
-    delete free_node;
-    free_node = node;
-  }
+  node_pool.deallocate(node);
 }
 
 template<typename BV>
@@ -38,6 +38,7 @@
 #ifndef FCL_INTERVAL_TREE_H
 #define FCL_INTERVAL_TREE_H
 
+#include "fcl/broadphase/node_pool.h"
 #include <deque>
 #include <limits>
 
@@ -128,6 +129,9 @@ public:
 
 protected:
 
+  /// @brief all the nodes of the tree, nil and root included
+  NodePool<IntervalTreeNode> node_pool;
+
   IntervalTreeNode* root;
 
   IntervalTreeNode* nil;
@@ -0,0 +1,205 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \author Jia Pan */
+
+#ifndef FCL_BROAD_PHASE_NODE_POOL_H
+#define FCL_BROAD_PHASE_NODE_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace fcl
+{
+
+/// @brief Pool of the nodes of a tree. Nodes are carved in order out of contiguous blocks starting on a cache line,
+/// and released nodes go to a free list reused by the next allocations, so that insert and remove churn does not reach
+/// the heap. The blocks are only returned to the heap when the pool is destroyed. T must fit a pointer and have a
+/// trivial destructor: clear() drops the nodes without destroying them
+template<typename T>
+class NodePool
+{
+public:
+  /// @brief alignment of the blocks
+  static const std::size_t ALIGNMENT = 64;
+
+  /// @brief the first block holds nodes_per_block nodes; the next ones double in size, up to MAX_BLOCK_SIZE nodes
+  NodePool(std::size_t nodes_per_block = 64) : first_block_size(nodes_per_block > 0 ? nodes_per_block : 1),
+                                                current_block(0),
+                                                next_node(NULL),
+                                                end_node(NULL),
+                                                free_list(NULL),
+                                                num_nodes(0)
+  {
+  }
+
+  ~NodePool()
+  {
+    for(std::size_t i = 0; i < blocks.size(); ++i)
+      ::operator delete(blocks[i].memory);
+  }
+
+  /// @brief a default constructed node
+  T* allocate()
+  {
+    return new(allocateMemory()) T();
+  }
+
+  /// @brief a node constructed from one argument, e.g. a copy of another node
+  template<typename A>
+  T* allocate(const A& a)
+  {
+    return new(allocateMemory()) T(a);
+  }
+
+  /// @brief release a node of the pool for reuse
+  void deallocate(T* node)
+  {
+    node->~T();
+    *reinterpret_cast<void**>(node) = free_list;
+    free_list = node;
+    --num_nodes;
+  }
+
+  /// @brief release all the nodes at once. The blocks are kept, and filled again in order by the next allocations
+  void clear()
+  {
+    free_list = NULL;
+    num_nodes = 0;
+    current_block = 0;
+    if(blocks.empty())
+    {
+      next_node = end_node = NULL;
+    }
+    else
+    {
+      next_node = blocks[0].begin;
+      end_node = blocks[0].begin + blocks[0].size * sizeof(T);
+    }
+  }
+
+  /// @brief number of nodes allocated and not released
+  std::size_t size() const
+  {
+    return num_nodes;
+  }
+
+  /// @brief number of nodes the blocks can hold
+  std::size_t capacity() const
+  {
+    std::size_t n = 0;
+    for(std::size_t i = 0; i < blocks.size(); ++i)
+      n += blocks[i].size;
+    return n;
+  }
+
+  static const std::size_t MAX_BLOCK_SIZE = 16384;
+
+private:
+  NodePool(const NodePool&);
+  NodePool& operator = (const NodePool&);
+
+  struct Block
+  {
+    void* memory;
+    char* begin;
+    std::size_t size;
+  };
+
+  void* allocateMemory()
+  {
+    ++num_nodes;
+
+    if(free_list)
+    {
+      void* p = free_list;
+      free_list = *reinterpret_cast<void**>(p);
+      return p;
+    }
+
+    if(next_node == end_node)
+    {
+      // blocks kept by clear() are filled again before new ones are allocated
+      if(next_node != NULL && current_block + 1 < blocks.size())
+        ++current_block;
+      else
+        addBlock();
+
+      next_node = blocks[current_block].begin;
+      end_node = next_node + blocks[current_block].size * sizeof(T);
+    }
+
+    void* p = next_node;
+    next_node += sizeof(T);
+    return p;
+  }
+
+  void addBlock()
+  {
+    std::size_t size = blocks.empty() ? first_block_size : blocks.back().size * 2;
+    if(size > MAX_BLOCK_SIZE) size = (first_block_size > MAX_BLOCK_SIZE) ? first_block_size : MAX_BLOCK_SIZE;
+
+    Block block;
+    block.memory = ::operator new(size * sizeof(T) + ALIGNMENT - 1);
+    block.begin = reinterpret_cast<char*>((reinterpret_cast<std::size_t>(block.memory) + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+    block.size = size;
+    blocks.push_back(block);
+    current_block = blocks.size() - 1;
+  }
+
+  std::size_t first_block_size;
+
+  std::vector<Block> blocks;
+
+  /// @brief block being filled, and its unused part
+  std::size_t current_block;
+  char* next_node;
+  char* end_node;
+
+  /// @brief released nodes, linked through their first bytes
+  void* free_list;
+
+  std::size_t num_nodes;
+};
+
+template<typename T>
+const std::size_t NodePool<T>::ALIGNMENT;
+
+template<typename T>
+const std::size_t NodePool<T>::MAX_BLOCK_SIZE;
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FCL_BROAD_PHASE_POSE_UPDATE_H
+#define FCL_BROAD_PHASE_POSE_UPDATE_H
+
+#include "fcl/collision_object.h"
+#include <vector>
+
+namespace fcl
+{
+
+/// @brief Set the poses of n objects, objs[i] to (rotations[i], translations[i]), and recompute their AABBs in world
+/// space. Each rotation is converted once and stored in both forms, instead of lazily on the first use of the matrix;
+/// the AABBs that are a rotated box (boxes, spheres, convex shapes, AABB and KDOP meshes, octrees, and every object
+/// with useTightAABB() off) are computed inline, the others through their geometry. The objects whose AABB changed
+/// are appended to changed_objs, in the order given. Returns their number
+std::size_t setPoses(CollisionObject* const* objs, const Quaternion3f* rotations, const Vec3f* translations, std::size_t n,
+                     std::vector<CollisionObject*>& changed_objs);
+
+/// @brief Same as above with the rotations given as matrices
+std::size_t setPoses(CollisionObject* const* objs, const Matrix3f* rotations, const Vec3f* translations, std::size_t n,
+                     std::vector<CollisionObject*>& changed_objs);
+
+}
+
+#endif
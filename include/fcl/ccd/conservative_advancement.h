@@ -97,6 +97,7 @@ private:
 	bool isCollisionFree() const;
 
 	void performContinuousCollision();
+	void performAdaptiveContinuousCollision();
 	void initContinuousCollision(ConservativeAdvancementNode& node);
 	void performConservativeSteps(ConservativeAdvancementNode& node);
 	bool stepsRemains(ConservativeAdvancementNode& node) const;
@@ -123,9 +124,11 @@ private:
 	FCL_REAL getRightTimeStep(ConservativeAdvancementNode& node,
 		const FCL_REAL& start_time, const FCL_REAL& end_time);
 
-	FCL_REAL getTimeStep(ConservativeAdvancementNode& node) const;
+	FCL_REAL getTimeStep(ConservativeAdvancementNode& node);
 
-	FCL_REAL getMinDistance(ConservativeAdvancementNode& node) const;
+	FCL_REAL getMinDistance(ConservativeAdvancementNode& node);
+	FCL_REAL getMinDistance(ConservativeAdvancementNode& node, BVHFrontList& front_list);
+	FCL_REAL getTimeStep(ConservativeAdvancementNode& node, BVHFrontList& front_list);
 
 	FCL_REAL moveForward();
 	void booleanCoolisionDetectionStep();
@@ -149,6 +152,9 @@ private:
 	FCL_REAL velocity_bound_;
 
 	FCL_REAL delta_time_;
+
+	int num_iterations_;
+	int num_distance_queries_;
 };
 
 template<typename BV, typename ConservativeAdvancementNode, typename CollisionNode>
@@ -161,7 +167,9 @@ ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::Conserv
 	motion2_(o2->getMotion() ),
 	model1_(static_cast<const BVHModel<BV>*>(o1->getCollisionGeometry() ) ),
 	model2_(static_cast<const BVHModel<BV>*>(o2->getCollisionGeometry() ) ),
-	velocity_bound_(0.0)
+	velocity_bound_(0.0),
+	num_iterations_(0),
+	num_distance_queries_(0)
 {
 }
 
@@ -176,7 +184,9 @@ ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::Conserv
 	motion2_(motion2),
 	model1_(static_cast<const BVHModel<BV>*>(geometry1) ),
 	model2_(static_cast<const BVHModel<BV>*>(geometry2) ),
-	velocity_bound_(0.0)
+	velocity_bound_(0.0),
+	num_iterations_(0),
+	num_distance_queries_(0)
 {
 }
 
@@ -198,9 +208,19 @@ int ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::col
 
 	if (isCollisionFree() )
 	{
-		performContinuousCollision();
+		if (request_->adaptive)
+		{
+			performAdaptiveContinuousCollision();
+		}
+		else
+		{
+			performContinuousCollision();
+		}
 	}
 
+	result_->setNumIterations(num_iterations_);
+	result_->setNumDistanceQueries(num_distance_queries_);
+
 	return static_cast<int>(result_->numContacts() );
 }
 
@@ -291,6 +311,9 @@ template<typename BV, typename ConservativeAdvancementNode, typename CollisionNo
 void ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::clearResult()
 {
 	result_->clear();
+
+	num_iterations_ = 0;
+	num_distance_queries_ = 0;
 }
 
 template<typename BV, typename ConservativeAdvancementNode, typename CollisionNode>
@@ -365,6 +388,96 @@ void ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::pe
 	result_->setTimeOfContact(node.toc);
 }
 
+template<typename BV, typename ConservativeAdvancementNode, typename CollisionNode>
+void ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::performAdaptiveContinuousCollision()
+{
+	// Intervals that may still contain the first contact, the earliest one at the back. Conservative steps shrink an
+	// interval from both ends; when they make little progress the interval is halved, which tightens the motion
+	// bounds of motions whose bounds depend on the time interval. The distance queries start from the front of the
+	// previous query, as consecutive queries are close in time
+	ConservativeAdvancementNode node;
+
+	integrateTimeToMotions(request_->start_time, request_->end_time);
+	initContinuousCollision(node);
+
+	BVHFrontList front_list;
+	const FCL_REAL tolerance = request_->toc_tolerance;
+
+	std::vector<std::pair<FCL_REAL, FCL_REAL> > intervals;
+	intervals.push_back(std::make_pair(request_->start_time, request_->end_time) );
+
+	FCL_REAL toc = request_->end_time;
+
+	while (!intervals.empty() )
+	{
+		FCL_REAL left_time = intervals.back().first;
+		FCL_REAL right_time = intervals.back().second;
+		intervals.pop_back();
+
+		++num_iterations_;
+
+		delta_time_ = right_time - left_time;
+
+		integrateTimeToMotions(left_time, right_time);
+		calculateVelocityBound();
+
+		if (getVelocityBound() <= std::numeric_limits<FCL_REAL>::min() )
+		{
+			continue;
+		}
+
+		FCL_REAL left_time_step = getTimeStep(node, front_list);
+
+		if (left_time_step <= tolerance)
+		{
+			toc = left_time;
+			addContact(node);
+			break;
+		}
+
+		FCL_REAL new_left_time = left_time + left_time_step;
+		if (new_left_time >= right_time)
+		{
+			continue;
+		}
+
+		// the motion bound of [left_time, right_time] also holds for the rest of the interval
+		integrateTimeToMotions(right_time, new_left_time);
+		FCL_REAL new_right_time = right_time - getTimeStep(node, front_list);
+		if (new_right_time <= new_left_time)
+		{
+			continue;
+		}
+
+		FCL_REAL progress = (new_left_time - left_time) + (right_time - new_right_time);
+		FCL_REAL middle_time = (new_left_time + new_right_time) / 2;
+
+		// halving only pays off when it gives a tighter motion bound, otherwise the steps would stay the same
+		bool split = false;
+		if (progress < (right_time - left_time) / 2 && new_right_time - new_left_time > 2 * tolerance)
+		{
+			FCL_REAL velocity_bound = getVelocityBound();
+
+			integrateTimeToMotions(new_left_time, middle_time);
+			calculateVelocityBound();
+
+			split = getVelocityBound() < 0.9 * velocity_bound;
+		}
+
+		if (split)
+		{
+			intervals.push_back(std::make_pair(middle_time, new_right_time) );
+			intervals.push_back(std::make_pair(new_left_time, middle_time) );
+		}
+		else
+		{
+			intervals.push_back(std::make_pair(new_left_time, new_right_time) );
+		}
+	}
+
+	result_->setTimeOfContact(toc);
+}
+
 template<typename BV, typename ConservativeAdvancementNode, typename CollisionNode>
 void ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::initContinuousCollision(ConservativeAdvancementNode& node)
 {
@@ -404,6 +517,8 @@ bool ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::st
 template<typename BV, typename ConservativeAdvancementNode, typename CollisionNode>
 void ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::performOneConservativeStep(ConservativeAdvancementNode& node)
 {
+	++num_iterations_;
+
 	initDistanceRecurse(node);
 
 	delta_time_ = request_->end_time - node.toc;
@@ -506,7 +621,12 @@ bool ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::co
 
 	initCollisionDetection();
 
-	return performBooleanContinuousCollision();		
+	bool is_collision = performBooleanContinuousCollision();
+
+	result_->setNumIterations(num_iterations_);
+	result_->setNumDistanceQueries(num_distance_queries_);
+
+	return is_collision;
 }
 
 template<typename BV, typename ConservativeAdvancementNode, typename CollisionNode>
@@ -545,6 +665,8 @@ bool ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::pe
 		const FCL_REAL& left_time = one_time_pair.first;
 		const FCL_REAL& right_time = one_time_pair.second;	
 
+		++num_iterations_;
+
 		FCL_REAL middle_time = (left_time + right_time) / 2.0;
 
 		performDiscreteCollision(middle_time);	
@@ -612,13 +734,9 @@ void ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::ca
 
 	velocity_bound_ = 0.0;
 
-	Vec3f nullPoint, distancePoint_1, distancePoint_2;
-
-	distancePoint_1[0] = model1_max_radius;
-	distancePoint_2[0] = model2_max_radius;
-
-	TriangleMotionBoundVisitor mb_visitor1(distancePoint_1, nullPoint, nullPoint, Vec3f(0.0, 0.0, 0.0) );
-	TriangleMotionBoundVisitor mb_visitor2(distancePoint_2, nullPoint, nullPoint, Vec3f(0.0, 0.0, 0.0) );
+	// direction independent bound for the ball around the model origin that contains the whole model
+	SphereMotionBoundVisitor mb_visitor1(Vec3f(0.0, 0.0, 0.0), model1_max_radius);
+	SphereMotionBoundVisitor mb_visitor2(Vec3f(0.0, 0.0, 0.0), model2_max_radius);
 
 	velocity_bound_ += motion1_->computeMotionBound(mb_visitor1);
 	velocity_bound_ += motion2_->computeMotionBound(mb_visitor2);
@@ -636,7 +754,7 @@ FCL_REAL ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>
 	FCL_REAL proj_max = 0;
 	FCL_REAL tmp = 0;
 
-	if (model1_->getNumBVs() <= 0)
+	if (model->getNumBVs() <= 0)
 	{
 		return 0.0;
 	}
@@ -652,7 +770,7 @@ FCL_REAL ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>
 	tmp = (bv.Tr + bv.axis[0] * bv.l[0] + bv.axis[1] * bv.l[1]).sqrLength();
 	if(tmp > proj_max) proj_max = tmp;
 
-	proj_max = std::sqrt(proj_max);
+	proj_max = std::sqrt(proj_max) + bv.r;
 
 	return proj_max;
 }
@@ -674,7 +792,7 @@ FCL_REAL ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>
 
 template<typename BV, typename ConservativeAdvancementNode, typename CollisionNode>
 FCL_REAL ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::getTimeStep(
-	ConservativeAdvancementNode& node) const
+	ConservativeAdvancementNode& node)
 {
 	FCL_REAL velocity_bound = getVelocityBound();
 
@@ -689,10 +807,54 @@ FCL_REAL ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>
 	return min_distance / velocity_bound;
 }
 
+template<typename BV, typename ConservativeAdvancementNode, typename CollisionNode>
+FCL_REAL ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::getTimeStep(
+	ConservativeAdvancementNode& node, BVHFrontList& front_list)
+{
+	FCL_REAL velocity_bound = getVelocityBound();
+
+	if (velocity_bound <= std::numeric_limits<FCL_REAL>::min() )
+	{
+		return 1.0;
+	}
+
+	return getMinDistance(node, front_list) / velocity_bound;
+}
+
 template<typename BV, typename ConservativeAdvancementNode, typename CollisionNode>
 FCL_REAL ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::getMinDistance(
-	ConservativeAdvancementNode& node) const
+	ConservativeAdvancementNode& node, BVHFrontList& front_list)
 {
+	Matrix3f R1_t, R2_t;
+	Vec3f T1_t, T2_t;
+
+	motion1_->getCurrentTransform(R1_t, T1_t);
+	motion2_->getCurrentTransform(R2_t, T2_t);
+
+	relativeTransform(R1_t, T1_t, R2_t, T2_t, node.R, node.T);
+
+	node.result->clear();
+
+	if (front_list.empty() )
+	{
+		::fcl::distanceRecurse(&node, 0, 0, &front_list);
+	}
+	else
+	{
+		propagateBVHFrontListDistanceRecurse(&node, &front_list);
+	}
+
+	++num_distance_queries_;
+
+	return node.result->min_distance;
+}
+
+template<typename BV, typename ConservativeAdvancementNode, typename CollisionNode>
+FCL_REAL ConservativeAdvancement<BV, ConservativeAdvancementNode, CollisionNode>::getMinDistance(
+	ConservativeAdvancementNode& node)
+{
+	++num_distance_queries_;
+
 	// FAKE computation
 	// return 100.0;
 
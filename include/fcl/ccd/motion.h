@@ -44,6 +44,7 @@
 #include <vector>
 
 #include "fcl/articulated_model/link_bound.h"
+#include "fcl/articulated_model/motion_bound_table.h"
 
 #include <boost/shared_ptr.hpp>
 
@@ -74,6 +75,12 @@ public:
     return mb_visitor.visit(*this);
   }
 
+  /// @brief Compute the direction independent speed bound for a sphere, which is defined in the visitor
+  FCL_REAL computeMotionBound(const SphereMotionBoundVisitor& mb_visitor) const
+  {
+    return mb_visitor.visit(*this);
+  }
+
   /// @brief Get the rotation and translation in current step
   void getCurrentTransform(Matrix3f& R, Vec3f& T) const
   {
@@ -275,6 +282,12 @@ public:
     return mb_visitor.visit(*this);
   }
 
+  /// @brief Compute the direction independent speed bound for a sphere, which is defined in the visitor
+  FCL_REAL computeMotionBound(const SphereMotionBoundVisitor& mb_visitor) const
+  {
+    return mb_visitor.visit(*this);
+  }
+
 
   /// @brief Get the rotation and translation in current step
   void getCurrentTransform(Matrix3f& R, Vec3f& T) const
@@ -451,6 +464,12 @@ public:
     return mb_visitor.visit(*this);
   }
 
+  /// @brief Compute the direction independent speed bound for a sphere, which is defined in the visitor
+  FCL_REAL computeMotionBound(const SphereMotionBoundVisitor& mb_visitor) const
+  {
+    return mb_visitor.visit(*this);
+  }
+
   /// @brief Get the rotation and translation in current step
   void getCurrentTransform(Matrix3f& R, Vec3f& T) const
   {
@@ -573,9 +592,19 @@ public:
     return mb_visitor.visit(*this);
   }
 
+  /// @brief Compute the direction independent speed bound for a sphere, which is defined in the visitor
+  FCL_REAL computeMotionBound(const SphereMotionBoundVisitor& mb_visitor) const
+  {
+    return mb_visitor.visit(*this);
+  }
+
   FCL_REAL getMotionBound(const Vec3f& direction, const FCL_REAL max_distance_from_joint_center = 0) const;
   FCL_REAL getNonDirectionalMotionBound(const FCL_REAL max_distance_from_joint_center = 0) const;
 
+  /// @brief Take the motion bounds from a precomputed table instead of the LinkBound. The table must be built for the
+  /// same Movement; pass an empty pointer to go back to the LinkBound
+  void setMotionBoundTable(const boost::shared_ptr<const MotionBoundTable>& table);
+
   /// @brief Get the rotation and translation in current step
   void getCurrentTransform(Matrix3f& R, Vec3f& T) const
   {
@@ -628,11 +657,17 @@ protected:
 private:
   // Non parametrized constructor is not allowed
   ArticularMotion() :
+    table_joint_id_(-1),
     start_time_(0.0) {};
 
 private:
   boost::shared_ptr<LinkBound> link_bound_;
 
+  boost::shared_ptr<const MotionBoundTable> motion_bound_table_;
+
+  /// @brief Id of the parent joint of the bounded link in the table
+  int table_joint_id_;
+
   /// @brief The transformation at current time t
   mutable Transform3f tf_;
 
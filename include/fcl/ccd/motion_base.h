@@ -98,6 +98,24 @@ protected:
   Vec3f a, b, c, n;
 };
 
+/// @brief Compute a direction independent bound on the speed of any point of a sphere, given by its center and radius in the
+/// local frame of the object. Used to advance objects for which only the distance, and not the closest direction, is known
+class SphereMotionBoundVisitor
+{
+public:
+  SphereMotionBoundVisitor(const Vec3f& center_, FCL_REAL radius_) : center(center_), radius(radius_) {}
+
+  virtual FCL_REAL visit(const MotionBase& motion) const { return 0; }
+  virtual FCL_REAL visit(const SplineMotion& motion) const;
+  virtual FCL_REAL visit(const ScrewMotion& motion) const;
+  virtual FCL_REAL visit(const InterpMotion& motion) const;
+  virtual FCL_REAL visit(const ArticularMotion& motion) const;
+
+protected:
+  Vec3f center;
+  FCL_REAL radius;
+};
+
 
 
 class MotionBase
@@ -129,6 +147,9 @@ public:
   /** \brief Compute the motion bound for a triangle, given the closest direction n between two query objects */
   virtual FCL_REAL computeMotionBound(const TriangleMotionBoundVisitor& mb_visitor) const = 0;
 
+  /** \brief Compute the speed bound for a sphere in the local frame, independent of the direction */
+  virtual FCL_REAL computeMotionBound(const SphereMotionBoundVisitor& mb_visitor) const = 0;
+
   /** \brief Get the rotation and translation in current step */
   virtual void getCurrentTransform(Matrix3f& R, Vec3f& T) const = 0;
 
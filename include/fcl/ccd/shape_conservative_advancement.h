@@ -0,0 +1,99 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef FCL_SHAPE_CONSERVATIVE_ADVANCEMENT_H
+#define FCL_SHAPE_CONSERVATIVE_ADVANCEMENT_H
+
+#include "fcl/collision_object.h"
+#include "fcl/collision_data.h"
+#include "fcl/ccd/motion_base.h"
+
+namespace fcl
+{
+
+/// @brief Conservative advancement for pairs with at least one primitive shape (shape-shape and shape-mesh).
+/// Each step computes the distance of the two geometries with the narrow phase solver (GJK for shape pairs) and moves
+/// forward by the time in which the objects cannot travel that distance. The speed of an object is bounded analytically
+/// from its motion and the bounding sphere of its geometry, so the shapes never need to be tessellated.
+/// The bounding spheres are taken from aabb_center and aabb_radius, i.e. computeLocalAABB() must have been called for
+/// both geometries (ContinuousCollisionObject does that on construction).
+template<typename NarrowPhaseSolver>
+class ShapeConservativeAdvancement
+{
+public:
+  ShapeConservativeAdvancement(const ContinuousCollisionObject* o1, const ContinuousCollisionObject* o2,
+                               const NarrowPhaseSolver* nsolver = NULL);
+
+  ShapeConservativeAdvancement(const CollisionGeometry* geometry1, const MotionBase* motion1,
+                               const CollisionGeometry* geometry2, const MotionBase* motion2,
+                               const NarrowPhaseSolver* nsolver = NULL);
+
+  ~ShapeConservativeAdvancement();
+
+  /// @brief Find the first time of contact in [request.start_time, request.end_time], returns number of contacts (0 or 1)
+  int collide(const ContinuousCollisionRequest& request, ContinuousCollisionResult& result);
+
+  /// @brief Number of distance queries performed by the last call of collide()
+  int getNumSteps() const { return num_steps_; }
+
+  /// @brief Whether the pair of geometries can be handled: both are shapes, or one is a shape and the other a mesh
+  static bool isSupported(const CollisionGeometry* geometry1, const CollisionGeometry* geometry2);
+
+  /// @brief Advancement stops and reports a contact when the time step becomes smaller than this
+  static const FCL_REAL TIME_TOLERANCE;
+
+private:
+  /// @brief Distance of the geometries at the time the motions were last integrated to
+  FCL_REAL computeDistance(DistanceResult& distance_result);
+
+  /// @brief Bound on the speed of the closest points of the two geometries at the current time
+  FCL_REAL computeVelocityBound() const;
+
+  const CollisionGeometry* geometry1_;
+  const CollisionGeometry* geometry2_;
+
+  const MotionBase* motion1_;
+  const MotionBase* motion2_;
+
+  const NarrowPhaseSolver* nsolver_;
+  bool own_solver_;
+
+  int num_steps_;
+};
+
+}
+
+#endif
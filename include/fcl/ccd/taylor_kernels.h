@@ -0,0 +1,97 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \author Jia Pan */
+
+#ifndef FCL_CCD_TAYLOR_KERNELS_H
+#define FCL_CCD_TAYLOR_KERNELS_H
+
+#include "fcl/ccd/interval.h"
+
+/// @brief Kernels for the Taylor model arithmetic. An interval is kept in one register as the pair (-lower, upper),
+/// so that the sums and products of both ends round in the same direction: every result is widened upwards by its
+/// worst case round-off, which gives outward rounding without switching the rounding mode of the FPU. SSE2 is used
+/// when the compiler targets it, plain code otherwise.
+
+namespace fcl
+{
+
+namespace details
+{
+
+/// @brief Number of coefficients of a product of two cubic polynomials
+static const std::size_t TAYLOR_PRODUCT_SIZE = 7;
+
+/// @brief [a, b] + [c, d], rounded outwards
+Interval addOutward(const Interval& a, const Interval& b);
+
+/// @brief [a, b] * [c, d], rounded outwards
+Interval multiplyOutward(const Interval& a, const Interval& b);
+
+/// @brief Bound of sum_k coeffs[k] * powers[k] for k in [0, n), rounded outwards. powers[k] is the range of t^k
+Interval boundPolynomial(const FCL_REAL* coeffs, const Interval* powers, std::size_t n);
+
+/// @brief Sum of weighted products of cubic Taylor models over one time interval, sum_i w_i (p_i + r_i)(q_i + s_i).
+/// The coefficients of degree 4 to 6 and the round-off of the coefficients go into the remainder, so the result
+/// encloses the exact sum
+class TaylorProductAccumulator
+{
+public:
+  /// @brief powers[k] is the range of t^k, k = 0, ..., 6
+  TaylorProductAccumulator(const Interval* powers);
+
+  void add(const FCL_REAL* p, const Interval& r, const FCL_REAL* q, const Interval& s, FCL_REAL weight);
+
+  /// @brief The 4 coefficients and the remainder of the sum
+  void getResult(FCL_REAL* coeffs, Interval& remainder) const;
+
+private:
+  const Interval* powers_;
+
+  FCL_REAL product_[TAYLOR_PRODUCT_SIZE];
+
+  /// @brief Sums of the absolute values of the terms added to each coefficient
+  FCL_REAL magnitude_[TAYLOR_PRODUCT_SIZE];
+
+  /// @brief Remainder of the products, without the terms of degree 4 to 6
+  Interval remainder_;
+
+  std::size_t num_products_;
+};
+
+}
+
+}
+
+#endif
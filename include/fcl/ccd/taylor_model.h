@@ -53,21 +53,16 @@ struct TimeInterval
   Interval t5_; // [t1, t2]^5
   Interval t6_; // [t1, t2]^6
 
+  /// @brief [t1, t2]^k for k = 0, ..., 6 in one array, rounded outwards; used by the Taylor model kernels
+  Interval powers_[7];
+
   TimeInterval() {}
   TimeInterval(FCL_REAL l, FCL_REAL r)
   {
     setValue(l, r);
   }
 
-  void setValue(FCL_REAL l, FCL_REAL r)
-  {
-    t_.setValue(l, r);
-    t2_.setValue(l * t_[0], r * t_[1]);
-    t3_.setValue(l * t2_[0], r * t2_[1]);
-    t4_.setValue(l * t3_[0], r * t3_[1]);
-    t5_.setValue(l * t4_[0], r * t4_[1]);
-    t6_.setValue(l * t5_[0], r * t5_[1]);    
-  }
+  void setValue(FCL_REAL l, FCL_REAL r);
 };
 
 /// @brief TaylorModel implements a third order Taylor model, i.e., a cubic approximation of a function
@@ -143,8 +138,17 @@ public:
   Interval getBound(FCL_REAL t) const;
 
   void setZero();
+
+  friend void sumOfProducts(const TaylorModel* const* a, const TaylorModel* const* b, const FCL_REAL* weights,
+                            std::size_t n, TaylorModel& res);
 };
 
+/// @brief res = weights[0] * a[0] * b[0] + ... + weights[n - 1] * a[n - 1] * b[n - 1], computed in one pass with
+/// a single remainder. The round-off of the coefficients is moved into the remainder, so the result encloses the
+/// exact sum. All the models must share one time interval; res may be one of the inputs
+void sumOfProducts(const TaylorModel* const* a, const TaylorModel* const* b, const FCL_REAL* weights,
+                   std::size_t n, TaylorModel& res);
+
 TaylorModel operator * (FCL_REAL d, const TaylorModel& a);
 TaylorModel operator + (FCL_REAL d, const TaylorModel& a);
 TaylorModel operator - (FCL_REAL d, const TaylorModel& a);
@@ -72,14 +72,31 @@ std::size_t collide(const CollisionGeometry* o1, const Transform3f& tf1,
                     const CollisionRequest& request,
                     CollisionResult& result);
 
+/// @brief Continuous collision over the motions of the objects. Pairs with a primitive shape are advanced with GJK distances
+/// and analytic motion bounds (ShapeConservativeAdvancement), mesh pairs with the RSS conservative advancement
 std::size_t collide(const ContinuousCollisionObject* o1, const ContinuousCollisionObject* o2,
                     const ContinuousCollisionRequest& request,
                     ContinuousCollisionResult& result);
 
+std::size_t collide(const CollisionGeometry* o1, const MotionBase* motion1,
+                    const CollisionGeometry* o2, const MotionBase* motion2,
+                    const ContinuousCollisionRequest& request,
+                    ContinuousCollisionResult& result);
+
 std::size_t collide(const CollisionGeometry* o1, const MotionBase* motion1,
                     const CollisionGeometry* o2, const MotionBase* motion2,
                     const CollisionRequest& request,
                     CollisionResult& result);
+
+/// @brief Aggregate cost query between an octree and another object: the sum, over the octree cells overlapping the AABB
+/// of the other object, of the cell occupancy (the default occupancy for unknown cells) times the cost density of the
+/// object times the overlap volume. This is the approximate cost of CollisionRequest summed up without building the cost
+/// sources. Inner nodes bound the cost below them by their occupancy, which is the maximum of their children, so the
+/// traversal stops as soon as the total is known to be above or below request.cost_threshold.
+/// Return value is the lower bound of the total cost, which is the total cost when the query did not stop early.
+FCL_REAL computeCost(const CollisionObject* o1, const CollisionObject* o2,
+                     const CostRequest& request,
+                     CostResult& result);
 }
 
 #endif
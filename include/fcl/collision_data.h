@@ -163,7 +163,84 @@ struct CostSource
   }
 };
 
+/// @brief Statistics of the queries that request them. Counters accumulate over the queries sharing a result until
+/// the result is cleared, like its contacts
+struct QueryStatistics
+{
+  /// @brief number of collide() or distance() queries between two objects
+  std::size_t num_queries;
+
+  /// @brief number of BV overlap or distance tests, in BVH, compact model and octree traversals
+  std::size_t num_bv_tests;
+
+  /// @brief number of primitive (leaf) tests
+  std::size_t num_leaf_tests;
+
+  /// @brief number of GJK runs of either narrow phase solver, including the MPR runs of libccd intersection tests
+  std::size_t num_gjk_calls;
+
+  /// @brief number of GJK iterations. libccd keeps the iterations of its MPR internal, they are not counted
+  std::size_t num_gjk_iterations;
+
+  /// @brief number of EPA iterations of the built-in solver
+  std::size_t num_epa_iterations;
+
+  /// @brief wall time of the queries, in seconds
+  FCL_REAL time;
+
+  QueryStatistics()
+  {
+    clear();
+  }
+
+  /// @brief reset all the counters and the time
+  void clear();
+
+  /// @brief add the counters and time of other statistics
+  QueryStatistics& operator += (const QueryStatistics& other);
+};
+
+namespace details
+{
+
+/// @brief The statistics the traversals, solvers and queries running on the calling thread add to, NULL if none of
+/// the enclosing queries requested statistics
+QueryStatistics* getQueryStatistics();
+
+/// @brief Gather the statistics of a query on the calling thread. The counters of the enclosed work go to a block
+/// local to the scope; on exit they are added with the elapsed time to the target, and the counters to the enclosing
+/// scope, which times itself. With a NULL target, or a target an enclosing scope already gathers, the enclosing scope
+/// keeps gathering
+class QueryStatisticsScope
+{
+public:
+  QueryStatisticsScope(QueryStatistics* target);
+
+  ~QueryStatisticsScope();
+
+  /// @brief the block the enclosed work adds to, NULL if no statistics are gathered
+  QueryStatistics* statistics()
+  {
+    if(target_) return &local_;
+    return parent_ ? &parent_->local_ : NULL;
+  }
+
+private:
+  QueryStatisticsScope(const QueryStatisticsScope&);
+  QueryStatisticsScope& operator = (const QueryStatisticsScope&);
+
+  friend QueryStatistics* getQueryStatistics();
+
+  QueryStatistics* target_;
+  QueryStatisticsScope* parent_;
+  QueryStatistics local_;
+  FCL_REAL start_;
+};
+
+}
+
 struct CollisionResult;
+struct CostResult;
 
 /// @brief request to the collision algorithm
 struct CollisionRequest
@@ -183,17 +260,22 @@ struct CollisionRequest
   /// @brief whether the cost computation is approximated
   bool use_approximate_cost;
 
+  /// @brief whether the statistics of the query are added to the result
+  bool enable_statistics;
+
   CollisionRequest(size_t num_max_contacts_ = 1,
 				   bool enable_contact_ = false,
 				   size_t num_max_cost_sources_ = 1,
 				   bool enable_cost_ = false,
-				   bool use_approximate_cost_ = true)
+				   bool use_approximate_cost_ = true,
+				   bool enable_statistics_ = false)
 	:
 	num_max_contacts(num_max_contacts_),
 	enable_contact(enable_contact_),
 	num_max_cost_sources(num_max_cost_sources_),
 	enable_cost(enable_cost_),
-	use_approximate_cost(use_approximate_cost_)
+	use_approximate_cost(use_approximate_cost_),
+	enable_statistics(enable_statistics_)
   {
   }
 
@@ -202,6 +284,42 @@ struct CollisionRequest
   void assign(const CollisionRequest& request);
 };
 
+/// @brief request to the aggregate cost query between an octree and another object, see computeCost()
+struct CostRequest
+{
+  /// @brief the query stops as soon as the total cost is known to be above or below this threshold. With the default
+  /// the total cost is computed exactly
+  FCL_REAL cost_threshold;
+
+  CostRequest(FCL_REAL cost_threshold_ = std::numeric_limits<FCL_REAL>::max()) : cost_threshold(cost_threshold_)
+  {
+  }
+
+  bool isSatisfied(const CostResult& result) const;
+};
+
+/// @brief result of the aggregate cost query: the total cost lies in [lower_bound, upper_bound]. Both are equal unless
+/// the query stopped early at the threshold
+struct CostResult
+{
+  FCL_REAL lower_bound;
+
+  FCL_REAL upper_bound;
+
+  CostResult() : lower_bound(0), upper_bound(0)
+  {
+  }
+
+  /// @brief whether the total cost is known to reach the threshold
+  inline bool isAbove(FCL_REAL threshold) const { return lower_bound >= threshold; }
+
+  /// @brief whether the total cost is known to stay below the threshold
+  inline bool isBelow(FCL_REAL threshold) const { return upper_bound < threshold; }
+
+  /// @brief clear the results obtained
+  void clear();
+};
+
 /// @brief request to the continuous collision algorithm
 struct ContinuousCollisionRequest
 	: CollisionRequest
@@ -210,10 +328,19 @@ struct ContinuousCollisionRequest
 	FCL_REAL start_time;
 	FCL_REAL end_time;
 
+	/// @brief whether conservative advancement is combined with bisection of the time interval; this needs far fewer
+	/// distance queries for trajectories that pass close to contact
+	bool adaptive;
+
+	/// @brief the adaptive mode stops once the time of contact is known within this tolerance
+	FCL_REAL toc_tolerance;
+
 	ContinuousCollisionRequest()
 		:
 		start_time(0.0),
-		end_time(1.0)
+		end_time(1.0),
+		adaptive(false),
+		toc_tolerance(0.00001)
 	{
 	}
 };
@@ -257,6 +384,9 @@ public:
 	/// @brief clear the results obtained
 	void clear();
 
+	/// @brief statistics of the queries since the last clear, if the requests enabled them
+	QueryStatistics statistics;
+
 private:
 	/// @brief contact information
 	std::vector<Contact> contacts_;
@@ -271,7 +401,9 @@ struct ContinuousCollisionResult
 public:
 	ContinuousCollisionResult()
 		:
-		time_of_contact_(0.0)
+		time_of_contact_(0.0),
+		num_iterations_(0),
+		num_distance_queries_(0)
 	  {
 	  }
 
@@ -285,11 +417,35 @@ public:
 		  return time_of_contact_;
 	  }	  
 
+	  /// @brief number of advancement steps (or processed time intervals) of the last query
+	  inline void setNumIterations(int num_iterations)
+	  {
+		  num_iterations_ = num_iterations;
+	  }
+
+	  inline int getNumIterations() const
+	  {
+		  return num_iterations_;
+	  }
+
+	  /// @brief number of distance queries of the last query
+	  inline void setNumDistanceQueries(int num_distance_queries)
+	  {
+		  num_distance_queries_ = num_distance_queries;
+	  }
+
+	  inline int getNumDistanceQueries() const
+	  {
+		  return num_distance_queries_;
+	  }
+
 	  /// @brief clear the results obtained
 	  void clear();
 
 private:
 	FCL_REAL time_of_contact_;
+	int num_iterations_;
+	int num_distance_queries_;
 };
 
 struct DistanceResult;
@@ -300,7 +456,12 @@ struct DistanceRequest
   /// @brief whether to return the nearest points
   bool enable_nearest_points;
 
-  DistanceRequest(bool enable_nearest_points_ = false) : enable_nearest_points(enable_nearest_points_)
+  /// @brief whether the statistics of the query are added to the result
+  bool enable_statistics;
+
+  DistanceRequest(bool enable_nearest_points_ = false,
+                  bool enable_statistics_ = false) : enable_nearest_points(enable_nearest_points_),
+                                                     enable_statistics(enable_statistics_)
   {
   }
 
@@ -337,6 +498,9 @@ public:
   /// if object 2 is octree, it is the id of the cell
   int b2;
 
+  /// @brief statistics of the queries since the last clear, if the requests enabled them
+  QueryStatistics statistics;
+
   /// @brief invalid contact primitive information
   static const int NONE = -1;
   
@@ -400,6 +564,7 @@ public:
 	o2 = NULL;
 	b1 = NONE;
 	b2 = NONE;
+	statistics.clear();
   }
 };
 
@@ -51,12 +51,25 @@
 namespace fcl
 {
 
-/// @brief object type: BVH (mesh, points), basic geometry, octree
-enum OBJECT_TYPE {OT_UNKNOWN, OT_BVH, OT_GEOM, OT_OCTREE, OT_COUNT};
+/// @brief object type: BVH (mesh, points), basic geometry, octree, signed distance field
+enum OBJECT_TYPE {OT_UNKNOWN, OT_BVH, OT_GEOM, OT_OCTREE, OT_SDF, OT_COUNT};
 
-/// @brief traversal node type: bounding volume (AABB, OBB, RSS, kIOS, OBBRSS, KDOP16, KDOP18, kDOP24), basic shape (box, sphere, capsule, cone, cylinder, convex, plane, triangle), and octree
-enum NODE_TYPE {BV_UNKNOWN, BV_AABB, BV_OBB, BV_RSS, BV_kIOS, BV_OBBRSS, BV_KDOP16, BV_KDOP18, BV_KDOP24,
-                GEOM_BOX, GEOM_SPHERE, GEOM_CAPSULE, GEOM_CONE, GEOM_CYLINDER, GEOM_CONVEX, GEOM_PLANE, GEOM_HALFSPACE, GEOM_TRIANGLE, GEOM_OCTREE, NODE_COUNT};
+/// @brief traversal node type: bounding volume (AABB, OBB, RSS, kIOS, OBBRSS, KDOP16, KDOP18, kDOP24, compact quantized AABB), basic shape (box, sphere, capsule, cone, cylinder, convex, plane, triangle), octree, linear octree and signed distance field
+enum NODE_TYPE {BV_UNKNOWN, BV_AABB, BV_OBB, BV_RSS, BV_kIOS, BV_OBBRSS, BV_KDOP16, BV_KDOP18, BV_KDOP24, BV_COMPACT,
+                GEOM_BOX, GEOM_SPHERE, GEOM_CAPSULE, GEOM_CONE, GEOM_CYLINDER, GEOM_CONVEX, GEOM_PLANE, GEOM_HALFSPACE, GEOM_TRIANGLE, GEOM_OCTREE, GEOM_LINEAR_OCTREE, GEOM_SDF, NODE_COUNT};
+
+/// @brief Compute the AABB in world space of a box placed at tf, given by its center, axes and half extents in local coordinate
+inline void computeOrientedBoxAABB(const Transform3f& tf, const Vec3f& center, const Vec3f axis[3], const Vec3f& extent, AABB& aabb)
+{
+  const Matrix3f& R = tf.getRotation();
+  Vec3f delta;
+  for(int i = 0; i < 3; ++i)
+    delta += abs(R * axis[i]) * extent[i];
+
+  Vec3f c = tf.transform(center);
+  aabb.min_ = c - delta;
+  aabb.max_ = c + delta;
+}
 
 /// @brief The geometry for the object for collision or distance computation
 class CollisionGeometry
@@ -81,6 +94,19 @@ public:
   /// @brief compute the AABB for object in local coordinate
   virtual void computeLocalAABB() = 0;
 
+  /// @brief compute the AABB in world space of the object placed at tf. The default bounds the rotated aabb_local,
+  /// clipped by the box around the bounding sphere, which is smaller for round objects
+  virtual void computeAABB(const Transform3f& tf, AABB& aabb) const
+  {
+    const Vec3f axis[3] = {Vec3f(1, 0, 0), Vec3f(0, 1, 0), Vec3f(0, 0, 1)};
+    computeOrientedBoxAABB(tf, aabb_local.center(), axis, (aabb_local.max_ - aabb_local.min_) * 0.5, aabb);
+
+    Vec3f center = tf.transform(aabb_center);
+    Vec3f delta(aabb_radius);
+    aabb.min_.lbound(center - delta);
+    aabb.max_.ubound(center + delta);
+  }
+
   /// @brief get user data in geometry
   void* getUserData() const
   {
@@ -172,26 +198,30 @@ private:
 class CollisionObject
 {
 public:
-  CollisionObject(const boost::shared_ptr<CollisionGeometry> &cgeom_) : cgeom(cgeom_)
+  CollisionObject(const boost::shared_ptr<CollisionGeometry> &cgeom_) : cgeom(cgeom_), use_tight_aabb(true),
+      collision_category(1), collision_mask(~FCL_UINT32(0))
   {
     cgeom->computeLocalAABB();
     computeAABB();
   }
 
-  CollisionObject(const boost::shared_ptr<CollisionGeometry> &cgeom_, const Transform3f& tf) : cgeom(cgeom_), t(tf)
+  CollisionObject(const boost::shared_ptr<CollisionGeometry> &cgeom_, const Transform3f& tf) : cgeom(cgeom_), t(tf), use_tight_aabb(true),
+      collision_category(1), collision_mask(~FCL_UINT32(0))
   {
     cgeom->computeLocalAABB();
     computeAABB();
   }
 
   CollisionObject(const boost::shared_ptr<CollisionGeometry> &cgeom_, const Matrix3f& R, const Vec3f& T):
-      cgeom(cgeom_), t(Transform3f(R, T))
+      cgeom(cgeom_), t(Transform3f(R, T)), use_tight_aabb(true),
+      collision_category(1), collision_mask(~FCL_UINT32(0))
   {
     cgeom->computeLocalAABB();
     computeAABB();
   }
 
-  CollisionObject()
+  CollisionObject() : use_tight_aabb(true),
+      collision_category(1), collision_mask(~FCL_UINT32(0))
   {
   }
 
@@ -224,6 +254,10 @@ public:
     {
       aabb = translate(cgeom->aabb_local, t.getTranslation());
     }
+    else if(use_tight_aabb)
+    {
+      cgeom->computeAABB(t, aabb);
+    }
     else
     {
       Vec3f center = t.transform(cgeom->aabb_center);
@@ -233,6 +267,18 @@ public:
     }
   }
 
+  /// @brief whether computeAABB() bounds a rotated object by the tight AABB of its geometry, instead of the box
+  /// around its bounding sphere
+  bool useTightAABB() const
+  {
+    return use_tight_aabb;
+  }
+
+  void useTightAABB(bool use)
+  {
+    use_tight_aabb = use;
+  }
+
   /// @brief get user data in object
   void* getUserData() const
   {
@@ -305,6 +351,18 @@ public:
     t = tf;
   }
 
+  /// @brief set object's transform from both forms of the rotation, R being the matrix of q
+  void setTransform(const Matrix3f& R, const Quaternion3f& q, const Vec3f& T)
+  {
+    t.setTransform(R, q, T);
+  }
+
+  /// @brief set the AABB in world space, computed by the caller for the current transform in place of computeAABB()
+  void setAABB(const AABB& aabb_)
+  {
+    aabb = aabb_;
+  }
+
   /// @brief whether the object is in local coordinate
   bool isIdentityTransform() const
   {
@@ -359,6 +417,37 @@ public:
     return cgeom->isUncertain();
   }
 
+  /// @brief get the category bits of the object, tested against the collision mask of other objects by the broadphase
+  inline FCL_UINT32 getCollisionCategory() const
+  {
+    return collision_category;
+  }
+
+  /// @brief set the category bits of the object. Registered objects must be updated in their manager afterwards
+  void setCollisionCategory(FCL_UINT32 category)
+  {
+    collision_category = category;
+  }
+
+  /// @brief get the mask of the categories the object can collide with
+  inline FCL_UINT32 getCollisionMask() const
+  {
+    return collision_mask;
+  }
+
+  /// @brief set the mask of the categories the object can collide with. Registered objects must be updated in their
+  /// manager afterwards
+  void setCollisionMask(FCL_UINT32 mask)
+  {
+    collision_mask = mask;
+  }
+
+  /// @brief whether the category and mask bits of the two objects let the broadphase report them as a pair
+  static inline bool canCollide(const CollisionObject* o1, const CollisionObject* o2)
+  {
+    return (o1->collision_category & o2->collision_mask) && (o2->collision_category & o1->collision_mask);
+  }
+
 protected:
 
   boost::shared_ptr<CollisionGeometry> cgeom;
@@ -370,6 +459,14 @@ protected:
 
   /// @brief pointer to user defined data specific to this object
   void *user_data;
+
+  bool use_tight_aabb;
+
+  /// @brief category bits, 1 by default
+  FCL_UINT32 collision_category;
+
+  /// @brief categories the object collides with, all by default
+  FCL_UINT32 collision_mask;
 };
 
 
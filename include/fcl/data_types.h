@@ -39,15 +39,28 @@
 
 #include <cstddef>
 #include <boost/cstdint.hpp>
+#include "fcl/config.h"
 
 namespace fcl
 {
 
+#if FCL_SINGLE_PRECISION
+typedef float FCL_REAL;
+#else
 typedef double FCL_REAL;
+#endif
 typedef uint64_t FCL_INT64;
 typedef int64_t FCL_UINT64;
 typedef uint32_t FCL_UINT32;
 typedef int32_t FCL_INT32;
+typedef uint16_t FCL_UINT16;
+
+/// @brief storage class of the per-thread variables
+#if defined(_MSC_VER)
+#define FCL_THREAD_LOCAL __declspec(thread)
+#else
+#define FCL_THREAD_LOCAL __thread
+#endif
 
 /// @brief Triangle with 3 indices for points
 class Triangle
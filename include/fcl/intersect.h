@@ -127,9 +127,37 @@ public:
                                  unsigned int* num_contact_points = NULL,
                                  FCL_REAL* penetration_depth = NULL,
                                  Vec3f* normal = NULL);
+
+  /// @brief CD intersect between two triangles [P1, P2, P3] and [Q1, Q2, Q3] whose supporting planes n1 * x = t1 and n2 * x = t2 are
+  /// known (unit normals, as computed by buildTrianglePlane). This is the interval test of Guigue and Devillers, which needs no cross product
+  /// for non-coplanar triangles. Coplanar triangles are handled by the separating axis test above.
+  static bool intersect_Triangle(const Vec3f& P1, const Vec3f& P2, const Vec3f& P3, const Vec3f& n1, FCL_REAL t1,
+                                 const Vec3f& Q1, const Vec3f& Q2, const Vec3f& Q3, const Vec3f& n2, FCL_REAL t2,
+                                 Vec3f* contact_points = NULL,
+                                 unsigned int* num_contact_points = NULL,
+                                 FCL_REAL* penetration_depth = NULL,
+                                 Vec3f* normal = NULL);
+
+  /// @brief Same as above, with [Q1, Q2, Q3] and its plane given in the frame (R, T). Q is rejected against the plane of P before
+  /// its vertices are transformed.
+  static bool intersect_Triangle(const Vec3f& P1, const Vec3f& P2, const Vec3f& P3, const Vec3f& n1, FCL_REAL t1,
+                                 const Vec3f& Q1, const Vec3f& Q2, const Vec3f& Q3, const Vec3f& n2, FCL_REAL t2,
+                                 const Matrix3f& R, const Vec3f& T,
+                                 Vec3f* contact_points = NULL,
+                                 unsigned int* num_contact_points = NULL,
+                                 FCL_REAL* penetration_depth = NULL,
+                                 Vec3f* normal = NULL);
   
 private:
 
+  /// @brief Contact points, normal and depth of two intersecting triangles with the supporting planes n1 * x = t1 and n2 * x = t2
+  static void computeTriangleContacts(const Vec3f& P1, const Vec3f& P2, const Vec3f& P3, const Vec3f& n1, FCL_REAL t1,
+                                      const Vec3f& Q1, const Vec3f& Q2, const Vec3f& Q3, const Vec3f& n2, FCL_REAL t2,
+                                      Vec3f* contact_points,
+                                      unsigned int* num_contact_points,
+                                      FCL_REAL* penetration_depth,
+                                      Vec3f* normal);
+
   /// @brief Project function used in intersect_Triangle() 
   static int project6(const Vec3f& ax,
                       const Vec3f& p1, const Vec3f& p2, const Vec3f& p3,
@@ -0,0 +1,212 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef FCL_LINEAR_OCTREE_H
+#define FCL_LINEAR_OCTREE_H
+
+#include <vector>
+#include "fcl/octree.h"
+
+namespace fcl
+{
+
+/// @brief Immutable snapshot of an octomap tree, stored as one contiguous array of nodes. It can be used in place of
+/// OcTree in all the OcTreeSolver queries. The children of a node are stored next to each other and are reached by an
+/// offset instead of a pointer. The occupancy and the occupied/free/uncertain classification of every node are computed
+/// once when the snapshot is taken, and the subtrees below free nodes are dropped since no query descends into them.
+/// Later changes to the octomap tree are not reflected in the snapshot.
+class LinearOcTree : public CollisionGeometry
+{
+public:
+  /// @brief Node of the linear octree, with the same interface as the octomap node used by the traversal
+  class Node
+  {
+  public:
+    /// @brief whether the node has any child
+    inline bool hasChildren() const { return child_mask != 0; }
+
+    /// @brief whether the i-th child exists
+    inline bool childExists(unsigned int i) const { return (child_mask >> i) & 1; }
+
+    /// @brief get the i-th child, which must exist
+    inline const Node* getChild(unsigned int i) const
+    {
+      return this + first_child + countBits(child_mask & ((1 << i) - 1));
+    }
+
+    /// @brief occupancy probability of the node
+    inline FCL_REAL getOccupancy() const { return occupancy; }
+
+    /// @brief Morton location code of the node: a leading 1 followed by the child index (3 bits) on each level below the root
+    inline FCL_UINT64 getKey() const { return key; }
+
+    /// @brief depth of the node, the root is at depth 0
+    unsigned int getDepth() const;
+
+  private:
+    friend class LinearOcTree;
+
+    enum { OCCUPIED = 1, FREE = 2 };
+
+    static inline unsigned int countBits(unsigned int mask)
+    {
+      mask = mask - ((mask >> 1) & 0x55);
+      mask = (mask & 0x33) + ((mask >> 2) & 0x33);
+      return (mask + (mask >> 4)) & 0x0f;
+    }
+
+    FCL_UINT64 key;
+
+    /// @brief offset from this node to its first child in the node array
+    FCL_UINT32 first_child;
+
+    float occupancy;
+
+    unsigned char child_mask;
+
+    unsigned char flags;
+  };
+
+  typedef Node OcTreeNode;
+
+  /// @brief take a snapshot of an octomap tree, using the same default thresholds as OcTree
+  LinearOcTree(const boost::shared_ptr<const octomap::OcTree>& tree);
+
+  /// @brief take a snapshot of the octomap tree of an OcTree, keeping the thresholds of the OcTree
+  LinearOcTree(const OcTree& tree);
+
+  /// @brief compute the AABB for the octree in its local coordinate system
+  void computeLocalAABB()
+  {
+    aabb_local = getRootBV();
+    aabb_center = aabb_local.center();
+    aabb_radius = (aabb_local.min_ - aabb_center).length();
+  }
+
+  /// @brief get the bounding volume for the root
+  inline AABB getRootBV() const
+  {
+    return root_bv;
+  }
+
+  /// @brief get the root node of the octree, NULL if the tree is empty
+  inline const Node* getRoot() const
+  {
+    return nodes.empty() ? NULL : &nodes[0];
+  }
+
+  /// @brief whether one node is completely occupied
+  inline bool isNodeOccupied(const Node* node) const
+  {
+    return node->flags & Node::OCCUPIED;
+  }
+
+  /// @brief whether one node is completely free
+  inline bool isNodeFree(const Node* node) const
+  {
+    return node->flags & Node::FREE;
+  }
+
+  /// @brief whether one node is uncertain
+  inline bool isNodeUncertain(const Node* node) const
+  {
+    return node->flags == 0;
+  }
+
+  /// @brief number of nodes in the snapshot
+  inline std::size_t size() const
+  {
+    return nodes.size();
+  }
+
+  /// @brief access the i-th node, nodes are stored with each node's children after it
+  inline const Node& getNode(std::size_t i) const
+  {
+    return nodes[i];
+  }
+
+  /// @brief compute the bounding volume of a node from its location code
+  AABB getNodeBV(const Node* node) const;
+
+  /// @brief transform the octree into a bunch of boxes, same as OcTree::toBoxes
+  std::vector<boost::array<FCL_REAL, 6> > toBoxes() const;
+
+  /// @brief the threshold used to decide whether one node is occupied
+  FCL_REAL getOccupancyThres() const
+  {
+    return occupancy_threshold;
+  }
+
+  /// @brief the threshold used to decide whether one node is free
+  FCL_REAL getFreeThres() const
+  {
+    return free_threshold;
+  }
+
+  FCL_REAL getDefaultOccupancy() const
+  {
+    return default_occupancy;
+  }
+
+  /// @brief return object type, it is an octree
+  OBJECT_TYPE getObjectType() const { return OT_OCTREE; }
+
+  /// @brief return node type, it is a linear octree
+  NODE_TYPE getNodeType() const { return GEOM_LINEAR_OCTREE; }
+
+private:
+  /// @brief copy the octomap tree into the node array
+  void build(const octomap::OcTree& tree);
+
+  /// @brief append the children of the node at index, whose source is the given octomap node, and their subtrees
+  void addChildren(std::size_t index, const octomap::OcTreeNode* source);
+
+  /// @brief fill in the node from its octomap source
+  void setNode(Node& node, const octomap::OcTreeNode* source, FCL_UINT64 key) const;
+
+  std::vector<Node> nodes;
+
+  AABB root_bv;
+
+  FCL_REAL default_occupancy;
+
+  FCL_REAL occupancy_threshold;
+  FCL_REAL free_threshold;
+};
+
+}
+
+#endif
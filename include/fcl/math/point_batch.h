@@ -0,0 +1,133 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FCL_POINT_BATCH_H
+#define FCL_POINT_BATCH_H
+
+#include "fcl/math/vec_3f.h"
+#include "fcl/math/matrix_3f.h"
+
+/// @brief Kernels working on many points at once. The points are stored as structure of arrays (all x, then all y,
+/// then all z), so the kernels process several points per instruction with AVX or SSE when the compiler targets them,
+/// and fall back to plain loops otherwise.
+
+namespace fcl
+{
+
+/// @brief Fixed size block of points in structure of arrays layout, used to stream scattered points through the kernels
+struct PointBlock
+{
+  static const int CAPACITY = 64;
+
+  FCL_REAL x[CAPACITY];
+  FCL_REAL y[CAPACITY];
+  FCL_REAL z[CAPACITY];
+  int size;
+
+  PointBlock() : size(0) {}
+
+  inline bool empty() const { return size == 0; }
+
+  /// @brief Whether there is room for n more points
+  inline bool hasRoom(int n) const { return size + n <= CAPACITY; }
+
+  inline void clear() { size = 0; }
+
+  inline void push_back(const Vec3f& p)
+  {
+    x[size] = p[0]; y[size] = p[1]; z[size] = p[2];
+    ++size;
+  }
+
+  inline Vec3f point(int i) const { return Vec3f(x[i], y[i], z[i]); }
+};
+
+/// @brief Transform n points: (ox, oy, oz)[i] = R * (x, y, z)[i] + T. The output may alias the input
+void transformPoints(const Matrix3f& R, const Vec3f& T,
+                     const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n,
+                     FCL_REAL* ox, FCL_REAL* oy, FCL_REAL* oz);
+
+/// @brief Index of the first point with the largest dot product with dir, -1 when there is no point. max_dot receives that product
+int maxDotPoint(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n, const Vec3f& dir, FCL_REAL& max_dot);
+
+/// @brief Grow the box [min, max] to contain the n points
+void boundPoints(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n, Vec3f& min, Vec3f& max);
+
+/// @brief Add the sum of the points to sum and the sum of their outer products p * p^T to sum_squares
+void accumulatePointMoments(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n, Vec3f& sum, Matrix3f& sum_squares);
+
+/// @brief Separating axis test of n axis aligned cubes, given by their centers (x, y, z) and half sizes, against the
+/// triangle (p1, p2, p3) in the same frame. overlap[i] tells whether cube i touches the triangle; returns the number
+/// of cubes that do
+int overlapCubesTriangle(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, const FCL_REAL* half_size, int n,
+                         const Vec3f& p1, const Vec3f& p2, const Vec3f& p3, bool* overlap);
+
+inline void transformPoints(const Matrix3f& R, const Vec3f& T, const PointBlock& block, PointBlock& out)
+{
+  transformPoints(R, T, block.x, block.y, block.z, block.size, out.x, out.y, out.z);
+  out.size = block.size;
+}
+
+inline int maxDotPoint(const PointBlock& block, const Vec3f& dir, FCL_REAL& max_dot)
+{
+  return maxDotPoint(block.x, block.y, block.z, block.size, dir, max_dot);
+}
+
+inline void boundPoints(const PointBlock& block, Vec3f& min, Vec3f& max)
+{
+  boundPoints(block.x, block.y, block.z, block.size, min, max);
+}
+
+inline void accumulatePointMoments(const PointBlock& block, Vec3f& sum, Matrix3f& sum_squares)
+{
+  accumulatePointMoments(block.x, block.y, block.z, block.size, sum, sum_squares);
+}
+
+inline int overlapCubesTriangle(const PointBlock& centers, const FCL_REAL* half_size,
+                                const Vec3f& p1, const Vec3f& p2, const Vec3f& p3, bool* overlap)
+{
+  return overlapCubesTriangle(centers.x, centers.y, centers.z, half_size, centers.size, p1, p2, p3, overlap);
+}
+
+/// @brief Versions for arrays of Vec3f, which are converted block by block
+void transformPoints(const Matrix3f& R, const Vec3f& T, const Vec3f* ps, int n, Vec3f* out);
+
+int maxDotPoint(const Vec3f* ps, int n, const Vec3f& dir, FCL_REAL& max_dot);
+
+void boundPoints(const Vec3f* ps, int n, Vec3f& min, Vec3f& max);
+
+}
+
+#endif
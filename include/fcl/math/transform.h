@@ -259,6 +259,16 @@ public:
     T = T_;
   }
 
+  /// @brief set transform from both forms of the rotation and translation, when R_ is already known to be the
+  /// matrix of q_; neither is converted to the other
+  inline void setTransform(const Matrix3f& R_, const Quaternion3f& q_, const Vec3f& T_)
+  {
+    R = R_;
+    q = q_;
+    T = T_;
+    matrix_set = true;
+  }
+
   /// @brief set transform from rotation
   inline void setRotation(const Matrix3f& R_)
   {
@@ -180,7 +180,11 @@ private:
 
 static const size_t EPA_MAX_FACES = 128;
 static const size_t EPA_MAX_VERTICES = 64;
+#if FCL_SINGLE_PRECISION
+static const FCL_REAL EPA_EPS = 0.0001;
+#else
 static const FCL_REAL EPA_EPS = 0.000001;
+#endif
 static const size_t EPA_MAX_ITERATIONS = 255;
 
 /// @brief class for EPA algorithm
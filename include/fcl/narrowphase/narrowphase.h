@@ -175,8 +175,13 @@ struct GJKSolver_libccd
   {
     max_collision_iterations = 500;
     max_distance_iterations = 1000;
+#if FCL_SINGLE_PRECISION
+    collision_tolerance = 1e-4;
+    distance_tolerance = 1e-4;
+#else
     collision_tolerance = 1e-6;
     distance_tolerance = 1e-6;
+#endif
   }
 
   /// @brief maximum number of iterations used in GJK algorithm for collision
@@ -560,11 +565,16 @@ struct GJKSolver_indep
   GJKSolver_indep()
   {
     gjk_max_iterations = 128;
-    gjk_tolerance = 1e-6;
     epa_max_face_num = 128;
     epa_max_vertex_num = 64;
     epa_max_iterations = 255;
+#if FCL_SINGLE_PRECISION
+    gjk_tolerance = 1e-4;
+    epa_tolerance = 1e-4;
+#else
+    gjk_tolerance = 1e-6;
     epa_tolerance = 1e-6;
+#endif
   }
 
   /// @brief maximum number of simplex face used in EPA algorithm
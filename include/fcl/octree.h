@@ -39,8 +39,10 @@
 #define FCL_OCTREE_H
 
 
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include <boost/array.hpp>
+#include <boost/unordered_set.hpp>
 
 #include <octomap/octomap.h>
 #include "fcl/BV/AABB.h"
@@ -60,6 +62,15 @@ private:
   FCL_REAL occupancy_threshold;
   FCL_REAL free_threshold;
 
+  /// @brief cells changed since the dirty state was last cleared, in the octree's local frame
+  std::vector<AABB> dirty_cells;
+
+  /// @brief bounding box of all the dirty cells
+  AABB dirty_bound;
+
+  /// @brief keys of the octomap cells already in dirty_cells
+  boost::unordered_set<FCL_UINT64> dirty_keys;
+
 public:
 
   /// @brief OcTreeNode must implement the following interfaces:
@@ -105,6 +116,12 @@ public:
     return AABB(Vec3f(-delta, -delta, -delta), Vec3f(delta, delta, delta));
   }
 
+  /// @brief get the underlying octomap tree
+  inline const boost::shared_ptr<const octomap::OcTree>& getTree() const
+  {
+    return tree;
+  }
+
   /// @brief get the root node of the octree
   inline OcTreeNode* getRoot() const
   {
@@ -190,11 +207,52 @@ public:
     free_threshold = d;
   }
 
+  /// @brief mark the cells reported by octomap's change detection as dirty and return the number of newly marked cells.
+  /// The owner of the octomap tree enables the detection with enableChangeDetection(true) and calls
+  /// resetChangeDetection() after the changes were collected; cells already marked are not added again.
+  std::size_t collectChanges();
+
+  /// @brief mark a region, given in the octree's local frame, as dirty
+  void markDirty(const AABB& region);
+
+  /// @brief forget the dirty cells, once everything depending on them is up to date
+  void clearDirty();
+
+  /// @brief whether any cell is dirty
+  inline bool isDirty() const
+  {
+    return !dirty_cells.empty();
+  }
+
+  /// @brief the dirty cells, in the octree's local frame
+  inline const std::vector<AABB>& getDirtyCells() const
+  {
+    return dirty_cells;
+  }
+
+  /// @brief bounding box of the dirty cells
+  inline const AABB& getDirtyBound() const
+  {
+    return dirty_bound;
+  }
+
+  /// @brief whether a box in the octree's local frame overlaps any dirty cell
+  bool overlapDirty(const AABB& bv) const;
+
+  /// @brief bring boxes computed by toBoxes() up to date with the dirty cells: only the boxes around the dirty cells
+  /// are replaced, the rest are kept as they are
+  void updateBoxes(std::vector<boost::array<FCL_REAL, 6> >& boxes) const;
+
   /// @brief return object type, it is an octree
   OBJECT_TYPE getObjectType() const { return OT_OCTREE; }
 
   /// @brief return node type, it is an octree
   NODE_TYPE getNodeType() const { return GEOM_OCTREE; }
+
+private:
+  /// @brief collect the leaf cells below node that overlap one of the regions
+  void collectLeaves(const OcTreeNode* node, const AABB& bv, const std::vector<AABB>& regions, const AABB& regions_bound,
+                     std::vector<std::pair<const OcTreeNode*, AABB> >& leaves) const;
 };
 
 /// @brief compute the bounding volume of an octree node's i-th child
@@ -0,0 +1,214 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \author Jia Pan */
+
+#ifndef FCL_PROBE_H
+#define FCL_PROBE_H
+
+#include "fcl/config.h"
+#include <boost/cstdint.hpp>
+#include <iostream>
+
+#if FCL_ENABLE_PROBES
+#include <boost/atomic.hpp>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#else
+#include <boost/date_time/posix_time/posix_time.hpp>
+#endif
+#endif
+
+namespace fcl
+{
+
+namespace tools
+{
+
+/// @brief The instrumented hot paths. Timed probes count their calls and the time spent in them, nested calls on the
+/// same thread included in the outermost one. The other probes only count events
+enum ProbeId
+{
+  PROBE_BROADPHASE_COLLIDE,   ///< timed: collision queries of broadphase managers, callbacks included
+  PROBE_BROADPHASE_DISTANCE,  ///< timed: distance queries of broadphase managers, callbacks included
+  PROBE_COLLIDE,              ///< timed: collide() between two objects
+  PROBE_DISTANCE,             ///< timed: distance() between two objects
+  PROBE_BV_TEST,              ///< BV overlap or distance tests of the BVH traversals
+  PROBE_LEAF_TEST,            ///< leaf tests of the BVH traversals
+  PROBE_GJK_ITERATION,        ///< iterations of GJK in the built-in solver
+  PROBE_EPA_ITERATION,        ///< iterations of EPA in the built-in solver
+  NUM_PROBES
+};
+
+/// @brief Name of a probe, for reports
+const char* getProbeName(ProbeId id);
+
+/// @brief Counts and times of all the probes, summed over the threads
+struct ProbeTotals
+{
+  ProbeTotals();
+
+  /// @brief number of events or timed calls
+  boost::uint64_t count[NUM_PROBES];
+
+  /// @brief time spent in the timed calls, in ticks of the probe clock
+  boost::uint64_t ticks[NUM_PROBES];
+
+  /// @brief time spent in the timed calls of a probe, in seconds
+  double seconds(ProbeId id) const;
+
+  /// @brief the totals gathered since an earlier snapshot
+  ProbeTotals since(const ProbeTotals& earlier) const;
+
+  /// @brief print the non-zero probes
+  void print(std::ostream& out = std::cout) const;
+};
+
+/// @brief Whether the probes are compiled in (FCL_USE_PROBES). If not, all the totals stay 0
+bool probesEnabled();
+
+/// @brief Sum the probes of all the threads that ever fired one, including threads that exited. It takes no lock, so
+/// it can be called periodically while other threads run queries: each counter is read atomically, but a snapshot
+/// taken during a query may see its count without its time yet
+void snapshotProbes(ProbeTotals& totals);
+
+/// @brief Number of ticks of the probe clock per second: the TSC frequency, measured against the system clock since
+/// the library was loaded, or 1e6 on platforms without a TSC
+double probeTicksPerSecond();
+
+#if FCL_ENABLE_PROBES
+
+namespace details
+{
+
+/// @brief The probes of one thread. Only the owning thread writes them; snapshots read them concurrently. When its
+/// thread exits, the block is released with its counts and reused by the next new thread
+struct ProbeBlock
+{
+  boost::atomic<boost::uint64_t> count[NUM_PROBES];
+  boost::atomic<boost::uint64_t> ticks[NUM_PROBES];
+
+  /// @brief whether a timed probe is running on the thread, to skip nested ones
+  bool active[NUM_PROBES];
+
+  /// @brief whether a live thread owns the block
+  boost::atomic<bool> in_use;
+
+  /// @brief next block of the registry, set before the block is published
+  ProbeBlock* next;
+};
+
+/// @brief The block of the calling thread, claimed or allocated on the first probe the thread fires
+ProbeBlock* getProbeBlock();
+
+inline boost::uint64_t probeTicks()
+{
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+  return __rdtsc();
+#else
+  return (boost::posix_time::microsec_clock::universal_time() - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_microseconds();
+#endif
+}
+
+/// @brief Add to a counter of the calling thread. The owner is the only writer, so no read-modify-write is needed
+inline void probeAdd(boost::atomic<boost::uint64_t>& counter, boost::uint64_t n)
+{
+  counter.store(counter.load(boost::memory_order_relaxed) + n, boost::memory_order_relaxed);
+}
+
+}
+
+/// @brief Count n events of a probe
+inline void probeCount(ProbeId id, boost::uint64_t n = 1)
+{
+  details::probeAdd(details::getProbeBlock()->count[id], n);
+}
+
+/// @brief Time the enclosing scope with a probe, unless the probe is already timing an enclosing scope of the thread
+class ScopedProbe
+{
+public:
+  ScopedProbe(ProbeId id) : id_(id), block_(details::getProbeBlock())
+  {
+    if(block_->active[id_])
+    {
+      block_ = NULL;
+      return;
+    }
+
+    block_->active[id_] = true;
+    start_ = details::probeTicks();
+  }
+
+  ~ScopedProbe()
+  {
+    if(!block_) return;
+
+    details::probeAdd(block_->ticks[id_], details::probeTicks() - start_);
+    details::probeAdd(block_->count[id_], 1);
+    block_->active[id_] = false;
+  }
+
+private:
+  ProbeId id_;
+  details::ProbeBlock* block_;
+  boost::uint64_t start_;
+};
+
+#define FCL_PROBE_CONCAT_(a, b) a##b
+#define FCL_PROBE_CONCAT(a, b) FCL_PROBE_CONCAT_(a, b)
+
+/// @brief Time the rest of the enclosing scope with the probe id
+#define FCL_PROBE_SCOPE(id) fcl::tools::ScopedProbe FCL_PROBE_CONCAT(fcl_probe_scope_, __LINE__)(fcl::tools::id)
+
+/// @brief Count n events of the probe id
+#define FCL_PROBE_ADD(id, n) fcl::tools::probeCount(fcl::tools::id, (n))
+
+#else
+
+#define FCL_PROBE_SCOPE(id)
+#define FCL_PROBE_ADD(id, n)
+
+#endif
+
+/// @brief Count one event of the probe id
+#define FCL_PROBE_COUNT(id) FCL_PROBE_ADD(id, 1)
+
+}
+
+}
+
+#endif
@@ -0,0 +1,321 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FCL_SDF_SOLVER_H
+#define FCL_SDF_SOLVER_H
+
+#include "fcl/signed_distance_field.h"
+#include "fcl/shape/geometric_shapes.h"
+#include "fcl/shape/geometric_shapes_utility.h"
+#include "fcl/collision_data.h"
+#include <limits>
+#include <vector>
+
+namespace fcl
+{
+
+namespace details
+{
+
+/// @brief Signed distance from point p (in the local frame of the shape) to the shape surface, or a lower bound of it.
+/// The value is exact inside the shape, which is needed for penetration depth.
+inline FCL_REAL shapeSignedDistance(const Box& s, const Vec3f& p)
+{
+  Vec3f q = abs(p) - s.side * 0.5;
+  FCL_REAL inside = std::min(std::max(q[0], std::max(q[1], q[2])), (FCL_REAL)0);
+  q.lbound(Vec3f(0, 0, 0));
+  return q.length() + inside;
+}
+
+inline FCL_REAL shapeSignedDistance(const Sphere& s, const Vec3f& p)
+{
+  return p.length() - s.radius;
+}
+
+inline FCL_REAL shapeSignedDistance(const Capsule& s, const Vec3f& p)
+{
+  FCL_REAL half = s.lz * 0.5;
+  Vec3f q(p[0], p[1], p[2] - std::max(-half, std::min(p[2], half)));
+  return q.length() - s.radius;
+}
+
+inline FCL_REAL shapeSignedDistance(const Cylinder& s, const Vec3f& p)
+{
+  FCL_REAL d_rho = std::sqrt(p[0] * p[0] + p[1] * p[1]) - s.radius;
+  FCL_REAL d_z = std::abs(p[2]) - s.lz * 0.5;
+  FCL_REAL inside = std::min(std::max(d_rho, d_z), (FCL_REAL)0);
+  d_rho = std::max(d_rho, (FCL_REAL)0);
+  d_z = std::max(d_z, (FCL_REAL)0);
+  return std::sqrt(d_rho * d_rho + d_z * d_z) + inside;
+}
+
+/// @brief lower bound for cones: the cone is the intersection of the base half space and the slanted side
+inline FCL_REAL shapeSignedDistance(const Cone& s, const Vec3f& p)
+{
+  FCL_REAL half = s.lz * 0.5;
+  FCL_REAL rho = std::sqrt(p[0] * p[0] + p[1] * p[1]);
+  FCL_REAL slant = std::sqrt(s.lz * s.lz + s.radius * s.radius);
+  FCL_REAL d_side = (s.lz * rho + s.radius * (p[2] - half)) / slant;
+  FCL_REAL d_base = -half - p[2];
+  return std::max(d_side, d_base);
+}
+
+/// @brief lower bound for convex polytopes: the largest distance to the face planes
+inline FCL_REAL shapeSignedDistance(const Convex& s, const Vec3f& p)
+{
+  FCL_REAL d = -std::numeric_limits<FCL_REAL>::max();
+  for(int i = 0; i < s.num_planes; ++i)
+  {
+    FCL_REAL n = s.plane_normals[i].length();
+    d = std::max(d, (s.plane_normals[i].dot(p) - s.plane_dis[i]) / n);
+  }
+  return d;
+}
+
+}
+
+/// @brief Queries between a signed distance field and shapes or meshes. The field is always the first object
+/// here; the function matrices swap the results when it is the second one.
+class SDFSolver
+{
+public:
+  SDFSolver(const SignedDistanceField* sdf_, const Transform3f& tf_) : sdf(sdf_), tf(tf_)
+  {
+  }
+
+  /// @brief Smallest signed distance of the field over the points of a shape, found by branch and bound over the
+  /// shape's bounding box. Returns the point reaching it and the field gradient there, both in the local frame of
+  /// the field. The search stops as soon as a penetration is found if stop_at_penetration is set.
+  template<typename S>
+  FCL_REAL shapeDistance(const S& s, const Transform3f& tf_s, bool stop_at_penetration, Vec3f& point, Vec3f& gradient) const
+  {
+    Transform3f tf_rel = tf.inverseTimes(tf_s);
+
+    AABB box;
+    computeBV<AABB, S>(s, Transform3f(), box);
+
+    const FCL_REAL leaf_radius = 0.5 * sdf->getVoxelSize();
+    FCL_REAL best = std::numeric_limits<FCL_REAL>::max();
+
+    std::vector<Cell> stack;
+    stack.push_back(Cell(box.center(), (box.max_ - box.min_) * 0.5));
+    while(!stack.empty())
+    {
+      Cell cell = stack.back();
+      stack.pop_back();
+
+      FCL_REAL r = cell.half.length();
+      FCL_REAL d_shape = details::shapeSignedDistance(s, cell.center);
+      if(d_shape > r) continue;
+
+      Vec3f p = tf_rel.transform(cell.center);
+      Vec3f g;
+      FCL_REAL d = sdf->distance(p, g);
+      if(d - r >= best) continue;
+
+      bool leaf = (r <= leaf_radius);
+      if(d_shape <= 0 || leaf)
+      {
+        // a ball of radius -d_shape around the center lies in the shape; at leaves the shape is within d_shape
+        FCL_REAL candidate = d + d_shape;
+        if(candidate < best)
+        {
+          best = candidate;
+          FCL_REAL g_len = g.length();
+          point = (d_shape < 0 && g_len > 0) ? p + g * (d_shape / g_len) : p;
+          gradient = g;
+          if(stop_at_penetration && best < 0) break;
+        }
+      }
+
+      if(leaf) continue;
+
+      FCL_REAL h_max = std::max(cell.half[0], std::max(cell.half[1], cell.half[2]));
+      bool split[3];
+      for(int i = 0; i < 3; ++i)
+        split[i] = (cell.half[i] >= 0.5 * h_max);
+
+      Vec3f child_half = cell.half;
+      for(int i = 0; i < 3; ++i)
+        if(split[i]) child_half[i] *= 0.5;
+
+      for(int c = 0; c < 8; ++c)
+      {
+        if((!split[0] && (c & 1)) || (!split[1] && (c & 2)) || (!split[2] && (c & 4))) continue;
+        Vec3f child_center = cell.center;
+        for(int i = 0; i < 3; ++i)
+          if(split[i]) child_center[i] += ((c >> i) & 1) ? child_half[i] : -child_half[i];
+        stack.push_back(Cell(child_center, child_half));
+      }
+    }
+
+    return best;
+  }
+
+  /// @brief Collision with a shape; adds at most one contact at the deepest point found
+  template<typename S>
+  void shapeIntersect(const CollisionGeometry* o_sdf, const S& s, const Transform3f& tf_s, bool swapped,
+                      const CollisionRequest& request, CollisionResult& result) const
+  {
+    Vec3f point, gradient;
+    FCL_REAL d = shapeDistance(s, tf_s, !request.enable_contact, point, gradient);
+    if(d >= 0) return;
+
+    if(!request.enable_contact)
+    {
+      if(swapped)
+        result.addContact(Contact(&s, o_sdf, Contact::NONE, Contact::NONE));
+      else
+        result.addContact(Contact(o_sdf, &s, Contact::NONE, Contact::NONE));
+      return;
+    }
+
+    Vec3f normal = tf.getRotation() * gradient;
+    normal.normalize();
+    Vec3f pos = tf.transform(point);
+    if(swapped)
+      result.addContact(Contact(&s, o_sdf, Contact::NONE, Contact::NONE, pos, -normal, -d));
+    else
+      result.addContact(Contact(o_sdf, &s, Contact::NONE, Contact::NONE, pos, normal, -d));
+  }
+
+  /// @brief Distance to a shape. The distance is negative when the shape penetrates the field.
+  template<typename S>
+  FCL_REAL shapeDistance(const CollisionGeometry* o_sdf, const S& s, const Transform3f& tf_s, bool swapped,
+                         const DistanceRequest& request, DistanceResult& result) const
+  {
+    Vec3f point, gradient;
+    FCL_REAL d = shapeDistance(s, tf_s, false, point, gradient);
+    updateDistance(o_sdf, &s, Contact::NONE, d, point, gradient, swapped, request, result);
+    return d;
+  }
+
+  /// @brief Collision with a mesh, testing the mesh vertices against the field. Each penetrating vertex gives one
+  /// contact whose mesh primitive id is the vertex index.
+  template<typename BV>
+  void meshIntersect(const CollisionGeometry* o_sdf, const BVHModel<BV>& model, const Transform3f& tf_m, bool swapped,
+                     const CollisionRequest& request, CollisionResult& result) const
+  {
+    Transform3f tf_rel = tf.inverseTimes(tf_m);
+
+    if(!model.vertices || sdf->distance(tf_rel.transform(model.aabb_center)) >= model.aabb_radius) return;
+
+    for(int i = 0; i < model.num_vertices; ++i)
+    {
+      Vec3f p = tf_rel.transform(model.vertices[i]);
+      Vec3f g;
+      FCL_REAL d = sdf->distance(p, g);
+      if(d >= 0) continue;
+
+      Vec3f normal = tf.getRotation() * g;
+      normal.normalize();
+      Vec3f pos = tf.transform(p);
+      if(swapped)
+        result.addContact(Contact(&model, o_sdf, i, Contact::NONE, pos, -normal, -d));
+      else
+        result.addContact(Contact(o_sdf, &model, Contact::NONE, i, pos, normal, -d));
+
+      if(request.isSatisfied(result)) return;
+    }
+  }
+
+  /// @brief Distance to a mesh, as the smallest field value at the mesh vertices
+  template<typename BV>
+  FCL_REAL meshDistance(const CollisionGeometry* o_sdf, const BVHModel<BV>& model, const Transform3f& tf_m, bool swapped,
+                        const DistanceRequest& request, DistanceResult& result) const
+  {
+    Transform3f tf_rel = tf.inverseTimes(tf_m);
+
+    FCL_REAL best = std::numeric_limits<FCL_REAL>::max();
+    int best_id = -1;
+    Vec3f best_point, best_gradient;
+    for(int i = 0; model.vertices && i < model.num_vertices; ++i)
+    {
+      Vec3f p = tf_rel.transform(model.vertices[i]);
+      Vec3f g;
+      FCL_REAL d = sdf->distance(p, g);
+      if(d < best)
+      {
+        best = d;
+        best_id = i;
+        best_point = p;
+        best_gradient = g;
+      }
+    }
+
+    if(best_id >= 0)
+      updateDistance(o_sdf, &model, best_id, best, best_point, best_gradient, swapped, request, result);
+    return best;
+  }
+
+private:
+  struct Cell
+  {
+    Cell(const Vec3f& center_, const Vec3f& half_) : center(center_), half(half_) {}
+
+    Vec3f center;
+    Vec3f half;
+  };
+
+  void updateDistance(const CollisionGeometry* o_sdf, const CollisionGeometry* o_other, int b_other,
+                      FCL_REAL d, const Vec3f& point, const Vec3f& gradient, bool swapped,
+                      const DistanceRequest& request, DistanceResult& result) const
+  {
+    if(!request.enable_nearest_points)
+    {
+      if(swapped)
+        result.update(d, o_other, o_sdf, b_other, DistanceResult::NONE);
+      else
+        result.update(d, o_sdf, o_other, DistanceResult::NONE, b_other);
+      return;
+    }
+
+    Vec3f n = gradient;
+    n.normalize();
+    Vec3f p_other = tf.transform(point);
+    Vec3f p_sdf = tf.transform(point - n * d);
+    if(swapped)
+      result.update(d, o_other, o_sdf, b_other, DistanceResult::NONE, p_other, p_sdf);
+    else
+      result.update(d, o_sdf, o_other, DistanceResult::NONE, b_other, p_sdf, p_other);
+  }
+
+  const SignedDistanceField* sdf;
+  Transform3f tf;
+};
+
+}
+
+#endif
@@ -41,6 +41,7 @@
 #include "fcl/collision_object.h"
 #include "fcl/math/vec_3f.h"
 #include <string.h>
+#include <vector>
 
 namespace fcl
 {
@@ -65,6 +66,9 @@ public:
 
   /// @brief virtual function of compute AABB in local coordinate
   void computeLocalAABB();
+
+  /// @brief Compute the tight AABB in world space of the shape placed at tf
+  void computeAABB(const Transform3f& tf, AABB& aabb) const;
   
   NODE_TYPE getNodeType() const { return GEOM_TRIANGLE; }
 
@@ -91,6 +95,9 @@ public:
   /// @brief Compute AABB
   void computeLocalAABB();
 
+  /// @brief Compute the tight AABB in world space of the shape placed at tf
+  void computeAABB(const Transform3f& tf, AABB& aabb) const;
+
   /// @brief Get node type: a box
   NODE_TYPE getNodeType() const { return GEOM_BOX; }
 };
@@ -109,6 +116,9 @@ public:
   /// @brief Compute AABB 
   void computeLocalAABB();
 
+  /// @brief Compute the tight AABB in world space of the shape placed at tf
+  void computeAABB(const Transform3f& tf, AABB& aabb) const;
+
   /// @brief Get node type: a sphere 
   NODE_TYPE getNodeType() const { return GEOM_SPHERE; }
 };
@@ -130,6 +140,9 @@ public:
   /// @brief Compute AABB 
   void computeLocalAABB();
 
+  /// @brief Compute the tight AABB in world space of the shape placed at tf
+  void computeAABB(const Transform3f& tf, AABB& aabb) const;
+
   /// @brief Get node type: a capsule 
   NODE_TYPE getNodeType() const { return GEOM_CAPSULE; }
 };
@@ -151,6 +164,9 @@ public:
   /// @brief Compute AABB 
   void computeLocalAABB();
 
+  /// @brief Compute the tight AABB in world space of the shape placed at tf
+  void computeAABB(const Transform3f& tf, AABB& aabb) const;
+
   /// @brief Get node type: a cone 
   NODE_TYPE getNodeType() const { return GEOM_CONE; }
 };
@@ -173,6 +189,9 @@ public:
   /// @brief Compute AABB 
   void computeLocalAABB();
 
+  /// @brief Compute the tight AABB in world space of the shape placed at tf
+  void computeAABB(const Transform3f& tf, AABB& aabb) const;
+
   /// @brief Get node type: a cylinder 
   NODE_TYPE getNodeType() const { return GEOM_CYLINDER; }
 };
@@ -193,13 +212,18 @@ public:
     plane_dis = plane_dis_;
     num_planes = num_planes_;
     points = points_;
+    num_points = num_points_;
     polygons = polygons_;
     edges = NULL;
 
     Vec3f sum;
+    points_soa.resize(3 * num_points);
     for(int i = 0; i < num_points; ++i)
     {
       sum += points[i];
+      points_soa[i] = points[i][0];
+      points_soa[num_points + i] = points[i][1];
+      points_soa[2 * num_points + i] = points[i][2];
     }
 
     center = sum * (FCL_REAL)(1.0 / num_points);
@@ -214,7 +238,11 @@ public:
     plane_dis = other.plane_dis;
     num_planes = other.num_planes;
     points = other.points;
+    num_points = other.num_points;
+    points_soa = other.points_soa;
     polygons = other.polygons;
+    center = other.center;
+    num_edges = other.num_edges;
     edges = new Edge[other.num_edges];
     memcpy(edges, other.edges, sizeof(Edge) * num_edges);
   }
@@ -230,6 +258,14 @@ public:
   /// @brief Get node type: a conex polytope 
   NODE_TYPE getNodeType() const { return GEOM_CONVEX; }
 
+  /// @brief Index of the first point furthest along dir, -1 if the polytope has no point
+  int supportPointIndex(const Vec3f& dir) const;
+
+  /// @brief x, y and z coordinates of the points, one array after the other
+  inline const FCL_REAL* pointsX() const { return points_soa.empty() ? NULL : &points_soa[0]; }
+  inline const FCL_REAL* pointsY() const { return points_soa.empty() ? NULL : &points_soa[num_points]; }
+  inline const FCL_REAL* pointsZ() const { return points_soa.empty() ? NULL : &points_soa[2 * num_points]; }
+
   
   Vec3f* plane_normals;
   FCL_REAL* plane_dis;
@@ -256,6 +292,10 @@ public:
 protected:
   /// @brief Get edge information 
   void fillEdges();
+
+  /// @brief Copy of the points in structure of arrays layout, used by the batch kernels. It is filled on construction,
+  /// so points should not be modified afterwards
+  std::vector<FCL_REAL> points_soa;
 };
 
 
@@ -294,6 +334,9 @@ public:
   /// @brief Compute AABB
   void computeLocalAABB();
 
+  /// @brief Compute the tight AABB in world space of the shape placed at tf
+  void computeAABB(const Transform3f& tf, AABB& aabb) const;
+
   /// @brief Get node type: a half space
   NODE_TYPE getNodeType() const { return GEOM_HALFSPACE; }
   
@@ -341,6 +384,9 @@ public:
   /// @brief Compute AABB 
   void computeLocalAABB();
 
+  /// @brief Compute the tight AABB in world space of the shape placed at tf
+  void computeAABB(const Transform3f& tf, AABB& aabb) const;
+
   /// @brief Get node type: a plane 
   NODE_TYPE getNodeType() const { return GEOM_PLANE; }
 
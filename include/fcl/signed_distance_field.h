@@ -0,0 +1,177 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FCL_SIGNED_DISTANCE_FIELD_H
+#define FCL_SIGNED_DISTANCE_FIELD_H
+
+#include "fcl/collision_object.h"
+#include "fcl/BVH/BVH_model.h"
+#include <boost/shared_ptr.hpp>
+#include <vector>
+#include <string>
+
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+}
+}
+
+namespace fcl
+{
+
+/// @brief Signed distance field baked from a closed triangle mesh, used as a static environment geometry.
+/// The samples lie on a regular grid which is split into cubic blocks of BLOCK_SIZE^3 samples. Blocks near the
+/// surface keep all their samples; blocks completely outside the narrow band are collapsed into one value, the
+/// smallest distance magnitude among their samples, so the far field only gives lower bounds on the distance.
+/// Distances are negative inside the mesh.
+class SignedDistanceField : public CollisionGeometry
+{
+public:
+  /// @brief Number of samples along each axis of one block
+  static const int BLOCK_SIZE = 8;
+
+  /// @brief Constructing an empty field
+  SignedDistanceField();
+
+  /// @brief Copy from another field; a memory mapped field shares the mapping
+  SignedDistanceField(const SignedDistanceField& other);
+
+  SignedDistanceField& operator = (const SignedDistanceField& other);
+
+  ~SignedDistanceField();
+
+  /// @brief Bake the field from a closed mesh. voxel_size is the sample spacing, padding the number of voxels
+  /// kept around the mesh bounds and band the half width (in voxels) of the region kept at full resolution.
+  template<typename BV>
+  bool bake(const BVHModel<BV>& model, FCL_REAL voxel_size, int padding = 2, FCL_REAL band = BLOCK_SIZE)
+  {
+    return bake(model.vertices, model.num_vertices, model.tri_indices, model.num_tris, voxel_size, padding, band);
+  }
+
+  /// @brief Bake the field from raw mesh arrays
+  bool bake(const Vec3f* vertices, int num_vertices, const Triangle* triangles, int num_triangles,
+            FCL_REAL voxel_size, int padding = 2, FCL_REAL band = BLOCK_SIZE);
+
+  /// @brief Write the field in the binary on-disk format
+  bool save(const std::string& filename) const;
+
+  /// @brief Memory map a file written by save(). The mapping is read-only and its samples are used in place,
+  /// so processes loading the same file share the physical pages.
+  bool load(const std::string& filename);
+
+  /// @brief Whether the samples reference a memory mapped file
+  bool isMapped() const { return region_.get() != NULL; }
+
+  /// @brief Whether the field has been baked or loaded
+  bool isEmpty() const { return num_blocks_total_ == 0; }
+
+  /// @brief Signed distance at point p, given in the local frame of the field
+  FCL_REAL distance(const Vec3f& p) const;
+
+  /// @brief Signed distance at point p, also returning the (not normalized) gradient of the field at p
+  FCL_REAL distance(const Vec3f& p, Vec3f& gradient) const;
+
+  /// @brief Compute the AABB of the sampled region in the local frame
+  void computeLocalAABB();
+
+  /// @brief Spacing between two samples
+  FCL_REAL getVoxelSize() const { return voxel_size_; }
+
+  /// @brief Position of the first sample in the local frame
+  const Vec3f& getOrigin() const { return origin_; }
+
+  /// @brief Number of blocks along one axis
+  int getNumBlocks(int axis) const { return num_blocks_[axis]; }
+
+  /// @brief Number of blocks stored at full resolution
+  int getNumDenseBlocks() const { return num_dense_blocks_; }
+
+  /// @brief Number of bytes used by the samples, block values and block table
+  std::size_t memUsage() const;
+
+  /// @brief Get object type: a signed distance field
+  OBJECT_TYPE getObjectType() const { return OT_SDF; }
+
+  /// @brief Get node type: a signed distance field
+  NODE_TYPE getNodeType() const { return GEOM_SDF; }
+
+private:
+  /// @brief Value of the sample (i, j, k), taken from its block
+  inline FCL_REAL sample(int i, int j, int k) const
+  {
+    int block = ((k / BLOCK_SIZE) * num_blocks_[1] + (j / BLOCK_SIZE)) * num_blocks_[0] + (i / BLOCK_SIZE);
+    FCL_INT32 dense = block_table_[block];
+    if(dense < 0)
+      return block_values_[block];
+
+    int local = ((k % BLOCK_SIZE) * BLOCK_SIZE + (j % BLOCK_SIZE)) * BLOCK_SIZE + (i % BLOCK_SIZE);
+    return samples_[dense * BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE + local];
+  }
+
+  /// @brief Point the data arrays to the owned storage
+  void bindStorage();
+
+  void clear();
+
+  Vec3f origin_;
+  FCL_REAL voxel_size_;
+  int num_blocks_[3];
+  int num_samples_[3];
+  int num_blocks_total_;
+  int num_dense_blocks_;
+
+  /// @brief for each block, index of its dense samples or -1 if it is collapsed
+  const FCL_INT32* block_table_;
+
+  /// @brief for each block, its representative value (used when the block is collapsed)
+  const float* block_values_;
+
+  /// @brief dense block samples, BLOCK_SIZE^3 per dense block with x varying fastest
+  const float* samples_;
+
+  /// @brief owned storage, used when the field is baked in memory
+  std::vector<FCL_INT32> block_table_storage_;
+  std::vector<float> block_values_storage_;
+  std::vector<float> samples_storage_;
+
+  /// @brief mapped file, used when the field is loaded from disk
+  boost::shared_ptr<boost::interprocess::mapped_region> region_;
+};
+
+}
+
+#endif
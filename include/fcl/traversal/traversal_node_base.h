@@ -48,6 +48,8 @@ namespace fcl
 class TraversalNodeBase
 {
 public:
+  TraversalNodeBase() : query_statistics(NULL) {}
+
   virtual ~TraversalNodeBase();
 
   virtual void preprocess() {}
@@ -83,6 +85,9 @@ public:
 
   /// @brief configuration of second object
   Transform3f tf2;
+
+  /// @brief statistics of the query the traversal belongs to, NULL if not requested. Set when the traversal starts
+  QueryStatistics* query_statistics;
 };
 
 /// @brief Node structure encoding the information required for collision traversal.
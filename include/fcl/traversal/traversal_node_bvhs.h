@@ -56,6 +56,52 @@
 namespace fcl
 {
 
+namespace details
+{
+
+/// @brief Whether the two triangles have precomputed planes in their models
+template<typename BV>
+inline bool useTriangleCache(const BVHModel<BV>* model1, int primitive_id1, const BVHModel<BV>* model2, int primitive_id2)
+{
+  const TriangleCache& cache1 = model1->triangle_cache;
+  const TriangleCache& cache2 = model2->triangle_cache;
+  return (cache1.size() == model1->num_tris) && (cache2.size() == model2->num_tris) &&
+    cache1.valid(primitive_id1) && cache2.valid(primitive_id2);
+}
+
+/// @brief Intersection between two mesh triangles in the same frame, with the precomputed planes when both models have them
+template<typename BV>
+inline bool meshTriangleIntersect(const BVHModel<BV>* model1, int primitive_id1, const Vec3f& p1, const Vec3f& p2, const Vec3f& p3,
+                                  const BVHModel<BV>* model2, int primitive_id2, const Vec3f& q1, const Vec3f& q2, const Vec3f& q3,
+                                  Vec3f* contact_points = NULL, unsigned int* num_contact_points = NULL,
+                                  FCL_REAL* penetration_depth = NULL, Vec3f* normal = NULL)
+{
+  if(useTriangleCache(model1, primitive_id1, model2, primitive_id2))
+    return Intersect::intersect_Triangle(p1, p2, p3, model1->triangle_cache.normal(primitive_id1), model1->triangle_cache.offset(primitive_id1),
+                                         q1, q2, q3, model2->triangle_cache.normal(primitive_id2), model2->triangle_cache.offset(primitive_id2),
+                                         contact_points, num_contact_points, penetration_depth, normal);
+
+  return Intersect::intersect_Triangle(p1, p2, p3, q1, q2, q3, contact_points, num_contact_points, penetration_depth, normal);
+}
+
+/// @brief Intersection between two mesh triangles, the second one in the frame (R, T), with the precomputed planes when both models have them
+template<typename BV>
+inline bool meshTriangleIntersect(const BVHModel<BV>* model1, int primitive_id1, const Vec3f& p1, const Vec3f& p2, const Vec3f& p3,
+                                  const BVHModel<BV>* model2, int primitive_id2, const Vec3f& q1, const Vec3f& q2, const Vec3f& q3,
+                                  const Matrix3f& R, const Vec3f& T,
+                                  Vec3f* contact_points = NULL, unsigned int* num_contact_points = NULL,
+                                  FCL_REAL* penetration_depth = NULL, Vec3f* normal = NULL)
+{
+  if(useTriangleCache(model1, primitive_id1, model2, primitive_id2))
+    return Intersect::intersect_Triangle(p1, p2, p3, model1->triangle_cache.normal(primitive_id1), model1->triangle_cache.offset(primitive_id1),
+                                         q1, q2, q3, model2->triangle_cache.normal(primitive_id2), model2->triangle_cache.offset(primitive_id2),
+                                         R, T, contact_points, num_contact_points, penetration_depth, normal);
+
+  return Intersect::intersect_Triangle(p1, p2, p3, q1, q2, q3, R, T, contact_points, num_contact_points, penetration_depth, normal);
+}
+
+}
+
 /// @brief Traversal node for collision between BVH models
 template<typename BV>
 class BVHCollisionTraversalNode : public CollisionTraversalNodeBase
@@ -186,7 +232,7 @@ public:
 
       if(!this->request.enable_contact) // only interested in collision or not
       {
-        if(Intersect::intersect_Triangle(p1, p2, p3, q1, q2, q3))
+        if(details::meshTriangleIntersect(this->model1, primitive_id1, p1, p2, p3, this->model2, primitive_id2, q1, q2, q3))
         {
           is_intersect = true;
           if(this->result->numContacts() < this->request.num_max_contacts)
@@ -200,11 +246,11 @@ public:
         unsigned int n_contacts;
         Vec3f contacts[2];
 
-        if(Intersect::intersect_Triangle(p1, p2, p3, q1, q2, q3,
-                                         contacts,
-                                         &n_contacts,
-                                         &penetration,
-                                         &normal))
+        if(details::meshTriangleIntersect(this->model1, primitive_id1, p1, p2, p3, this->model2, primitive_id2, q1, q2, q3,
+                                          contacts,
+                                          &n_contacts,
+                                          &penetration,
+                                          &normal))
         {
           is_intersect = true;
           
@@ -227,7 +273,7 @@ public:
     }   
     else if((!this->model1->isFree() && !this->model2->isFree()) && this->request.enable_cost)
     {
-      if(Intersect::intersect_Triangle(p1, p2, p3, q1, q2, q3))
+      if(details::meshTriangleIntersect(this->model1, primitive_id1, p1, p2, p3, this->model2, primitive_id2, q1, q2, q3))
       {
         AABB overlap_part;
         AABB(p1, p2, p3).overlap(AABB(q1, q2, q3), overlap_part);
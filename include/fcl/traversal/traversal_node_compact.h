@@ -0,0 +1,166 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FCL_TRAVERSAL_NODE_COMPACT_H
+#define FCL_TRAVERSAL_NODE_COMPACT_H
+
+#include "fcl/BVH/BVH_compact.h"
+#include "fcl/collision_data.h"
+#include "fcl/shape/geometric_shapes_utility.h"
+
+namespace fcl
+{
+
+/// @brief Collision between two compact models. The node boxes are decoded on the way down the hierarchies,
+/// as each one is stored relative to its parent.
+std::size_t compactCollide(const CompactBVHModel* model1, const Transform3f& tf1,
+                           const CompactBVHModel* model2, const Transform3f& tf2,
+                           const CollisionRequest& request, CollisionResult& result);
+
+namespace details
+{
+
+template<typename S, typename NarrowPhaseSolver>
+struct CompactShapeCollisionData
+{
+  const CompactBVHModel* model;
+  const S* shape;
+  Transform3f tf1;
+  Transform3f tf2;
+  AABB shape_box;
+  const NarrowPhaseSolver* nsolver;
+  const CollisionRequest* request;
+  CollisionResult* result;
+  QueryStatistics* statistics;
+};
+
+template<typename S, typename NarrowPhaseSolver>
+void compactShapeLeafTesting(const CompactShapeCollisionData<S, NarrowPhaseSolver>& data, int primitive_id)
+{
+  const CollisionRequest& request = *data.request;
+  CollisionResult& result = *data.result;
+
+  Vec3f p1, p2, p3;
+  data.model->getTriangle(primitive_id, p1, p2, p3);
+
+  bool is_intersect = false;
+  if(!request.enable_contact)
+  {
+    if(data.nsolver->shapeTriangleIntersect(*data.shape, data.tf2, p1, p2, p3, data.tf1, NULL, NULL, NULL))
+    {
+      is_intersect = true;
+      if(request.num_max_contacts > result.numContacts())
+        result.addContact(Contact(data.model, data.shape, primitive_id, Contact::NONE));
+    }
+  }
+  else
+  {
+    FCL_REAL penetration;
+    Vec3f normal;
+    Vec3f contactp;
+
+    if(data.nsolver->shapeTriangleIntersect(*data.shape, data.tf2, p1, p2, p3, data.tf1, &contactp, &penetration, &normal))
+    {
+      is_intersect = true;
+      if(request.num_max_contacts > result.numContacts())
+        result.addContact(Contact(data.model, data.shape, primitive_id, Contact::NONE, contactp, -normal, penetration));
+    }
+  }
+
+  if(is_intersect && request.enable_cost)
+  {
+    AABB overlap_part;
+    AABB shape_aabb;
+    computeBV<AABB, S>(*data.shape, data.tf2, shape_aabb);
+    if(AABB(data.tf1.transform(p1), data.tf1.transform(p2), data.tf1.transform(p3)).overlap(shape_aabb, overlap_part))
+      result.addCostSource(CostSource(overlap_part, data.model->cost_density * data.shape->cost_density), request.num_max_cost_sources);
+  }
+}
+
+template<typename S, typename NarrowPhaseSolver>
+void compactShapeCollisionRecurse(const CompactShapeCollisionData<S, NarrowPhaseSolver>& data, int b, const AABB& box)
+{
+  if(data.statistics) data.statistics->num_bv_tests++;
+  if(!box.overlap(data.shape_box)) return;
+
+  const CompactBVHModel::Node& node = data.model->getNode(b);
+  if(node.isLeaf())
+  {
+    if(data.statistics) data.statistics->num_leaf_tests++;
+    compactShapeLeafTesting(data, node.primitiveId());
+    return;
+  }
+
+  AABB child_box;
+  data.model->decodeBox(data.model->getNode(node.leftChild()), box, child_box);
+  compactShapeCollisionRecurse(data, node.leftChild(), child_box);
+
+  if(data.request->isSatisfied(*data.result)) return;
+
+  data.model->decodeBox(data.model->getNode(node.rightChild()), box, child_box);
+  compactShapeCollisionRecurse(data, node.rightChild(), child_box);
+}
+
+}
+
+/// @brief Collision between a compact model and a shape. The shape is bounded by its AABB in the model frame,
+/// which is tested against the decoded node boxes.
+template<typename S, typename NarrowPhaseSolver>
+std::size_t compactShapeCollide(const CompactBVHModel* model, const Transform3f& tf1,
+                                const S* shape, const Transform3f& tf2,
+                                const NarrowPhaseSolver* nsolver,
+                                const CollisionRequest& request, CollisionResult& result)
+{
+  if(model->getNumNodes() == 0 || !model->isOccupied() || !shape->isOccupied()) return result.numContacts();
+
+  details::CompactShapeCollisionData<S, NarrowPhaseSolver> data;
+  data.model = model;
+  data.shape = shape;
+  data.tf1 = tf1;
+  data.tf2 = tf2;
+  computeBV<AABB, S>(*shape, tf1.inverseTimes(tf2), data.shape_box);
+  data.nsolver = nsolver;
+  data.request = &request;
+  data.result = &result;
+  data.statistics = details::getQueryStatistics();
+
+  details::compactShapeCollisionRecurse(data, 0, model->getRootBox());
+
+  return result.numContacts();
+}
+
+}
+
+#endif
@@ -42,12 +42,14 @@
 #include "fcl/narrowphase/narrowphase.h"
 #include "fcl/shape/geometric_shapes_utility.h"
 #include "fcl/octree.h"
+#include "fcl/linear_octree.h"
 #include "fcl/BVH/BVH_model.h"
+#include "fcl/math/point_batch.h"
 
 namespace fcl
 {
 
-/// @brief Algorithms for collision related with octree
+/// @brief Algorithms for collision related with octree. The octree arguments can be OcTree or LinearOcTree
 template<typename NarrowPhaseSolver>
 class OcTreeSolver
 {
@@ -60,23 +62,42 @@ private:
   mutable CollisionResult* cresult;
   mutable DistanceResult* dresult;
 
+  /// @brief pose of the mesh in the frame of the octree, during an octree-mesh collision
+  mutable Transform3f mesh_tf;
+
+  /// @brief statistics of the current query, NULL if not requested
+  mutable QueryStatistics* statistics;
+
+  void countBVTests(std::size_t n) const
+  {
+    if(statistics) statistics->num_bv_tests += n;
+  }
+
+  void countLeafTests(std::size_t n) const
+  {
+    if(statistics) statistics->num_leaf_tests += n;
+  }
+
 public:
   OcTreeSolver(const NarrowPhaseSolver* solver_) : solver(solver_),
                                                    crequest(NULL),
                                                    drequest(NULL),
                                                    cresult(NULL),
-                                                   dresult(NULL)
+                                                   dresult(NULL),
+                                                   statistics(NULL)
   {
   }
 
   /// @brief collision between two octrees
-  void OcTreeIntersect(const OcTree* tree1, const OcTree* tree2,
+  template<typename OcTreeT1, typename OcTreeT2>
+  void OcTreeIntersect(const OcTreeT1* tree1, const OcTreeT2* tree2,
                        const Transform3f& tf1, const Transform3f& tf2,
                        const CollisionRequest& request_,
                        CollisionResult& result_) const
   {
     crequest = &request_;
     cresult = &result_;
+    statistics = details::getQueryStatistics();
     
     OcTreeIntersectRecurse(tree1, tree1->getRoot(), tree1->getRootBV(), 
                            tree2, tree2->getRoot(), tree2->getRootBV(), 
@@ -84,13 +105,15 @@ public:
   }
 
   /// @brief distance between two octrees
-  void OcTreeDistance(const OcTree* tree1, const OcTree* tree2,
+  template<typename OcTreeT1, typename OcTreeT2>
+  void OcTreeDistance(const OcTreeT1* tree1, const OcTreeT2* tree2,
                       const Transform3f& tf1, const Transform3f& tf2,
                       const DistanceRequest& request_,
                       DistanceResult& result_) const
   {
     drequest = &request_;
     dresult = &result_;
+    statistics = details::getQueryStatistics();
 
     OcTreeDistanceRecurse(tree1, tree1->getRoot(), tree1->getRootBV(), 
                           tree2, tree2->getRoot(), tree2->getRootBV(),
@@ -98,14 +121,16 @@ public:
   }
 
   /// @brief collision between octree and mesh
-  template<typename BV>
-  void OcTreeMeshIntersect(const OcTree* tree1, const BVHModel<BV>* tree2,
+  template<typename BV, typename OcTreeT>
+  void OcTreeMeshIntersect(const OcTreeT* tree1, const BVHModel<BV>* tree2,
                            const Transform3f& tf1, const Transform3f& tf2,
                            const CollisionRequest& request_,
                            CollisionResult& result_) const
   {
     crequest = &request_;
     cresult = &result_;
+    statistics = details::getQueryStatistics();
+    mesh_tf = tf1.inverseTimes(tf2);
 
     OcTreeMeshIntersectRecurse(tree1, tree1->getRoot(), tree1->getRootBV(),
                                tree2, 0,
@@ -113,14 +138,15 @@ public:
   }
 
   /// @brief distance between octree and mesh
-  template<typename BV>
-  void OcTreeMeshDistance(const OcTree* tree1, const BVHModel<BV>* tree2,
+  template<typename BV, typename OcTreeT>
+  void OcTreeMeshDistance(const OcTreeT* tree1, const BVHModel<BV>* tree2,
                           const Transform3f& tf1, const Transform3f& tf2,
                           const DistanceRequest& request_,
                           DistanceResult& result_) const
   {
     drequest = &request_;
     dresult = &result_;
+    statistics = details::getQueryStatistics();
 
     OcTreeMeshDistanceRecurse(tree1, tree1->getRoot(), tree1->getRootBV(),
                               tree2, 0,
@@ -128,8 +154,8 @@ public:
   }
 
   /// @brief collision between mesh and octree
-  template<typename BV>
-  void MeshOcTreeIntersect(const BVHModel<BV>* tree1, const OcTree* tree2,
+  template<typename BV, typename OcTreeT>
+  void MeshOcTreeIntersect(const BVHModel<BV>* tree1, const OcTreeT* tree2,
                            const Transform3f& tf1, const Transform3f& tf2,
                            const CollisionRequest& request_,
                            CollisionResult& result_) const
@@ -137,6 +163,8 @@ public:
   {
     crequest = &request_;
     cresult = &result_;
+    statistics = details::getQueryStatistics();
+    mesh_tf = tf2.inverseTimes(tf1);
 
     OcTreeMeshIntersectRecurse(tree2, tree2->getRoot(), tree2->getRootBV(),
                                tree1, 0,
@@ -144,29 +172,31 @@ public:
   }
 
   /// @brief distance between mesh and octree
-  template<typename BV>
-  void MeshOcTreeDistance(const BVHModel<BV>* tree1, const OcTree* tree2,
+  template<typename BV, typename OcTreeT>
+  void MeshOcTreeDistance(const BVHModel<BV>* tree1, const OcTreeT* tree2,
                           const Transform3f& tf1, const Transform3f& tf2,
                           const DistanceRequest& request_,
                           DistanceResult& result_) const
   {
     drequest = &request_;
     dresult = &result_;
+    statistics = details::getQueryStatistics();
 
-    OcTreeMeshDistanceRecurse(tree1, 0,
-                              tree2, tree2->getRoot(), tree2->getRootBV(),
-                              tf1, tf2);
+    OcTreeMeshDistanceRecurse(tree2, tree2->getRoot(), tree2->getRootBV(),
+                              tree1, 0,
+                              tf2, tf1);
   }
 
   /// @brief collision between octree and shape
-  template<typename S>
-  void OcTreeShapeIntersect(const OcTree* tree, const S& s,
+  template<typename S, typename OcTreeT>
+  void OcTreeShapeIntersect(const OcTreeT* tree, const S& s,
                             const Transform3f& tf1, const Transform3f& tf2,
                             const CollisionRequest& request_,
                             CollisionResult& result_) const
   {
     crequest = &request_;
     cresult = &result_;
+    statistics = details::getQueryStatistics();
 
     AABB bv2;
     computeBV<AABB>(s, Transform3f(), bv2);
@@ -179,14 +209,15 @@ public:
   }
 
   /// @brief collision between shape and octree
-  template<typename S>
-  void ShapeOcTreeIntersect(const S& s, const OcTree* tree,
+  template<typename S, typename OcTreeT>
+  void ShapeOcTreeIntersect(const S& s, const OcTreeT* tree,
                             const Transform3f& tf1, const Transform3f& tf2,
                             const CollisionRequest& request_,
                             CollisionResult& result_) const
   {
     crequest = &request_;
     cresult = &result_;
+    statistics = details::getQueryStatistics();
 
     AABB bv1;
     computeBV<AABB>(s, Transform3f(), bv1);
@@ -198,14 +229,15 @@ public:
   }
 
   /// @brief distance between octree and shape
-  template<typename S>
-  void OcTreeShapeDistance(const OcTree* tree, const S& s,
+  template<typename S, typename OcTreeT>
+  void OcTreeShapeDistance(const OcTreeT* tree, const S& s,
                            const Transform3f& tf1, const Transform3f& tf2,
                            const DistanceRequest& request_,
                            DistanceResult& result_) const
   {
     drequest = &request_;
     dresult = &result_;
+    statistics = details::getQueryStatistics();
 
     AABB aabb2;
     computeBV<AABB>(s, tf2, aabb2);
@@ -215,14 +247,15 @@ public:
   }
 
   /// @brief distance between shape and octree
-  template<typename S>
-  void ShapeOcTreeDistance(const S& s, const OcTree* tree,
+  template<typename S, typename OcTreeT>
+  void ShapeOcTreeDistance(const S& s, const OcTreeT* tree,
                            const Transform3f& tf1, const Transform3f& tf2,
                            const DistanceRequest& request_,
                            DistanceResult& result_) const
   {
     drequest = &request_;
     dresult = &result_;
+    statistics = details::getQueryStatistics();
 
     AABB aabb1;
     computeBV<AABB>(s, tf1, aabb1);
@@ -233,8 +266,8 @@ public:
   
 
 private:
-  template<typename S>
-  bool OcTreeShapeDistanceRecurse(const OcTree* tree1, const OcTree::OcTreeNode* root1, const AABB& bv1,
+  template<typename S, typename OcTreeT>
+  bool OcTreeShapeDistanceRecurse(const OcTreeT* tree1, const typename OcTreeT::OcTreeNode* root1, const AABB& bv1,
                                   const S& s, const AABB& aabb2,
                                   const Transform3f& tf1, const Transform3f& tf2) const
   {
@@ -247,6 +280,7 @@ private:
         constructBox(bv1, tf1, box, box_tf);
  
         FCL_REAL dist;
+        countLeafTests(1);
         solver->shapeDistance(box, box_tf, s, tf2, &dist);
         
         dresult->update(dist, tree1, &s, root1 - tree1->getRoot(), DistanceResult::NONE);
@@ -263,12 +297,13 @@ private:
     {
       if(root1->childExists(i))
       {
-        const OcTree::OcTreeNode* child = root1->getChild(i);
+        const typename OcTreeT::OcTreeNode* child = root1->getChild(i);
         AABB child_bv;
         computeChildBV(bv1, i, child_bv);
         
         AABB aabb1;
         convertBV(child_bv, tf1, aabb1);
+        countBVTests(1);
         FCL_REAL d = aabb1.distance(aabb2);
         if(d < dresult->min_distance)
         {
@@ -281,8 +316,8 @@ private:
     return false;
   }
 
-  template<typename S>
-  bool OcTreeShapeIntersectRecurse(const OcTree* tree1, const OcTree::OcTreeNode* root1, const AABB& bv1,
+  template<typename S, typename OcTreeT>
+  bool OcTreeShapeIntersectRecurse(const OcTreeT* tree1, const typename OcTreeT::OcTreeNode* root1, const AABB& bv1,
                                    const S& s, const OBB& obb2,
                                    const Transform3f& tf1, const Transform3f& tf2) const
   {
@@ -290,12 +325,14 @@ private:
     {
       OBB obb1;
       convertBV(bv1, tf1, obb1);
+      countBVTests(1);
       if(obb1.overlap(obb2))
       {
         Box box;
         Transform3f box_tf;
         constructBox(bv1, tf1, box, box_tf);
 
+        countLeafTests(1);
         if(solver->shapeIntersect(box, box_tf, s, tf2, NULL, NULL, NULL))
         {
           AABB overlap_part;
@@ -315,6 +352,7 @@ private:
       {
         OBB obb1;
         convertBV(bv1, tf1, obb1);
+        countBVTests(1);
         if(obb1.overlap(obb2))
         {
           Box box;
@@ -324,6 +362,7 @@ private:
           bool is_intersect = false;
           if(!crequest->enable_contact)
           {
+            countLeafTests(1);
             if(solver->shapeIntersect(box, box_tf, s, tf2, NULL, NULL, NULL))
             {
               is_intersect = true;
@@ -337,6 +376,7 @@ private:
             FCL_REAL depth;
             Vec3f normal;
 
+            countLeafTests(1);
             if(solver->shapeIntersect(box, box_tf, s, tf2, &contact, &depth, &normal))
             {
               is_intersect = true;
@@ -362,12 +402,14 @@ private:
       {
         OBB obb1;
         convertBV(bv1, tf1, obb1);
+        countBVTests(1);
         if(obb1.overlap(obb2))
         {
           Box box;
           Transform3f box_tf;
           constructBox(bv1, tf1, box, box_tf);
 
+          countLeafTests(1);
           if(solver->shapeIntersect(box, box_tf, s, tf2, NULL, NULL, NULL))
           {
             AABB overlap_part;
@@ -393,6 +435,7 @@ private:
     {
       OBB obb1;
       convertBV(bv1, tf1, obb1);
+      countBVTests(1);
       if(!obb1.overlap(obb2)) return false;
     }
 
@@ -400,7 +443,7 @@ private:
     {
       if(root1->childExists(i))
       {
-        const OcTree::OcTreeNode* child = root1->getChild(i);
+        const typename OcTreeT::OcTreeNode* child = root1->getChild(i);
         AABB child_bv;
         computeChildBV(bv1, i, child_bv);
         
@@ -420,8 +463,8 @@ private:
     return false;    
   }
 
-  template<typename BV>
-  bool OcTreeMeshDistanceRecurse(const OcTree* tree1, const OcTree::OcTreeNode* root1, const AABB& bv1,
+  template<typename BV, typename OcTreeT>
+  bool OcTreeMeshDistanceRecurse(const OcTreeT* tree1, const typename OcTreeT::OcTreeNode* root1, const AABB& bv1,
                                  const BVHModel<BV>* tree2, int root2,
                                  const Transform3f& tf1, const Transform3f& tf2) const
   {
@@ -440,6 +483,7 @@ private:
         const Vec3f& p3 = tree2->vertices[tri_id[2]];
         
         FCL_REAL dist;
+        countLeafTests(1);
         solver->shapeTriangleDistance(box, box_tf, p1, p2, p3, tf2, &dist);
 
         dresult->update(dist, tree1, tree2, root1 - tree1->getRoot(), primitive_id);
@@ -458,7 +502,7 @@ private:
       {
         if(root1->childExists(i))
         {
-          const OcTree::OcTreeNode* child = root1->getChild(i);
+          const typename OcTreeT::OcTreeNode* child = root1->getChild(i);
           AABB child_bv;
           computeChildBV(bv1, i, child_bv);
 
@@ -466,6 +510,7 @@ private:
           AABB aabb1, aabb2;
           convertBV(child_bv, tf1, aabb1);
           convertBV(tree2->getBV(root2).bv, tf2, aabb2);
+          countBVTests(1);
           d = aabb1.distance(aabb2);
           
           if(d < dresult->min_distance)
@@ -483,6 +528,7 @@ private:
       convertBV(bv1, tf1, aabb1);
       int child = tree2->getBV(root2).leftChild();
       convertBV(tree2->getBV(child).bv, tf2, aabb2);
+      countBVTests(1);
       d = aabb1.distance(aabb2);
 
       if(d < dresult->min_distance)
@@ -493,6 +539,7 @@ private:
 
       child = tree2->getBV(root2).rightChild();
       convertBV(tree2->getBV(child).bv, tf2, aabb2);
+      countBVTests(1);
       d = aabb1.distance(aabb2);
       
       if(d < dresult->min_distance)
@@ -506,8 +553,124 @@ private:
   }
 
 
+  /// @brief whether the octree cell bv touches the triangle (p1, p2, p3) of the mesh
+  bool voxelTriangleIntersect(const AABB& bv, const Vec3f& p1, const Vec3f& p2, const Vec3f& p3) const
+  {
+    Vec3f center = bv.center();
+    FCL_REAL x = center[0], y = center[1], z = center[2];
+    FCL_REAL half_size = bv.width() * 0.5;
+    bool overlap;
+    return overlapCubesTriangle(&x, &y, &z, &half_size, 1, mesh_tf.transform(p1), mesh_tf.transform(p2), mesh_tf.transform(p3), &overlap) > 0;
+  }
+
+  /// @brief whether the octree cell bv1 overlaps the bounding volume bv2 of a mesh node. The test is done in the frame of
+  /// the octree, where the cell stays axis aligned and the OBB test needs no relative rotation
   template<typename BV>
-  bool OcTreeMeshIntersectRecurse(const OcTree* tree1, const OcTree::OcTreeNode* root1, const AABB& bv1,
+  bool overlapCellBV(const AABB& bv1, const BV& bv2) const
+  {
+    OBB obb2;
+    convertBV(bv2, mesh_tf, obb2);
+    Matrix3f B(obb2.axis[0][0], obb2.axis[1][0], obb2.axis[2][0],
+               obb2.axis[0][1], obb2.axis[1][1], obb2.axis[2][1],
+               obb2.axis[0][2], obb2.axis[1][2], obb2.axis[2][2]);
+    return !obbDisjoint(B, obb2.To - bv1.center(), (bv1.max_ - bv1.min_) * 0.5, obb2.extent);
+  }
+
+  /// @brief occupied leaf cells waiting to be tested against one triangle
+  template<typename OcTreeNode>
+  struct VoxelBatch
+  {
+    PointBlock centers;
+    FCL_REAL half_sizes[PointBlock::CAPACITY];
+    const OcTreeNode* nodes[PointBlock::CAPACITY];
+  };
+
+  /// @brief collision between the cells below root1 and the triangle of the mesh leaf root2, when no contact details
+  /// nor costs are requested. The occupied leaf cells overlapping the triangle's box are gathered in the octree frame
+  /// and tested in blocks by the cube-triangle separating axis test
+  template<typename BV, typename OcTreeT>
+  bool OcTreeMeshIntersectBatch(const OcTreeT* tree1, const typename OcTreeT::OcTreeNode* root1, const AABB& bv1,
+                                const BVHModel<BV>* tree2, int root2) const
+  {
+    const Triangle& tri_id = tree2->tri_indices[tree2->getBV(root2).primitiveId()];
+    Vec3f p1 = mesh_tf.transform(tree2->vertices[tri_id[0]]);
+    Vec3f p2 = mesh_tf.transform(tree2->vertices[tri_id[1]]);
+    Vec3f p3 = mesh_tf.transform(tree2->vertices[tri_id[2]]);
+    AABB tri_bv(p1, p2, p3);
+
+    VoxelBatch<typename OcTreeT::OcTreeNode> batch;
+    if(OcTreeMeshCollectVoxels(tree1, root1, bv1, tri_bv, tree2, root2, p1, p2, p3, batch))
+      return true;
+
+    return OcTreeMeshTestVoxels(tree1, tree2, root2, p1, p2, p3, batch);
+  }
+
+  template<typename BV, typename OcTreeT>
+  bool OcTreeMeshCollectVoxels(const OcTreeT* tree1, const typename OcTreeT::OcTreeNode* root1, const AABB& bv1, const AABB& tri_bv,
+                               const BVHModel<BV>* tree2, int root2,
+                               const Vec3f& p1, const Vec3f& p2, const Vec3f& p3,
+                               VoxelBatch<typename OcTreeT::OcTreeNode>& batch) const
+  {
+    countBVTests(1);
+    if(!tree1->isNodeOccupied(root1) || !bv1.overlap(tri_bv)) return false;
+
+    if(!root1->hasChildren())
+    {
+      if(!batch.centers.hasRoom(1) && OcTreeMeshTestVoxels(tree1, tree2, root2, p1, p2, p3, batch))
+        return true;
+
+      batch.nodes[batch.centers.size] = root1;
+      batch.half_sizes[batch.centers.size] = bv1.width() * 0.5;
+      batch.centers.push_back(bv1.center());
+      return false;
+    }
+
+    for(unsigned int i = 0; i < 8; ++i)
+    {
+      if(root1->childExists(i))
+      {
+        AABB child_bv;
+        computeChildBV(bv1, i, child_bv);
+
+        if(OcTreeMeshCollectVoxels(tree1, root1->getChild(i), child_bv, tri_bv, tree2, root2, p1, p2, p3, batch))
+          return true;
+      }
+    }
+
+    return false;
+  }
+
+  /// @brief test the gathered cells against the triangle and report the touching ones, in the order they were gathered
+  template<typename BV, typename OcTreeT>
+  bool OcTreeMeshTestVoxels(const OcTreeT* tree1, const BVHModel<BV>* tree2, int root2,
+                            const Vec3f& p1, const Vec3f& p2, const Vec3f& p3,
+                            VoxelBatch<typename OcTreeT::OcTreeNode>& batch) const
+  {
+    countLeafTests(batch.centers.size);
+    bool overlap[PointBlock::CAPACITY];
+    int num_overlap = overlapCubesTriangle(batch.centers, batch.half_sizes, p1, p2, p3, overlap);
+
+    for(int i = 0; num_overlap > 0 && i < batch.centers.size; ++i)
+    {
+      if(!overlap[i]) continue;
+      --num_overlap;
+
+      if(cresult->numContacts() < crequest->num_max_contacts)
+        cresult->addContact(Contact(tree1, tree2, batch.nodes[i] - tree1->getRoot(), root2));
+
+      if(crequest->isSatisfied(*cresult))
+      {
+        batch.centers.clear();
+        return true;
+      }
+    }
+
+    batch.centers.clear();
+    return false;
+  }
+
+  template<typename BV, typename OcTreeT>
+  bool OcTreeMeshIntersectRecurse(const OcTreeT* tree1, const typename OcTreeT::OcTreeNode* root1, const AABB& bv1,
                                   const BVHModel<BV>* tree2, int root2,
                                   const Transform3f& tf1, const Transform3f& tf2) const
   {
@@ -518,6 +681,7 @@ private:
         OBB obb1, obb2;
         convertBV(bv1, tf1, obb1);
         convertBV(tree2->getBV(root2).bv, tf2, obb2);
+        countBVTests(1);
         if(obb1.overlap(obb2))
         {
           Box box;
@@ -530,7 +694,8 @@ private:
           const Vec3f& p2 = tree2->vertices[tri_id[1]];
           const Vec3f& p3 = tree2->vertices[tri_id[2]];
         
-          if(solver->shapeTriangleIntersect(box, box_tf, p1, p2, p3, tf2, NULL, NULL, NULL))
+          countLeafTests(1);
+          if(voxelTriangleIntersect(bv1, p1, p2, p3))
           {
             AABB overlap_part;
             AABB aabb1;
@@ -561,6 +726,7 @@ private:
         OBB obb1, obb2;
         convertBV(bv1, tf1, obb1);
         convertBV(tree2->getBV(root2).bv, tf2, obb2);
+        countBVTests(1);
         if(obb1.overlap(obb2))
         {
           Box box;
@@ -576,7 +742,8 @@ private:
           bool is_intersect = false;
           if(!crequest->enable_contact)
           {
-            if(solver->shapeTriangleIntersect(box, box_tf, p1, p2, p3, tf2, NULL, NULL, NULL))
+            countLeafTests(1);
+            if(voxelTriangleIntersect(bv1, p1, p2, p3))
             {
               is_intersect = true;
               if(cresult->numContacts() < crequest->num_max_contacts)
@@ -589,6 +756,7 @@ private:
             FCL_REAL depth;
             Vec3f normal;
 
+            countLeafTests(1);
             if(solver->shapeTriangleIntersect(box, box_tf, p1, p2, p3, tf2, &contact, &depth, &normal))
             {
               is_intersect = true;
@@ -617,6 +785,7 @@ private:
         OBB obb1, obb2;
         convertBV(bv1, tf1, obb1);
         convertBV(tree2->getBV(root2).bv, tf2, obb2);
+        countBVTests(1);
         if(obb1.overlap(obb2))
         {
           Box box;
@@ -629,7 +798,8 @@ private:
           const Vec3f& p2 = tree2->vertices[tri_id[1]];
           const Vec3f& p3 = tree2->vertices[tri_id[2]];
         
-          if(solver->shapeTriangleIntersect(box, box_tf, p1, p2, p3, tf2, NULL, NULL, NULL))
+          countLeafTests(1);
+          if(voxelTriangleIntersect(bv1, p1, p2, p3))
           {
             AABB overlap_part;
             AABB aabb1;
@@ -651,13 +821,11 @@ private:
     ///           2) (two uncertain nodes OR one node occupied and one node uncertain) AND cost not required
     if(tree1->isNodeFree(root1) || tree2->isFree()) return false;
     else if((tree1->isNodeUncertain(root1) || tree2->isUncertain()) && !crequest->enable_cost) return false;
-    else
-    {
-      OBB obb1, obb2;
-      convertBV(bv1, tf1, obb1);
-      convertBV(tree2->getBV(root2).bv, tf2, obb2);
-      if(!obb1.overlap(obb2)) return false;      
-    }
+    else if(!overlapCellBV(bv1, tree2->getBV(root2).bv)) return false;
+
+    // only occupied voxels matter now, so test all of them against the triangle at once
+    if(tree2->getBV(root2).isLeaf() && !crequest->enable_contact && !crequest->enable_cost)
+      return OcTreeMeshIntersectBatch(tree1, root1, bv1, tree2, root2);
    
     if(tree2->getBV(root2).isLeaf() || (root1->hasChildren() && (bv1.size() > tree2->getBV(root2).bv.size())))
     {
@@ -665,7 +833,7 @@ private:
       {
         if(root1->childExists(i))
         {
-          const OcTree::OcTreeNode* child = root1->getChild(i);
+          const typename OcTreeT::OcTreeNode* child = root1->getChild(i);
           AABB child_bv;
           computeChildBV(bv1, i, child_bv);
           
@@ -695,8 +863,9 @@ private:
     return false;
   }
 
-  bool OcTreeDistanceRecurse(const OcTree* tree1, const OcTree::OcTreeNode* root1, const AABB& bv1,
-                             const OcTree* tree2, const OcTree::OcTreeNode* root2, const AABB& bv2,
+  template<typename OcTreeT1, typename OcTreeT2>
+  bool OcTreeDistanceRecurse(const OcTreeT1* tree1, const typename OcTreeT1::OcTreeNode* root1, const AABB& bv1,
+                             const OcTreeT2* tree2, const typename OcTreeT2::OcTreeNode* root2, const AABB& bv2,
                              const Transform3f& tf1, const Transform3f& tf2) const
   {
     if(!root1->hasChildren() && !root2->hasChildren())
@@ -709,6 +878,7 @@ private:
         constructBox(bv2, tf2, box2, box2_tf);
 
         FCL_REAL dist;
+        countLeafTests(1);
         solver->shapeDistance(box1, box1_tf, box2, box2_tf, &dist);
 
         dresult->update(dist, tree1, tree2, root1 - tree1->getRoot(), root2 - tree2->getRoot());
@@ -727,7 +897,7 @@ private:
       {
         if(root1->childExists(i))
         {
-          const OcTree::OcTreeNode* child = root1->getChild(i);
+          const typename OcTreeT1::OcTreeNode* child = root1->getChild(i);
           AABB child_bv;
           computeChildBV(bv1, i, child_bv);
 
@@ -735,6 +905,7 @@ private:
           AABB aabb1, aabb2;
           convertBV(bv1, tf1, aabb1);
           convertBV(bv2, tf2, aabb2);
+          countBVTests(1);
           d = aabb1.distance(aabb2);
 
           if(d < dresult->min_distance)
@@ -752,7 +923,7 @@ private:
       {
         if(root2->childExists(i))
         {
-          const OcTree::OcTreeNode* child = root2->getChild(i);
+          const typename OcTreeT2::OcTreeNode* child = root2->getChild(i);
           AABB child_bv;
           computeChildBV(bv2, i, child_bv);
 
@@ -760,6 +931,7 @@ private:
           AABB aabb1, aabb2;
           convertBV(bv1, tf1, aabb1);
           convertBV(bv2, tf2, aabb2);
+          countBVTests(1);
           d = aabb1.distance(aabb2);
 
           if(d < dresult->min_distance)
@@ -775,8 +947,9 @@ private:
   }
 
 
-  bool OcTreeIntersectRecurse(const OcTree* tree1, const OcTree::OcTreeNode* root1, const AABB& bv1,
-                              const OcTree* tree2, const OcTree::OcTreeNode* root2, const AABB& bv2,
+  template<typename OcTreeT1, typename OcTreeT2>
+  bool OcTreeIntersectRecurse(const OcTreeT1* tree1, const typename OcTreeT1::OcTreeNode* root1, const AABB& bv1,
+                              const OcTreeT2* tree2, const typename OcTreeT2::OcTreeNode* root2, const AABB& bv2,
                               const Transform3f& tf1, const Transform3f& tf2) const
   {
     if(!root1 && !root2)
@@ -785,6 +958,7 @@ private:
       convertBV(bv1, tf1, obb1);
       convertBV(bv2, tf2, obb2);
 
+      countBVTests(1);
       if(obb1.overlap(obb2))
       {
         Box box1, box2;
@@ -810,7 +984,7 @@ private:
         {
           if(root2->childExists(i))
           {
-            const OcTree::OcTreeNode* child = root2->getChild(i);
+            const typename OcTreeT2::OcTreeNode* child = root2->getChild(i);
             AABB child_bv;
             computeChildBV(bv2, i, child_bv);
             if(OcTreeIntersectRecurse(tree1, NULL, bv1, tree2, child, child_bv, tf1, tf2))
@@ -841,7 +1015,7 @@ private:
         {
           if(root1->childExists(i))
           {
-            const OcTree::OcTreeNode* child = root1->getChild(i);
+            const typename OcTreeT1::OcTreeNode* child = root1->getChild(i);
             AABB child_bv;
             computeChildBV(bv1, i,  child_bv);
             if(OcTreeIntersectRecurse(tree1, child, child_bv, tree2, NULL, bv2, tf1, tf2))
@@ -875,6 +1049,7 @@ private:
           convertBV(bv1, tf1, obb1);
           convertBV(bv2, tf2, obb2);
           
+          countLeafTests(1);
           if(obb1.overlap(obb2))
           {
             is_intersect = true;
@@ -892,6 +1067,7 @@ private:
           Vec3f contact;
           FCL_REAL depth;
           Vec3f normal;
+          countLeafTests(1);
           if(solver->shapeIntersect(box1, box1_tf, box2, box2_tf, &contact, &depth, &normal))
           {
             is_intersect = true;
@@ -923,6 +1099,7 @@ private:
         convertBV(bv1, tf1, obb1);
         convertBV(bv2, tf2, obb2);
         
+        countBVTests(1);
         if(obb1.overlap(obb2))
         {
           Box box1, box2;
@@ -954,6 +1131,7 @@ private:
       OBB obb1, obb2;
       convertBV(bv1, tf1, obb1);
       convertBV(bv2, tf2, obb2);
+      countBVTests(1);
       if(!obb1.overlap(obb2)) return false;
     }
 
@@ -963,7 +1141,7 @@ private:
       {
         if(root1->childExists(i))
         {
-          const OcTree::OcTreeNode* child = root1->getChild(i);
+          const typename OcTreeT1::OcTreeNode* child = root1->getChild(i);
           AABB child_bv;
           computeChildBV(bv1, i, child_bv);
         
@@ -990,7 +1168,7 @@ private:
       {
         if(root2->childExists(i))
         {
-          const OcTree::OcTreeNode* child = root2->getChild(i);
+          const typename OcTreeT2::OcTreeNode* child = root2->getChild(i);
           AABB child_bv;
           computeChildBV(bv2, i, child_bv);
           
@@ -1020,7 +1198,7 @@ private:
 
 
 /// @brief Traversal node for octree collision
-template<typename NarrowPhaseSolver>
+template<typename NarrowPhaseSolver, typename OcTreeT1 = OcTree, typename OcTreeT2 = OcTreeT1>
 class OcTreeCollisionTraversalNode : public CollisionTraversalNodeBase
 {
 public:
@@ -1042,8 +1220,8 @@ public:
     otsolver->OcTreeIntersect(model1, model2, tf1, tf2, request, *result);
   }
 
-  const OcTree* model1;
-  const OcTree* model2;
+  const OcTreeT1* model1;
+  const OcTreeT2* model2;
 
   Transform3f tf1, tf2;
 
@@ -1051,7 +1229,7 @@ public:
 };
 
 /// @brief Traversal node for octree distance
-template<typename NarrowPhaseSolver>
+template<typename NarrowPhaseSolver, typename OcTreeT1 = OcTree, typename OcTreeT2 = OcTreeT1>
 class OcTreeDistanceTraversalNode : public DistanceTraversalNodeBase
 {
 public:
@@ -1074,14 +1252,14 @@ public:
     otsolver->OcTreeDistance(model1, model2, tf1, tf2, request, *result);
   }
 
-  const OcTree* model1;
-  const OcTree* model2;
+  const OcTreeT1* model1;
+  const OcTreeT2* model2;
 
   const OcTreeSolver<NarrowPhaseSolver>* otsolver;
 };
 
 /// @brief Traversal node for shape-octree collision
-template<typename S, typename NarrowPhaseSolver>
+template<typename S, typename NarrowPhaseSolver, typename OcTreeT = OcTree>
 class ShapeOcTreeCollisionTraversalNode : public CollisionTraversalNodeBase
 {
 public:
@@ -1104,7 +1282,7 @@ public:
   }
 
   const S* model1;
-  const OcTree* model2;
+  const OcTreeT* model2;
 
   Transform3f tf1, tf2;
 
@@ -1112,7 +1290,7 @@ public:
 };
 
 /// @brief Traversal node for octree-shape collision
-template<typename S, typename NarrowPhaseSolver>
+template<typename S, typename NarrowPhaseSolver, typename OcTreeT = OcTree>
 class OcTreeShapeCollisionTraversalNode : public CollisionTraversalNodeBase
 {
 public:
@@ -1134,7 +1312,7 @@ public:
     otsolver->OcTreeShapeIntersect(model1, *model2, tf1, tf2, request, *result);
   }
 
-  const OcTree* model1;
+  const OcTreeT* model1;
   const S* model2;
 
   Transform3f tf1, tf2;
@@ -1143,7 +1321,7 @@ public:
 };
 
 /// @brief Traversal node for shape-octree distance
-template<typename S, typename NarrowPhaseSolver>
+template<typename S, typename NarrowPhaseSolver, typename OcTreeT = OcTree>
 class ShapeOcTreeDistanceTraversalNode : public DistanceTraversalNodeBase
 {
 public:
@@ -1166,13 +1344,13 @@ public:
   }
 
   const S* model1;
-  const OcTree* model2;
+  const OcTreeT* model2;
 
   const OcTreeSolver<NarrowPhaseSolver>* otsolver;
 };
 
 /// @brief Traversal node for octree-shape distance
-template<typename S, typename NarrowPhaseSolver>
+template<typename S, typename NarrowPhaseSolver, typename OcTreeT = OcTree>
 class OcTreeShapeDistanceTraversalNode : public DistanceTraversalNodeBase
 {
 public:
@@ -1194,14 +1372,14 @@ public:
     otsolver->OcTreeShapeDistance(model1, *model2, tf1, tf2, request, *result);
   }
 
-  const OcTree* model1;
+  const OcTreeT* model1;
   const S* model2;
 
   const OcTreeSolver<NarrowPhaseSolver>* otsolver;
 };
 
 /// @brief Traversal node for mesh-octree collision
-template<typename BV, typename NarrowPhaseSolver>
+template<typename BV, typename NarrowPhaseSolver, typename OcTreeT = OcTree>
 class MeshOcTreeCollisionTraversalNode : public CollisionTraversalNodeBase
 {
 public:
@@ -1224,7 +1402,7 @@ public:
   }
 
   const BVHModel<BV>* model1;
-  const OcTree* model2;
+  const OcTreeT* model2;
 
   Transform3f tf1, tf2;
     
@@ -1232,7 +1410,7 @@ public:
 };
 
 /// @brief Traversal node for octree-mesh collision
-template<typename BV, typename NarrowPhaseSolver>
+template<typename BV, typename NarrowPhaseSolver, typename OcTreeT = OcTree>
 class OcTreeMeshCollisionTraversalNode : public CollisionTraversalNodeBase
 {
 public:
@@ -1254,7 +1432,7 @@ public:
     otsolver->OcTreeMeshIntersect(model1, model2, tf1, tf2, request, *result);
   }
 
-  const OcTree* model1;
+  const OcTreeT* model1;
   const BVHModel<BV>* model2;
 
   Transform3f tf1, tf2;
@@ -1263,7 +1441,7 @@ public:
 };
 
 /// @brief Traversal node for mesh-octree distance
-template<typename BV, typename NarrowPhaseSolver>
+template<typename BV, typename NarrowPhaseSolver, typename OcTreeT = OcTree>
 class MeshOcTreeDistanceTraversalNode : public DistanceTraversalNodeBase
 {
 public:
@@ -1286,14 +1464,14 @@ public:
   }
 
   const BVHModel<BV>* model1;
-  const OcTree* model2;
+  const OcTreeT* model2;
 
   const OcTreeSolver<NarrowPhaseSolver>* otsolver;
 
 };
 
 /// @brief Traversal node for octree-mesh distance
-template<typename BV, typename NarrowPhaseSolver>
+template<typename BV, typename NarrowPhaseSolver, typename OcTreeT = OcTree>
 class OcTreeMeshDistanceTraversalNode : public DistanceTraversalNodeBase
 {
 public:
@@ -1315,7 +1493,7 @@ public:
     otsolver->OcTreeMeshDistance(model1, model2, tf1, tf2, request, *result);
   }
 
-  const OcTree* model1;
+  const OcTreeT* model1;
   const BVHModel<BV>* model2;
 
   const OcTreeSolver<NarrowPhaseSolver>* otsolver;
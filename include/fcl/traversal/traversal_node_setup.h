@@ -54,10 +54,10 @@ namespace fcl
 
 #if FCL_HAVE_OCTOMAP
 /// @brief Initialize traversal node for collision between two octrees, given current object transform
-template<typename NarrowPhaseSolver>
-bool initialize(OcTreeCollisionTraversalNode<NarrowPhaseSolver>& node,
-                const OcTree& model1, const Transform3f& tf1,
-                const OcTree& model2, const Transform3f& tf2,
+template<typename NarrowPhaseSolver, typename OcTreeT1, typename OcTreeT2>
+bool initialize(OcTreeCollisionTraversalNode<NarrowPhaseSolver, OcTreeT1, OcTreeT2>& node,
+                const OcTreeT1& model1, const Transform3f& tf1,
+                const OcTreeT2& model2, const Transform3f& tf2,
                 const OcTreeSolver<NarrowPhaseSolver>* otsolver,
                 const CollisionRequest& request,
                 CollisionResult& result)
@@ -77,10 +77,10 @@ bool initialize(OcTreeCollisionTraversalNode<NarrowPhaseSolver>& node,
 }
 
 /// @brief Initialize traversal node for distance between two octrees, given current object transform
-template<typename NarrowPhaseSolver>
-bool initialize(OcTreeDistanceTraversalNode<NarrowPhaseSolver>& node,
-                const OcTree& model1, const Transform3f& tf1,
-                const OcTree& model2, const Transform3f& tf2,
+template<typename NarrowPhaseSolver, typename OcTreeT1, typename OcTreeT2>
+bool initialize(OcTreeDistanceTraversalNode<NarrowPhaseSolver, OcTreeT1, OcTreeT2>& node,
+                const OcTreeT1& model1, const Transform3f& tf1,
+                const OcTreeT2& model2, const Transform3f& tf2,
                 const OcTreeSolver<NarrowPhaseSolver>* otsolver,
                 const DistanceRequest& request,
                 DistanceResult& result)
@@ -100,10 +100,10 @@ bool initialize(OcTreeDistanceTraversalNode<NarrowPhaseSolver>& node,
 }
 
 /// @brief Initialize traversal node for collision between one shape and one octree, given current object transform
-template<typename S, typename NarrowPhaseSolver>
-bool initialize(ShapeOcTreeCollisionTraversalNode<S, NarrowPhaseSolver>& node,
+template<typename S, typename NarrowPhaseSolver, typename OcTreeT>
+bool initialize(ShapeOcTreeCollisionTraversalNode<S, NarrowPhaseSolver, OcTreeT>& node,
                 const S& model1, const Transform3f& tf1,
-                const OcTree& model2, const Transform3f& tf2,
+                const OcTreeT& model2, const Transform3f& tf2,
                 const OcTreeSolver<NarrowPhaseSolver>* otsolver,
                 const CollisionRequest& request,
                 CollisionResult& result)
@@ -123,9 +123,9 @@ bool initialize(ShapeOcTreeCollisionTraversalNode<S, NarrowPhaseSolver>& node,
 }
 
 /// @brief Initialize traversal node for collision between one octree and one shape, given current object transform
-template<typename S, typename NarrowPhaseSolver>
-bool initialize(OcTreeShapeCollisionTraversalNode<S, NarrowPhaseSolver>& node,
-                const OcTree& model1, const Transform3f& tf1,
+template<typename S, typename NarrowPhaseSolver, typename OcTreeT>
+bool initialize(OcTreeShapeCollisionTraversalNode<S, NarrowPhaseSolver, OcTreeT>& node,
+                const OcTreeT& model1, const Transform3f& tf1,
                 const S& model2, const Transform3f& tf2,
                 const OcTreeSolver<NarrowPhaseSolver>* otsolver,
                 const CollisionRequest& request,
@@ -146,10 +146,10 @@ bool initialize(OcTreeShapeCollisionTraversalNode<S, NarrowPhaseSolver>& node,
 }
 
 /// @brief Initialize traversal node for distance between one shape and one octree, given current object transform
-template<typename S, typename NarrowPhaseSolver>
-bool initialize(ShapeOcTreeDistanceTraversalNode<S, NarrowPhaseSolver>& node,
+template<typename S, typename NarrowPhaseSolver, typename OcTreeT>
+bool initialize(ShapeOcTreeDistanceTraversalNode<S, NarrowPhaseSolver, OcTreeT>& node,
                 const S& model1, const Transform3f& tf1,
-                const OcTree& model2, const Transform3f& tf2,
+                const OcTreeT& model2, const Transform3f& tf2,
                 const OcTreeSolver<NarrowPhaseSolver>* otsolver,
                 const DistanceRequest& request,
                 DistanceResult& result)
@@ -169,9 +169,9 @@ bool initialize(ShapeOcTreeDistanceTraversalNode<S, NarrowPhaseSolver>& node,
 }
 
 /// @brief Initialize traversal node for distance between one octree and one shape, given current object transform
-template<typename S, typename NarrowPhaseSolver>
-bool initialize(OcTreeShapeDistanceTraversalNode<S, NarrowPhaseSolver>& node,
-                const OcTree& model1, const Transform3f& tf1,
+template<typename S, typename NarrowPhaseSolver, typename OcTreeT>
+bool initialize(OcTreeShapeDistanceTraversalNode<S, NarrowPhaseSolver, OcTreeT>& node,
+                const OcTreeT& model1, const Transform3f& tf1,
                 const S& model2, const Transform3f& tf2,
                 const OcTreeSolver<NarrowPhaseSolver>* otsolver,
                 const DistanceRequest& request,
@@ -192,10 +192,10 @@ bool initialize(OcTreeShapeDistanceTraversalNode<S, NarrowPhaseSolver>& node,
 }
 
 /// @brief Initialize traversal node for collision between one mesh and one octree, given current object transform
-template<typename BV, typename NarrowPhaseSolver>
-bool initialize(MeshOcTreeCollisionTraversalNode<BV, NarrowPhaseSolver>& node,
+template<typename BV, typename NarrowPhaseSolver, typename OcTreeT>
+bool initialize(MeshOcTreeCollisionTraversalNode<BV, NarrowPhaseSolver, OcTreeT>& node,
                 const BVHModel<BV>& model1, const Transform3f& tf1,
-                const OcTree& model2, const Transform3f& tf2,
+                const OcTreeT& model2, const Transform3f& tf2,
                 const OcTreeSolver<NarrowPhaseSolver>* otsolver,
                 const CollisionRequest& request,
                 CollisionResult& result)
@@ -215,9 +215,9 @@ bool initialize(MeshOcTreeCollisionTraversalNode<BV, NarrowPhaseSolver>& node,
 }
 
 /// @brief Initialize traversal node for collision between one octree and one mesh, given current object transform
-template<typename BV, typename NarrowPhaseSolver>
-bool initialize(OcTreeMeshCollisionTraversalNode<BV, NarrowPhaseSolver>& node,
-                const OcTree& model1, const Transform3f& tf1,
+template<typename BV, typename NarrowPhaseSolver, typename OcTreeT>
+bool initialize(OcTreeMeshCollisionTraversalNode<BV, NarrowPhaseSolver, OcTreeT>& node,
+                const OcTreeT& model1, const Transform3f& tf1,
                 const BVHModel<BV>& model2, const Transform3f& tf2,
                 const OcTreeSolver<NarrowPhaseSolver>* otsolver,
                 const CollisionRequest& request,
@@ -238,10 +238,10 @@ bool initialize(OcTreeMeshCollisionTraversalNode<BV, NarrowPhaseSolver>& node,
 }
 
 /// @brief Initialize traversal node for distance between one mesh and one octree, given current object transform
-template<typename BV, typename NarrowPhaseSolver>
-bool initialize(MeshOcTreeDistanceTraversalNode<BV, NarrowPhaseSolver>& node,
+template<typename BV, typename NarrowPhaseSolver, typename OcTreeT>
+bool initialize(MeshOcTreeDistanceTraversalNode<BV, NarrowPhaseSolver, OcTreeT>& node,
                 const BVHModel<BV>& model1, const Transform3f& tf1,
-                const OcTree& model2, const Transform3f& tf2,
+                const OcTreeT& model2, const Transform3f& tf2,
                 const OcTreeSolver<NarrowPhaseSolver>* otsolver,
                 const DistanceRequest& request,
                 DistanceResult& result)
@@ -261,9 +261,9 @@ bool initialize(MeshOcTreeDistanceTraversalNode<BV, NarrowPhaseSolver>& node,
 }
 
 /// @brief Initialize traversal node for collision between one octree and one mesh, given current object transform
-template<typename BV, typename NarrowPhaseSolver>
-bool initialize(OcTreeMeshDistanceTraversalNode<BV, NarrowPhaseSolver>& node,
-                const OcTree& model1, const Transform3f& tf1,
+template<typename BV, typename NarrowPhaseSolver, typename OcTreeT>
+bool initialize(OcTreeMeshDistanceTraversalNode<BV, NarrowPhaseSolver, OcTreeT>& node,
+                const OcTreeT& model1, const Transform3f& tf1,
                 const BVHModel<BV>& model2, const Transform3f& tf2,
                 const OcTreeSolver<NarrowPhaseSolver>* otsolver,
                 const DistanceRequest& request,
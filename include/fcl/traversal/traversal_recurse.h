@@ -69,6 +69,10 @@ void distanceQueueRecurse(DistanceTraversalNodeBase* node, int bv_node1_id, int
 /// @brief Recurse function for front list propagation
 void propagateBVHFrontListCollisionRecurse(CollisionTraversalNodeBase* node, BVHFrontList* front_list);
 
+/// @brief Recurse function for distance starting from the front list of a previous distance query. The front list is
+/// replaced by the front of this query
+void propagateBVHFrontListDistanceRecurse(DistanceTraversalNodeBase* node, BVHFrontList* front_list);
+
 
 }
 
@@ -40,6 +40,13 @@
 namespace fcl
 {
 
+/// @brief Tolerance of the Voronoi region tests used by the RSS distance
+#if FCL_SINGLE_PRECISION
+static const FCL_REAL VORONOI_EPS = 1e-5;
+#else
+static const FCL_REAL VORONOI_EPS = 1e-7;
+#endif
+
 /// @brief Clip value between a and b
 void clipToRange(FCL_REAL& val, FCL_REAL a, FCL_REAL b)
 {
@@ -88,7 +95,7 @@ void segCoords(FCL_REAL& t, FCL_REAL& u, FCL_REAL a, FCL_REAL b, FCL_REAL A_dot_
 /// A,B, and Anorm are unit vectors. T is the vector between Pa and Pb.
 bool inVoronoi(FCL_REAL a, FCL_REAL b, FCL_REAL Anorm_dot_B, FCL_REAL Anorm_dot_T, FCL_REAL A_dot_B, FCL_REAL A_dot_T, FCL_REAL B_dot_T)
 {
-  if(fabs(Anorm_dot_B) < 1e-7) return false;
+  if(fabs(Anorm_dot_B) < VORONOI_EPS) return false;
 
   FCL_REAL t, u, v;
 
@@ -102,11 +109,11 @@ bool inVoronoi(FCL_REAL a, FCL_REAL b, FCL_REAL Anorm_dot_B, FCL_REAL Anorm_dot_
 
   if(Anorm_dot_B > 0)
   {
-    if(v > (u + 1e-7)) return true;
+    if(v > (u + VORONOI_EPS)) return true;
   }
   else
   {
-    if(v < (u - 1e-7)) return true;
+    if(v < (u - VORONOI_EPS)) return true;
   }
   return false;
 }
@@ -0,0 +1,184 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "fcl/BVH/BVH_compact.h"
+#include <cmath>
+#include <iostream>
+
+namespace fcl
+{
+
+const FCL_UINT16 CompactBVHModel::QUANTIZATION_MAX;
+
+CompactBVHModel::CompactBVHModel() : num_tris(0)
+{
+}
+
+void CompactBVHModel::build(const Vec3f* vertices_, int num_vertices_, const Triangle* triangles, int num_triangles, const std::vector<int>& first_child)
+{
+  nodes.clear();
+  vertices.clear();
+  tri_indices16.clear();
+  tri_indices32.clear();
+  num_tris = 0;
+  root_box = AABB();
+
+  if(first_child.empty() || num_triangles == 0)
+  {
+    std::cerr << "BVH Error! Only triangle models with a built hierarchy can be compacted." << std::endl;
+    return;
+  }
+
+  num_tris = num_triangles;
+
+  vertices.resize(3 * num_vertices_);
+  for(int i = 0; i < num_vertices_; ++i)
+  {
+    vertices[3 * i] = (float)vertices_[i][0];
+    vertices[3 * i + 1] = (float)vertices_[i][1];
+    vertices[3 * i + 2] = (float)vertices_[i][2];
+  }
+
+  if(num_vertices_ <= QUANTIZATION_MAX + 1)
+  {
+    tri_indices16.resize(3 * num_triangles);
+    for(int i = 0; i < num_triangles; ++i)
+      for(int j = 0; j < 3; ++j)
+        tri_indices16[3 * i + j] = (FCL_UINT16)triangles[i][j];
+  }
+  else
+  {
+    tri_indices32.resize(3 * num_triangles);
+    for(int i = 0; i < num_triangles; ++i)
+      for(int j = 0; j < 3; ++j)
+        tri_indices32[3 * i + j] = (FCL_UINT32)triangles[i][j];
+  }
+
+  // exact boxes of the single precision triangles; children are always stored after their parent
+  int num_nodes = (int)first_child.size();
+  std::vector<AABB> boxes(num_nodes);
+  for(int i = num_nodes - 1; i >= 0; --i)
+  {
+    if(first_child[i] < 0)
+    {
+      Vec3f p1, p2, p3;
+      getTriangle(-(first_child[i] + 1), p1, p2, p3);
+      boxes[i] = AABB(p1, p2, p3);
+    }
+    else
+      boxes[i] = boxes[first_child[i]] + boxes[first_child[i] + 1];
+  }
+
+  // quantize each child against the decoded box of its parent, rounding outwards
+  nodes.resize(num_nodes);
+  std::vector<AABB> decoded(num_nodes);
+  root_box = boxes[0];
+  decoded[0] = root_box;
+  for(int i = 0; i < 3; ++i)
+  {
+    nodes[0].lower[i] = 0;
+    nodes[0].upper[i] = QUANTIZATION_MAX;
+  }
+
+  for(int id = 0; id < num_nodes; ++id)
+  {
+    nodes[id].first_child = first_child[id];
+    if(first_child[id] < 0) continue;
+
+    const AABB& parent = decoded[id];
+    for(int c = first_child[id]; c <= first_child[id] + 1; ++c)
+    {
+      for(int i = 0; i < 3; ++i)
+      {
+        FCL_REAL lo = parent.min_[i];
+        FCL_REAL hi = parent.max_[i];
+        FCL_REAL extent = hi - lo;
+
+        int q_lower = 0;
+        int q_upper = QUANTIZATION_MAX;
+        if(extent > 0)
+        {
+          q_lower = std::max(0, std::min((int)std::floor((boxes[c].min_[i] - lo) / extent * QUANTIZATION_MAX), (int)QUANTIZATION_MAX));
+          while(q_lower > 0 && decodeCoordinate(q_lower, lo, hi) > boxes[c].min_[i]) --q_lower;
+
+          q_upper = std::max(0, std::min((int)std::ceil((boxes[c].max_[i] - lo) / extent * QUANTIZATION_MAX), (int)QUANTIZATION_MAX));
+          while(q_upper < QUANTIZATION_MAX && decodeCoordinate(q_upper, lo, hi) < boxes[c].max_[i]) ++q_upper;
+        }
+
+        nodes[c].lower[i] = (FCL_UINT16)q_lower;
+        nodes[c].upper[i] = (FCL_UINT16)q_upper;
+      }
+
+      decodeBox(nodes[c], parent, decoded[c]);
+    }
+  }
+}
+
+void CompactBVHModel::computeLocalAABB()
+{
+  aabb_local = root_box;
+  aabb_center = aabb_local.center();
+
+  aabb_radius = 0;
+  for(int i = 0; i < getNumVertices(); ++i)
+  {
+    FCL_REAL r = (aabb_center - getVertex(i)).sqrLength();
+    if(r > aabb_radius) aabb_radius = r;
+  }
+
+  aabb_radius = sqrt(aabb_radius);
+}
+
+int CompactBVHModel::memUsage(int msg) const
+{
+  int mem_node_list = sizeof(Node) * nodes.size();
+  int mem_tri_list = sizeof(FCL_UINT16) * tri_indices16.size() + sizeof(FCL_UINT32) * tri_indices32.size();
+  int mem_vertex_list = sizeof(float) * vertices.size();
+
+  int total_mem = mem_node_list + mem_tri_list + mem_vertex_list + sizeof(CompactBVHModel);
+  if(msg)
+  {
+    std::cerr << "Total for compact model " << total_mem << " bytes." << std::endl;
+    std::cerr << "Nodes: " << nodes.size() << " allocated, " << mem_node_list << " bytes." << std::endl;
+    std::cerr << "Tris: " << num_tris << " allocated, " << mem_tri_list << " bytes." << std::endl;
+    std::cerr << "Vertices: " << getNumVertices() << " allocated, " << mem_vertex_list << " bytes." << std::endl;
+    if(num_tris > 0)
+      std::cerr << "Bytes per triangle: " << (FCL_REAL)total_mem / num_tris << std::endl;
+  }
+
+  return total_mem;
+}
+
+}
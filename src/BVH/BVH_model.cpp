@@ -36,12 +36,45 @@
 
 #include "fcl/BVH/BVH_model.h"
 #include "fcl/BV/BV.h"
+#include "fcl/math/point_batch.h"
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <string.h>
 
 namespace fcl
 {
 
+namespace details
+{
+
+struct BVHRefitTopology
+{
+  /// @brief Parent of each node, -1 for the root
+  std::vector<int> parents;
+
+  /// @brief Leaf node of each primitive
+  std::vector<int> primitive_leaves;
+
+  /// @brief Triangles using vertex i are vertex_primitives[vertex_primitive_offsets[i] ... vertex_primitive_offsets[i + 1] - 1]
+  std::vector<int> vertex_primitive_offsets;
+  std::vector<int> vertex_primitives;
+
+  /// @brief Nodes at depth d are level_nodes[level_offsets[d] ... level_offsets[d + 1] - 1]
+  std::vector<int> level_nodes;
+  std::vector<int> level_offsets;
+};
+
+}
+
+/// @brief Hierarchies with fewer nodes per thread are refit on the calling thread
+static const int PARALLEL_REFIT_MIN_NODES = 8192;
+
+/// @brief The whole hierarchy is refit when more than 1 / SELECTIVE_REFIT_MAX_FRACTION of the vertices moved
+static const int SELECTIVE_REFIT_MAX_FRACTION = 4;
+
 template<typename BV>
 BVHModel<BV>::BVHModel(const BVHModel<BV>& other) : CollisionGeometry(other),
                                                     num_tris(other.num_tris),
@@ -49,9 +82,33 @@ BVHModel<BV>::BVHModel(const BVHModel<BV>& other) : CollisionGeometry(other),
                                                     build_state(other.build_state),
                                                     bv_splitter(other.bv_splitter),
                                                     bv_fitter(other.bv_fitter),
+                                                    use_triangle_cache(other.use_triangle_cache),
+                                                    triangle_cache(other.triangle_cache),
+                                                    refit_num_threads(other.refit_num_threads),
+                                                    rebuild_threshold(other.rebuild_threshold),
                                                     num_tris_allocated(other.num_tris),
-                                                    num_vertices_allocated(other.num_vertices)
+                                                    num_vertices_allocated(other.num_vertices),
+                                                    all_vertices_dirty(other.all_vertices_dirty),
+                                                    refit_topology(other.refit_topology),
+                                                    tree_size_sum(other.tree_size_sum),
+                                                    built_tree_cost(other.built_tree_cost)
 {
+  if(other.shared_storage)
+  {
+    // a built model is immutable until it is detached, so the copy references the same arrays
+    vertices = other.vertices;
+    tri_indices = other.tri_indices;
+    prev_vertices = other.prev_vertices;
+    primitive_indices = other.primitive_indices;
+    bvs = other.bvs;
+    num_tris_allocated = other.num_tris_allocated;
+    num_vertices_allocated = other.num_vertices_allocated;
+    num_bvs = other.num_bvs;
+    num_bvs_allocated = other.num_bvs_allocated;
+    shared_storage = other.shared_storage;
+    return;
+  }
+
   if(other.vertices)
   {
     vertices = new Vec3f[num_vertices];
@@ -78,18 +135,7 @@ BVHModel<BV>::BVHModel(const BVHModel<BV>& other) : CollisionGeometry(other),
 
   if(other.primitive_indices)
   {
-    int num_primitives = 0;
-    switch(other.getModelType())
-    {
-      case BVH_MODEL_TRIANGLES:
-        num_primitives = num_tris;
-        break;
-      case BVH_MODEL_POINTCLOUD:
-        num_primitives = num_vertices;
-        break;
-      default:
-        ;
-    }
+    int num_primitives = other.getNumPrimitives();
 
     primitive_indices = new unsigned int[num_primitives];
     memcpy(primitive_indices, other.primitive_indices, sizeof(unsigned int) * num_primitives);
@@ -113,11 +159,7 @@ int BVHModel<BV>::beginModel(int num_tris_, int num_vertices_)
 {
   if(build_state != BVH_BUILD_STATE_EMPTY)
   {
-    delete [] vertices; vertices = NULL;
-    delete [] tri_indices; tri_indices = NULL;
-    delete [] bvs; bvs = NULL;
-    delete [] prev_vertices; prev_vertices = NULL;
-    delete [] primitive_indices; primitive_indices = NULL;
+    releaseData();
 
     num_vertices_allocated = num_vertices = num_tris_allocated = num_tris = num_bvs_allocated = num_bvs = 0;
   }
@@ -399,10 +441,15 @@ int BVHModel<BV>::endModel()
   num_bvs = 0;
 
   buildTree();
+  updateTreeCost(true);
+
+  updateTriangleCache();
 
   // finish constructing
   build_state = BVH_BUILD_STATE_PROCESSED;
 
+  shareStorage();
+
   return BVH_OK;
 }
 
@@ -417,6 +464,12 @@ int BVHModel<BV>::beginReplaceModel()
     return BVH_ERR_BUILD_EMPTY_PREVIOUS_FRAME;
   }
 
+  detachSharedStorage();
+
+  // the leaves also covered the previous positions, which are dropped now
+  all_vertices_dirty = (prev_vertices != NULL);
+  dirty_vertices.clear();
+
   if(prev_vertices) delete [] prev_vertices; prev_vertices = NULL;
 
   num_vertex_updated = 0;
@@ -435,8 +488,7 @@ int BVHModel<BV>::replaceVertex(const Vec3f& p)
     return BVH_ERR_BUILD_OUT_OF_SEQUENCE;
   }
 
-  vertices[num_vertex_updated] = p;
-  num_vertex_updated++;
+  setNextVertex(p);
 
   return BVH_OK;
 }
@@ -450,9 +502,9 @@ int BVHModel<BV>::replaceTriangle(const Vec3f& p1, const Vec3f& p2, const Vec3f&
     return BVH_ERR_BUILD_OUT_OF_SEQUENCE;
   }
 
-  vertices[num_vertex_updated] = p1; num_vertex_updated++;
-  vertices[num_vertex_updated] = p2; num_vertex_updated++;
-  vertices[num_vertex_updated] = p3; num_vertex_updated++;
+  setNextVertex(p1);
+  setNextVertex(p2);
+  setNextVertex(p3);
   return BVH_OK;
 }
 
@@ -466,10 +518,7 @@ int BVHModel<BV>::replaceSubModel(const std::vector<Vec3f>& ps)
   }
 
   for(unsigned int i = 0; i < ps.size(); ++i)
-  {
-    vertices[num_vertex_updated] = ps[i];
-    num_vertex_updated++;
-  }
+    setNextVertex(ps[i]);
   return BVH_OK;
 }
 
@@ -490,15 +539,20 @@ int BVHModel<BV>::endReplaceModel(bool refit, bool bottomup)
 
   if(refit)  // refit, do not change BVH structure
   {
-    refitTree(bottomup);
+    refitDirtyTree(bottomup);
   }
   else // reconstruct bvh tree based on current frame data
   {
     buildTree();
+    updateTreeCost(true);
   }
 
+  updateTriangleCache();
+
   build_state = BVH_BUILD_STATE_PROCESSED;
 
+  shareStorage();
+
   return BVH_OK;
 }
 
@@ -515,6 +569,13 @@ int BVHModel<BV>::beginUpdateModel()
     return BVH_ERR_BUILD_EMPTY_PREVIOUS_FRAME;
   }
 
+  detachSharedStorage();
+
+  // the leaves covered the positions at the last two frames; a leaf keeps its BV if the positions the new ones
+  // overwrite are the same, which cannot be checked for the first update
+  all_vertices_dirty = (prev_vertices == NULL);
+  dirty_vertices.clear();
+
   if(prev_vertices)
   {
     Vec3f* temp = prev_vertices;
@@ -543,8 +604,7 @@ int BVHModel<BV>::updateVertex(const Vec3f& p)
     return BVH_ERR_BUILD_OUT_OF_SEQUENCE;
   }
 
-  vertices[num_vertex_updated] = p;
-  num_vertex_updated++;
+  setNextVertex(p);
 
   return BVH_OK;
 }
@@ -558,9 +618,9 @@ int BVHModel<BV>::updateTriangle(const Vec3f& p1, const Vec3f& p2, const Vec3f&
     return BVH_ERR_BUILD_OUT_OF_SEQUENCE;
   }
 
-  vertices[num_vertex_updated] = p1; num_vertex_updated++;
-  vertices[num_vertex_updated] = p2; num_vertex_updated++;
-  vertices[num_vertex_updated] = p3; num_vertex_updated++;
+  setNextVertex(p1);
+  setNextVertex(p2);
+  setNextVertex(p3);
   return BVH_OK;
 }
 
@@ -574,10 +634,7 @@ int BVHModel<BV>::updateSubModel(const std::vector<Vec3f>& ps)
   }
 
   for(unsigned int i = 0; i < ps.size(); ++i)
-  {
-    vertices[num_vertex_updated] = ps[i];
-    num_vertex_updated++;
-  }
+    setNextVertex(ps[i]);
   return BVH_OK;
 }
 
@@ -598,7 +655,7 @@ int BVHModel<BV>::endUpdateModel(bool refit, bool bottomup)
 
   if(refit)  // refit, do not change BVH structure
   {
-    refitTree(bottomup);
+    refitDirtyTree(bottomup);
   }
   else // reconstruct bvh tree based on current frame data
   {
@@ -607,34 +664,164 @@ int BVHModel<BV>::endUpdateModel(bool refit, bool bottomup)
     // then refit
 
     refitTree(bottomup);
+    updateTreeCost(true);
   }
 
+  updateTriangleCache();
 
   build_state = BVH_BUILD_STATE_UPDATED;
 
+  shareStorage();
+
   return BVH_OK;
 }
 
 
 
 
+template<typename BV>
+void BVHModel<BV>::updateTriangleCache()
+{
+  if(use_triangle_cache && num_tris > 0)
+    triangle_cache.build(vertices, tri_indices, num_tris);
+  else
+    triangle_cache.clear();
+}
+
+template<typename BV>
+void BVHModel<BV>::releaseData()
+{
+  if(!shared_storage)
+  {
+    delete [] vertices;
+    delete [] tri_indices;
+    delete [] bvs;
+    delete [] prev_vertices;
+    delete [] primitive_indices;
+  }
+
+  vertices = NULL;
+  tri_indices = NULL;
+  bvs = NULL;
+  prev_vertices = NULL;
+  primitive_indices = NULL;
+  shared_storage.reset();
+
+  refit_topology.reset();
+  refit_marks.clear();
+  built_tree_cost = -1;
+}
+
+template<typename BV>
+void BVHModel<BV>::shareStorage()
+{
+  if(shared_storage) return;
+
+  shared_storage.reset(new details::BVHSharedStorage<BV>());
+  shared_storage->vertices = vertices;
+  shared_storage->tri_indices = tri_indices;
+  shared_storage->prev_vertices = prev_vertices;
+  shared_storage->primitive_indices = primitive_indices;
+  shared_storage->bvs = bvs;
+}
+
+template<typename BV>
+void BVHModel<BV>::detachSharedStorage()
+{
+  if(!shared_storage) return;
+
+  if(shared_storage.unique() && !shared_storage->mapping)
+  {
+    // no other copy uses the arrays, take them back without copying
+    shared_storage->vertices = NULL;
+    shared_storage->tri_indices = NULL;
+    shared_storage->prev_vertices = NULL;
+    shared_storage->primitive_indices = NULL;
+    shared_storage->bvs = NULL;
+    shared_storage.reset();
+    return;
+  }
+
+  int num_primitives = getNumPrimitives();
+
+  if(vertices)
+  {
+    Vec3f* temp = new Vec3f[num_vertices];
+    memcpy(temp, vertices, sizeof(Vec3f) * num_vertices);
+    vertices = temp;
+  }
+
+  if(tri_indices)
+  {
+    Triangle* temp = new Triangle[num_tris];
+    memcpy(temp, tri_indices, sizeof(Triangle) * num_tris);
+    tri_indices = temp;
+  }
+
+  if(prev_vertices)
+  {
+    Vec3f* temp = new Vec3f[num_vertices];
+    memcpy(temp, prev_vertices, sizeof(Vec3f) * num_vertices);
+    prev_vertices = temp;
+  }
+
+  if(primitive_indices)
+  {
+    unsigned int* temp = new unsigned int[num_primitives];
+    memcpy(temp, primitive_indices, sizeof(unsigned int) * num_primitives);
+    primitive_indices = temp;
+  }
+
+  if(bvs)
+  {
+    BVNode<BV>* temp = new BVNode<BV>[num_bvs];
+    memcpy(temp, bvs, sizeof(BVNode<BV>) * num_bvs);
+    bvs = temp;
+  }
+
+  num_vertices_allocated = num_vertices;
+  num_tris_allocated = num_tris;
+  num_bvs_allocated = num_bvs;
+
+  shared_storage.reset();
+}
+
+template<typename BV>
+int BVHModel<BV>::getNumPrimitives() const
+{
+  switch(getModelType())
+  {
+  case BVH_MODEL_TRIANGLES:
+    return num_tris;
+  case BVH_MODEL_POINTCLOUD:
+    return num_vertices;
+  default:
+    return 0;
+  }
+}
+
 template<typename BV>
 int BVHModel<BV>::memUsage(int msg) const
 {
-  int mem_bv_list = sizeof(BV) * num_bvs;
+  int mem_bv_list = sizeof(BVNode<BV>) * num_bvs;
   int mem_tri_list = sizeof(Triangle) * num_tris;
   int mem_vertex_list = sizeof(Vec3f) * num_vertices;
+  int mem_triangle_cache = triangle_cache.memUsage();
 
-  int total_mem = mem_bv_list + mem_tri_list + mem_vertex_list + sizeof(BVHModel<BV>);
+  int total_mem = mem_bv_list + mem_tri_list + mem_vertex_list + mem_triangle_cache + sizeof(BVHModel<BV>);
   if(msg)
   {
     std::cerr << "Total for model " << total_mem << " bytes." << std::endl;
-    std::cerr << "BVs: " << num_bvs << " allocated." << std::endl;
-    std::cerr << "Tris: " << num_tris << " allocated." << std::endl;
-    std::cerr << "Vertices: " << num_vertices << " allocated." << std::endl;
+    std::cerr << "BVs: " << num_bvs << " allocated, " << mem_bv_list << " bytes." << std::endl;
+    std::cerr << "Tris: " << num_tris << " allocated, " << mem_tri_list << " bytes." << std::endl;
+    std::cerr << "Vertices: " << num_vertices << " allocated, " << mem_vertex_list << " bytes." << std::endl;
+    if(mem_triangle_cache > 0)
+      std::cerr << "Triangle cache: " << mem_triangle_cache << " bytes." << std::endl;
+    if(num_tris > 0)
+      std::cerr << "Bytes per triangle: " << (FCL_REAL)total_mem / num_tris << std::endl;
   }
 
-  return BVH_OK;
+  return total_mem;
 }
 
 
@@ -666,6 +853,9 @@ int BVHModel<BV>::buildTree()
     primitive_indices[i] = i;
   recursiveBuildTree(0, 0, num_primitives);
 
+  refit_topology.reset();
+  refit_marks.clear();
+
   bv_fitter->clear();
   bv_splitter->clear();
 
@@ -762,70 +952,128 @@ int BVHModel<BV>::refitTree(bool bottomup)
 template<typename BV>
 int BVHModel<BV>::refitTree_bottomup()
 {
-  int res = recursiveRefitTree_bottomup(0);
+  int threads = (refit_num_threads > 0) ? refit_num_threads : static_cast<int>(boost::thread::hardware_concurrency());
+  threads = std::min(threads, num_bvs / PARALLEL_REFIT_MIN_NODES);
+  if(threads <= 1)
+    return recursiveRefitTree_bottomup(0);
+
+  if(getModelType() == BVH_MODEL_UNKNOWN)
+  {
+    std::cerr << "BVH Error: Model type not supported!" << std::endl;
+    return BVH_ERR_UNSUPPORTED_FUNCTION;
+  }
+
+  buildRefitTopology();
+
+  boost::barrier barrier(threads);
+  boost::thread_group workers;
+  for(int i = 1; i < threads; ++i)
+    workers.create_thread(boost::bind(&BVHModel<BV>::refitLevels, this, i, threads, &barrier));
+
+  refitLevels(0, threads, &barrier);
+  workers.join_all();
 
-  return res;
+  return BVH_OK;
 }
 
+template<typename BV>
+void BVHModel<BV>::refitLevels(int thread_id, int num_threads, boost::barrier* barrier)
+{
+  const details::BVHRefitTopology& topology = *refit_topology;
+  int num_levels = static_cast<int>(topology.level_offsets.size()) - 1;
+
+  // the nodes of one level only depend on the deeper levels
+  for(int level = num_levels - 1; level >= 0; --level)
+  {
+    int first = topology.level_offsets[level];
+    int size = topology.level_offsets[level + 1] - first;
+    int begin = first + static_cast<int>(static_cast<long long>(size) * thread_id / num_threads);
+    int end = first + static_cast<int>(static_cast<long long>(size) * (thread_id + 1) / num_threads);
+
+    for(int i = begin; i < end; ++i)
+      refitNode_bottomup(topology.level_nodes[i]);
+
+    barrier->wait();
+  }
+}
 
 template<typename BV>
-int BVHModel<BV>::recursiveRefitTree_bottomup(int bv_id)
+void BVHModel<BV>::refitNode_bottomup(int bv_id)
 {
   BVNode<BV>* bvnode = bvs + bv_id;
   if(bvnode->isLeaf())
-  {
-    BVHModelType type = getModelType();
-    int primitive_id = -(bvnode->first_child + 1);
-    if(type == BVH_MODEL_POINTCLOUD)
-    {
-      BV bv;
+    refitLeaf(bv_id);
+  else
+    bvnode->bv = bvs[bvnode->leftChild()].bv + bvs[bvnode->rightChild()].bv;
+}
 
-      if(prev_vertices)
-      {
-        Vec3f v[2];
-        v[0] = prev_vertices[primitive_id];
-        v[1] = vertices[primitive_id];
-        fit(v, 2, bv);
-      }
-      else
-        fit(vertices + primitive_id, 1, bv);
+template<typename BV>
+int BVHModel<BV>::refitLeaf(int bv_id)
+{
+  BVNode<BV>* bvnode = bvs + bv_id;
+  BVHModelType type = getModelType();
+  int primitive_id = -(bvnode->first_child + 1);
+  if(type == BVH_MODEL_POINTCLOUD)
+  {
+    BV bv;
 
-      bvnode->bv = bv;
-    }
-    else if(type == BVH_MODEL_TRIANGLES)
+    if(prev_vertices)
     {
-      BV bv;
-      const Triangle& triangle = tri_indices[primitive_id];
+      Vec3f v[2];
+      v[0] = prev_vertices[primitive_id];
+      v[1] = vertices[primitive_id];
+      fit(v, 2, bv);
+    }
+    else
+      fit(vertices + primitive_id, 1, bv);
 
-      if(prev_vertices)
-      {
-        Vec3f v[6];
-        for(int i = 0; i < 3; ++i)
-        {
-          v[i] = prev_vertices[triangle[i]];
-          v[i + 3] = vertices[triangle[i]];
-        }
+    bvnode->bv = bv;
+  }
+  else if(type == BVH_MODEL_TRIANGLES)
+  {
+    BV bv;
+    const Triangle& triangle = tri_indices[primitive_id];
 
-        fit(v, 6, bv);
-      }
-      else
+    if(prev_vertices)
+    {
+      Vec3f v[6];
+      for(int i = 0; i < 3; ++i)
       {
-        Vec3f v[3];
-        for(int i = 0; i < 3; ++i)
-        {
-          v[i] = vertices[triangle[i]];
-        }
-
-        fit(v, 3, bv);
+        v[i] = prev_vertices[triangle[i]];
+        v[i + 3] = vertices[triangle[i]];
       }
 
-      bvnode->bv = bv;
+      fit(v, 6, bv);
     }
     else
     {
-      std::cerr << "BVH Error: Model type not supported!" << std::endl;
-      return BVH_ERR_UNSUPPORTED_FUNCTION;
+      Vec3f v[3];
+      for(int i = 0; i < 3; ++i)
+      {
+        v[i] = vertices[triangle[i]];
+      }
+
+      fit(v, 3, bv);
     }
+
+    bvnode->bv = bv;
+  }
+  else
+  {
+    std::cerr << "BVH Error: Model type not supported!" << std::endl;
+    return BVH_ERR_UNSUPPORTED_FUNCTION;
+  }
+
+  return BVH_OK;
+}
+
+template<typename BV>
+int BVHModel<BV>::recursiveRefitTree_bottomup(int bv_id)
+{
+  BVNode<BV>* bvnode = bvs + bv_id;
+  if(bvnode->isLeaf())
+  {
+    return refitLeaf(bv_id);
   }
   else
   {
@@ -853,14 +1101,190 @@ int BVHModel<BV>::refitTree_topdown()
 }
 
 template<typename BV>
-void BVHModel<BV>::computeLocalAABB()
+void BVHModel<BV>::setNextVertex(const Vec3f& p)
 {
-  AABB aabb_;
-  for(int i = 0; i < num_vertices; ++i)
+  Vec3f& v = vertices[num_vertex_updated];
+  if(!all_vertices_dirty && (v[0] != p[0] || v[1] != p[1] || v[2] != p[2]))
+    dirty_vertices.push_back(num_vertex_updated);
+
+  v = p;
+  num_vertex_updated++;
+}
+
+template<typename BV>
+int BVHModel<BV>::refitDirtyTree(bool bottomup)
+{
+  if(all_vertices_dirty || static_cast<int>(dirty_vertices.size()) > num_vertices / SELECTIVE_REFIT_MAX_FRACTION)
+  {
+    int res = refitTree(bottomup);
+    updateTreeCost(false);
+    if(res != BVH_OK) return res;
+  }
+  else if(!dirty_vertices.empty())
+  {
+    buildRefitTopology();
+    const details::BVHRefitTopology& topology = *refit_topology;
+    bool triangles = (getModelType() == BVH_MODEL_TRIANGLES);
+
+    // collect the leaves of the primitives using a dirty vertex and their ancestors
+    std::vector<int> nodes;
+    refit_marks.resize(num_bvs, 0);
+    for(std::size_t i = 0; i < dirty_vertices.size(); ++i)
+    {
+      int vertex_id = dirty_vertices[i];
+      int begin = triangles ? topology.vertex_primitive_offsets[vertex_id] : vertex_id;
+      int end = triangles ? topology.vertex_primitive_offsets[vertex_id + 1] : vertex_id + 1;
+      for(int j = begin; j < end; ++j)
+      {
+        int primitive_id = triangles ? topology.vertex_primitives[j] : j;
+        int bv_id = topology.primitive_leaves[primitive_id];
+        while(bv_id >= 0 && !refit_marks[bv_id])
+        {
+          refit_marks[bv_id] = 1;
+          nodes.push_back(bv_id);
+          bv_id = topology.parents[bv_id];
+        }
+      }
+    }
+
+    // children have larger indices than their parent
+    std::sort(nodes.begin(), nodes.end(), std::greater<int>());
+
+    bool track_cost = (rebuild_threshold > 0);
+    if(!bottomup)
+      bv_fitter->set(vertices, prev_vertices, tri_indices, getModelType());
+
+    for(std::size_t i = 0; i < nodes.size(); ++i)
+    {
+      BVNode<BV>& bvnode = bvs[nodes[i]];
+      if(track_cost) tree_size_sum -= bvnode.bv.size();
+
+      if(bottomup)
+        refitNode_bottomup(nodes[i]);
+      else
+        bvnode.bv = bv_fitter->fit(primitive_indices + bvnode.first_primitive, bvnode.num_primitives);
+
+      if(track_cost) tree_size_sum += bvnode.bv.size();
+      refit_marks[nodes[i]] = 0;
+    }
+
+    if(!bottomup)
+      bv_fitter->clear();
+
+    if(track_cost && built_tree_cost < 0)
+      updateTreeCost(false);
+  }
+
+  dirty_vertices.clear();
+
+  if(rebuild_threshold > 0 && getRelativeTreeCost() > rebuild_threshold)
   {
-    aabb_ += vertices[i];
+    buildTree();
+
+    // the leaves of an update also cover the previous positions
+    if(prev_vertices)
+      refitTree(bottomup);
+
+    updateTreeCost(true);
   }
 
+  return BVH_OK;
+}
+
+template<typename BV>
+void BVHModel<BV>::buildRefitTopology()
+{
+  if(refit_topology) return;
+
+  boost::shared_ptr<details::BVHRefitTopology> topology(new details::BVHRefitTopology());
+
+  int num_primitives = getNumPrimitives();
+  topology->parents.resize(num_bvs);
+  topology->primitive_leaves.resize(num_primitives, -1);
+  std::vector<int> depths(num_bvs, 0);
+  int num_levels = 1;
+
+  topology->parents[0] = -1;
+  for(int i = 0; i < num_bvs; ++i)
+  {
+    const BVNode<BV>& bvnode = bvs[i];
+    if(bvnode.isLeaf())
+      topology->primitive_leaves[bvnode.primitiveId()] = i;
+    else
+    {
+      topology->parents[bvnode.leftChild()] = topology->parents[bvnode.rightChild()] = i;
+      depths[bvnode.leftChild()] = depths[bvnode.rightChild()] = depths[i] + 1;
+      num_levels = std::max(num_levels, depths[i] + 2);
+    }
+  }
+
+  // nodes sorted by depth
+  topology->level_offsets.assign(num_levels + 1, 0);
+  for(int i = 0; i < num_bvs; ++i)
+    topology->level_offsets[depths[i] + 1]++;
+  for(int i = 0; i < num_levels; ++i)
+    topology->level_offsets[i + 1] += topology->level_offsets[i];
+  topology->level_nodes.resize(num_bvs);
+  std::vector<int> level_fill(topology->level_offsets.begin(), topology->level_offsets.end() - 1);
+  for(int i = 0; i < num_bvs; ++i)
+    topology->level_nodes[level_fill[depths[i]]++] = i;
+
+  // triangles of each vertex
+  if(getModelType() == BVH_MODEL_TRIANGLES)
+  {
+    topology->vertex_primitive_offsets.assign(num_vertices + 1, 0);
+    for(int i = 0; i < num_tris; ++i)
+      for(int j = 0; j < 3; ++j)
+        topology->vertex_primitive_offsets[tri_indices[i][j] + 1]++;
+    for(int i = 0; i < num_vertices; ++i)
+      topology->vertex_primitive_offsets[i + 1] += topology->vertex_primitive_offsets[i];
+    topology->vertex_primitives.resize(3 * num_tris);
+    std::vector<int> vertex_fill(topology->vertex_primitive_offsets.begin(), topology->vertex_primitive_offsets.end() - 1);
+    for(int i = 0; i < num_tris; ++i)
+      for(int j = 0; j < 3; ++j)
+        topology->vertex_primitives[vertex_fill[tri_indices[i][j]]++] = i;
+  }
+
+  refit_topology = topology;
+}
+
+template<typename BV>
+void BVHModel<BV>::updateTreeCost(bool after_build)
+{
+  if(rebuild_threshold <= 0)
+  {
+    built_tree_cost = -1;
+    return;
+  }
+
+  tree_size_sum = 0;
+  for(int i = 0; i < num_bvs; ++i)
+    tree_size_sum += bvs[i].bv.size();
+
+  if(after_build || built_tree_cost < 0)
+    built_tree_cost = computeTreeCost();
+}
+
+template<typename BV>
+FCL_REAL BVHModel<BV>::computeTreeCost() const
+{
+  FCL_REAL root_size = (num_bvs > 0) ? bvs[0].bv.size() : 0;
+  return (root_size > 0) ? tree_size_sum / root_size : 1;
+}
+
+template<typename BV>
+FCL_REAL BVHModel<BV>::getRelativeTreeCost() const
+{
+  if(built_tree_cost <= 0) return 1;
+  return computeTreeCost() / built_tree_cost;
+}
+
+template<typename BV>
+void BVHModel<BV>::computeLocalAABB()
+{
+  AABB aabb_;
+  boundPoints(vertices, num_vertices, aabb_.min_, aabb_.max_);
+
   aabb_center = aabb_.center();
 
   aabb_radius = 0;
@@ -876,6 +1300,58 @@ void BVHModel<BV>::computeLocalAABB()
 }
 
 
+template<typename BV>
+void BVHModel<BV>::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  CollisionGeometry::computeAABB(tf, aabb);
+}
+
+/// @brief Clip aabb by the AABB in world space of the oriented box placed at tf
+static void clipByOrientedBox(const Transform3f& tf, const Vec3f& center, const Vec3f axis[3], const Vec3f& extent, AABB& aabb)
+{
+  AABB box;
+  computeOrientedBoxAABB(tf, center, axis, extent, box);
+  aabb.min_.lbound(box.min_);
+  aabb.max_.ubound(box.max_);
+}
+
+template<>
+void BVHModel<OBB>::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  CollisionGeometry::computeAABB(tf, aabb);
+  if(num_bvs > 0)
+    clipByOrientedBox(tf, bvs[0].bv.To, bvs[0].bv.axis, bvs[0].bv.extent, aabb);
+}
+
+template<>
+void BVHModel<RSS>::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  CollisionGeometry::computeAABB(tf, aabb);
+  if(num_bvs > 0)
+  {
+    // Tr is a corner of the rectangle
+    const RSS& rss = bvs[0].bv;
+    Vec3f center = rss.Tr + rss.axis[0] * (0.5 * rss.l[0]) + rss.axis[1] * (0.5 * rss.l[1]);
+    clipByOrientedBox(tf, center, rss.axis, Vec3f(0.5 * rss.l[0] + rss.r, 0.5 * rss.l[1] + rss.r, rss.r), aabb);
+  }
+}
+
+template<>
+void BVHModel<OBBRSS>::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  CollisionGeometry::computeAABB(tf, aabb);
+  if(num_bvs > 0)
+    clipByOrientedBox(tf, bvs[0].bv.obb.To, bvs[0].bv.obb.axis, bvs[0].bv.obb.extent, aabb);
+}
+
+template<>
+void BVHModel<kIOS>::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  CollisionGeometry::computeAABB(tf, aabb);
+  if(num_bvs > 0)
+    clipByOrientedBox(tf, bvs[0].bv.obb.To, bvs[0].bv.obb.axis, bvs[0].bv.obb.extent, aabb);
+}
+
 template<>
 void BVHModel<OBB>::makeParentRelativeRecurse(int bv_id, Vec3f parent_axis[], const Vec3f& parent_c)
 {
@@ -0,0 +1,299 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "fcl/BVH/BVH_serialization.h"
+#include "fcl/BV/BV.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string.h>
+
+#if defined(_WIN32)
+#  include <boost/shared_array.hpp>
+#else
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace fcl
+{
+
+namespace
+{
+
+const char BVH_FILE_MAGIC[8] = {'F', 'C', 'L', 'B', 'V', 'H', 0, 0};
+const FCL_UINT32 BVH_FILE_BYTE_ORDER = 0x01020304;
+
+FCL_UINT64 alignOffset(FCL_UINT64 offset)
+{
+  return (offset + BVH_FILE_ALIGNMENT - 1) / BVH_FILE_ALIGNMENT * BVH_FILE_ALIGNMENT;
+}
+
+/// @brief Read-only view of a whole file, memory mapped where possible
+class MappedFile
+{
+public:
+  MappedFile() : data_(NULL), size_(0) {}
+
+  ~MappedFile()
+  {
+#if !defined(_WIN32)
+    if(data_) munmap(data_, size_);
+#endif
+  }
+
+  bool open(const std::string& file_name)
+  {
+#if defined(_WIN32)
+    std::ifstream in(file_name.c_str(), std::ios::binary | std::ios::ate);
+    if(!in) return false;
+    size_ = (std::size_t)in.tellg();
+    buffer_.reset(new char[size_ + 1]);
+    in.seekg(0);
+    if(!in.read(buffer_.get(), size_)) return false;
+    data_ = buffer_.get();
+    return true;
+#else
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+      close(fd);
+      return false;
+    }
+
+    size_ = (std::size_t)st.st_size;
+    void* data = mmap(NULL, size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED) return false;
+    data_ = (char*)data;
+    return true;
+#endif
+  }
+
+  const char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+private:
+  MappedFile(const MappedFile&);
+  MappedFile& operator = (const MappedFile&);
+
+  char* data_;
+  std::size_t size_;
+#if defined(_WIN32)
+  boost::shared_array<char> buffer_;
+#endif
+};
+
+/// @brief Whether an array of num elements of size bytes at offset lies inside a file of file_size bytes
+bool validArray(FCL_UINT64 offset, FCL_INT32 num, FCL_UINT64 size, FCL_UINT64 file_size)
+{
+  if(num < 0 || offset % BVH_FILE_ALIGNMENT != 0) return false;
+  return offset <= file_size && (FCL_UINT64)num * size <= file_size - offset;
+}
+
+}
+
+template<typename BV>
+int saveBVHModel(const BVHModel<BV>& model, const std::string& file_name)
+{
+  if(model.build_state != BVH_BUILD_STATE_PROCESSED && model.build_state != BVH_BUILD_STATE_UPDATED)
+  {
+    std::cerr << "BVH Error! Only models with a built hierarchy can be saved." << std::endl;
+    return BVH_ERR_BUILD_EMPTY_MODEL;
+  }
+
+  BVHFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, BVH_FILE_MAGIC, sizeof(header.magic));
+  header.version = BVH_FILE_VERSION;
+  header.byte_order = BVH_FILE_BYTE_ORDER;
+
+  header.node_type = model.getNodeType();
+  header.real_size = sizeof(FCL_REAL);
+  header.vertex_size = sizeof(Vec3f);
+  header.triangle_size = sizeof(Triangle);
+  header.node_size = sizeof(BVNode<BV>);
+
+  header.num_vertices = model.num_vertices;
+  header.num_tris = model.tri_indices ? model.num_tris : 0;
+  header.num_primitives = model.primitive_indices ? model.getNumPrimitives() : 0;
+  header.num_bvs = model.num_bvs;
+
+  header.vertices_offset = alignOffset(sizeof(BVHFileHeader));
+  header.tri_indices_offset = alignOffset(header.vertices_offset + (FCL_UINT64)header.num_vertices * sizeof(Vec3f));
+  header.primitive_indices_offset = alignOffset(header.tri_indices_offset + (FCL_UINT64)header.num_tris * sizeof(Triangle));
+  header.bvs_offset = alignOffset(header.primitive_indices_offset + (FCL_UINT64)header.num_primitives * sizeof(unsigned int));
+  header.file_size = header.bvs_offset + (FCL_UINT64)header.num_bvs * sizeof(BVNode<BV>);
+
+  for(int i = 0; i < 3; ++i)
+  {
+    header.aabb_min[i] = model.aabb_local.min_[i];
+    header.aabb_max[i] = model.aabb_local.max_[i];
+    header.aabb_center[i] = model.aabb_center[i];
+  }
+  header.aabb_radius = model.aabb_radius;
+  header.cost_density = model.cost_density;
+  header.threshold_occupied = model.threshold_occupied;
+  header.threshold_free = model.threshold_free;
+
+  std::ofstream out(file_name.c_str(), std::ios::binary | std::ios::trunc);
+  if(!out)
+  {
+    std::cerr << "BVH Error! Cannot open " << file_name << " for writing." << std::endl;
+    return BVH_ERR_FILE_IO;
+  }
+
+  // the gaps between the arrays are zero filled
+  const char padding[BVH_FILE_ALIGNMENT] = {0};
+
+  out.write((const char*)&header, sizeof(header));
+  out.write(padding, header.vertices_offset - sizeof(header));
+  out.write((const char*)model.vertices, (std::streamsize)header.num_vertices * sizeof(Vec3f));
+  out.write(padding, header.tri_indices_offset - (header.vertices_offset + (FCL_UINT64)header.num_vertices * sizeof(Vec3f)));
+  out.write((const char*)model.tri_indices, (std::streamsize)header.num_tris * sizeof(Triangle));
+  out.write(padding, header.primitive_indices_offset - (header.tri_indices_offset + (FCL_UINT64)header.num_tris * sizeof(Triangle)));
+  out.write((const char*)model.primitive_indices, (std::streamsize)header.num_primitives * sizeof(unsigned int));
+  out.write(padding, header.bvs_offset - (header.primitive_indices_offset + (FCL_UINT64)header.num_primitives * sizeof(unsigned int)));
+  out.write((const char*)model.bvs, (std::streamsize)header.num_bvs * sizeof(BVNode<BV>));
+
+  if(!out)
+  {
+    std::cerr << "BVH Error! Writing " << file_name << " failed." << std::endl;
+    return BVH_ERR_FILE_IO;
+  }
+
+  return BVH_OK;
+}
+
+template<typename BV>
+int loadBVHModel(const std::string& file_name, BVHModel<BV>& model)
+{
+  boost::shared_ptr<MappedFile> file(new MappedFile());
+  if(!file->open(file_name) || file->size() < sizeof(BVHFileHeader))
+  {
+    std::cerr << "BVH Error! Cannot map " << file_name << "." << std::endl;
+    return BVH_ERR_FILE_IO;
+  }
+
+  const char* data = file->data();
+  BVHFileHeader header;
+  memcpy(&header, data, sizeof(header));
+
+  if(memcmp(header.magic, BVH_FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != BVH_FILE_VERSION ||
+     header.byte_order != BVH_FILE_BYTE_ORDER)
+  {
+    std::cerr << "BVH Error! " << file_name << " is not a BVH model file of version " << BVH_FILE_VERSION << " for this machine." << std::endl;
+    return BVH_ERR_INCORRECT_DATA;
+  }
+
+  if(header.node_type != model.getNodeType() || header.real_size != sizeof(FCL_REAL) ||
+     header.vertex_size != sizeof(Vec3f) || header.triangle_size != sizeof(Triangle) ||
+     header.node_size != sizeof(BVNode<BV>))
+  {
+    std::cerr << "BVH Error! " << file_name << " was saved for another BV type or floating point precision." << std::endl;
+    return BVH_ERR_INCORRECT_DATA;
+  }
+
+  FCL_UINT64 file_size = file->size();
+  if(header.file_size != file_size ||
+     !validArray(header.vertices_offset, header.num_vertices, sizeof(Vec3f), file_size) ||
+     !validArray(header.tri_indices_offset, header.num_tris, sizeof(Triangle), file_size) ||
+     !validArray(header.primitive_indices_offset, header.num_primitives, sizeof(unsigned int), file_size) ||
+     !validArray(header.bvs_offset, header.num_bvs, sizeof(BVNode<BV>), file_size))
+  {
+    std::cerr << "BVH Error! " << file_name << " is truncated or corrupted." << std::endl;
+    return BVH_ERR_INCORRECT_DATA;
+  }
+
+  model.releaseData();
+
+  model.num_vertices = model.num_vertices_allocated = header.num_vertices;
+  model.num_tris = model.num_tris_allocated = header.num_tris;
+  model.num_bvs = model.num_bvs_allocated = header.num_bvs;
+
+  // the model only reads the arrays until it detaches from the mapping
+  model.vertices = header.num_vertices ? (Vec3f*)(data + header.vertices_offset) : NULL;
+  model.tri_indices = header.num_tris ? (Triangle*)(data + header.tri_indices_offset) : NULL;
+  model.primitive_indices = header.num_primitives ? (unsigned int*)(data + header.primitive_indices_offset) : NULL;
+  model.bvs = header.num_bvs ? (BVNode<BV>*)(data + header.bvs_offset) : NULL;
+  model.shared_storage.reset(new details::BVHSharedStorage<BV>());
+  model.shared_storage->vertices = model.vertices;
+  model.shared_storage->tri_indices = model.tri_indices;
+  model.shared_storage->primitive_indices = model.primitive_indices;
+  model.shared_storage->bvs = model.bvs;
+  model.shared_storage->mapping = file;
+
+  model.build_state = BVH_BUILD_STATE_PROCESSED;
+
+  for(int i = 0; i < 3; ++i)
+  {
+    model.aabb_local.min_[i] = header.aabb_min[i];
+    model.aabb_local.max_[i] = header.aabb_max[i];
+    model.aabb_center[i] = header.aabb_center[i];
+  }
+  model.aabb_radius = header.aabb_radius;
+  model.cost_density = header.cost_density;
+  model.threshold_occupied = header.threshold_occupied;
+  model.threshold_free = header.threshold_free;
+
+  model.updateTriangleCache();
+
+  return BVH_OK;
+}
+
+template int saveBVHModel(const BVHModel<KDOP<16> >& model, const std::string& file_name);
+template int saveBVHModel(const BVHModel<KDOP<18> >& model, const std::string& file_name);
+template int saveBVHModel(const BVHModel<KDOP<24> >& model, const std::string& file_name);
+template int saveBVHModel(const BVHModel<OBB>& model, const std::string& file_name);
+template int saveBVHModel(const BVHModel<AABB>& model, const std::string& file_name);
+template int saveBVHModel(const BVHModel<RSS>& model, const std::string& file_name);
+template int saveBVHModel(const BVHModel<kIOS>& model, const std::string& file_name);
+template int saveBVHModel(const BVHModel<OBBRSS>& model, const std::string& file_name);
+
+template int loadBVHModel(const std::string& file_name, BVHModel<KDOP<16> >& model);
+template int loadBVHModel(const std::string& file_name, BVHModel<KDOP<18> >& model);
+template int loadBVHModel(const std::string& file_name, BVHModel<KDOP<24> >& model);
+template int loadBVHModel(const std::string& file_name, BVHModel<OBB>& model);
+template int loadBVHModel(const std::string& file_name, BVHModel<AABB>& model);
+template int loadBVHModel(const std::string& file_name, BVHModel<RSS>& model);
+template int loadBVHModel(const std::string& file_name, BVHModel<kIOS>& model);
+template int loadBVHModel(const std::string& file_name, BVHModel<OBBRSS>& model);
+
+}
@@ -0,0 +1,121 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "fcl/BVH/BVH_triangle_cache.h"
+
+namespace fcl
+{
+
+const int TriangleCache::ALIGNMENT;
+
+TriangleCache::TriangleCache() : data(NULL), stride(0), num_tris(0)
+{
+}
+
+TriangleCache::TriangleCache(const TriangleCache& other) : buffer(other.buffer),
+                                                           data(other.data),
+                                                           stride(other.stride),
+                                                           num_tris(other.num_tris)
+{
+}
+
+TriangleCache& TriangleCache::operator = (const TriangleCache& other)
+{
+  buffer = other.buffer;
+  data = other.data;
+  stride = other.stride;
+  num_tris = other.num_tris;
+
+  return *this;
+}
+
+void TriangleCache::allocate(int n)
+{
+  if(n != num_tris || (buffer && !buffer.unique()))
+  {
+    buffer.reset();
+    data = NULL;
+    stride = 0;
+    num_tris = n;
+
+    if(n == 0) return;
+
+    // pad each array so that the next one starts aligned as well
+    const int values_per_alignment = ALIGNMENT / sizeof(FCL_REAL);
+    stride = (n + values_per_alignment - 1) / values_per_alignment * values_per_alignment;
+
+    buffer.reset(new FCL_REAL[4 * stride + values_per_alignment]);
+    std::size_t misalignment = reinterpret_cast<std::size_t>(buffer.get()) % ALIGNMENT;
+    data = buffer.get() + ((misalignment == 0) ? 0 : (ALIGNMENT - misalignment) / sizeof(FCL_REAL));
+  }
+}
+
+void TriangleCache::build(const Vec3f* vertices, const Triangle* triangles, int num_triangles)
+{
+  allocate(num_triangles);
+
+  FCL_REAL* nx = data;
+  FCL_REAL* ny = data + stride;
+  FCL_REAL* nz = data + 2 * stride;
+  FCL_REAL* t = data + 3 * stride;
+
+  for(int i = 0; i < num_triangles; ++i)
+  {
+    const Triangle& tri = triangles[i];
+    const Vec3f& p1 = vertices[tri[0]];
+    Vec3f n = (vertices[tri[1]] - p1).cross(vertices[tri[2]] - p1);
+
+    bool can_normalize = false;
+    n.normalize(&can_normalize);
+    if(!can_normalize) n.setValue(0);
+
+    nx[i] = n[0];
+    ny[i] = n[1];
+    nz[i] = n[2];
+    t[i] = n.dot(p1);
+  }
+}
+
+void TriangleCache::clear()
+{
+  allocate(0);
+}
+
+int TriangleCache::memUsage() const
+{
+  return (buffer) ? sizeof(FCL_REAL) * (4 * stride + ALIGNMENT / sizeof(FCL_REAL)) : 0;
+}
+
+}
@@ -36,6 +36,7 @@
 
 
 #include "fcl/BVH/BVH_utility.h"
+#include "fcl/math/point_batch.h"
 
 namespace fcl
 {
@@ -103,85 +104,75 @@ void BVHExpand(BVHModel<RSS>& model, const Variance3f* ucs, FCL_REAL r = 1.0)
 }
 
 
-void getCovariance(Vec3f* ps, Vec3f* ps2, Triangle* ts, unsigned int* indices, int n, Matrix3f& M)
+/// @brief Stream the points used by a set or subset of primitives (the triangle vertices, or the points themselves, in
+/// both frames when ps2 is given) through point blocks, calling the visitor on every block
+template<typename Visitor>
+static void visitPointBlocks(Vec3f* ps, Vec3f* ps2, Triangle* ts, unsigned int* indices, int n, Visitor& visitor)
 {
-  Vec3f S1;
-  Vec3f S2[3];
+  int points_per_primitive = ((ps2) ? 2 : 1) * ((ts) ? 3 : 1);
 
-  if(ts)
+  PointBlock block;
+  for(int i = 0; i < n; ++i)
   {
-    for(int i = 0; i < n; ++i)
+    if(!block.hasRoom(points_per_primitive))
     {
-      const Triangle& t = (indices) ? ts[indices[i]] : ts[i];
-
-      const Vec3f& p1 = ps[t[0]];
-      const Vec3f& p2 = ps[t[1]];
-      const Vec3f& p3 = ps[t[2]];
-
-      S1[0] += (p1[0] + p2[0] + p3[0]);
-      S1[1] += (p1[1] + p2[1] + p3[1]);
-      S1[2] += (p1[2] + p2[2] + p3[2]);
-      S2[0][0] += (p1[0] * p1[0] + p2[0] * p2[0] + p3[0] * p3[0]);
-      S2[1][1] += (p1[1] * p1[1] + p2[1] * p2[1] + p3[1] * p3[1]);
-      S2[2][2] += (p1[2] * p1[2] + p2[2] * p2[2] + p3[2] * p3[2]);
-      S2[0][1] += (p1[0] * p1[1] + p2[0] * p2[1] + p3[0] * p3[1]);
-      S2[0][2] += (p1[0] * p1[2] + p2[0] * p2[2] + p3[0] * p3[2]);
-      S2[1][2] += (p1[1] * p1[2] + p2[1] * p2[2] + p3[1] * p3[2]);
+      visitor(block);
+      block.clear();
+    }
 
+    unsigned int index = (indices) ? indices[i] : i;
+    if(ts)
+    {
+      const Triangle& t = ts[index];
+      block.push_back(ps[t[0]]);
+      block.push_back(ps[t[1]]);
+      block.push_back(ps[t[2]]);
       if(ps2)
       {
-        const Vec3f& p1 = ps2[t[0]];
-        const Vec3f& p2 = ps2[t[1]];
-        const Vec3f& p3 = ps2[t[2]];
-
-        S1[0] += (p1[0] + p2[0] + p3[0]);
-        S1[1] += (p1[1] + p2[1] + p3[1]);
-        S1[2] += (p1[2] + p2[2] + p3[2]);
-
-        S2[0][0] += (p1[0] * p1[0] + p2[0] * p2[0] + p3[0] * p3[0]);
-        S2[1][1] += (p1[1] * p1[1] + p2[1] * p2[1] + p3[1] * p3[1]);
-        S2[2][2] += (p1[2] * p1[2] + p2[2] * p2[2] + p3[2] * p3[2]);
-        S2[0][1] += (p1[0] * p1[1] + p2[0] * p2[1] + p3[0] * p3[1]);
-        S2[0][2] += (p1[0] * p1[2] + p2[0] * p2[2] + p3[0] * p3[2]);
-        S2[1][2] += (p1[1] * p1[2] + p2[1] * p2[2] + p3[1] * p3[2]);
+        block.push_back(ps2[t[0]]);
+        block.push_back(ps2[t[1]]);
+        block.push_back(ps2[t[2]]);
       }
     }
-  }
-  else
-  {
-    for(int i = 0; i < n; ++i)
+    else
     {
-      const Vec3f& p = (indices) ? ps[indices[i]] : ps[i];
-      S1 += p;
-      S2[0][0] += (p[0] * p[0]);
-      S2[1][1] += (p[1] * p[1]);
-      S2[2][2] += (p[2] * p[2]);
-      S2[0][1] += (p[0] * p[1]);
-      S2[0][2] += (p[0] * p[2]);
-      S2[1][2] += (p[1] * p[2]);
-
-      if(ps2) // another frame
-      {
-        const Vec3f& p = (indices) ? ps2[indices[i]] : ps2[i];
-        S1 += p;
-        S2[0][0] += (p[0] * p[0]);
-        S2[1][1] += (p[1] * p[1]);
-        S2[2][2] += (p[2] * p[2]);
-        S2[0][1] += (p[0] * p[1]);
-        S2[0][2] += (p[0] * p[2]);
-        S2[1][2] += (p[1] * p[2]);
-      }
+      block.push_back(ps[index]);
+      if(ps2) block.push_back(ps2[index]);
     }
   }
 
+  if(!block.empty()) visitor(block);
+}
+
+struct MomentVisitor
+{
+  Vec3f S1;
+  Matrix3f S2;
+
+  MomentVisitor() : S2(0, 0, 0, 0, 0, 0, 0, 0, 0) {}
+
+  void operator () (const PointBlock& block)
+  {
+    accumulatePointMoments(block, S1, S2);
+  }
+};
+
+void getCovariance(Vec3f* ps, Vec3f* ps2, Triangle* ts, unsigned int* indices, int n, Matrix3f& M)
+{
+  MomentVisitor moments;
+  visitPointBlocks(ps, ps2, ts, indices, n, moments);
+
+  const Vec3f& S1 = moments.S1;
+  const Matrix3f& S2 = moments.S2;
+
   int n_points = ((ps2) ? 2 : 1) * ((ts) ? 3 : 1) * n;
 
-  M(0, 0) = S2[0][0] - S1[0]*S1[0] / n_points;
-  M(1, 1) = S2[1][1] - S1[1]*S1[1] / n_points;
-  M(2, 2) = S2[2][2] - S1[2]*S1[2] / n_points;
-  M(0, 1) = S2[0][1] - S1[0]*S1[1] / n_points;
-  M(1, 2) = S2[1][2] - S1[1]*S1[2] / n_points;
-  M(0, 2) = S2[0][2] - S1[0]*S1[2] / n_points;
+  M(0, 0) = S2(0, 0) - S1[0]*S1[0] / n_points;
+  M(1, 1) = S2(1, 1) - S1[1]*S1[1] / n_points;
+  M(2, 2) = S2(2, 2) - S1[2]*S1[2] / n_points;
+  M(0, 1) = S2(0, 1) - S1[0]*S1[1] / n_points;
+  M(1, 2) = S2(1, 2) - S1[1]*S1[2] / n_points;
+  M(0, 2) = S2(0, 2) - S1[0]*S1[2] / n_points;
   M(1, 0) = M(0, 1);
   M(2, 0) = M(0, 2);
   M(2, 1) = M(1, 2);
@@ -468,50 +459,34 @@ void getRadiusAndOriginAndRectangleSize(Vec3f* ps, Vec3f* ps2, Triangle* ts, uns
 }
 
 
-/** \brief Compute the bounding volume extent and center for a set or subset of points.
- * The bounding volume axes are known.
- */
-static inline void getExtentAndCenter_pointcloud(Vec3f* ps, Vec3f* ps2, unsigned int* indices, int n, Vec3f axis[3], Vec3f& center, Vec3f& extent)
+/// @brief Bounds of the points projected on the BV axes
+struct ProjectedBoundVisitor
 {
-  bool indirect_index = true;
-  if(!indices) indirect_index = false;
-
-  FCL_REAL real_max = std::numeric_limits<FCL_REAL>::max();
-
-  FCL_REAL min_coord[3] = {real_max, real_max, real_max};
-  FCL_REAL max_coord[3] = {-real_max, -real_max, -real_max};
+  Matrix3f axes;
+  Vec3f min_coord;
+  Vec3f max_coord;
 
-  for(int i = 0; i < n; ++i)
+  ProjectedBoundVisitor(const Vec3f axis[3]) : axes(axis[0], axis[1], axis[2]),
+                                               min_coord(std::numeric_limits<FCL_REAL>::max()),
+                                               max_coord(-std::numeric_limits<FCL_REAL>::max())
   {
-    int index = indirect_index ? indices[i] : i;
+  }
 
-    const Vec3f& p = ps[index];
-    Vec3f v(p[0], p[1], p[2]);
-    FCL_REAL proj[3];
-    proj[0] = axis[0].dot(v);
-    proj[1] = axis[1].dot(v);
-    proj[2] = axis[2].dot(v);
+  void operator () (const PointBlock& block)
+  {
+    PointBlock proj;
+    transformPoints(axes, Vec3f(), block, proj);
+    boundPoints(proj, min_coord, max_coord);
+  }
+};
 
-    for(int j = 0; j < 3; ++j)
-    {
-      if(proj[j] > max_coord[j]) max_coord[j] = proj[j];
-      if(proj[j] < min_coord[j]) min_coord[j] = proj[j];
-    }
+void getExtentAndCenter(Vec3f* ps, Vec3f* ps2, Triangle* ts, unsigned int* indices, int n, Vec3f axis[3], Vec3f& center, Vec3f& extent)
+{
+  ProjectedBoundVisitor bounds(axis);
+  visitPointBlocks(ps, ps2, ts, indices, n, bounds);
 
-    if(ps2)
-    {
-      const Vec3f& v = ps2[index];
-      proj[0] = axis[0].dot(v);
-      proj[1] = axis[1].dot(v);
-      proj[2] = axis[2].dot(v);
-
-      for(int j = 0; j < 3; ++j)
-      {
-        if(proj[j] > max_coord[j]) max_coord[j] = proj[j];
-        if(proj[j] < min_coord[j]) min_coord[j] = proj[j];
-      }
-    }
-  }
+  const Vec3f& min_coord = bounds.min_coord;
+  const Vec3f& max_coord = bounds.max_coord;
 
   Vec3f o((max_coord[0] + min_coord[0]) / 2,
           (max_coord[1] + min_coord[1]) / 2,
@@ -522,86 +497,30 @@ static inline void getExtentAndCenter_pointcloud(Vec3f* ps, Vec3f* ps2, unsigned
   extent.setValue((max_coord[0] - min_coord[0]) / 2,
                   (max_coord[1] - min_coord[1]) / 2,
                   (max_coord[2] - min_coord[2]) / 2);
-
 }
 
 
-/** \brief Compute the bounding volume extent and center for a set or subset of points.
- * The bounding volume axes are known.
- */
-static inline void getExtentAndCenter_mesh(Vec3f* ps, Vec3f* ps2, Triangle* ts, unsigned int* indices, int n, Vec3f axis[3], Vec3f& center, Vec3f& extent)
+/// @brief Bounds of the points in the frame they are given in
+struct BoundVisitor
 {
-  bool indirect_index = true;
-  if(!indices) indirect_index = false;
+  Vec3f& min;
+  Vec3f& max;
 
-  FCL_REAL real_max = std::numeric_limits<FCL_REAL>::max();
+  BoundVisitor(Vec3f& min_, Vec3f& max_) : min(min_), max(max_) {}
 
-  FCL_REAL min_coord[3] = {real_max, real_max, real_max};
-  FCL_REAL max_coord[3] = {-real_max, -real_max, -real_max};
-
-  for(int i = 0; i < n; ++i)
+  void operator () (const PointBlock& block)
   {
-    unsigned int index = indirect_index? indices[i] : i;
-    const Triangle& t = ts[index];
-
-    for(int j = 0; j < 3; ++j)
-    {
-      int point_id = static_cast<int>(t[j]);
-      const Vec3f& p = ps[point_id];
-      Vec3f v(p[0], p[1], p[2]);
-      FCL_REAL proj[3];
-      proj[0] = axis[0].dot(v);
-      proj[1] = axis[1].dot(v);
-      proj[2] = axis[2].dot(v);
-
-      for(int k = 0; k < 3; ++k)
-      {
-        if(proj[k] > max_coord[k]) max_coord[k] = proj[k];
-        if(proj[k] < min_coord[k]) min_coord[k] = proj[k];
-      }
-    }
-
-    if(ps2)
-    {
-      for(int j = 0; j < 3; ++j)
-      {
-        int point_id = static_cast<int>(t[j]);
-        const Vec3f& p = ps2[point_id];
-        Vec3f v(p[0], p[1], p[2]);
-        FCL_REAL proj[3];
-        proj[0] = axis[0].dot(v);
-        proj[1] = axis[1].dot(v);
-        proj[2] = axis[2].dot(v);
-
-        for(int k = 0; k < 3; ++k)
-        {
-          if(proj[k] > max_coord[k]) max_coord[k] = proj[k];
-          if(proj[k] < min_coord[k]) min_coord[k] = proj[k];
-        }
-      }
-    }
+    boundPoints(block, min, max);
   }
+};
 
-  Vec3f o((max_coord[0] + min_coord[0]) / 2,
-          (max_coord[1] + min_coord[1]) / 2,
-          (max_coord[2] + min_coord[2]) / 2);
-
-  center = axis[0] * o[0] + axis[1] * o[1] + axis[2] * o[2];
-
-  extent.setValue((max_coord[0] - min_coord[0]) / 2,
-                  (max_coord[1] - min_coord[1]) / 2,
-                  (max_coord[2] - min_coord[2]) / 2);
-
-}
-
-void getExtentAndCenter(Vec3f* ps, Vec3f* ps2, Triangle* ts, unsigned int* indices, int n, Vec3f axis[3], Vec3f& center, Vec3f& extent)
+void getBoundingBox(Vec3f* ps, Vec3f* ps2, Triangle* ts, unsigned int* indices, int n, Vec3f& min, Vec3f& max)
 {
-  if(ts)
-    getExtentAndCenter_mesh(ps, ps2, ts, indices, n, axis, center, extent);
-  else
-    getExtentAndCenter_pointcloud(ps, ps2, indices, n, axis, center, extent);
+  BoundVisitor bounds(min, max);
+  visitPointBlocks(ps, ps2, ts, indices, n, bounds);
 }
 
+
 void circumCircleComputation(const Vec3f& a, const Vec3f& b, const Vec3f& c, Vec3f& center, FCL_REAL& radius)
 {
   Vec3f e1 = a - c;
@@ -42,11 +42,11 @@ namespace fcl
 {
 
 
-static const double kIOS_RATIO = 1.5;
-static const double invSinA = 2;
-static const double invCosA = 2.0 / sqrt(3.0);
-static const double sinA = 0.5;
-static const double cosA = sqrt(3.0) / 2.0;
+static const FCL_REAL kIOS_RATIO = 1.5;
+static const FCL_REAL invSinA = 2;
+static const FCL_REAL invCosA = 2.0 / sqrt(3.0);
+static const FCL_REAL sinA = 0.5;
+static const FCL_REAL cosA = sqrt(3.0) / 2.0;
 
 static inline void axisFromEigen(Vec3f eigenV[3], Matrix3f::U eigenS[3], Vec3f axis[3])
 {
@@ -516,6 +516,18 @@ void fit(Vec3f* ps, int n, OBBRSS& bv)
 }
 
 
+AABB BVFitter<AABB>::fit(unsigned int* primitive_indices, int num_primitives)
+{
+  AABB bv;
+
+  if(type == BVH_MODEL_TRIANGLES)
+    getBoundingBox(vertices, prev_vertices, tri_indices, primitive_indices, num_primitives, bv.min_, bv.max_);
+  else if(type == BVH_MODEL_POINTCLOUD)
+    getBoundingBox(vertices, prev_vertices, NULL, primitive_indices, num_primitives, bv.min_, bv.max_);
+
+  return bv;
+}
+
 OBB BVFitter<OBB>::fit(unsigned int* primitive_indices, int num_primitives)
 {
   OBB bv;
@@ -0,0 +1,209 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \author Dalibor Matura, Jia Pan */
+
+#include "fcl/articulated_model/compiled_model.h"
+#include "fcl/articulated_model/model.h"
+#include "fcl/articulated_model/model_config.h"
+
+#include <boost/assert.hpp>
+
+namespace fcl
+{
+
+/// @brief Rotation by angle around the unit axis (Rodrigues formula)
+static inline void axisAngleRotation(const Vec3f& axis, FCL_REAL angle, Matrix3f& R)
+{
+  FCL_REAL s = std::sin(angle);
+  FCL_REAL c = std::cos(angle);
+  FCL_REAL t = 1 - c;
+  FCL_REAL x = axis[0], y = axis[1], z = axis[2];
+
+  R.setValue(t * x * x + c,     t * x * y - s * z, t * x * z + s * y,
+             t * x * y + s * z, t * y * y + c,     t * y * z - s * x,
+             t * x * z - s * y, t * y * z + s * x, t * z * z + c);
+}
+
+CompiledModel::CompiledModel(const Model& model) : num_dofs_(0)
+{
+  std::size_t num_joints = model.getNumJoints();
+  parents_.reserve(num_joints);
+  types_.reserve(num_joints);
+  rotations_to_parent_.reserve(num_joints);
+  translations_to_parent_.reserve(num_joints);
+  axes_.reserve(num_joints);
+  dof_offsets_.reserve(num_joints + 1);
+  names_.reserve(num_joints);
+
+  boost::shared_ptr<Link> root = model.getRoot();
+  if(!root)
+    throw ModelParseError("Model must be initialized before it is compiled.");
+
+  // breadth first from the root, so that every joint comes after its parent; frontier holds the links whose child
+  // joints are not added yet, together with the id of their parent joint
+  std::vector<std::pair<boost::shared_ptr<const Link>, int> > frontier;
+  frontier.push_back(std::make_pair(boost::shared_ptr<const Link>(root), -1));
+
+  for(std::size_t i = 0; i < frontier.size(); ++i)
+  {
+    std::vector<boost::shared_ptr<Joint> > child_joints = frontier[i].first->getChildJoints();
+    int parent_id = frontier[i].second;
+
+    for(std::size_t j = 0; j < child_joints.size(); ++j)
+    {
+      const boost::shared_ptr<Joint>& joint = child_joints[j];
+      if(joint_ids_.find(joint->getName()) != joint_ids_.end())
+        continue;
+
+      int id = (int)parents_.size();
+      const Transform3f& tf = joint->getTransformToParent();
+
+      parents_.push_back(parent_id);
+      types_.push_back(joint->getJointType());
+      rotations_to_parent_.push_back(tf.getRotation());
+      translations_to_parent_.push_back(tf.getTranslation());
+
+      Vec3f axis;
+      if(joint->getJointType() == JT_PRISMATIC)
+        axis = tf.getRotation() * joint->getAxis();
+      else if(joint->getJointType() == JT_REVOLUTE)
+        axis = joint->getAxis();
+      axes_.push_back(axis);
+
+      dof_offsets_.push_back(num_dofs_);
+      num_dofs_ += joint->getNumDofs();
+      names_.push_back(joint->getName());
+      joint_ids_[joint->getName()] = id;
+
+      boost::shared_ptr<const Link> child_link = joint->getChildLink();
+      if(child_link)
+      {
+        link_joint_ids_[child_link->getName()] = id;
+        frontier.push_back(std::make_pair(child_link, id));
+      }
+    }
+  }
+
+  dof_offsets_.push_back(num_dofs_);
+
+  if(parents_.size() != num_joints)
+    throw ModelParseError("Some joints are not connected to the root link [" + root->getName() + "]");
+}
+
+int CompiledModel::getJointId(const std::string& name) const
+{
+  std::map<std::string, int>::const_iterator it = joint_ids_.find(name);
+  return (it == joint_ids_.end()) ? -1 : it->second;
+}
+
+int CompiledModel::getLinkJointId(const std::string& name) const
+{
+  std::map<std::string, int>::const_iterator it = link_joint_ids_.find(name);
+  return (it == link_joint_ids_.end()) ? -1 : it->second;
+}
+
+void CompiledModel::getDofs(const ModelConfig& model_cfg, std::vector<FCL_REAL>& dofs) const
+{
+  dofs.resize(num_dofs_);
+  for(std::size_t i = 0; i < names_.size(); ++i)
+  {
+    JointConfig joint_cfg = model_cfg.getJointConfig(names_[i]);
+    for(std::size_t k = dof_offsets_[i]; k < dof_offsets_[i + 1]; ++k)
+      dofs[k] = joint_cfg[k - dof_offsets_[i]];
+  }
+}
+
+void CompiledModel::setDofs(const std::vector<FCL_REAL>& dofs, ModelConfig& model_cfg) const
+{
+  BOOST_ASSERT(dofs.size() == num_dofs_);
+  for(std::size_t i = 0; i < names_.size(); ++i)
+  {
+    JointConfig& joint_cfg = model_cfg.getJointConfig(names_[i]);
+    for(std::size_t k = dof_offsets_[i]; k < dof_offsets_[i + 1]; ++k)
+      joint_cfg[k - dof_offsets_[i]] = dofs[k];
+  }
+}
+
+void CompiledModel::forwardKinematics(const FCL_REAL* dofs, KinematicsResult& result) const
+{
+  std::size_t num_joints = parents_.size();
+  result.rotations.resize(num_joints);
+  result.translations.resize(num_joints);
+
+  Matrix3f local_R;
+  Vec3f local_T;
+
+  for(std::size_t i = 0; i < num_joints; ++i)
+  {
+    const FCL_REAL* q = dofs + dof_offsets_[i];
+
+    // same local transforms as the getLocalTransform() of the joint classes
+    switch(types_[i])
+    {
+    case JT_PRISMATIC:
+      local_R = rotations_to_parent_[i];
+      local_T = translations_to_parent_[i] + axes_[i] * q[0];
+      break;
+    case JT_REVOLUTE:
+      axisAngleRotation(axes_[i], q[0], local_R);
+      local_R = rotations_to_parent_[i] * local_R;
+      local_T = translations_to_parent_[i];
+      break;
+    case JT_BALLEULER:
+      local_R.setEulerYPR(q[0], q[1], q[2]);
+      local_R = rotations_to_parent_[i] * local_R;
+      local_T = translations_to_parent_[i];
+      break;
+    default:
+      local_R = rotations_to_parent_[i];
+      local_T = translations_to_parent_[i];
+    }
+
+    int parent = parents_[i];
+    if(parent < 0)
+    {
+      result.rotations[i] = local_R;
+      result.translations[i] = local_T;
+    }
+    else
+    {
+      const Matrix3f& parent_R = result.rotations[parent];
+      result.rotations[i] = parent_R * local_R;
+      result.translations[i] = parent_R * local_T + result.translations[parent];
+    }
+  }
+}
+
+}
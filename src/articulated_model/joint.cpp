@@ -228,7 +228,9 @@ BallEulerJoint::BallEulerJoint(const boost::shared_ptr<Link>& link_parent, const
 							   const Transform3f& transform_to_parent,
 							   const std::string& name) :
   Joint(link_parent, link_child, transform_to_parent, name)
-{}
+{
+  type_ = JT_BALLEULER;
+}
 
 std::size_t BallEulerJoint::getNumDofs() const
 {
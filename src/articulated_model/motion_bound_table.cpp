@@ -0,0 +1,189 @@
+#include "fcl/articulated_model/motion_bound_table.h"
+
+#include "fcl/articulated_model/model.h"
+#include "fcl/articulated_model/joint.h"
+#include "fcl/articulated_model/movement.h"
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
+namespace fcl
+{
+
+MotionBoundTable::MotionBoundTable(boost::shared_ptr<const Movement> movement, const std::vector<FCL_REAL>& times) :
+	compiled_model_(*movement->getModel() ),
+	num_joints_(compiled_model_.getNumJoints() ),
+	times_(times)
+{
+	BOOST_ASSERT(times_.size() >= 2 && "At least one time interval is needed");
+
+	init(*movement);
+}
+
+MotionBoundTable::MotionBoundTable(boost::shared_ptr<const Movement> movement, std::size_t num_intervals) :
+	compiled_model_(*movement->getModel() ),
+	num_joints_(compiled_model_.getNumJoints() )
+{
+	if (num_intervals == 0)
+	{
+		num_intervals = 1;
+	}
+
+	times_.resize(num_intervals + 1);
+	for (std::size_t k = 0; k <= num_intervals; ++k)
+	{
+		times_[k] = (FCL_REAL)k / num_intervals;
+	}
+
+	init(*movement);
+}
+
+void MotionBoundTable::init(const Movement& movement)
+{
+	const Model& model = *movement.getModel();
+	std::size_t num_intervals = getNumIntervals();
+
+	std::vector<boost::shared_ptr<const Joint> > joints(num_joints_);
+	for (std::size_t i = 0; i < num_joints_; ++i)
+	{
+		joints[i] = model.getJoint(compiled_model_.getJointName(i) );
+	}
+
+	// per joint data that does not depend on time
+	chain_roots_.resize(num_joints_);
+	chain_distance_bounds_.resize(num_joints_);
+	std::vector<FCL_REAL> child_parent_distance_bounds(num_joints_, 0);
+
+	for (std::size_t i = 0; i < num_joints_; ++i)
+	{
+		int parent = compiled_model_.getParent(i);
+		if (parent < 0)
+		{
+			chain_roots_[i] = i;
+			chain_distance_bounds_[i] = 0;
+		}
+		else
+		{
+			child_parent_distance_bounds[i] = movement.getChildParentDistanceBound(joints[i], joints[parent]);
+			chain_roots_[i] = chain_roots_[parent];
+			chain_distance_bounds_[i] = chain_distance_bounds_[parent] + child_parent_distance_bounds[i];
+		}
+	}
+
+	std::size_t size = num_intervals * num_joints_;
+	linear_velocity_bounds_.resize(size);
+	angular_velocity_bounds_.resize(size);
+	absolute_linear_velocity_bounds_.resize(size);
+	absolute_angular_velocity_bounds_.resize(size);
+	accumulated_angular_bounds_.resize(size);
+	chain_motion_bounds_.resize(size);
+
+	for (std::size_t k = 0; k < num_intervals; ++k)
+	{
+		FCL_REAL start_time = times_[k];
+		FCL_REAL end_time = times_[k + 1];
+
+		for (std::size_t i = 0; i < num_joints_; ++i)
+		{
+			std::size_t id = index(i, k);
+
+			linear_velocity_bounds_[id] = movement.getLinearVelocityBound(joints[i], start_time, end_time);
+			angular_velocity_bounds_[id] = movement.getAngularVelocityBound(joints[i], start_time, end_time);
+			absolute_linear_velocity_bounds_[id] = movement.getAbsoluteLinearVelocityBound(joints[i], start_time, end_time);
+			absolute_angular_velocity_bounds_[id] = movement.getAbsoluteAngularVelocityBound(joints[i], start_time, end_time);
+
+			// parents come first, so their accumulated values are ready
+			int parent = compiled_model_.getParent(i);
+			if (parent < 0)
+			{
+				accumulated_angular_bounds_[id] = absolute_angular_velocity_bounds_[id];
+				chain_motion_bounds_[id] = 0;
+			}
+			else
+			{
+				std::size_t parent_id = index(parent, k);
+
+				accumulated_angular_bounds_[id] = accumulated_angular_bounds_[parent_id] + absolute_angular_velocity_bounds_[id];
+				chain_motion_bounds_[id] = chain_motion_bounds_[parent_id] + absolute_linear_velocity_bounds_[parent_id] +
+					accumulated_angular_bounds_[parent_id] * child_parent_distance_bounds[i];
+			}
+		}
+	}
+}
+
+std::size_t MotionBoundTable::getIntervalIndex(FCL_REAL time) const
+{
+	std::vector<FCL_REAL>::const_iterator it = std::upper_bound(times_.begin() + 1, times_.end() - 1, time);
+
+	return it - (times_.begin() + 1);
+}
+
+FCL_REAL MotionBoundTable::getMotionBound(int joint_id, std::size_t k,
+	const Vec3f& direction, FCL_REAL max_distance_from_joint_center) const
+{
+	std::size_t id = index(joint_id, k);
+
+	FCL_REAL chain_motion_bound = chain_motion_bounds_[id];
+	FCL_REAL accumulated_angular_bound = accumulated_angular_bounds_[id];
+
+	int root = chain_roots_[joint_id];
+	bool is_directional = direction[0] != 0.0 || direction[1] != 0.0 || direction[2] != 0.0;
+
+	// as in LinkBound, the direction only tightens the contribution of the root joint to the chain below it
+	if (is_directional && root != joint_id)
+	{
+		std::size_t root_id = index(root, k);
+
+		FCL_REAL linear_difference = (linear_velocity_bounds_[root_id] * direction).length() -
+			absolute_linear_velocity_bounds_[root_id];
+		FCL_REAL angular_difference = direction.cross(angular_velocity_bounds_[root_id]).length() -
+			absolute_angular_velocity_bounds_[root_id];
+
+		chain_motion_bound += linear_difference + angular_difference * chain_distance_bounds_[joint_id];
+		accumulated_angular_bound += angular_difference;
+	}
+
+	return chain_motion_bound + absolute_linear_velocity_bounds_[id] +
+		accumulated_angular_bound * max_distance_from_joint_center;
+}
+
+FCL_REAL MotionBoundTable::getMotionBound(int joint_id, FCL_REAL start_time, FCL_REAL end_time,
+	const Vec3f& direction, FCL_REAL max_distance_from_joint_center) const
+{
+	if (start_time > end_time)
+	{
+		std::swap(start_time, end_time);
+	}
+
+	std::size_t first = getIntervalIndex(start_time);
+
+	// an end time on an interval boundary belongs to the earlier interval
+	std::vector<FCL_REAL>::const_iterator it = std::lower_bound(times_.begin() + 1, times_.end() - 1, end_time);
+	std::size_t last = std::max(first, (std::size_t)(it - (times_.begin() + 1) ) );
+
+	FCL_REAL motion_bound = 0;
+	for (std::size_t k = first; k <= last; ++k)
+	{
+		motion_bound = std::max(motion_bound,
+			getMotionBound(joint_id, k, direction, max_distance_from_joint_center) );
+	}
+
+	return motion_bound;
+}
+
+void MotionBoundTable::getMotionBounds(const Vec3f& direction, FCL_REAL max_distance_from_joint_center,
+	std::vector<FCL_REAL>& bounds) const
+{
+	bounds.resize(getNumIntervals() * num_joints_);
+
+	for (std::size_t k = 0; k < getNumIntervals(); ++k)
+	{
+		for (std::size_t i = 0; i < num_joints_; ++i)
+		{
+			bounds[index(i, k)] = getMotionBound(i, k, direction, max_distance_from_joint_center);
+		}
+	}
+}
+
+}
@@ -37,6 +37,7 @@
 #include "fcl/broadphase/broadphase_SSaP.h"
 #include <algorithm>
 #include <limits>
+#include "fcl/probe.h"
 
 namespace fcl
 {
@@ -180,7 +181,7 @@ bool SSaPCollisionManager::checkColl(std::vector<CollisionObject*>::const_iterat
   {
     if(*pos_start != obj) // no collision between the same object
     {
-      if((*pos_start)->getAABB().overlap(obj->getAABB()))
+      if((*pos_start)->getAABB().overlap(obj->getAABB()) && canCollide(*pos_start, obj))
       {
         if(callback(*pos_start, obj, cdata))
           return true;
@@ -213,6 +214,9 @@ bool SSaPCollisionManager::checkDis(std::vector<CollisionObject*>::const_iterato
 
 void SSaPCollisionManager::collide(CollisionObject* obj, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   collide_(obj, cdata, callback);
@@ -268,6 +272,9 @@ bool SSaPCollisionManager::collide_(CollisionObject* obj, void* cdata, Collision
 
 void SSaPCollisionManager::distance(CollisionObject* obj, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
@@ -373,6 +380,9 @@ bool SSaPCollisionManager::distance_(CollisionObject* obj, void* cdata, Distance
 
 void SSaPCollisionManager::collide(void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   std::vector<CollisionObject*>::const_iterator pos, run_pos, pos_end;
@@ -413,7 +423,7 @@ void SSaPCollisionManager::collide(void* cdata, CollisionCallBack callback) cons
 
         if((obj->getAABB().max_[axis2] >= obj2->getAABB().min_[axis2]) && (obj2->getAABB().max_[axis2] >= obj->getAABB().min_[axis2]))
         {
-          if((obj->getAABB().max_[axis3] >= obj2->getAABB().min_[axis3]) && (obj2->getAABB().max_[axis3] >= obj->getAABB().min_[axis3]))
+          if((obj->getAABB().max_[axis3] >= obj2->getAABB().min_[axis3]) && (obj2->getAABB().max_[axis3] >= obj->getAABB().min_[axis3]) && canCollide(obj, obj2))
           {
             if(callback(obj, obj2, cdata))
               return;
@@ -429,6 +439,9 @@ void SSaPCollisionManager::collide(void* cdata, CollisionCallBack callback) cons
 
 void SSaPCollisionManager::distance(void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   std::vector<CollisionObject*>::const_iterator it, it_end;
@@ -444,6 +457,9 @@ void SSaPCollisionManager::distance(void* cdata, DistanceCallBack callback) cons
 
 void SSaPCollisionManager::collide(BroadPhaseCollisionManager* other_manager_, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   SSaPCollisionManager* other_manager = static_cast<SSaPCollisionManager*>(other_manager_);
   
   if((size() == 0) || (other_manager->size() == 0)) return;
@@ -470,6 +486,9 @@ void SSaPCollisionManager::collide(BroadPhaseCollisionManager* other_manager_, v
 
 void SSaPCollisionManager::distance(BroadPhaseCollisionManager* other_manager_, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   SSaPCollisionManager* other_manager = static_cast<SSaPCollisionManager*>(other_manager_);
 
   if((size() == 0) || (other_manager->size() == 0)) return;
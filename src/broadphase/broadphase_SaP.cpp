@@ -38,6 +38,7 @@
 #include <algorithm>
 #include <limits>
 #include <boost/bind.hpp>
+#include "fcl/probe.h"
 
 namespace fcl
 {
@@ -295,45 +296,39 @@ void SaPCollisionManager::update_(SaPAABB* updated_aabb)
   SaPAABB dummy;
   dummy.cached = current->obj->getAABB();
 
+  AABB old_cached = current->cached;
+
+  // The two endpoints of an interval are moved independently: a box whose size changes (e.g. the tight AABB of a
+  // rotating object) can grow or shrink on both sides at once. Growing moves are done first, so that a shrinking
+  // endpoint never passes the other endpoint of its own interval.
   for(int coord = 0; coord < 3; ++coord)
   {
-    int direction; // -1 reverse, 0 nochange, 1 forward
     EndPoint* temp;
 
+    // move the "lo" endpoint backward, adding the intervals that begin to overlap
     if(current->lo->getVal(coord) > new_min[coord])
-      direction = -1;
-    else if(current->lo->getVal(coord) < new_min[coord])
-      direction = 1;
-    else direction = 0;
-
-    if(direction == -1)
     {
-      //first update the "lo" endpoint of the interval
-      if(current->lo->prev[coord] != NULL)
+      temp = current->lo->prev[coord];
+      while((temp != NULL) && (temp->getVal(coord) > new_min[coord]))
       {
-        temp = current->lo;
-        while((temp != NULL) && (temp->getVal(coord) > new_min[coord]))
-        {
-          if(temp->minmax == 1)
-            if(temp->aabb->cached.overlap(dummy.cached))
-              addToOverlapPairs(SaPPair(temp->aabb->obj, current->obj));
-          temp = temp->prev[coord];
-        }
+        if((temp->minmax == 1) && (temp->aabb->cached.overlap(dummy.cached)))
+          addToOverlapPairs(SaPPair(temp->aabb->obj, current->obj));
+        temp = temp->prev[coord];
+      }
 
+      if(temp != current->lo->prev[coord])
+      {
+        current->lo->prev[coord]->next[coord] = current->lo->next[coord];
+        current->lo->next[coord]->prev[coord] = current->lo->prev[coord];
+        current->lo->prev[coord] = temp;
         if(temp == NULL)
         {
-          current->lo->prev[coord]->next[coord] = current->lo->next[coord];
-          current->lo->next[coord]->prev[coord] = current->lo->prev[coord];
-          current->lo->prev[coord] = NULL;
           current->lo->next[coord] = elist[coord];
           elist[coord]->prev[coord] = current->lo;
           elist[coord] = current->lo;
         }
         else
         {
-          current->lo->prev[coord]->next[coord] = current->lo->next[coord];
-          current->lo->next[coord]->prev[coord] = current->lo->prev[coord];
-          current->lo->prev[coord] = temp;
           current->lo->next[coord] = temp->next[coord];
           temp->next[coord]->prev[coord] = current->lo;
           temp->next[coord] = current->lo;
@@ -341,85 +336,85 @@ void SaPCollisionManager::update_(SaPAABB* updated_aabb)
       }
 
       current->lo->getVal(coord) = new_min[coord];
+    }
 
-      // update hi end point
-      temp = current->hi;
-      while(temp->getVal(coord) > new_max[coord])
+    // move the "hi" endpoint forward, adding the intervals that begin to overlap
+    if(current->hi->getVal(coord) < new_max[coord])
+    {
+      temp = current->hi->next[coord];
+      EndPoint* last = current->hi;
+      while((temp != NULL) && (temp->getVal(coord) < new_max[coord]))
       {
-        if((temp->minmax == 0) && (temp->aabb->cached.overlap(current->cached)))
-          removeFromOverlapPairs(SaPPair(temp->aabb->obj, current->obj));
-        temp = temp->prev[coord];
+        if((temp->minmax == 0) && (temp->aabb->cached.overlap(dummy.cached)))
+          addToOverlapPairs(SaPPair(temp->aabb->obj, current->obj));
+        last = temp;
+        temp = temp->next[coord];
       }
 
-      current->hi->prev[coord]->next[coord] = current->hi->next[coord];
-      if(current->hi->next[coord] != NULL)
+      if(last != current->hi)
+      {
+        current->hi->prev[coord]->next[coord] = current->hi->next[coord];
         current->hi->next[coord]->prev[coord] = current->hi->prev[coord];
-      current->hi->prev[coord] = temp;
-      current->hi->next[coord] = temp->next[coord];
-      if(temp->next[coord] != NULL)
-        temp->next[coord]->prev[coord] = current->hi;
-      temp->next[coord] = current->hi;
+        current->hi->prev[coord] = last;
+        current->hi->next[coord] = temp;
+        last->next[coord] = current->hi;
+        if(temp != NULL)
+          temp->prev[coord] = current->hi;
+      }
 
       current->hi->getVal(coord) = new_max[coord];
     }
-    else if(direction == 1)
+
+    // move the "lo" endpoint forward, removing the intervals that stop overlapping
+    if(current->lo->getVal(coord) < new_min[coord])
     {
-      //here, we first update the "hi" endpoint.
-      if(current->hi->next[coord] != NULL)
+      temp = current->lo->next[coord];
+      while(temp->getVal(coord) < new_min[coord])
       {
-        temp = current->hi;
-        while((temp->next[coord] != NULL) && (temp->getVal(coord) < new_max[coord]))
-        {
-          if(temp->minmax == 0)
-            if(temp->aabb->cached.overlap(dummy.cached))
-              addToOverlapPairs(SaPPair(temp->aabb->obj, current->obj));
-          temp = temp->next[coord];
-        }
+        if((temp->minmax == 1) && (temp->aabb->cached.overlap(old_cached)))
+          removeFromOverlapPairs(SaPPair(temp->aabb->obj, current->obj));
+        temp = temp->next[coord];
+      }
 
-        if(temp->getVal(coord) < new_max[coord])
-        {
-          current->hi->prev[coord]->next[coord] = current->hi->next[coord];
-          current->hi->next[coord]->prev[coord] = current->hi->prev[coord];
-          current->hi->prev[coord] = temp;
-          current->hi->next[coord] = NULL;
-          temp->next[coord] = current->hi;
-        }
+      if(temp != current->lo->next[coord])
+      {
+        if(current->lo->prev[coord] != NULL)
+          current->lo->prev[coord]->next[coord] = current->lo->next[coord];
         else
-        {
-          current->hi->prev[coord]->next[coord] = current->hi->next[coord];
-          current->hi->next[coord]->prev[coord] = current->hi->prev[coord];
-          current->hi->prev[coord] = temp->prev[coord];
-          current->hi->next[coord] = temp;
-          temp->prev[coord]->next[coord] = current->hi;
-          temp->prev[coord] = current->hi;
-        }
+          elist[coord] = current->lo->next[coord];
+        current->lo->next[coord]->prev[coord] = current->lo->prev[coord];
+        current->lo->prev[coord] = temp->prev[coord];
+        current->lo->next[coord] = temp;
+        temp->prev[coord]->next[coord] = current->lo;
+        temp->prev[coord] = current->lo;
       }
 
-      current->hi->getVal(coord) = new_max[coord];
-
-      //then, update the "lo" endpoint of the interval.
-      temp = current->lo;
+      current->lo->getVal(coord) = new_min[coord];
+    }
 
-      while(temp->getVal(coord) < new_min[coord])
+    // move the "hi" endpoint backward, removing the intervals that stop overlapping
+    if(current->hi->getVal(coord) > new_max[coord])
+    {
+      temp = current->hi->prev[coord];
+      while(temp->getVal(coord) > new_max[coord])
       {
-        if((temp->minmax == 1) && (temp->aabb->cached.overlap(current->cached)))
+        if((temp->minmax == 0) && (temp->aabb->cached.overlap(old_cached)))
           removeFromOverlapPairs(SaPPair(temp->aabb->obj, current->obj));
-        temp = temp->next[coord];
+        temp = temp->prev[coord];
       }
 
-      if(current->lo->prev[coord] != NULL)
-        current->lo->prev[coord]->next[coord] = current->lo->next[coord];
-      else
-        elist[coord] = current->lo->next[coord];
-      current->lo->next[coord]->prev[coord] = current->lo->prev[coord];
-      current->lo->prev[coord] = temp->prev[coord];
-      current->lo->next[coord] = temp;
-      if(temp->prev[coord] != NULL)
-        temp->prev[coord]->next[coord] = current->lo;
-      else
-        elist[coord] = current->lo;
-      temp->prev[coord] = current->lo;
-      current->lo->getVal(coord) = new_min[coord];
+      if(temp != current->hi->prev[coord])
+      {
+        current->hi->prev[coord]->next[coord] = current->hi->next[coord];
+        if(current->hi->next[coord] != NULL)
+          current->hi->next[coord]->prev[coord] = current->hi->prev[coord];
+        current->hi->prev[coord] = temp;
+        current->hi->next[coord] = temp->next[coord];
+        temp->next[coord]->prev[coord] = current->hi;
+        temp->next[coord] = current->hi;
+      }
+
+      current->hi->getVal(coord) = new_max[coord];
     }
   }
 }
@@ -524,7 +519,7 @@ bool SaPCollisionManager::collide_(CollisionObject* obj, void* cdata, CollisionC
     {
       if((pos->minmax == 0) && (pos->aabb->hi->getVal(axis) >= min_val))
       {
-        if(pos->aabb->cached.overlap(obj->getAABB()))
+        if(pos->aabb->cached.overlap(obj->getAABB()) && canCollide(obj, pos->aabb->obj))
           if(callback(obj, pos->aabb->obj, cdata))
             return true;
       }
@@ -537,6 +532,9 @@ bool SaPCollisionManager::collide_(CollisionObject* obj, void* cdata, CollisionC
 
 void SaPCollisionManager::collide(CollisionObject* obj, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
   
   collide_(obj, cdata, callback);
@@ -650,6 +648,9 @@ bool SaPCollisionManager::distance_(CollisionObject* obj, void* cdata, DistanceC
 
 void SaPCollisionManager::distance(CollisionObject* obj, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
@@ -659,6 +660,9 @@ void SaPCollisionManager::distance(CollisionObject* obj, void* cdata, DistanceCa
 
 void SaPCollisionManager::collide(void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   for(std::list<SaPPair>::const_iterator it = overlap_pairs.begin(), end = overlap_pairs.end(); it != end; ++it)
@@ -666,6 +670,8 @@ void SaPCollisionManager::collide(void* cdata, CollisionCallBack callback) const
     CollisionObject* obj1 = it->obj1;
     CollisionObject* obj2 = it->obj2;
 
+    if(!canCollide(obj1, obj2)) continue;
+
     if(callback(obj1, obj2, cdata))
       return;
   }
@@ -673,6 +679,9 @@ void SaPCollisionManager::collide(void* cdata, CollisionCallBack callback) const
 
 void SaPCollisionManager::distance(void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   enable_tested_set_ = true;
@@ -692,6 +701,9 @@ void SaPCollisionManager::distance(void* cdata, DistanceCallBack callback) const
 
 void SaPCollisionManager::collide(BroadPhaseCollisionManager* other_manager_, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   SaPCollisionManager* other_manager = static_cast<SaPCollisionManager*>(other_manager_);
 
   if((size() == 0) || (other_manager->size() == 0)) return;
@@ -722,6 +734,9 @@ void SaPCollisionManager::collide(BroadPhaseCollisionManager* other_manager_, vo
 
 void SaPCollisionManager::distance(BroadPhaseCollisionManager* other_manager_, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   SaPCollisionManager* other_manager = static_cast<SaPCollisionManager*>(other_manager_);
 
   if((size() == 0) || (other_manager->size() == 0)) return;
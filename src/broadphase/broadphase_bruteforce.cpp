@@ -36,6 +36,7 @@
 
 #include "fcl/broadphase/broadphase_bruteforce.h"
 #include <limits>
+#include "fcl/probe.h"
 
 namespace fcl
 {
@@ -78,6 +79,9 @@ void NaiveCollisionManager::getObjects(std::vector<CollisionObject*>& objs_) con
 
 void NaiveCollisionManager::collide(CollisionObject* obj, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   for(std::list<CollisionObject*>::const_iterator it = objs.begin(), end = objs.end(); it != end; ++it)
@@ -87,14 +91,18 @@ void NaiveCollisionManager::collide(CollisionObject* obj, void* cdata, Collision
     if(!obj->getCollisionGeometry()->useOuterGeometries() ||
         obj->getCollisionGeometry()->isOuterGeometry(colision_object->getCollisionGeometry() ) )
     {
-      if(callback(obj, colision_object, cdata))
-        return;
+      if(canCollide(obj, colision_object))
+        if(callback(obj, colision_object, cdata))
+          return;
     }
   }
 }
 
 void NaiveCollisionManager::distance(CollisionObject* obj, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
@@ -117,6 +125,9 @@ void NaiveCollisionManager::distance(CollisionObject* obj, void* cdata, Distance
 
 void NaiveCollisionManager::collide(void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   for(std::list<CollisionObject*>::const_iterator it1 = objs.begin(), end = objs.end(); 
@@ -128,7 +139,7 @@ void NaiveCollisionManager::collide(void* cdata, CollisionCallBack callback) con
       if(!(*it1)->getCollisionGeometry()->useOuterGeometries() ||
           (*it1)->getCollisionGeometry()->isOuterGeometry( (*it2)->getCollisionGeometry() ) )
       {
-        if((*it1)->getAABB().overlap((*it2)->getAABB()))
+        if((*it1)->getAABB().overlap((*it2)->getAABB()) && canCollide(*it1, *it2))
           if(callback(*it1, *it2, cdata))
             return;
       }
@@ -138,6 +149,9 @@ void NaiveCollisionManager::collide(void* cdata, CollisionCallBack callback) con
 
 void NaiveCollisionManager::distance(void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
   
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
@@ -161,6 +175,9 @@ void NaiveCollisionManager::distance(void* cdata, DistanceCallBack callback) con
 
 void NaiveCollisionManager::collide(BroadPhaseCollisionManager* other_manager_, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   NaiveCollisionManager* other_manager = static_cast<NaiveCollisionManager*>(other_manager_);
   
   if((size() == 0) || (other_manager->size() == 0)) return;
@@ -178,7 +195,7 @@ void NaiveCollisionManager::collide(BroadPhaseCollisionManager* other_manager_,
       if(!(*it1)->getCollisionGeometry()->useOuterGeometries() ||
           (*it1)->getCollisionGeometry()->isOuterGeometry( (*it2)->getCollisionGeometry() ) )
       {
-        if((*it1)->getAABB().overlap((*it2)->getAABB()))
+        if((*it1)->getAABB().overlap((*it2)->getAABB()) && canCollide(*it1, *it2))
           if(callback((*it1), (*it2), cdata))
             return;
       }
@@ -188,6 +205,9 @@ void NaiveCollisionManager::collide(BroadPhaseCollisionManager* other_manager_,
 
 void NaiveCollisionManager::distance(BroadPhaseCollisionManager* other_manager_, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   NaiveCollisionManager* other_manager = static_cast<NaiveCollisionManager*>(other_manager_);
 
   if((size() == 0) || (other_manager->size() == 0)) return;
@@ -36,6 +36,7 @@
 
 
 #include "fcl/broadphase/broadphase_dynamic_AABB_tree.h"
+#include "fcl/probe.h"
 
 #if FCL_HAVE_OCTOMAP
 #include "fcl/octree.h"
@@ -335,6 +336,30 @@ bool collisionRecurse(DynamicAABBTreeCollisionManager::DynamicAABBNode* root1, c
     return collisionRecurse_(root1, tree2, root2, root2_bv, tf2, cdata, callback);
 }
 
+/// @brief collision between the manager's tree and the dirty cells below root2. The octree is descended along the dirty
+/// cells, and each leaf overlapping them is tested against the whole manager. Unknown cells are skipped: a cell that gets
+/// updated always has a node
+bool collisionRecurseDirty(DynamicAABBTreeCollisionManager::DynamicAABBNode* root1, const OcTree* tree2, const OcTree::OcTreeNode* root2, const AABB& root2_bv, const Transform3f& tf2, void* cdata, CollisionCallBack callback)
+{
+  if(!tree2->overlapDirty(root2_bv)) return false;
+
+  if(!root2->hasChildren())
+    return collisionRecurse(root1, tree2, root2, root2_bv, tf2, cdata, callback);
+
+  for(unsigned int i = 0; i < 8; ++i)
+  {
+    if(root2->childExists(i))
+    {
+      AABB child_bv;
+      computeChildBV(root2_bv, i, child_bv);
+      if(collisionRecurseDirty(root1, tree2, root2->getChild(i), child_bv, tf2, cdata, callback))
+        return true;
+    }
+  }
+
+  return false;
+}
+
 
 bool distanceRecurse_(DynamicAABBTreeCollisionManager::DynamicAABBNode* root1, const OcTree* tree2, const OcTree::OcTreeNode* root2, const AABB& root2_bv, const Vec3f& tf2, void* cdata, DistanceCallBack callback, FCL_REAL& min_dist)
 {
@@ -424,65 +449,100 @@ bool distanceRecurse(DynamicAABBTreeCollisionManager::DynamicAABBNode* root1, co
 
 #endif
 
-bool collisionRecurse(DynamicAABBTreeCollisionManager::DynamicAABBNode* root1, DynamicAABBTreeCollisionManager::DynamicAABBNode* root2, void* cdata, CollisionCallBack callback)
+/// @brief set the category and mask of each node to the union of those of the objects in its subtree
+void refreshFilterBits(DynamicAABBTreeCollisionManager::DynamicAABBNode* root)
 {
+  if(root->isLeaf())
+  {
+    CollisionObject* obj = static_cast<CollisionObject*>(root->data);
+    root->category = obj->getCollisionCategory();
+    root->mask = obj->getCollisionMask();
+    return;
+  }
+
+  refreshFilterBits(root->children[0]);
+  refreshFilterBits(root->children[1]);
+  root->category = root->children[0]->category | root->children[1]->category;
+  root->mask = root->children[0]->mask | root->children[1]->mask;
+}
+
+/// @brief whether no pair of objects between the two subtrees can pass the category and mask test
+inline bool filterOut(const DynamicAABBTreeCollisionManager::DynamicAABBNode* root1, const DynamicAABBTreeCollisionManager::DynamicAABBNode* root2)
+{
+  return !(root1->category & root2->mask) || !(root2->category & root1->mask);
+}
+
+bool collisionRecurse(DynamicAABBTreeCollisionManager::DynamicAABBNode* root1, DynamicAABBTreeCollisionManager::DynamicAABBNode* root2, const BroadPhaseCollisionManager* manager, void* cdata, CollisionCallBack callback)
+{
+  if(filterOut(root1, root2)) return false;
+
   if(root1->isLeaf() && root2->isLeaf())
   {
     if(!root1->bv.overlap(root2->bv)) return false;
-    return callback(static_cast<CollisionObject*>(root1->data), static_cast<CollisionObject*>(root2->data), cdata);
+    CollisionObject* obj1 = static_cast<CollisionObject*>(root1->data);
+    CollisionObject* obj2 = static_cast<CollisionObject*>(root2->data);
+    if(manager->isPairDisabled(obj1, obj2)) return false;
+    return callback(obj1, obj2, cdata);
   }
     
   if(!root1->bv.overlap(root2->bv)) return false;
     
   if(root2->isLeaf() || (!root1->isLeaf() && (root1->bv.size() > root2->bv.size())))
   {
-    if(collisionRecurse(root1->children[0], root2, cdata, callback))
+    if(collisionRecurse(root1->children[0], root2, manager, cdata, callback))
       return true;
-    if(collisionRecurse(root1->children[1], root2, cdata, callback))
+    if(collisionRecurse(root1->children[1], root2, manager, cdata, callback))
       return true;
   }
   else
   {
-    if(collisionRecurse(root1, root2->children[0], cdata, callback))
+    if(collisionRecurse(root1, root2->children[0], manager, cdata, callback))
       return true;
-    if(collisionRecurse(root1, root2->children[1], cdata, callback))
+    if(collisionRecurse(root1, root2->children[1], manager, cdata, callback))
       return true;
   }
   return false;
 }
 
-bool collisionRecurse(DynamicAABBTreeCollisionManager::DynamicAABBNode* root, CollisionObject* query, void* cdata, CollisionCallBack callback)
+bool collisionRecurse(DynamicAABBTreeCollisionManager::DynamicAABBNode* root, CollisionObject* query, const BroadPhaseCollisionManager* manager, void* cdata, CollisionCallBack callback)
 {
+  if(!(root->category & query->getCollisionMask()) || !(query->getCollisionCategory() & root->mask)) return false;
+
   if(root->isLeaf())
   {
     if(!root->bv.overlap(query->getAABB())) return false;
-    return callback(static_cast<CollisionObject*>(root->data), query, cdata);
+    CollisionObject* obj = static_cast<CollisionObject*>(root->data);
+    if(manager->isPairDisabled(obj, query)) return false;
+    return callback(obj, query, cdata);
   }
     
   if(!root->bv.overlap(query->getAABB())) return false;
 
   int select_res = static_cast<int>(select(query->getAABB(), *(root->children[0]), *(root->children[1]) ) );
     
-  if(collisionRecurse(root->children[select_res], query, cdata, callback))
+  if(collisionRecurse(root->children[select_res], query, manager, cdata, callback))
     return true;
     
-  if(collisionRecurse(root->children[1-select_res], query, cdata, callback))
+  if(collisionRecurse(root->children[1-select_res], query, manager, cdata, callback))
     return true;
 
   return false;
 }
 
-bool selfCollisionRecurse(DynamicAABBTreeCollisionManager::DynamicAABBNode* root, void* cdata, CollisionCallBack callback)
+bool selfCollisionRecurse(DynamicAABBTreeCollisionManager::DynamicAABBNode* root, const BroadPhaseCollisionManager* manager, void* cdata, CollisionCallBack callback)
 {
   if(root->isLeaf()) return false;
 
-  if(selfCollisionRecurse(root->children[0], cdata, callback))
+  // no two objects of the subtree can pass the filter
+  if(filterOut(root, root)) return false;
+
+  if(selfCollisionRecurse(root->children[0], manager, cdata, callback))
     return true;
 
-  if(selfCollisionRecurse(root->children[1], cdata, callback))
+  if(selfCollisionRecurse(root->children[1], manager, cdata, callback))
     return true;
 
-  if(collisionRecurse(root->children[0], root->children[1], cdata, callback))
+  if(collisionRecurse(root->children[0], root->children[1], manager, cdata, callback))
     return true;
 
   return false;
@@ -644,11 +704,7 @@ void DynamicAABBTreeCollisionManager::registerObjects(const std::vector<Collisio
     table.rehash(other_objs.size());
     for(size_t i = 0, size = other_objs.size(); i < size; ++i)
     {
-      DynamicAABBNode* node = new DynamicAABBNode; // node will be managed by the dtree
-      node->bv = other_objs[i]->getAABB();
-      node->parent = NULL;
-      node->children[1] = NULL;
-      node->data = other_objs[i];
+      DynamicAABBNode* node = dtree.createLeaf(other_objs[i]->getAABB(), other_objs[i]); // node will be managed by the dtree
       table[other_objs[i]] = node;
       leaves[i] = node;
     }
@@ -657,12 +713,15 @@ void DynamicAABBTreeCollisionManager::registerObjects(const std::vector<Collisio
    
     setup_ = true;
   }
+
+  filter_dirty_ = true;
 }
 
 void DynamicAABBTreeCollisionManager::registerObject(CollisionObject* obj)
 {
   DynamicAABBNode* node = dtree.insert(obj->getAABB(), obj);
   table[obj] = node;
+  filter_dirty_ = true;
 }
 
 void DynamicAABBTreeCollisionManager::unregisterObject(CollisionObject* obj)
@@ -670,6 +729,7 @@ void DynamicAABBTreeCollisionManager::unregisterObject(CollisionObject* obj)
   DynamicAABBNode* node = table[obj];
   table.erase(obj);
   dtree.remove(node);
+  filter_dirty_ = true;
 }
 
 void DynamicAABBTreeCollisionManager::setup()
@@ -692,6 +752,7 @@ void DynamicAABBTreeCollisionManager::setup()
       dtree.balanceTopdown();
 
     setup_ = true;
+    filter_dirty_ = true;
   }
 }
 
@@ -707,6 +768,7 @@ void DynamicAABBTreeCollisionManager::update()
 
   dtree.refit();
   setup_ = false;
+  filter_dirty_ = true;
 
   setup();
 }
@@ -721,6 +783,7 @@ void DynamicAABBTreeCollisionManager::update_(CollisionObject* updated_obj)
       dtree.update(node, updated_obj->getAABB());
   }
   setup_ = false;
+  filter_dirty_ = true;
 }
 
 void DynamicAABBTreeCollisionManager::update(CollisionObject* updated_obj)
@@ -736,9 +799,20 @@ void DynamicAABBTreeCollisionManager::update(const std::vector<CollisionObject*>
   setup();
 }
 
+void DynamicAABBTreeCollisionManager::refreshFilter_() const
+{
+  if(filter_dirty_ && !dtree.empty())
+    details::dynamic_AABB_tree::refreshFilterBits(dtree.getRoot());
+  filter_dirty_ = false;
+}
+
 void DynamicAABBTreeCollisionManager::collide(CollisionObject* obj, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
+  refreshFilter_();
 
 #if FCL_HAVE_OCTOMAP
   switch(obj->getCollisionGeometry()->getNodeType())
@@ -748,24 +822,46 @@ void DynamicAABBTreeCollisionManager::collide(CollisionObject* obj, void* cdata,
       if(!octree_as_geometry_collide)
       {
         const OcTree* octree = static_cast<const OcTree*>(obj->getCollisionGeometry());
-        details::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), cdata, callback); 
+        details::FilteredCollisionData filtered_data(this, obj, cdata, callback);
+        details::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), &filtered_data, details::filteredCollisionCallback); 
       }
       else
-        details::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), obj, cdata, callback);
+        details::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), obj, this, cdata, callback);
     }
     break;
   default:
 #endif
 
-  details::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), obj, cdata, callback);
+  details::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), obj, this, cdata, callback);
 
 #if FCL_HAVE_OCTOMAP
   }
 #endif
 }
 
+void DynamicAABBTreeCollisionManager::collideDirty(CollisionObject* obj, void* cdata, CollisionCallBack callback) const
+{
+  if(size() == 0) return;
+
+#if FCL_HAVE_OCTOMAP
+  if(obj->getCollisionGeometry()->getNodeType() == GEOM_OCTREE)
+  {
+    const OcTree* octree = static_cast<const OcTree*>(obj->getCollisionGeometry());
+    details::FilteredCollisionData filtered_data(this, obj, cdata, callback);
+    if(octree->getRoot())
+      details::dynamic_AABB_tree::collisionRecurseDirty(dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), &filtered_data, details::filteredCollisionCallback);
+    return;
+  }
+#endif
+
+  collide(obj, cdata, callback);
+}
+
 void DynamicAABBTreeCollisionManager::distance(CollisionObject* obj, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
 
@@ -796,12 +892,19 @@ void DynamicAABBTreeCollisionManager::distance(CollisionObject* obj, void* cdata
 
 void DynamicAABBTreeCollisionManager::collide(void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
-  details::dynamic_AABB_tree::selfCollisionRecurse(dtree.getRoot(), cdata, callback);
+  refreshFilter_();
+  details::dynamic_AABB_tree::selfCollisionRecurse(dtree.getRoot(), this, cdata, callback);
 }
 
 void DynamicAABBTreeCollisionManager::distance(void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
   details::dynamic_AABB_tree::selfDistanceRecurse(dtree.getRoot(), cdata, callback, min_dist);
@@ -809,13 +912,21 @@ void DynamicAABBTreeCollisionManager::distance(void* cdata, DistanceCallBack cal
 
 void DynamicAABBTreeCollisionManager::collide(BroadPhaseCollisionManager* other_manager_, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   DynamicAABBTreeCollisionManager* other_manager = static_cast<DynamicAABBTreeCollisionManager*>(other_manager_);
   if((size() == 0) || (other_manager->size() == 0)) return;
-  details::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), other_manager->dtree.getRoot(), cdata, callback);
+  refreshFilter_();
+  other_manager->refreshFilter_();
+  details::dynamic_AABB_tree::collisionRecurse(dtree.getRoot(), other_manager->dtree.getRoot(), this, cdata, callback);
 }
 
 void DynamicAABBTreeCollisionManager::distance(BroadPhaseCollisionManager* other_manager_, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   DynamicAABBTreeCollisionManager* other_manager = static_cast<DynamicAABBTreeCollisionManager*>(other_manager_);
   if((size() == 0) || (other_manager->size() == 0)) return;
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
@@ -35,6 +35,7 @@
 /** \author Jia Pan */
 
 #include "fcl/broadphase/broadphase_dynamic_AABB_tree_array.h"
+#include "fcl/probe.h"
 
 #if FCL_HAVE_OCTOMAP
 #include "fcl/octree.h"
@@ -413,71 +414,107 @@ bool distanceRecurse_(DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* no
 
 #endif
 
+/// @brief set the category and mask of each node to the union of those of the objects in its subtree
+void refreshFilterBits(DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* nodes, size_t root_id)
+{
+  DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* root = nodes + root_id;
+  if(root->isLeaf())
+  {
+    CollisionObject* obj = static_cast<CollisionObject*>(root->data);
+    root->category = obj->getCollisionCategory();
+    root->mask = obj->getCollisionMask();
+    return;
+  }
+
+  refreshFilterBits(nodes, root->children[0]);
+  refreshFilterBits(nodes, root->children[1]);
+  root->category = nodes[root->children[0]].category | nodes[root->children[1]].category;
+  root->mask = nodes[root->children[0]].mask | nodes[root->children[1]].mask;
+}
+
+/// @brief whether no pair of objects between the two subtrees can pass the category and mask test
+inline bool filterOut(const DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* root1, const DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* root2)
+{
+  return !(root1->category & root2->mask) || !(root2->category & root1->mask);
+}
+
 bool collisionRecurse(DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* nodes1, size_t root1_id, 
                       DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* nodes2, size_t root2_id, 
-                      void* cdata, CollisionCallBack callback)
+                      const BroadPhaseCollisionManager* manager, void* cdata, CollisionCallBack callback)
 {
   DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* root1 = nodes1 + root1_id;
   DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* root2 = nodes2 + root2_id;
+  if(filterOut(root1, root2)) return false;
+
   if(root1->isLeaf() && root2->isLeaf())
   {
     if(!root1->bv.overlap(root2->bv)) return false;
-    return callback(static_cast<CollisionObject*>(root1->data), static_cast<CollisionObject*>(root2->data), cdata);
+    CollisionObject* obj1 = static_cast<CollisionObject*>(root1->data);
+    CollisionObject* obj2 = static_cast<CollisionObject*>(root2->data);
+    if(manager->isPairDisabled(obj1, obj2)) return false;
+    return callback(obj1, obj2, cdata);
   }
     
   if(!root1->bv.overlap(root2->bv)) return false;
     
   if(root2->isLeaf() || (!root1->isLeaf() && (root1->bv.size() > root2->bv.size())))
   {
-    if(collisionRecurse(nodes1, root1->children[0], nodes2, root2_id, cdata, callback))
+    if(collisionRecurse(nodes1, root1->children[0], nodes2, root2_id, manager, cdata, callback))
       return true;
-    if(collisionRecurse(nodes1, root1->children[1], nodes2, root2_id, cdata, callback))
+    if(collisionRecurse(nodes1, root1->children[1], nodes2, root2_id, manager, cdata, callback))
       return true;
   }
   else
   {
-    if(collisionRecurse(nodes1, root1_id, nodes2, root2->children[0], cdata, callback))
+    if(collisionRecurse(nodes1, root1_id, nodes2, root2->children[0], manager, cdata, callback))
       return true;
-    if(collisionRecurse(nodes1, root1_id, nodes2, root2->children[1], cdata, callback))
+    if(collisionRecurse(nodes1, root1_id, nodes2, root2->children[1], manager, cdata, callback))
       return true;
   }
   return false;
 }
 
-bool collisionRecurse(DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* nodes, size_t root_id, CollisionObject* query, void* cdata, CollisionCallBack callback)
+bool collisionRecurse(DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* nodes, size_t root_id, CollisionObject* query, const BroadPhaseCollisionManager* manager, void* cdata, CollisionCallBack callback)
 {
   DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* root = nodes + root_id;
+  if(!(root->category & query->getCollisionMask()) || !(query->getCollisionCategory() & root->mask)) return false;
+
   if(root->isLeaf())
   {
     if(!root->bv.overlap(query->getAABB())) return false;
-    return callback(static_cast<CollisionObject*>(root->data), query, cdata);
+    CollisionObject* obj = static_cast<CollisionObject*>(root->data);
+    if(manager->isPairDisabled(obj, query)) return false;
+    return callback(obj, query, cdata);
   }
     
   if(!root->bv.overlap(query->getAABB())) return false;
 
   int select_res = static_cast<int>(implementation_array::select(query->getAABB(), root->children[0], root->children[1], nodes) );
     
-  if(collisionRecurse(nodes, root->children[select_res], query, cdata, callback))
+  if(collisionRecurse(nodes, root->children[select_res], query, manager, cdata, callback))
     return true;
     
-  if(collisionRecurse(nodes, root->children[1-select_res], query, cdata, callback))
+  if(collisionRecurse(nodes, root->children[1-select_res], query, manager, cdata, callback))
     return true;
 
   return false;
 }
 
-bool selfCollisionRecurse(DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* nodes, size_t root_id, void* cdata, CollisionCallBack callback)
+bool selfCollisionRecurse(DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* nodes, size_t root_id, const BroadPhaseCollisionManager* manager, void* cdata, CollisionCallBack callback)
 {
   DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* root = nodes + root_id;
   if(root->isLeaf()) return false;
 
-  if(selfCollisionRecurse(nodes, root->children[0], cdata, callback))
+  // no two objects of the subtree can pass the filter
+  if(filterOut(root, root)) return false;
+
+  if(selfCollisionRecurse(nodes, root->children[0], manager, cdata, callback))
     return true;
 
-  if(selfCollisionRecurse(nodes, root->children[1], cdata, callback))
+  if(selfCollisionRecurse(nodes, root->children[1], manager, cdata, callback))
     return true;
 
-  if(collisionRecurse(nodes, root->children[0], nodes, root->children[1], cdata, callback))
+  if(collisionRecurse(nodes, root->children[0], nodes, root->children[1], manager, cdata, callback))
     return true;
 
   return false;
@@ -639,6 +676,30 @@ bool collisionRecurse(DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* no
     return collisionRecurse_(nodes1, root1_id, tree2, root2, root2_bv, tf2, cdata, callback);
 }
 
+/// @brief collision between the manager's tree and the dirty cells below root2. The octree is descended along the dirty
+/// cells, and each leaf overlapping them is tested against the whole manager. Unknown cells are skipped: a cell that gets
+/// updated always has a node
+bool collisionRecurseDirty(DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* nodes1, size_t root1_id, const OcTree* tree2, const OcTree::OcTreeNode* root2, const AABB& root2_bv, const Transform3f& tf2, void* cdata, CollisionCallBack callback)
+{
+  if(!tree2->overlapDirty(root2_bv)) return false;
+
+  if(!root2->hasChildren())
+    return collisionRecurse(nodes1, root1_id, tree2, root2, root2_bv, tf2, cdata, callback);
+
+  for(unsigned int i = 0; i < 8; ++i)
+  {
+    if(root2->childExists(i))
+    {
+      AABB child_bv;
+      computeChildBV(root2_bv, i, child_bv);
+      if(collisionRecurseDirty(nodes1, root1_id, tree2, root2->getChild(i), child_bv, tf2, cdata, callback))
+        return true;
+    }
+  }
+
+  return false;
+}
+
 
 bool distanceRecurse(DynamicAABBTreeCollisionManager_Array::DynamicAABBNode* nodes1, size_t root1_id, const OcTree* tree2, const OcTree::OcTreeNode* root2, const AABB& root2_bv, const Transform3f& tf2, void* cdata, DistanceCallBack callback, FCL_REAL& min_dist)
 {
@@ -680,12 +741,15 @@ void DynamicAABBTreeCollisionManager_Array::registerObjects(const std::vector<Co
    
     setup_ = true;
   }
+
+  filter_dirty_ = true;
 }
 
 void DynamicAABBTreeCollisionManager_Array::registerObject(CollisionObject* obj)
 {
   size_t node = dtree.insert(obj->getAABB(), obj);
   table[obj] = node;
+  filter_dirty_ = true;
 }
 
 void DynamicAABBTreeCollisionManager_Array::unregisterObject(CollisionObject* obj)
@@ -693,6 +757,7 @@ void DynamicAABBTreeCollisionManager_Array::unregisterObject(CollisionObject* ob
   size_t node = table[obj];
   table.erase(obj);
   dtree.remove(node);
+  filter_dirty_ = true;
 }
 
 void DynamicAABBTreeCollisionManager_Array::setup()
@@ -715,6 +780,7 @@ void DynamicAABBTreeCollisionManager_Array::setup()
       dtree.balanceTopdown();
 
     setup_ = true;
+    filter_dirty_ = true;
   }
 }
 
@@ -730,6 +796,7 @@ void DynamicAABBTreeCollisionManager_Array::update()
 
   dtree.refit();
   setup_ = false;
+  filter_dirty_ = true;
 
   setup();
 }
@@ -744,6 +811,7 @@ void DynamicAABBTreeCollisionManager_Array::update_(CollisionObject* updated_obj
       dtree.update(node, updated_obj->getAABB());
   }
   setup_ = false;
+  filter_dirty_ = true;
 }
 
 void DynamicAABBTreeCollisionManager_Array::update(CollisionObject* updated_obj)
@@ -761,9 +829,20 @@ void DynamicAABBTreeCollisionManager_Array::update(const std::vector<CollisionOb
 
 
 
+void DynamicAABBTreeCollisionManager_Array::refreshFilter_() const
+{
+  if(filter_dirty_ && !dtree.empty())
+    details::dynamic_AABB_tree_array::refreshFilterBits(dtree.getNodes(), dtree.getRoot());
+  filter_dirty_ = false;
+}
+
 void DynamicAABBTreeCollisionManager_Array::collide(CollisionObject* obj, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
+  refreshFilter_();
 
 #if FCL_HAVE_OCTOMAP
   switch(obj->getCollisionGeometry()->getNodeType())
@@ -773,24 +852,46 @@ void DynamicAABBTreeCollisionManager_Array::collide(CollisionObject* obj, void*
       if(!octree_as_geometry_collide)
       {
         const OcTree* octree = static_cast<const OcTree*>(obj->getCollisionGeometry());
-        details::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), cdata, callback); 
+        details::FilteredCollisionData filtered_data(this, obj, cdata, callback);
+        details::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), &filtered_data, details::filteredCollisionCallback); 
       }
       else
-        details::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), obj, cdata, callback);
+        details::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), obj, this, cdata, callback);
     }
     break;
   default:
 #endif
 
-  details::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), obj, cdata, callback);
+  details::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), obj, this, cdata, callback);
 
 #if FCL_HAVE_OCTOMAP
   }
 #endif
 }
 
+void DynamicAABBTreeCollisionManager_Array::collideDirty(CollisionObject* obj, void* cdata, CollisionCallBack callback) const
+{
+  if(size() == 0) return;
+
+#if FCL_HAVE_OCTOMAP
+  if(obj->getCollisionGeometry()->getNodeType() == GEOM_OCTREE)
+  {
+    const OcTree* octree = static_cast<const OcTree*>(obj->getCollisionGeometry());
+    details::FilteredCollisionData filtered_data(this, obj, cdata, callback);
+    if(octree->getRoot())
+      details::dynamic_AABB_tree_array::collisionRecurseDirty(dtree.getNodes(), dtree.getRoot(), octree, octree->getRoot(), octree->getRootBV(), obj->getTransform(), &filtered_data, details::filteredCollisionCallback);
+    return;
+  }
+#endif
+
+  collide(obj, cdata, callback);
+}
+
 void DynamicAABBTreeCollisionManager_Array::distance(CollisionObject* obj, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
 
@@ -820,12 +921,19 @@ void DynamicAABBTreeCollisionManager_Array::distance(CollisionObject* obj, void*
 
 void DynamicAABBTreeCollisionManager_Array::collide(void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
-  details::dynamic_AABB_tree_array::selfCollisionRecurse(dtree.getNodes(), dtree.getRoot(), cdata, callback);
+  refreshFilter_();
+  details::dynamic_AABB_tree_array::selfCollisionRecurse(dtree.getNodes(), dtree.getRoot(), this, cdata, callback);
 }
 
 void DynamicAABBTreeCollisionManager_Array::distance(void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
   details::dynamic_AABB_tree_array::selfDistanceRecurse(dtree.getNodes(), dtree.getRoot(), cdata, callback, min_dist);
@@ -833,13 +941,21 @@ void DynamicAABBTreeCollisionManager_Array::distance(void* cdata, DistanceCallBa
 
 void DynamicAABBTreeCollisionManager_Array::collide(BroadPhaseCollisionManager* other_manager_, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   DynamicAABBTreeCollisionManager_Array* other_manager = static_cast<DynamicAABBTreeCollisionManager_Array*>(other_manager_);
   if((size() == 0) || (other_manager->size() == 0)) return;
-  details::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), other_manager->dtree.getNodes(), other_manager->dtree.getRoot(), cdata, callback);
+  refreshFilter_();
+  other_manager->refreshFilter_();
+  details::dynamic_AABB_tree_array::collisionRecurse(dtree.getNodes(), dtree.getRoot(), other_manager->dtree.getNodes(), other_manager->dtree.getRoot(), this, cdata, callback);
 }
 
 void DynamicAABBTreeCollisionManager_Array::distance(BroadPhaseCollisionManager* other_manager_, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   DynamicAABBTreeCollisionManager_Array* other_manager = static_cast<DynamicAABBTreeCollisionManager_Array*>(other_manager_);
   if((size() == 0) || (other_manager->size() == 0)) return;
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
@@ -0,0 +1,597 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */ 
+
+
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree_continues.h"
+#include "fcl/collision.h"
+#include "fcl/ccd/motion_base.h"
+
+#include <boost/thread.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <algorithm>
+
+namespace fcl
+{
+
+namespace details
+{
+
+namespace dynamic_AABB_tree_continues
+{
+
+/// @brief whether the pair is tested, according to the outer geometries of the first object
+static inline bool isPairEnabled(const ContinuousCollisionObject* o1, const ContinuousCollisionObject* o2)
+{
+  return !o1->getCollisionGeometry()->useOuterGeometries() ||
+    o1->getCollisionGeometry()->isOuterGeometry(o2->getCollisionGeometry());
+}
+
+bool collisionRecurse(DynamicAABBTreeContinuousCollisionManager::DynamicAABBNode* root1, DynamicAABBTreeContinuousCollisionManager::DynamicAABBNode* root2, void* cdata, ContinuousCollisionCallBack callback)
+{
+  if(!root1->bv.overlap(root2->bv)) return false;
+
+  if(root1->isLeaf() && root2->isLeaf())
+  {
+    ContinuousCollisionObject* root1_obj = static_cast<ContinuousCollisionObject*>(root1->data);
+    ContinuousCollisionObject* root2_obj = static_cast<ContinuousCollisionObject*>(root2->data);
+    if(!isPairEnabled(root1_obj, root2_obj)) return false;
+    return callback(root1_obj, root2_obj, cdata);
+  }
+
+  if(root2->isLeaf() || (!root1->isLeaf() && (root1->bv.size() > root2->bv.size())))
+  {
+    if(collisionRecurse(root1->children[0], root2, cdata, callback))
+      return true;
+    if(collisionRecurse(root1->children[1], root2, cdata, callback))
+      return true;
+  }
+  else
+  {
+    if(collisionRecurse(root1, root2->children[0], cdata, callback))
+      return true;
+    if(collisionRecurse(root1, root2->children[1], cdata, callback))
+      return true;
+  }
+  return false;
+}
+
+bool collisionRecurse(DynamicAABBTreeContinuousCollisionManager::DynamicAABBNode* root, ContinuousCollisionObject* query, void* cdata, ContinuousCollisionCallBack callback)
+{
+  if(!root->bv.overlap(query->getAABB())) return false;
+
+  if(root->isLeaf())
+  {
+    ContinuousCollisionObject* root_obj = static_cast<ContinuousCollisionObject*>(root->data);
+    if(!isPairEnabled(query, root_obj)) return false;
+    return callback(query, root_obj, cdata);
+  }
+
+  int select_res = static_cast<int>(select(query->getAABB(), *(root->children[0]), *(root->children[1]) ) );
+
+  if(collisionRecurse(root->children[select_res], query, cdata, callback))
+    return true;
+
+  if(collisionRecurse(root->children[1-select_res], query, cdata, callback))
+    return true;
+
+  return false;
+}
+
+bool selfCollisionRecurse(DynamicAABBTreeContinuousCollisionManager::DynamicAABBNode* root, void* cdata, ContinuousCollisionCallBack callback)
+{
+  if(root->isLeaf()) return false;
+
+  if(selfCollisionRecurse(root->children[0], cdata, callback))
+    return true;
+
+  if(selfCollisionRecurse(root->children[1], cdata, callback))
+    return true;
+
+  if(collisionRecurse(root->children[0], root->children[1], cdata, callback))
+    return true;
+
+  return false;
+}
+
+bool distanceRecurse(DynamicAABBTreeContinuousCollisionManager::DynamicAABBNode* root1, DynamicAABBTreeContinuousCollisionManager::DynamicAABBNode* root2, void* cdata, ContinuousDistanceCallBack callback, FCL_REAL& min_dist)
+{
+  if(root1->isLeaf() && root2->isLeaf())
+  {
+    ContinuousCollisionObject* root1_obj = static_cast<ContinuousCollisionObject*>(root1->data);
+    ContinuousCollisionObject* root2_obj = static_cast<ContinuousCollisionObject*>(root2->data);
+    if(!isPairEnabled(root1_obj, root2_obj)) return false;
+    return callback(root1_obj, root2_obj, cdata, min_dist);
+  }
+
+  if(root2->isLeaf() || (!root1->isLeaf() && (root1->bv.size() > root2->bv.size())))
+  {
+    FCL_REAL d1 = root2->bv.distance(root1->children[0]->bv);
+    FCL_REAL d2 = root2->bv.distance(root1->children[1]->bv);
+    int first = (d2 < d1) ? 1 : 0;
+    FCL_REAL d[2] = {d1, d2};
+
+    if(d[first] < min_dist)
+    {
+      if(distanceRecurse(root1->children[first], root2, cdata, callback, min_dist))
+        return true;
+    }
+
+    if(d[1 - first] < min_dist)
+    {
+      if(distanceRecurse(root1->children[1 - first], root2, cdata, callback, min_dist))
+        return true;
+    }
+  }
+  else
+  {
+    FCL_REAL d1 = root1->bv.distance(root2->children[0]->bv);
+    FCL_REAL d2 = root1->bv.distance(root2->children[1]->bv);
+    int first = (d2 < d1) ? 1 : 0;
+    FCL_REAL d[2] = {d1, d2};
+
+    if(d[first] < min_dist)
+    {
+      if(distanceRecurse(root1, root2->children[first], cdata, callback, min_dist))
+        return true;
+    }
+
+    if(d[1 - first] < min_dist)
+    {
+      if(distanceRecurse(root1, root2->children[1 - first], cdata, callback, min_dist))
+        return true;
+    }
+  }
+
+  return false;
+}
+
+bool distanceRecurse(DynamicAABBTreeContinuousCollisionManager::DynamicAABBNode* root, ContinuousCollisionObject* query, void* cdata, ContinuousDistanceCallBack callback, FCL_REAL& min_dist)
+{
+  if(root->isLeaf())
+  {
+    ContinuousCollisionObject* root_obj = static_cast<ContinuousCollisionObject*>(root->data);
+    if(!isPairEnabled(query, root_obj)) return false;
+    return callback(query, root_obj, cdata, min_dist);
+  }
+
+  FCL_REAL d1 = query->getAABB().distance(root->children[0]->bv);
+  FCL_REAL d2 = query->getAABB().distance(root->children[1]->bv);
+  int first = (d2 < d1) ? 1 : 0;
+  FCL_REAL d[2] = {d1, d2};
+
+  if(d[first] < min_dist)
+  {
+    if(distanceRecurse(root->children[first], query, cdata, callback, min_dist))
+      return true;
+  }
+
+  if(d[1 - first] < min_dist)
+  {
+    if(distanceRecurse(root->children[1 - first], query, cdata, callback, min_dist))
+      return true;
+  }
+
+  return false;
+}
+
+bool selfDistanceRecurse(DynamicAABBTreeContinuousCollisionManager::DynamicAABBNode* root, void* cdata, ContinuousDistanceCallBack callback, FCL_REAL& min_dist)
+{
+  if(root->isLeaf()) return false;
+
+  if(selfDistanceRecurse(root->children[0], cdata, callback, min_dist))
+    return true;
+
+  if(selfDistanceRecurse(root->children[1], cdata, callback, min_dist))
+    return true;
+
+  if(distanceRecurse(root->children[0], root->children[1], cdata, callback, min_dist))
+    return true;
+
+  return false;
+}
+
+/// @brief A candidate pair of collideEarliest(), with a lower bound of its time of contact
+struct ContinuousPair
+{
+  ContinuousCollisionObject* o1;
+  ContinuousCollisionObject* o2;
+  FCL_REAL toc_lower_bound;
+  std::size_t id;
+
+  bool operator < (const ContinuousPair& other) const
+  {
+    if(toc_lower_bound != other.toc_lower_bound) return toc_lower_bound < other.toc_lower_bound;
+    return id < other.id;
+  }
+};
+
+static bool collectPair(ContinuousCollisionObject* o1, ContinuousCollisionObject* o2, void* cdata)
+{
+  std::vector<ContinuousPair>* pairs = static_cast<std::vector<ContinuousPair>*>(cdata);
+  ContinuousPair pair;
+  pair.o1 = o1;
+  pair.o2 = o2;
+  pair.toc_lower_bound = 0;
+  pair.id = pairs->size();
+  pairs->push_back(pair);
+  return false;
+}
+
+/// @brief Lower bound of the time of contact of the bounding spheres of the objects, moving from start_time with the
+/// speed bounded by SphereMotionBoundVisitor
+static FCL_REAL timeOfContactLowerBound(const ContinuousCollisionObject* o1, const ContinuousCollisionObject* o2, FCL_REAL start_time)
+{
+  const CollisionGeometry* geom1 = o1->getCollisionGeometry();
+  const CollisionGeometry* geom2 = o2->getCollisionGeometry();
+  const MotionBase* motion1 = o1->getMotion();
+  const MotionBase* motion2 = o2->getMotion();
+
+  motion1->integrate(start_time);
+  motion2->integrate(start_time);
+
+  Transform3f tf1, tf2;
+  motion1->getCurrentTransform(tf1);
+  motion2->getCurrentTransform(tf2);
+
+  FCL_REAL gap = (tf1.transform(geom1->aabb_center) - tf2.transform(geom2->aabb_center)).length() - geom1->aabb_radius - geom2->aabb_radius;
+  if(gap <= 0) return start_time;
+
+  FCL_REAL velocity_bound = motion1->computeMotionBound(SphereMotionBoundVisitor(geom1->aabb_center, geom1->aabb_radius))
+    + motion2->computeMotionBound(SphereMotionBoundVisitor(geom2->aabb_center, geom2->aabb_radius));
+  if(velocity_bound <= std::numeric_limits<FCL_REAL>::min()) return std::numeric_limits<FCL_REAL>::max();
+
+  return start_time + gap / velocity_bound;
+}
+
+/// @brief State of collideEarliest() shared by the threads: the pairs ordered by their lower bound and the earliest
+/// contact found so far
+class EarliestContactSearch
+{
+public:
+  EarliestContactSearch(const std::vector<ContinuousPair>& pairs_, const ContinuousCollisionRequest& request_) :
+    pairs(pairs_), request(request_), next(0), toc(request_.end_time), best(NULL)
+  {
+  }
+
+  /// @brief take pairs from the shared list until there is none that can contact before the best time of contact
+  void runShared()
+  {
+    const ContinuousPair* pair;
+    FCL_REAL end_time;
+    while(nextPair(pair, end_time))
+      advance(*pair, end_time, true);
+  }
+
+  /// @brief run the pairs of a private list, in the order of their lower bounds
+  void runPrivate(const std::vector<ContinuousPair>& private_pairs)
+  {
+    for(std::size_t i = 0; i < private_pairs.size(); ++i)
+    {
+      FCL_REAL end_time;
+      {
+        boost::mutex::scoped_lock lock(mutex);
+        end_time = toc;
+      }
+
+      if(private_pairs[i].toc_lower_bound > end_time) break;
+      advance(private_pairs[i], end_time, false);
+    }
+  }
+
+  const ContinuousPair* getBest() const { return best; }
+
+  const ContinuousCollisionResult& getResult() const { return result; }
+
+private:
+  bool nextPair(const ContinuousPair*& pair, FCL_REAL& end_time)
+  {
+    boost::mutex::scoped_lock lock(mutex);
+
+    if(next >= pairs.size() || pairs[next].toc_lower_bound > toc)
+    {
+      next = pairs.size();
+      return false;
+    }
+
+    pair = &pairs[next++];
+    end_time = toc;
+    return true;
+  }
+
+  void advance(const ContinuousPair& pair, FCL_REAL end_time, bool clone_motions)
+  {
+    ContinuousCollisionRequest pair_request(request);
+    pair_request.end_time = end_time;
+
+    ContinuousCollisionResult pair_result;
+
+    if(clone_motions)
+    {
+      // the motions keep the integrated time, so every thread needs its own copy
+      boost::scoped_ptr<MotionBase> motion1(pair.o1->getMotion()->clone());
+      boost::scoped_ptr<MotionBase> motion2(pair.o2->getMotion()->clone());
+      collide(pair.o1->getCollisionGeometry(), motion1.get(), pair.o2->getCollisionGeometry(), motion2.get(), pair_request, pair_result);
+    }
+    else
+      collide(pair.o1, pair.o2, pair_request, pair_result);
+
+    if(pair_result.numContacts() == 0) return;
+
+    boost::mutex::scoped_lock lock(mutex);
+    FCL_REAL pair_toc = pair_result.getTimeOfContact();
+    if(!best || pair_toc < toc || (pair_toc == toc && pair.id < best->id))
+    {
+      toc = pair_toc;
+      best = &pair;
+      result = pair_result;
+    }
+  }
+
+  const std::vector<ContinuousPair>& pairs;
+  const ContinuousCollisionRequest& request;
+
+  boost::mutex mutex;
+  std::size_t next;
+  FCL_REAL toc;
+  const ContinuousPair* best;
+  ContinuousCollisionResult result;
+};
+
+/// @brief thread entry of collideEarliest()
+struct EarliestContactWorker
+{
+  EarliestContactSearch* search;
+
+  EarliestContactWorker(EarliestContactSearch* search_) : search(search_) {}
+
+  void operator()() const
+  {
+    search->runShared();
+  }
+};
+
+} // dynamic_AABB_tree_continues
+
+} // details
+
+void DynamicAABBTreeContinuousCollisionManager::registerObjects(const std::vector<ContinuousCollisionObject*>& other_objs)
+{
+  if(size() > 0)
+  {
+    BroadPhaseContinuousCollisionManager::registerObjects(other_objs);
+  }
+  else
+  {
+    std::vector<DynamicAABBNode*> leaves(other_objs.size());
+    table.rehash(other_objs.size());
+    for(size_t i = 0, size = other_objs.size(); i < size; ++i)
+    {
+      DynamicAABBNode* node = dtree.createLeaf(other_objs[i]->getAABB(), other_objs[i]); // node will be managed by the dtree
+      table[other_objs[i]] = node;
+      leaves[i] = node;
+    }
+
+    dtree.init(leaves, tree_init_level);
+
+    setup_ = true;
+  }
+}
+
+void DynamicAABBTreeContinuousCollisionManager::registerObject(ContinuousCollisionObject* obj)
+{
+  DynamicAABBNode* node = dtree.insert(obj->getAABB(), obj);
+  table[obj] = node;
+}
+
+void DynamicAABBTreeContinuousCollisionManager::unregisterObject(ContinuousCollisionObject* obj)
+{
+  DynamicAABBNode* node = table[obj];
+  table.erase(obj);
+  dtree.remove(node);
+}
+
+void DynamicAABBTreeContinuousCollisionManager::setup()
+{
+  if(!setup_)
+  {
+    int num = static_cast<int>(dtree.size() );
+    if(num == 0)
+    {
+      setup_ = true;
+      return;
+    }
+
+    int height = static_cast<int>(dtree.getMaxHeight() );
+
+    if(height - std::log((FCL_REAL)num) / std::log(2.0) < max_tree_nonbalanced_level)
+      dtree.balanceIncremental(tree_incremental_balance_pass);
+    else
+      dtree.balanceTopdown();
+
+    setup_ = true;
+  }
+}
+
+void DynamicAABBTreeContinuousCollisionManager::update()
+{
+  for(DynamicAABBTable::const_iterator it = table.begin(); it != table.end(); ++it)
+  {
+    ContinuousCollisionObject* obj = it->first;
+    DynamicAABBNode* node = it->second;
+    node->bv = obj->getAABB();
+  }
+
+  dtree.refit();
+  setup_ = false;
+
+  setup();
+}
+
+void DynamicAABBTreeContinuousCollisionManager::update_(ContinuousCollisionObject* updated_obj)
+{
+  DynamicAABBTable::const_iterator it = table.find(updated_obj);
+  if(it != table.end())
+  {
+    DynamicAABBNode* node = it->second;
+    if(!node->bv.equal(updated_obj->getAABB()))
+      dtree.update(node, updated_obj->getAABB());
+  }
+  setup_ = false;
+}
+
+void DynamicAABBTreeContinuousCollisionManager::update(ContinuousCollisionObject* updated_obj)
+{
+  update_(updated_obj);
+  setup();
+}
+
+void DynamicAABBTreeContinuousCollisionManager::update(const std::vector<ContinuousCollisionObject*>& updated_objs)
+{
+  for(size_t i = 0, size = updated_objs.size(); i < size; ++i)
+    update_(updated_objs[i]);
+  setup();
+}
+
+void DynamicAABBTreeContinuousCollisionManager::collide(ContinuousCollisionObject* obj, void* cdata, ContinuousCollisionCallBack callback) const
+{
+  if(size() == 0) return;
+  details::dynamic_AABB_tree_continues::collisionRecurse(dtree.getRoot(), obj, cdata, callback);
+}
+
+void DynamicAABBTreeContinuousCollisionManager::distance(ContinuousCollisionObject* obj, void* cdata, ContinuousDistanceCallBack callback) const
+{
+  if(size() == 0) return;
+  FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
+  details::dynamic_AABB_tree_continues::distanceRecurse(dtree.getRoot(), obj, cdata, callback, min_dist);
+}
+
+void DynamicAABBTreeContinuousCollisionManager::collide(void* cdata, ContinuousCollisionCallBack callback) const
+{
+  if(size() == 0) return;
+  details::dynamic_AABB_tree_continues::selfCollisionRecurse(dtree.getRoot(), cdata, callback);
+}
+
+void DynamicAABBTreeContinuousCollisionManager::distance(void* cdata, ContinuousDistanceCallBack callback) const
+{
+  if(size() == 0) return;
+  FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
+  details::dynamic_AABB_tree_continues::selfDistanceRecurse(dtree.getRoot(), cdata, callback, min_dist);
+}
+
+void DynamicAABBTreeContinuousCollisionManager::collide(BroadPhaseContinuousCollisionManager* other_manager_, void* cdata, ContinuousCollisionCallBack callback) const
+{
+  DynamicAABBTreeContinuousCollisionManager* other_manager = static_cast<DynamicAABBTreeContinuousCollisionManager*>(other_manager_);
+  if((size() == 0) || (other_manager->size() == 0)) return;
+
+  if(this == other_manager)
+  {
+    collide(cdata, callback);
+    return;
+  }
+
+  details::dynamic_AABB_tree_continues::collisionRecurse(dtree.getRoot(), other_manager->dtree.getRoot(), cdata, callback);
+}
+
+void DynamicAABBTreeContinuousCollisionManager::distance(BroadPhaseContinuousCollisionManager* other_manager_, void* cdata, ContinuousDistanceCallBack callback) const
+{
+  DynamicAABBTreeContinuousCollisionManager* other_manager = static_cast<DynamicAABBTreeContinuousCollisionManager*>(other_manager_);
+  if((size() == 0) || (other_manager->size() == 0)) return;
+
+  if(this == other_manager)
+  {
+    distance(cdata, callback);
+    return;
+  }
+
+  FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
+  details::dynamic_AABB_tree_continues::distanceRecurse(dtree.getRoot(), other_manager->dtree.getRoot(), cdata, callback, min_dist);
+}
+
+int DynamicAABBTreeContinuousCollisionManager::collideEarliest(const ContinuousCollisionRequest& request, ContinuousCollisionResult& result,
+                                                               ContinuousCollisionObject*& o1, ContinuousCollisionObject*& o2) const
+{
+  using namespace details::dynamic_AABB_tree_continues;
+
+  result.clear();
+  result.setTimeOfContact(request.end_time);
+  o1 = NULL;
+  o2 = NULL;
+
+  if(size() == 0 || request.num_max_contacts == 0) return 0;
+
+  std::vector<ContinuousPair> candidates;
+  collide(&candidates, collectPair);
+
+  // pairs with an articular motion cannot be advanced concurrently, the others run on cloned motions
+  std::vector<ContinuousPair> pairs, articular_pairs;
+  for(std::size_t i = 0; i < candidates.size(); ++i)
+  {
+    ContinuousPair& pair = candidates[i];
+    pair.toc_lower_bound = timeOfContactLowerBound(pair.o1, pair.o2, request.start_time);
+    if(pair.toc_lower_bound > request.end_time) continue;
+
+    if(pair.o1->getMotion()->isArticular() || pair.o2->getMotion()->isArticular())
+      articular_pairs.push_back(pair);
+    else
+      pairs.push_back(pair);
+  }
+
+  std::sort(pairs.begin(), pairs.end());
+  std::sort(articular_pairs.begin(), articular_pairs.end());
+
+  EarliestContactSearch search(pairs, request);
+
+  int threads = (num_threads > 0) ? num_threads : static_cast<int>(boost::thread::hardware_concurrency());
+  threads = std::min(threads, static_cast<int>(pairs.size()));
+
+  boost::thread_group workers;
+  for(int i = 1; i < threads; ++i)
+    workers.create_thread(EarliestContactWorker(&search));
+
+  // the calling thread handles the articular pairs first, then helps with the shared list
+  search.runPrivate(articular_pairs);
+  search.runShared();
+
+  workers.join_all();
+
+  if(!search.getBest()) return 0;
+
+  result = search.getResult();
+  o1 = search.getBest()->o1;
+  o2 = search.getBest()->o2;
+
+  return static_cast<int>(result.numContacts());
+}
+
+}
@@ -38,6 +38,7 @@
 #include <algorithm>
 #include <limits>
 #include <boost/bind.hpp>
+#include "fcl/probe.h"
 
 namespace fcl
 {
@@ -182,8 +183,16 @@ void IntervalTreeCollisionManager::setup()
     std::sort(endpoints[2].begin(), endpoints[2].end(), boost::bind(&EndPoint::value, _1) < boost::bind(&EndPoint::value, _2));
 
     for(int i = 0; i < 3; ++i)
+    {
       delete interval_trees[i];
 
+      // the trees do not own the intervals
+      for(std::map<CollisionObject*, SAPInterval*>::const_iterator it = obj_interval_maps[i].begin(), end = obj_interval_maps[i].end();
+          it != end; ++it)
+        delete it->second;
+      obj_interval_maps[i].clear();
+    }
+
     for(int i = 0; i < 3; ++i)
       interval_trees[i] = new IntervalTree;
 
@@ -244,9 +253,8 @@ void IntervalTreeCollisionManager::update()
 }
 
 
-void IntervalTreeCollisionManager::update(CollisionObject* updated_obj)
+void IntervalTreeCollisionManager::updateIntervals_(CollisionObject* updated_obj, AABB& old_aabb)
 {
-  AABB old_aabb;
   const AABB& new_aabb = updated_obj->getAABB();
   for(int i = 0; i < 3; ++i)
   {
@@ -258,6 +266,13 @@ void IntervalTreeCollisionManager::update(CollisionObject* updated_obj)
     it->second->high = new_aabb.max_[i];
     interval_trees[i]->insert(it->second);
   }
+}
+
+void IntervalTreeCollisionManager::update(CollisionObject* updated_obj)
+{
+  AABB old_aabb;
+  const AABB& new_aabb = updated_obj->getAABB();
+  updateIntervals_(updated_obj, old_aabb);
 
   EndPoint dummy;
   std::vector<EndPoint>::iterator it;
@@ -291,8 +306,35 @@ void IntervalTreeCollisionManager::update(CollisionObject* updated_obj)
 
 void IntervalTreeCollisionManager::update(const std::vector<CollisionObject*>& updated_objs)
 {
+  // deleting an interval from a tree searches the whole tree for it: moving k intervals costs O(k n), rebuilding the
+  // trees O(n log n)
+  std::size_t log_size = 1;
+  for(std::size_t n = size(); n > 1; n >>= 1)
+    ++log_size;
+  if(updated_objs.size() > 16 * log_size)
+  {
+    update();
+    return;
+  }
+
+  // the intervals are moved in the trees one by one, but the end points are refreshed and sorted once for the whole
+  // set instead of once per object
+  AABB old_aabb;
   for(size_t i = 0; i < updated_objs.size(); ++i)
-    update(updated_objs[i]);
+    updateIntervals_(updated_objs[i], old_aabb);
+
+  for(int i = 0; i < 3; ++i)
+  {
+    for(size_t j = 0, size = endpoints[i].size(); j < size; ++j)
+    {
+      if(endpoints[i][j].minmax == 0)
+        endpoints[i][j].value = endpoints[i][j].obj->getAABB().min_[i];
+      else
+        endpoints[i][j].value = endpoints[i][j].obj->getAABB().max_[i];
+    }
+
+    std::sort(endpoints[i].begin(), endpoints[i].end(), boost::bind(&EndPoint::value, _1) < boost::bind(&EndPoint::value, _2));
+  }
 }
 
 void IntervalTreeCollisionManager::clear()
@@ -335,6 +377,9 @@ void IntervalTreeCollisionManager::getObjects(std::vector<CollisionObject*>& obj
 
 void IntervalTreeCollisionManager::collide(CollisionObject* obj, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
   collide_(obj, cdata, callback);
 }
@@ -377,6 +422,9 @@ bool IntervalTreeCollisionManager::collide_(CollisionObject* obj, void* cdata, C
 
 void IntervalTreeCollisionManager::distance(CollisionObject* obj, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
   FCL_REAL min_dist = std::numeric_limits<FCL_REAL>::max();
   distance_(obj, cdata, callback, min_dist);
@@ -470,6 +518,9 @@ bool IntervalTreeCollisionManager::distance_(CollisionObject* obj, void* cdata,
 
 void IntervalTreeCollisionManager::collide(void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   std::set<CollisionObject*> active;
@@ -510,7 +561,7 @@ void IntervalTreeCollisionManager::collide(void* cdata, CollisionCallBack callba
           else
             insert_res = overlap.insert(std::make_pair(index, active_index));
 
-          if(insert_res.second)
+          if(insert_res.second && canCollide(active_index, index))
           {
             if(callback(active_index, index, cdata))
               return;
@@ -527,6 +578,9 @@ void IntervalTreeCollisionManager::collide(void* cdata, CollisionCallBack callba
 
 void IntervalTreeCollisionManager::distance(void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   if(size() == 0) return;
 
   enable_tested_set_ = true;
@@ -542,6 +596,9 @@ void IntervalTreeCollisionManager::distance(void* cdata, DistanceCallBack callba
 
 void IntervalTreeCollisionManager::collide(BroadPhaseCollisionManager* other_manager_, void* cdata, CollisionCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   IntervalTreeCollisionManager* other_manager = static_cast<IntervalTreeCollisionManager*>(other_manager_);
 
   if((size() == 0) || (other_manager->size() == 0)) return;
@@ -566,6 +623,9 @@ void IntervalTreeCollisionManager::collide(BroadPhaseCollisionManager* other_man
 
 void IntervalTreeCollisionManager::distance(BroadPhaseCollisionManager* other_manager_, void* cdata, DistanceCallBack callback) const
 {
+  FCL_PROBE_SCOPE(PROBE_BROADPHASE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(enable_statistics_ ? &statistics_ : NULL);
+
   IntervalTreeCollisionManager* other_manager = static_cast<IntervalTreeCollisionManager*>(other_manager_);
 
   if((size() == 0) || (other_manager->size() == 0)) return;
@@ -602,7 +662,7 @@ bool IntervalTreeCollisionManager::checkColl(std::deque<SimpleInterval*>::const_
     SAPInterval* ivl = static_cast<SAPInterval*>(*pos_start); 
     if(ivl->obj != obj)
     {
-      if(ivl->obj->getAABB().overlap(obj->getAABB()))
+      if(ivl->obj->getAABB().overlap(obj->getAABB()) && canCollide(ivl->obj, obj))
       {
         if(callback(ivl->obj, obj, cdata))
           return true;
@@ -82,13 +82,13 @@ public:
 IntervalTree::IntervalTree() :
   current_parent(0)
 {
-  nil = new IntervalTreeNode;
+  nil = node_pool.allocate();
   nil->left = nil->right = nil->parent = nil;
   nil->red = false;
   nil->key = nil->high = nil->max_high = -std::numeric_limits<double>::max();
   nil->stored_interval = NULL;
 
-  root = new IntervalTreeNode;
+  root = node_pool.allocate();
   root->parent = root->left = root->right = nil;
   root->key = root->high = root->max_high = std::numeric_limits<double>::max();
   root->red = false;
@@ -103,38 +103,7 @@ IntervalTree::IntervalTree() :
 
 IntervalTree::~IntervalTree()
 {
-  IntervalTreeNode* x = root->left;
-  std::deque<IntervalTreeNode*> nodes_to_free;
-
-  if(x != nil)
-  {
-    if(x->left != nil)
-    {
-      nodes_to_free.push_back(x->left);
-    }
-    if(x->right != nil)
-    {
-      nodes_to_free.push_back(x->right);
-    }
-
-    delete x;
-    while( nodes_to_free.size() > 0)
-    {
-      x = nodes_to_free.back();
-      nodes_to_free.pop_back();
-      if(x->left != nil)
-      {
-        nodes_to_free.push_back(x->left);
-      }
-      if(x->right != nil)
-      {
-        nodes_to_free.push_back(x->right);
-      }
-      delete x;
-    }
-  }
-  delete nil;
-  delete root;
+  // the nodes are released with their pool
   free(recursion_node_stack);
 }
 
@@ -227,7 +196,7 @@ IntervalTreeNode* IntervalTree::insert(SimpleInterval* new_interval)
   IntervalTreeNode* x;
   IntervalTreeNode* new_node;
 
-  x = new IntervalTreeNode(new_interval);
+  x = node_pool.allocate(new_interval);
   recursiveInsert(x);
   fixupMaxHigh(x->parent);
   new_node = x;
@@ -502,13 +471,13 @@ SimpleInterval* IntervalTree::deleteNode(IntervalTreeNode* z)
     }
     else
       y->red = z->red;
-    delete z;
+    node_pool.deallocate(z);
   }
   else
   {
     fixupMaxHigh(x->parent);
     if(!(y->red)) deleteFixup(x);
-    delete y;
+    node_pool.deallocate(y);
   }
 
   return node_to_delete;
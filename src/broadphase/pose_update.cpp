@@ -0,0 +1,137 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "fcl/broadphase/pose_update.h"
+#include <algorithm>
+#include <cmath>
+
+namespace fcl
+{
+
+namespace details
+{
+
+/// @brief Whether the AABB in world space of a rotated obj is its local AABB rotated and clipped by the box around its
+/// bounding sphere, as CollisionGeometry::computeAABB() computes it, or (sphere_only) the box around the bounding sphere
+static bool isOrientedBoxAABB(const CollisionObject* obj, bool& sphere_only)
+{
+  sphere_only = true;
+  if(!obj->useTightAABB())
+    return true;
+
+  switch(obj->getNodeType())
+  {
+  case GEOM_SPHERE:
+    return true;
+  case GEOM_BOX:
+  case GEOM_CONVEX:
+  case GEOM_OCTREE:
+  case BV_AABB:
+  case BV_KDOP16:
+  case BV_KDOP18:
+  case BV_KDOP24:
+    sphere_only = false;
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// @brief Set the pose of obj, R being the matrix of q, and recompute its AABB. Returns whether the AABB changed
+static bool setPose(CollisionObject* obj, const Matrix3f& R, const Quaternion3f& q, const Vec3f& T)
+{
+  obj->setTransform(R, q, T);
+  AABB old_aabb = obj->getAABB();
+
+  bool sphere_only;
+  if(!q.isIdentity() && isOrientedBoxAABB(obj, sphere_only))
+  {
+    // the same operations as CollisionGeometry::computeAABB(), without the virtual call
+    const CollisionGeometry* cgeom = obj->getCollisionGeometry();
+    Vec3f center = q.transform(cgeom->aabb_center) + T;
+    Vec3f delta(cgeom->aabb_radius);
+    if(!sphere_only)
+    {
+      Vec3f extent = (cgeom->aabb_local.max_ - cgeom->aabb_local.min_) * 0.5;
+      for(int i = 0; i < 3; ++i)
+        delta[i] = std::min(std::fabs(R(i, 0)) * extent[0] + std::fabs(R(i, 1)) * extent[1] + std::fabs(R(i, 2)) * extent[2], delta[i]);
+    }
+    obj->setAABB(AABB(center - delta, center + delta));
+  }
+  else
+    obj->computeAABB();
+
+  return !old_aabb.equal(obj->getAABB());
+}
+
+}
+
+std::size_t setPoses(CollisionObject* const* objs, const Quaternion3f* rotations, const Vec3f* translations, std::size_t n,
+                     std::vector<CollisionObject*>& changed_objs)
+{
+  std::size_t num_changed = 0;
+  Matrix3f R;
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    rotations[i].toRotation(R);
+    if(details::setPose(objs[i], R, rotations[i], translations[i]))
+    {
+      changed_objs.push_back(objs[i]);
+      ++num_changed;
+    }
+  }
+
+  return num_changed;
+}
+
+std::size_t setPoses(CollisionObject* const* objs, const Matrix3f* rotations, const Vec3f* translations, std::size_t n,
+                     std::vector<CollisionObject*>& changed_objs)
+{
+  std::size_t num_changed = 0;
+  Quaternion3f q;
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    q.fromRotation(rotations[i]);
+    if(details::setPose(objs[i], rotations[i], q, translations[i]))
+    {
+      changed_objs.push_back(objs[i]);
+      ++num_changed;
+    }
+  }
+
+  return num_changed;
+}
+
+}
@@ -46,8 +46,9 @@ namespace fcl
 
 InterpolationFactory::InterpolationFactory()
 {
-  InterpolationLinear::registerToFactory();
-  InterpolationThirdOrder::registerToFactory();
+  // register directly: going through instance() here would re-enter the initialization of the static instance
+  registerClass(LINEAR, InterpolationLinear::create);
+  registerClass(THIRD_ORDER, InterpolationThirdOrder::create);
 }
 
 InterpolationFactory& InterpolationFactory::instance()
@@ -39,6 +39,7 @@
 
 #include "fcl/articulated_model/link_bound.h"
 #include "fcl/articulated_model/joint.h"
+#include "fcl/articulated_model/link.h"
 
 namespace fcl
 {
@@ -117,6 +118,27 @@ FCL_REAL TriangleMotionBoundVisitor::visit(const SplineMotion& motion) const
   return R_bound + T_bound;
 }
 
+/// @brief The translation is bounded per axis in both directions, the rotation with the largest value the triangle
+/// bound above can take for a unit direction n, i.e. (1 + sqrt(2)) ||c|| for a point c
+FCL_REAL SphereMotionBoundVisitor::visit(const SplineMotion& motion) const
+{
+  FCL_REAL T_bound = 0;
+  for(int i = 0; i < 3; ++i)
+  {
+    Vec3f n;
+    n[i] = 1;
+    T_bound += std::max(std::fabs(motion.computeTBound(n)), std::fabs(motion.computeTBound(-n)));
+  }
+
+  FCL_REAL tf_t = motion.getCurrentTime();
+  FCL_REAL dWdW_max = motion.computeDWMax();
+  FCL_REAL ratio = std::min(1 - tf_t, dWdW_max);
+
+  FCL_REAL R_bound = (1 + std::sqrt(2.0)) * (center.length() + radius) * 2 * ratio;
+
+  return R_bound + T_bound;
+}
+
 SplineMotion::SplineMotion(const Vec3f& Td0, const Vec3f& Td1, const Vec3f& Td2, const Vec3f& Td3,
                            const Vec3f& Rd0, const Vec3f& Rd1, const Vec3f& Rd2, const Vec3f& Rd3) :
   tf_t(0.0)
@@ -374,6 +396,18 @@ FCL_REAL TriangleMotionBoundVisitor::visit(const ScrewMotion& motion) const
   return mu;
 }
 
+/// @brief Bound the speed of the sphere according to mu < |v| + |w| (||c - p|| + r), where the distance of the center c
+/// from the axis through p does not change during the motion
+FCL_REAL SphereMotionBoundVisitor::visit(const ScrewMotion& motion) const
+{
+  Transform3f tf;
+  motion.getCurrentTransform(tf);
+
+  FCL_REAL proj_max = ((tf.transform(center) - motion.getAxisOrigin()).cross(motion.getAxis())).length() + radius;
+
+  return std::fabs(motion.getLinearVelocity()) + std::fabs(motion.getAngularVelocity()) * proj_max;
+}
+
 
 
 
@@ -441,6 +475,15 @@ FCL_REAL TriangleMotionBoundVisitor::visit(const InterpMotion& motion) const
   return mu;  
 }
 
+/// @brief Bound the speed of the sphere according to mu < ||v|| + |w| (||c - p|| + r), where p is the reference point
+/// the motion rotates about
+FCL_REAL SphereMotionBoundVisitor::visit(const InterpMotion& motion) const
+{
+  FCL_REAL proj_max = (center - motion.getReferencePoint()).length() + radius;
+
+  return motion.getLinearVelocity().length() + std::fabs(motion.getAngularVelocity()) * proj_max;
+}
+
 InterpMotion::InterpMotion()
 {
   // Default angular velocity is zero
@@ -531,6 +574,7 @@ Quaternion3f InterpMotion::absoluteRotation(FCL_REAL dt) const
 
 ArticularMotion::ArticularMotion(boost::shared_ptr<LinkBound> link_bound) :
   link_bound_(link_bound),
+  table_joint_id_(-1),
   reference_point_(Vec3f(0, 0, 0) ),
   //reference_point_(link_bound->getLastJoint()->getTransformToParent().getTranslation() ),
   start_time_(0.0)
@@ -560,9 +604,28 @@ bool ArticularMotion::integrate(double start_time, double end_time) const
   return true;
 }
 
+void ArticularMotion::setMotionBoundTable(const boost::shared_ptr<const MotionBoundTable>& table)
+{
+  motion_bound_table_ = table;
+  table_joint_id_ = -1;
+
+  if (table)
+  {
+    table_joint_id_ = table->getCompiledModel().getLinkJointId(link_bound_->getBoundedLink()->getName() );
+    if (table_joint_id_ < 0)
+      motion_bound_table_.reset();
+  }
+}
+
 FCL_REAL ArticularMotion::getMotionBound(const Vec3f& direction,
   const FCL_REAL max_distance_from_joint_center) const
 {
+  if (motion_bound_table_)
+  {
+    return motion_bound_table_->getMotionBound(table_joint_id_, start_time_, end_time_,
+      direction, max_distance_from_joint_center);
+  }
+
   if (start_time_ <= end_time_)
   {
 	return link_bound_->getMotionBound(start_time_, end_time_, direction, max_distance_from_joint_center);
@@ -576,6 +639,12 @@ FCL_REAL ArticularMotion::getMotionBound(const Vec3f& direction,
 FCL_REAL ArticularMotion::getNonDirectionalMotionBound(
   const FCL_REAL max_distance_from_joint_center) const
 {
+  if (motion_bound_table_)
+  {
+    return motion_bound_table_->getMotionBound(table_joint_id_, start_time_, end_time_,
+      Vec3f(0.0, 0.0, 0.0), max_distance_from_joint_center);
+  }
+
   if (start_time_ <= end_time_)
   {
 	  return link_bound_->getNonDirectionalMotionBound(start_time_, end_time_, max_distance_from_joint_center);
@@ -631,4 +700,11 @@ FCL_REAL TriangleMotionBoundVisitor::visit(const ArticularMotion& motion) const
   return motion.getMotionBound(n, proj_max);
 }
 
+FCL_REAL SphereMotionBoundVisitor::visit(const ArticularMotion& motion) const
+{
+  FCL_REAL proj_max = (center - motion.getReferencePoint()).length() + radius;
+
+  return motion.getNonDirectionalMotionBound(proj_max);
+}
+
 }
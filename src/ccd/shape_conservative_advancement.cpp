@@ -0,0 +1,181 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "fcl/ccd/shape_conservative_advancement.h"
+#include "fcl/distance.h"
+#include "fcl/narrowphase/narrowphase.h"
+
+#include <iostream>
+
+namespace fcl
+{
+
+template<typename NarrowPhaseSolver>
+const FCL_REAL ShapeConservativeAdvancement<NarrowPhaseSolver>::TIME_TOLERANCE = 0.00001;
+
+template<typename NarrowPhaseSolver>
+ShapeConservativeAdvancement<NarrowPhaseSolver>::ShapeConservativeAdvancement(
+  const ContinuousCollisionObject* o1, const ContinuousCollisionObject* o2, const NarrowPhaseSolver* nsolver) :
+  geometry1_(o1->getCollisionGeometry()),
+  geometry2_(o2->getCollisionGeometry()),
+  motion1_(o1->getMotion()),
+  motion2_(o2->getMotion()),
+  nsolver_(nsolver),
+  own_solver_(nsolver == NULL),
+  num_steps_(0)
+{
+  if(own_solver_) nsolver_ = new NarrowPhaseSolver();
+}
+
+template<typename NarrowPhaseSolver>
+ShapeConservativeAdvancement<NarrowPhaseSolver>::ShapeConservativeAdvancement(
+  const CollisionGeometry* geometry1, const MotionBase* motion1,
+  const CollisionGeometry* geometry2, const MotionBase* motion2,
+  const NarrowPhaseSolver* nsolver) :
+  geometry1_(geometry1),
+  geometry2_(geometry2),
+  motion1_(motion1),
+  motion2_(motion2),
+  nsolver_(nsolver),
+  own_solver_(nsolver == NULL),
+  num_steps_(0)
+{
+  if(own_solver_) nsolver_ = new NarrowPhaseSolver();
+}
+
+template<typename NarrowPhaseSolver>
+ShapeConservativeAdvancement<NarrowPhaseSolver>::~ShapeConservativeAdvancement()
+{
+  if(own_solver_) delete nsolver_;
+}
+
+template<typename NarrowPhaseSolver>
+bool ShapeConservativeAdvancement<NarrowPhaseSolver>::isSupported(const CollisionGeometry* geometry1, const CollisionGeometry* geometry2)
+{
+  OBJECT_TYPE object_type1 = geometry1->getObjectType();
+  OBJECT_TYPE object_type2 = geometry2->getObjectType();
+
+  if(object_type1 == OT_GEOM)
+    return object_type2 == OT_GEOM || object_type2 == OT_BVH;
+  if(object_type2 == OT_GEOM)
+    return object_type1 == OT_BVH;
+
+  return false;
+}
+
+template<typename NarrowPhaseSolver>
+int ShapeConservativeAdvancement<NarrowPhaseSolver>::collide(const ContinuousCollisionRequest& request, ContinuousCollisionResult& result)
+{
+  result.clear();
+  num_steps_ = 0;
+
+  if(request.num_max_contacts == 0)
+  {
+    std::cerr << "Warning: should stop early as num_max_contact is " << request.num_max_contacts << " !" << std::endl;
+    return 0;
+  }
+
+  if(!isSupported(geometry1_, geometry2_))
+  {
+    std::cerr << "Warning: conservative advancement between node type " << geometry1_->getNodeType() << " and node type " << geometry2_->getNodeType() << " is not supported" << std::endl;
+    return 0;
+  }
+
+  FCL_REAL toc = request.start_time;
+
+  while(true)
+  {
+    motion1_->integrate(toc);
+    motion2_->integrate(toc);
+
+    DistanceResult distance_result;
+    FCL_REAL distance = computeDistance(distance_result);
+
+    FCL_REAL velocity_bound = computeVelocityBound();
+
+    // the objects cannot meet before the end of the interval
+    if(velocity_bound <= std::numeric_limits<FCL_REAL>::min() && distance > 0)
+    {
+      toc = request.end_time;
+      break;
+    }
+
+    FCL_REAL delta_t = (distance > 0) ? distance / velocity_bound : 0;
+
+    if(delta_t <= TIME_TOLERANCE)
+    {
+      result.addContact(Contact(geometry1_, geometry2_, distance_result.b1, distance_result.b2));
+      break;
+    }
+
+    toc += delta_t;
+    if(toc >= request.end_time)
+    {
+      toc = request.end_time;
+      break;
+    }
+  }
+
+  result.setTimeOfContact(toc);
+
+  return static_cast<int>(result.numContacts());
+}
+
+template<typename NarrowPhaseSolver>
+FCL_REAL ShapeConservativeAdvancement<NarrowPhaseSolver>::computeDistance(DistanceResult& distance_result)
+{
+  Transform3f tf1, tf2;
+  motion1_->getCurrentTransform(tf1);
+  motion2_->getCurrentTransform(tf2);
+
+  ++num_steps_;
+
+  return distance<NarrowPhaseSolver>(geometry1_, tf1, geometry2_, tf2, nsolver_, DistanceRequest(), distance_result);
+}
+
+template<typename NarrowPhaseSolver>
+FCL_REAL ShapeConservativeAdvancement<NarrowPhaseSolver>::computeVelocityBound() const
+{
+  SphereMotionBoundVisitor mb_visitor1(geometry1_->aabb_center, geometry1_->aabb_radius);
+  SphereMotionBoundVisitor mb_visitor2(geometry2_->aabb_center, geometry2_->aabb_radius);
+
+  return motion1_->computeMotionBound(mb_visitor1) + motion2_->computeMotionBound(mb_visitor2);
+}
+
+template class ShapeConservativeAdvancement<GJKSolver_libccd>;
+template class ShapeConservativeAdvancement<GJKSolver_indep>;
+
+}
@@ -0,0 +1,303 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \author Jia Pan */
+
+#include "fcl/ccd/taylor_kernels.h"
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+#if !FCL_SINGLE_PRECISION && (defined(__SSE2__) || defined(_M_X64))
+#  include <emmintrin.h>
+#  define FCL_TAYLOR_KERNELS_SSE 1
+#endif
+
+namespace fcl
+{
+
+namespace details
+{
+
+/// @brief Relative and absolute widening that covers the round-off (and underflow) of one operation
+static const FCL_REAL ROUND_OFF_EPS = std::numeric_limits<FCL_REAL>::epsilon();
+static const FCL_REAL ROUND_OFF_TINY = std::numeric_limits<FCL_REAL>::min();
+
+#if FCL_TAYLOR_KERNELS_SSE
+
+/// @brief Lane 0 holds -lower and lane 1 holds upper
+typedef __m128d IntervalPack;
+
+static inline __m128d lowerSignMask() { return _mm_set_pd(0.0, -0.0); }
+
+static inline IntervalPack load(const Interval& a)
+{
+  return _mm_xor_pd(_mm_loadu_pd(a.i_), lowerSignMask());
+}
+
+static inline Interval store(IntervalPack a)
+{
+  Interval res;
+  _mm_storeu_pd(res.i_, _mm_xor_pd(a, lowerSignMask()));
+  return res;
+}
+
+static inline IntervalPack roundUp(IntervalPack a)
+{
+  __m128d abs_a = _mm_andnot_pd(_mm_set1_pd(-0.0), a);
+  return _mm_add_pd(a, _mm_add_pd(_mm_mul_pd(abs_a, _mm_set1_pd(ROUND_OFF_EPS)), _mm_set1_pd(ROUND_OFF_TINY)));
+}
+
+static inline IntervalPack addRounded(IntervalPack a, IntervalPack b)
+{
+  return roundUp(_mm_add_pd(a, b));
+}
+
+/// @brief (-min(p0, p1), max(p0, p1)) of the two products in p
+static inline IntervalPack hull(__m128d p)
+{
+  __m128d swapped = _mm_shuffle_pd(p, p, 1);
+  return _mm_max_pd(_mm_xor_pd(p, lowerSignMask()), _mm_xor_pd(swapped, lowerSignMask()));
+}
+
+static inline IntervalPack multiplyRounded(const Interval& a, const Interval& b)
+{
+  __m128d bb = _mm_loadu_pd(b.i_);
+  __m128d p = _mm_mul_pd(_mm_set1_pd(a.i_[0]), bb);
+  __m128d q = _mm_mul_pd(_mm_set1_pd(a.i_[1]), bb);
+  __m128d lower = _mm_min_pd(p, q);
+  __m128d upper = _mm_max_pd(p, q);
+  lower = _mm_min_sd(lower, _mm_unpackhi_pd(lower, lower));
+  upper = _mm_max_sd(upper, _mm_unpackhi_pd(upper, upper));
+  return roundUp(_mm_unpacklo_pd(_mm_xor_pd(lower, _mm_set1_pd(-0.0)), upper));
+}
+
+#else
+
+/// @brief i_[0] holds -lower and i_[1] holds upper
+typedef Interval IntervalPack;
+
+static inline IntervalPack load(const Interval& a)
+{
+  return Interval(-a.i_[0], a.i_[1]);
+}
+
+static inline Interval store(const IntervalPack& a)
+{
+  return Interval(-a.i_[0], a.i_[1]);
+}
+
+static inline FCL_REAL roundUp(FCL_REAL a)
+{
+  return a + (std::abs(a) * ROUND_OFF_EPS + ROUND_OFF_TINY);
+}
+
+static inline IntervalPack roundUp(const IntervalPack& a)
+{
+  return Interval(roundUp(a.i_[0]), roundUp(a.i_[1]));
+}
+
+static inline IntervalPack addRounded(const IntervalPack& a, const IntervalPack& b)
+{
+  return roundUp(Interval(a.i_[0] + b.i_[0], a.i_[1] + b.i_[1]));
+}
+
+static inline IntervalPack multiplyRounded(const Interval& a, const Interval& b)
+{
+  FCL_REAL p00 = a.i_[0] * b.i_[0];
+  FCL_REAL p01 = a.i_[0] * b.i_[1];
+  FCL_REAL p10 = a.i_[1] * b.i_[0];
+  FCL_REAL p11 = a.i_[1] * b.i_[1];
+  FCL_REAL lower = std::min(std::min(p00, p01), std::min(p10, p11));
+  FCL_REAL upper = std::max(std::max(p00, p01), std::max(p10, p11));
+  return roundUp(Interval(-lower, upper));
+}
+
+#endif
+
+/// @brief Bound of sum_k coeffs[k] * powers[k]; the products and sums are rounded once at the end, by the
+/// round-off bound of a sum of n products
+static inline IntervalPack boundPolynomialPack(const FCL_REAL* coeffs, const Interval* powers, std::size_t n)
+{
+#if FCL_TAYLOR_KERNELS_SSE
+  __m128d sum = _mm_setzero_pd();
+  __m128d magnitude = _mm_setzero_pd();
+  __m128d sign = _mm_set1_pd(-0.0);
+
+  for(std::size_t k = 0; k < n; ++k)
+  {
+    __m128d term = hull(_mm_mul_pd(_mm_set1_pd(coeffs[k]), _mm_loadu_pd(powers[k].i_)));
+    sum = _mm_add_pd(sum, term);
+    magnitude = _mm_add_pd(magnitude, _mm_andnot_pd(sign, term));
+  }
+
+  __m128d round_off = _mm_mul_pd(magnitude, _mm_set1_pd((n + 1) * ROUND_OFF_EPS));
+  return _mm_add_pd(sum, _mm_add_pd(round_off, _mm_set1_pd(ROUND_OFF_TINY)));
+#else
+  FCL_REAL sum[2] = {0, 0};
+  FCL_REAL magnitude[2] = {0, 0};
+
+  for(std::size_t k = 0; k < n; ++k)
+  {
+    FCL_REAL p0 = coeffs[k] * powers[k].i_[0];
+    FCL_REAL p1 = coeffs[k] * powers[k].i_[1];
+    FCL_REAL lower = -std::min(p0, p1);
+    FCL_REAL upper = std::max(p0, p1);
+    sum[0] += lower;
+    sum[1] += upper;
+    magnitude[0] += std::abs(lower);
+    magnitude[1] += std::abs(upper);
+  }
+
+  FCL_REAL eps = (n + 1) * ROUND_OFF_EPS;
+  return Interval(sum[0] + (magnitude[0] * eps + ROUND_OFF_TINY), sum[1] + (magnitude[1] * eps + ROUND_OFF_TINY));
+#endif
+}
+
+Interval addOutward(const Interval& a, const Interval& b)
+{
+  return store(addRounded(load(a), load(b)));
+}
+
+Interval multiplyOutward(const Interval& a, const Interval& b)
+{
+  return store(multiplyRounded(a, b));
+}
+
+Interval boundPolynomial(const FCL_REAL* coeffs, const Interval* powers, std::size_t n)
+{
+  return store(boundPolynomialPack(coeffs, powers, n));
+}
+
+TaylorProductAccumulator::TaylorProductAccumulator(const Interval* powers) : powers_(powers), num_products_(0)
+{
+  for(std::size_t k = 0; k < TAYLOR_PRODUCT_SIZE; ++k)
+    product_[k] = magnitude_[k] = 0;
+}
+
+void TaylorProductAccumulator::add(const FCL_REAL* p, const Interval& r, const FCL_REAL* q, const Interval& s,
+                                   FCL_REAL weight)
+{
+  ++num_products_;
+
+#if FCL_TAYLOR_KERNELS_SSE
+  // the products p[i] q[j] for i + j in {2 k, 2 k + 1} are summed in register k, with q shifted by one for odd i
+  __m128d q01 = _mm_loadu_pd(q);
+  __m128d q23 = _mm_loadu_pd(q + 2);
+  __m128d q_0 = _mm_unpacklo_pd(_mm_setzero_pd(), q01);
+  __m128d q12 = _mm_shuffle_pd(q01, q23, 1);
+  __m128d q3_ = _mm_unpackhi_pd(q23, _mm_setzero_pd());
+  __m128d sign = _mm_set1_pd(-0.0);
+
+  __m128d p0 = _mm_set1_pd(weight * p[0]);
+  __m128d p1 = _mm_set1_pd(weight * p[1]);
+  __m128d p2 = _mm_set1_pd(weight * p[2]);
+  __m128d p3 = _mm_set1_pd(weight * p[3]);
+
+  __m128d terms[10] = {_mm_mul_pd(p0, q01), _mm_mul_pd(p1, q_0),
+                       _mm_mul_pd(p0, q23), _mm_mul_pd(p1, q12), _mm_mul_pd(p2, q01), _mm_mul_pd(p3, q_0),
+                       _mm_mul_pd(p1, q3_), _mm_mul_pd(p2, q23), _mm_mul_pd(p3, q12),
+                       _mm_mul_pd(p3, q3_)};
+
+  // terms[first[k]], ..., terms[first[k + 1] - 1] go to the coefficients 2 k and 2 k + 1
+  static const int first[5] = {0, 2, 6, 9, 10};
+
+  for(int k = 0; k < 4; ++k)
+  {
+    __m128d sum = _mm_setzero_pd();
+    __m128d magnitude = _mm_setzero_pd();
+    for(int i = first[k]; i < first[k + 1]; ++i)
+    {
+      sum = _mm_add_pd(sum, terms[i]);
+      magnitude = _mm_add_pd(magnitude, _mm_andnot_pd(sign, terms[i]));
+    }
+
+    if(k < 3)
+    {
+      _mm_storeu_pd(product_ + 2 * k, _mm_add_pd(_mm_loadu_pd(product_ + 2 * k), sum));
+      _mm_storeu_pd(magnitude_ + 2 * k, _mm_add_pd(_mm_loadu_pd(magnitude_ + 2 * k), magnitude));
+    }
+    else
+    {
+      product_[6] += _mm_cvtsd_f64(sum);
+      magnitude_[6] += _mm_cvtsd_f64(magnitude);
+    }
+  }
+#else
+  for(std::size_t i = 0; i < 4; ++i)
+  {
+    FCL_REAL wp = weight * p[i];
+    for(std::size_t j = 0; j < 4; ++j)
+    {
+      FCL_REAL pq = wp * q[j];
+      product_[i + j] += pq;
+      magnitude_[i + j] += std::abs(pq);
+    }
+  }
+#endif
+
+  // (p + r)(q + s) - p q = p s + q r + r s
+  bool has_r = (r.i_[0] != 0 || r.i_[1] != 0);
+  bool has_s = (s.i_[0] != 0 || s.i_[1] != 0);
+  if(!has_r && !has_s) return;
+
+  IntervalPack remainder = multiplyRounded(r, s);
+  if(has_s) remainder = addRounded(remainder, multiplyRounded(store(boundPolynomialPack(p, powers_, 4)), s));
+  if(has_r) remainder = addRounded(remainder, multiplyRounded(store(boundPolynomialPack(q, powers_, 4)), r));
+  if(weight != 1) remainder = multiplyRounded(store(remainder), Interval(weight));
+
+  remainder_ = store(addRounded(load(remainder_), remainder));
+}
+
+void TaylorProductAccumulator::getResult(FCL_REAL* coeffs, Interval& remainder) const
+{
+  IntervalPack sum = addRounded(load(remainder_), boundPolynomialPack(product_ + 4, powers_ + 4, 3));
+
+  // each coefficient is a sum of at most 4 n weighted products, its round-off is below (4 n + 2) eps times the
+  // sum of the absolute values of the terms
+  FCL_REAL round_off = 0;
+  for(std::size_t k = 0; k < TAYLOR_PRODUCT_SIZE; ++k)
+    round_off += magnitude_[k] * std::max(std::abs(powers_[k].i_[0]), std::abs(powers_[k].i_[1]));
+  round_off *= (4 * num_products_ + 4) * ROUND_OFF_EPS;
+
+  remainder = store(addRounded(sum, load(Interval(-round_off, round_off))));
+
+  coeffs[0] = product_[0];
+  coeffs[1] = product_[1];
+  coeffs[2] = product_[2];
+  coeffs[3] = product_[3];
+}
+}
+
+}
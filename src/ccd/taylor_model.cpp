@@ -35,6 +35,7 @@
 /** \author Jia Pan */
 
 #include "fcl/ccd/taylor_model.h"
+#include "fcl/ccd/taylor_kernels.h"
 #include <cassert>
 #include <iostream>
 #include <cmath>
@@ -44,6 +45,34 @@
 namespace fcl
 {
 
+/// @brief Widening of the bounds of sin and cos to cover their round-off errors
+#if FCL_SINGLE_PRECISION
+static const FCL_REAL ROUND_OFF_MARGIN = 1e-6;
+#else
+static const FCL_REAL ROUND_OFF_MARGIN = 1e-15;
+#endif
+
+void TimeInterval::setValue(FCL_REAL l, FCL_REAL r)
+{
+  t_.setValue(l, r);
+
+  powers_[0].setValue(1);
+  powers_[1] = t_;
+  for(std::size_t k = 2; k < 7; ++k)
+  {
+    powers_[k] = details::multiplyOutward(powers_[k - 1], t_);
+
+    // even powers are not negative, also when the interval contains zero
+    if(k % 2 == 0 && powers_[k][0] < 0) powers_[k][0] = 0;
+  }
+
+  t2_ = powers_[2];
+  t3_ = powers_[3];
+  t4_ = powers_[4];
+  t5_ = powers_[5];
+  t6_ = powers_[6];
+}
+
 TaylorModel::TaylorModel()
 {
   coeffs_[0] = coeffs_[1] = coeffs_[2] = coeffs_[3] = 0;
@@ -164,36 +193,10 @@ TaylorModel TaylorModel::operator * (FCL_REAL d) const
 TaylorModel& TaylorModel::operator *= (const TaylorModel& other)
 {
   assert(other.time_interval_ == time_interval_);
-  register FCL_REAL c0, c1, c2, c3;
-  register FCL_REAL c0b = other.coeffs_[0], c1b = other.coeffs_[1], c2b = other.coeffs_[2], c3b = other.coeffs_[3];
-
-  const Interval& rb = other.r_;
-
-  c0 = coeffs_[0] * c0b;
-  c1 = coeffs_[0] * c1b + coeffs_[1] * c0b;
-  c2 = coeffs_[0] * c2b + coeffs_[1] * c1b + coeffs_[2] * c0b;
-  c3 = coeffs_[0] * c3b + coeffs_[1] * c2b + coeffs_[2] * c1b + coeffs_[3] * c0b;
-
-  Interval remainder(r_ * rb);
-  register FCL_REAL tempVal = coeffs_[1] * c3b + coeffs_[2] * c2b + coeffs_[3] * c1b;
-  remainder += time_interval_->t4_ * tempVal;
-
-  tempVal = coeffs_[2] * c3b + coeffs_[3] * c2b;
-  remainder += time_interval_->t5_ * tempVal;
-
-  tempVal = coeffs_[3] * c3b;
-  remainder += time_interval_->t6_ * tempVal;
-
-  remainder += ((Interval(coeffs_[0]) + time_interval_->t_ * coeffs_[1] + time_interval_->t2_ * coeffs_[2] + time_interval_->t3_ * coeffs_[3]) * rb +
-                (Interval(c0b) + time_interval_->t_ * c1b + time_interval_->t2_ * c2b + time_interval_->t3_ * c3b) * r_);
-
-  coeffs_[0] = c0;
-  coeffs_[1] = c1;
-  coeffs_[2] = c2;
-  coeffs_[3] = c3;
-
-  r_ = remainder;
-
+  const TaylorModel* a = this;
+  const TaylorModel* b = &other;
+  FCL_REAL weight = 1;
+  sumOfProducts(&a, &b, &weight, 1, *this);
   return *this;
 }
 
@@ -225,16 +228,13 @@ Interval TaylorModel::getBound(FCL_REAL t) const
 
 Interval TaylorModel::getBound(FCL_REAL t0, FCL_REAL t1) const
 {
-  Interval t(t0, t1);
-  Interval t2(t0 * t0, t1 * t1);
-  Interval t3(t0 * t2[0], t1 * t2[1]);
-
-  return Interval(coeffs_[0]) + t * coeffs_[1] + t2 * coeffs_[2] + t3 * coeffs_[3] + r_;
+  TimeInterval t(t0, t1);
+  return details::addOutward(details::boundPolynomial(coeffs_, t.powers_, 4), r_);
 }
 
 Interval TaylorModel::getBound() const
 {
-  return Interval(coeffs_[0] + r_[0], coeffs_[1] + r_[1]) + time_interval_->t_ * coeffs_[1] + time_interval_->t2_ * coeffs_[2] + time_interval_->t3_ * coeffs_[3];
+  return details::addOutward(details::boundPolynomial(coeffs_, time_interval_->powers_, 4), r_);
 }
 
 Interval TaylorModel::getTightBound(FCL_REAL t0, FCL_REAL t1) const
@@ -331,6 +331,23 @@ void TaylorModel::setZero()
   r_.setValue(0);
 }
 
+void sumOfProducts(const TaylorModel* const* a, const TaylorModel* const* b, const FCL_REAL* weights,
+                   std::size_t n, TaylorModel& res)
+{
+  details::TaylorProductAccumulator accumulator(a[0]->time_interval_->powers_);
+
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    assert(a[i]->time_interval_ == a[0]->time_interval_ && b[i]->time_interval_ == a[0]->time_interval_);
+    accumulator.add(a[i]->coeffs_, a[i]->r_, b[i]->coeffs_, b[i]->r_, weights[i]);
+  }
+
+  if(res.time_interval_ != a[0]->time_interval_)
+    res.time_interval_ = a[0]->time_interval_;
+
+  accumulator.getResult(res.coeffs_, res.r_);
+}
+
 TaylorModel operator * (FCL_REAL d, const TaylorModel& a)
 {
   TaylorModel res(a);
@@ -380,8 +397,8 @@ void generateTaylorModelForCosFunc(TaylorModel& tm, FCL_REAL w, FCL_REAL q0)
     else fddddBounds.setValue(cosQR, cosQL);
 
     // enlarge to handle round-off errors
-    fddddBounds[0] -= 1e-15;
-    fddddBounds[1] += 1e-15;
+    fddddBounds[0] -= ROUND_OFF_MARGIN;
+    fddddBounds[1] += ROUND_OFF_MARGIN;
 
     // cos reaches maximum if there exists an integer k in [(w*t0+q0)/2pi, (w*t1+q0)/2pi];
     // cos reaches minimum if there exists an integer k in [(w*t0+q0-pi)/2pi, (w*t1+q0-pi)/2pi]
@@ -416,7 +433,7 @@ void generateTaylorModelForCosFunc(TaylorModel& tm, FCL_REAL w, FCL_REAL q0)
   // [0, midSize4] * fdddBounds
   if(fddddBounds[0] > 0)
     tm.remainder().setValue(0, fddddBounds[1] * midSize4 * (1.0 / 24));
-  else if(fddddBounds[0] < 0)
+  else if(fddddBounds[1] < 0)
     tm.remainder().setValue(fddddBounds[0] * midSize4 * (1.0 / 24), 0);
   else
     tm.remainder().setValue(fddddBounds[0] * midSize4 * (1.0 / 24), fddddBounds[1] * midSize4 * (1.0 / 24));
@@ -451,8 +468,8 @@ void generateTaylorModelForSinFunc(TaylorModel& tm, FCL_REAL w, FCL_REAL q0)
     else fddddBounds.setValue(sinQR, sinQL);
 
     // enlarge to handle round-off errors
-    fddddBounds[0] -= 1e-15;
-    fddddBounds[1] += 1e-15;
+    fddddBounds[0] -= ROUND_OFF_MARGIN;
+    fddddBounds[1] += ROUND_OFF_MARGIN;
 
     // sin reaches maximum if there exists an integer k in [(w*t0+q0-pi/2)/2pi, (w*t1+q0-pi/2)/2pi];
     // sin reaches minimum if there exists an integer k in [(w*t0+q0-pi-pi/2)/2pi, (w*t1+q0-pi-pi/2)/2pi]
@@ -485,7 +502,7 @@ void generateTaylorModelForSinFunc(TaylorModel& tm, FCL_REAL w, FCL_REAL q0)
     // [0, midSize4] * fdddBounds
     if(fddddBounds[0] > 0)
       tm.remainder().setValue(0, fddddBounds[1] * midSize4 * (1.0 / 24));
-    else if(fddddBounds[0] < 0)
+    else if(fddddBounds[1] < 0)
       tm.remainder().setValue(fddddBounds[0] * midSize4 * (1.0 / 24), 0);
     else
       tm.remainder().setValue(fddddBounds[0] * midSize4 * (1.0 / 24), fddddBounds[1] * midSize4 * (1.0 / 24));
@@ -172,14 +172,31 @@ TaylorModel& TVector3::operator [] (size_t i)
 
 TaylorModel TVector3::dot(const TVector3& other) const
 {
-  return i_[0] * other.i_[0] + i_[1] * other.i_[1] + i_[2] * other.i_[2];
+  const TaylorModel* a[3] = {&i_[0], &i_[1], &i_[2]};
+  const TaylorModel* b[3] = {&other.i_[0], &other.i_[1], &other.i_[2]};
+  const FCL_REAL weights[3] = {1, 1, 1};
+
+  TaylorModel res;
+  sumOfProducts(a, b, weights, 3, res);
+  return res;
 }
 
 TVector3 TVector3::cross(const TVector3& other) const
 {
-  return TVector3(i_[1] * other.i_[2] - i_[2] * other.i_[1], 
-                  i_[2] * other.i_[0] - i_[0] * other.i_[2],
-                  i_[0] * other.i_[1] - i_[1] * other.i_[0]);
+  const FCL_REAL weights[2] = {1, -1};
+  TVector3 res;
+
+  for(std::size_t i = 0; i < 3; ++i)
+  {
+    std::size_t j = (i + 1) % 3;
+    std::size_t k = (i + 2) % 3;
+
+    const TaylorModel* a[2] = {&i_[j], &i_[k]};
+    const TaylorModel* b[2] = {&other.i_[k], &other.i_[j]};
+    sumOfProducts(a, b, weights, 2, res.i_[i]);
+  }
+
+  return res;
 }
 
 TaylorModel TVector3::dot(const Vec3f& other) const
@@ -235,7 +252,7 @@ void TVector3::print() const
 
 TaylorModel TVector3::squareLength() const
 {
-  return i_[0] * i_[0] + i_[1] * i_[1] + i_[2] * i_[2];
+  return dot(*this);
 }
 
 void TVector3::setTimeInterval(const boost::shared_ptr<TimeInterval>& time_interval)
@@ -38,8 +38,15 @@
 #include "fcl/collision.h"
 #include "fcl/collision_func_matrix.h"
 #include "fcl/narrowphase/narrowphase.h"
+#include "fcl/probe.h"
+
+#if FCL_HAVE_OCTOMAP
+#include "fcl/octree.h"
+#include "fcl/linear_octree.h"
+#endif
 
 #include <iostream>
+#include <algorithm>
 
 namespace fcl
 {
@@ -68,6 +75,11 @@ std::size_t collide(const CollisionGeometry* o1, const Transform3f& tf1,
                     const CollisionRequest& request,
                     CollisionResult& result)
 {
+  FCL_PROBE_SCOPE(PROBE_COLLIDE);
+  details::QueryStatisticsScope statistics_scope(request.enable_statistics ? &result.statistics : NULL);
+  QueryStatistics* statistics = statistics_scope.statistics();
+  if(statistics) statistics->num_queries++;
+
   const NarrowPhaseSolver* nsolver = nsolver_;
   if(!nsolver_)
     nsolver = new NarrowPhaseSolver();
@@ -138,9 +150,183 @@ std::size_t collide(const CollisionGeometry* o1, const Transform3f& tf1,
   // return collide<GJKSolver_indep>(o1, tf1, o2, tf2, &solver, request, result);
 }
 
+#if FCL_HAVE_OCTOMAP
+
+namespace details
+{
+
+/// @brief Depth first traversal for computeCost(). The result keeps the cost of the cells visited so far as lower bound,
+/// and that cost plus the bounds of the nodes still to visit as upper bound
+template<typename OcTreeT>
+class OcTreeCostTraversal
+{
+public:
+  typedef typename OcTreeT::OcTreeNode OcTreeNode;
+
+  OcTreeCostTraversal(const OcTreeT* tree_, const AABB& box_, FCL_REAL cost_density_,
+                      const CostRequest& request_, CostResult& result_) : tree(tree_),
+                                                                          box(box_),
+                                                                          cost_density(cost_density_),
+                                                                          request(request_),
+                                                                          result(result_)
+  {
+  }
+
+  void run()
+  {
+    const OcTreeNode* root = tree->getRoot();
+    FCL_REAL root_bound = bound(root, tree->getRootBV());
+    result.lower_bound = 0;
+    result.upper_bound = root_bound;
+    if(root_bound == 0 || request.isSatisfied(result)) return;
+
+    // once everything is visited, only rounding separates the two bounds
+    if(!recurse(root, tree->getRootBV(), root_bound))
+      result.upper_bound = result.lower_bound;
+  }
+
+private:
+  /// @brief bound of the cost below a node: its occupancy, or the default occupancy if some cells below it are unknown.
+  /// Free nodes are skipped as in the collision traversal
+  FCL_REAL bound(const OcTreeNode* node, const AABB& bv) const
+  {
+    AABB overlap_part;
+    if(!bv.overlap(box, overlap_part)) return 0;
+
+    FCL_REAL occupancy;
+    if(!node)
+      occupancy = tree->getDefaultOccupancy();
+    else if(tree->isNodeFree(node))
+      return 0;
+    else
+    {
+      occupancy = node->getOccupancy();
+      if(node->hasChildren())
+      {
+        for(unsigned int i = 0; i < 8; ++i)
+        {
+          if(!node->childExists(i))
+          {
+            occupancy = std::max(occupancy, tree->getDefaultOccupancy());
+            break;
+          }
+        }
+      }
+    }
+
+    return occupancy * cost_density * overlap_part.volume();
+  }
+
+  /// @brief visit a node whose bound is already part of the upper bound. Returns true when the query can stop
+  bool recurse(const OcTreeNode* node, const AABB& bv, FCL_REAL node_bound)
+  {
+    if(!node || !node->hasChildren())
+    {
+      // the bound of a cell is its cost
+      result.lower_bound += node_bound;
+      return request.isSatisfied(result);
+    }
+
+    AABB child_bvs[8];
+    FCL_REAL child_bounds[8];
+    result.upper_bound -= node_bound;
+    for(unsigned int i = 0; i < 8; ++i)
+    {
+      computeChildBV(bv, i, child_bvs[i]);
+      child_bounds[i] = bound(node->childExists(i) ? node->getChild(i) : NULL, child_bvs[i]);
+      result.upper_bound += child_bounds[i];
+    }
+
+    if(request.isSatisfied(result)) return true;
+
+    // the children with the largest bounds decide the query first
+    while(true)
+    {
+      int best = -1;
+      for(int i = 0; i < 8; ++i)
+      {
+        if(child_bounds[i] > 0 && (best < 0 || child_bounds[i] > child_bounds[best]))
+          best = i;
+      }
+      if(best < 0) break;
+
+      FCL_REAL child_bound = child_bounds[best];
+      child_bounds[best] = 0;
+      if(recurse(node->childExists(best) ? node->getChild(best) : NULL, child_bvs[best], child_bound))
+        return true;
+    }
+
+    return false;
+  }
+
+  const OcTreeT* tree;
+  AABB box;
+  FCL_REAL cost_density;
+  const CostRequest& request;
+  CostResult& result;
+};
+
+/// @brief bounding box, in the frame tf, of a box given in the world frame
+static AABB toLocalFrame(const AABB& aabb, const Transform3f& tf)
+{
+  if(tf.getQuatRotation().isIdentity())
+    return translate(aabb, -tf.getTranslation());
+
+  Transform3f inv_tf(tf);
+  inv_tf.inverse();
+
+  AABB local_aabb;
+  for(int i = 0; i < 8; ++i)
+  {
+    Vec3f corner((i & 1) ? aabb.max_[0] : aabb.min_[0],
+                 (i & 2) ? aabb.max_[1] : aabb.min_[1],
+                 (i & 4) ? aabb.max_[2] : aabb.min_[2]);
+    local_aabb += inv_tf.transform(corner);
+  }
+  return local_aabb;
+}
+
+}
+
+#endif
+
+FCL_REAL computeCost(const CollisionObject* o1, const CollisionObject* o2,
+                     const CostRequest& request,
+                     CostResult& result)
+{
+  result.clear();
+
+#if FCL_HAVE_OCTOMAP
+  const CollisionObject* octree_obj = o1;
+  const CollisionObject* other_obj = o2;
+  if(o1->getNodeType() != GEOM_OCTREE && o1->getNodeType() != GEOM_LINEAR_OCTREE)
+    std::swap(octree_obj, other_obj);
+
+  AABB box = details::toLocalFrame(other_obj->getAABB(), octree_obj->getTransform());
+  FCL_REAL cost_density = other_obj->getCollisionGeometry()->cost_density;
+
+  if(octree_obj->getNodeType() == GEOM_OCTREE)
+  {
+    const OcTree* tree = static_cast<const OcTree*>(octree_obj->getCollisionGeometry());
+    details::OcTreeCostTraversal<OcTree>(tree, box, cost_density, request, result).run();
+    return result.lower_bound;
+  }
+  else if(octree_obj->getNodeType() == GEOM_LINEAR_OCTREE)
+  {
+    const LinearOcTree* tree = static_cast<const LinearOcTree*>(octree_obj->getCollisionGeometry());
+    details::OcTreeCostTraversal<LinearOcTree>(tree, box, cost_density, request, result).run();
+    return result.lower_bound;
+  }
+#endif
+
+  std::cerr << "Warning: cost query between node type " << o1->getNodeType() << " and node type " << o2->getNodeType() << " is not supported" << std::endl;
+  return 0;
+}
+
 }
 
 #include "fcl/ccd/conservative_advancement.h"
+#include "fcl/ccd/shape_conservative_advancement.h"
 #include "fcl/traversal/traversal_node_bvhs.h"
 namespace fcl
 {
@@ -148,10 +334,24 @@ std::size_t collide(const ContinuousCollisionObject* o1, const ContinuousCollisi
                     const ContinuousCollisionRequest& request,
                     ContinuousCollisionResult& result)
 {
+  return collide(o1->getCollisionGeometry(), o1->getMotion(), o2->getCollisionGeometry(), o2->getMotion(), request, result);
+}
+
+std::size_t collide(const CollisionGeometry* o1, const MotionBase* motion1,
+                    const CollisionGeometry* o2, const MotionBase* motion2,
+                    const ContinuousCollisionRequest& request,
+                    ContinuousCollisionResult& result)
+{
+  if(ShapeConservativeAdvancement<GJKSolver_libccd>::isSupported(o1, o2))
+  {
+    ShapeConservativeAdvancement<GJKSolver_libccd> advancement(o1, motion1, o2, motion2);
+    return advancement.collide(request, result);
+  }
+
   typedef ConservativeAdvancement<RSS, MeshDistanceTraversalNodeRSS, MeshCollisionTraversalNodeRSS>
     ConservativeAdvancementType;
 
-  ConservativeAdvancementType advancement = ConservativeAdvancementType(o1, o2);
+  ConservativeAdvancementType advancement = ConservativeAdvancementType(o1, motion1, o2, motion2);
 
   return advancement.collide(request, result);
 }
@@ -161,6 +361,19 @@ std::size_t collide(const CollisionGeometry* o1, const MotionBase* motion1,
                     const CollisionRequest& request,
                     CollisionResult& result)
 {
+  if(ShapeConservativeAdvancement<GJKSolver_libccd>::isSupported(o1, o2))
+  {
+    ContinuousCollisionRequest continuous_request;
+    ContinuousCollisionResult continuous_result;
+    continuous_request.assign(request);
+
+    ShapeConservativeAdvancement<GJKSolver_libccd> advancement(o1, motion1, o2, motion2);
+    advancement.collide(continuous_request, continuous_result);
+    result = continuous_result;
+
+    return result.numContacts();
+  }
+
   FCL_REAL toc;
   return conservativeAdvancement<RSS, MeshDistanceTraversalNodeRSS, MeshCollisionTraversalNodeRSS>(
                                                                                                                   o1, motion1,
@@ -35,10 +35,87 @@
 /** \author Jia Pan */
 
 #include "fcl/collision_data.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
 
 namespace fcl
 {
 
+void QueryStatistics::clear()
+{
+  num_queries = 0;
+  num_bv_tests = 0;
+  num_leaf_tests = 0;
+  num_gjk_calls = 0;
+  num_gjk_iterations = 0;
+  num_epa_iterations = 0;
+  time = 0;
+}
+
+QueryStatistics& QueryStatistics::operator += (const QueryStatistics& other)
+{
+  num_queries += other.num_queries;
+  num_bv_tests += other.num_bv_tests;
+  num_leaf_tests += other.num_leaf_tests;
+  num_gjk_calls += other.num_gjk_calls;
+  num_gjk_iterations += other.num_gjk_iterations;
+  num_epa_iterations += other.num_epa_iterations;
+  time += other.time;
+  return *this;
+}
+
+namespace details
+{
+
+/// @brief innermost scope of the thread gathering statistics
+static FCL_THREAD_LOCAL QueryStatisticsScope* query_statistics_scope = NULL;
+
+static FCL_REAL statisticsClock()
+{
+  static const boost::posix_time::ptime origin = boost::posix_time::microsec_clock::universal_time();
+  return (boost::posix_time::microsec_clock::universal_time() - origin).total_microseconds() * 1e-6;
+}
+
+QueryStatistics* getQueryStatistics()
+{
+  QueryStatisticsScope* scope = query_statistics_scope;
+  return scope ? &scope->local_ : NULL;
+}
+
+QueryStatisticsScope::QueryStatisticsScope(QueryStatistics* target) : target_(target),
+                                                                      parent_(query_statistics_scope),
+                                                                      start_(0)
+{
+  if(!target_) return;
+
+  // a manager query calling another one of the same manager must not count twice
+  for(QueryStatisticsScope* scope = parent_; scope; scope = scope->parent_)
+  {
+    if(scope->target_ == target_)
+    {
+      target_ = NULL;
+      return;
+    }
+  }
+
+  query_statistics_scope = this;
+  start_ = statisticsClock();
+}
+
+QueryStatisticsScope::~QueryStatisticsScope()
+{
+  if(!target_) return;
+
+  query_statistics_scope = parent_;
+
+  // the enclosing scope measures its own time
+  if(parent_) parent_->local_ += local_;
+
+  local_.time = statisticsClock() - start_;
+  *target_ += local_;
+}
+
+}
+
 bool CollisionRequest::isSatisfied(const CollisionResult& result) const
 {
   return (!enable_cost) && result.isCollision() && (num_max_contacts <= result.numContacts());
@@ -50,6 +127,19 @@ void CollisionRequest::assign(const CollisionRequest& request)
 }
 
 
+bool CostRequest::isSatisfied(const CostResult& result) const
+{
+  // the default threshold asks for the exact cost
+  if(cost_threshold == std::numeric_limits<FCL_REAL>::max()) return false;
+  return result.isAbove(cost_threshold) || result.isBelow(cost_threshold);
+}
+
+void CostResult::clear()
+{
+  lower_bound = 0;
+  upper_bound = 0;
+}
+
 bool DistanceRequest::isSatisfied(const DistanceResult& result) const
 {
   return (result.min_distance <= 0);
@@ -95,6 +185,7 @@ void CollisionResult::clear()
 {
 	contacts_.clear();
 	cost_sources_.clear();
+	statistics.clear();
 }
 
 
@@ -103,6 +194,8 @@ void ContinuousCollisionResult::clear()
 	CollisionResult::clear();
 
 	time_of_contact_ = 0.0;
+	num_iterations_ = 0;
+	num_distance_queries_ = 0;
 }
 
 }
\ No newline at end of file
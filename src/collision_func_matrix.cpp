@@ -40,22 +40,24 @@
 #include "fcl/traversal/traversal_node_setup.h"
 #include "fcl/collision_node.h"
 #include "fcl/narrowphase/narrowphase.h"
+#include "fcl/sdf_solver.h"
+#include "fcl/traversal/traversal_node_compact.h"
 
 
 namespace fcl
 {
 
 #if FCL_HAVE_OCTOMAP
-template<typename T_SH, typename NarrowPhaseSolver>
+template<typename T_SH, typename T_OCTREE, typename NarrowPhaseSolver>
 std::size_t ShapeOcTreeCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2,
                                const NarrowPhaseSolver* nsolver,
                                const CollisionRequest& request, CollisionResult& result)
 {
   if(request.isSatisfied(result)) return result.numContacts();
 
-  ShapeOcTreeCollisionTraversalNode<T_SH, NarrowPhaseSolver> node;
+  ShapeOcTreeCollisionTraversalNode<T_SH, NarrowPhaseSolver, T_OCTREE> node;
   const T_SH* obj1 = static_cast<const T_SH*>(o1);
-  const OcTree* obj2 = static_cast<const OcTree*>(o2);
+  const T_OCTREE* obj2 = static_cast<const T_OCTREE*>(o2);
   OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
   initialize(node, *obj1, tf1, *obj2, tf2, &otsolver, request, result);
@@ -64,15 +66,15 @@ std::size_t ShapeOcTreeCollide(const CollisionGeometry* o1, const Transform3f& t
   return result.numContacts();
 }
 
-template<typename T_SH, typename NarrowPhaseSolver>
+template<typename T_OCTREE, typename T_SH, typename NarrowPhaseSolver>
 std::size_t OcTreeShapeCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2,
                                const NarrowPhaseSolver* nsolver,
                                const CollisionRequest& request, CollisionResult& result)
 {
   if(request.isSatisfied(result)) return result.numContacts();
 
-  OcTreeShapeCollisionTraversalNode<T_SH, NarrowPhaseSolver> node;
-  const OcTree* obj1 = static_cast<const OcTree*>(o1);
+  OcTreeShapeCollisionTraversalNode<T_SH, NarrowPhaseSolver, T_OCTREE> node;
+  const T_OCTREE* obj1 = static_cast<const T_OCTREE*>(o1);
   const T_SH* obj2 = static_cast<const T_SH*>(o2);
   OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
@@ -82,16 +84,16 @@ std::size_t OcTreeShapeCollide(const CollisionGeometry* o1, const Transform3f& t
   return result.numContacts();
 }
 
-template<typename NarrowPhaseSolver>
+template<typename T_OCTREE1, typename T_OCTREE2, typename NarrowPhaseSolver>
 std::size_t OcTreeCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2,
                           const NarrowPhaseSolver* nsolver,
                           const CollisionRequest& request, CollisionResult& result)
 {
   if(request.isSatisfied(result)) return result.numContacts();
 
-  OcTreeCollisionTraversalNode<NarrowPhaseSolver> node;
-  const OcTree* obj1 = static_cast<const OcTree*>(o1);
-  const OcTree* obj2 = static_cast<const OcTree*>(o2);
+  OcTreeCollisionTraversalNode<NarrowPhaseSolver, T_OCTREE1, T_OCTREE2> node;
+  const T_OCTREE1* obj1 = static_cast<const T_OCTREE1*>(o1);
+  const T_OCTREE2* obj2 = static_cast<const T_OCTREE2*>(o2);
   OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
   initialize(node, *obj1, tf1, *obj2, tf2, &otsolver, request, result);
@@ -100,7 +102,7 @@ std::size_t OcTreeCollide(const CollisionGeometry* o1, const Transform3f& tf1, c
   return result.numContacts();
 }
 
-template<typename T_BVH, typename NarrowPhaseSolver>
+template<typename T_OCTREE, typename T_BVH, typename NarrowPhaseSolver>
 std::size_t OcTreeBVHCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2,
                              const NarrowPhaseSolver* nsolver,
                              const CollisionRequest& request, CollisionResult& result)
@@ -112,8 +114,8 @@ std::size_t OcTreeBVHCollide(const CollisionGeometry* o1, const Transform3f& tf1
     CollisionRequest no_cost_request(request); // request remove cost to avoid the exact but expensive cost computation between mesh and octree
     no_cost_request.enable_cost = false; // disable cost computation
 
-    OcTreeMeshCollisionTraversalNode<T_BVH, NarrowPhaseSolver> node;
-    const OcTree* obj1 = static_cast<const OcTree*>(o1);
+    OcTreeMeshCollisionTraversalNode<T_BVH, NarrowPhaseSolver, T_OCTREE> node;
+    const T_OCTREE* obj1 = static_cast<const T_OCTREE*>(o1);
     const BVHModel<T_BVH>* obj2 = static_cast<const BVHModel<T_BVH>*>(o2);
     OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
@@ -129,12 +131,12 @@ std::size_t OcTreeBVHCollide(const CollisionGeometry* o1, const Transform3f& tf1
     box.threshold_free = obj2->threshold_free;
 
     CollisionRequest only_cost_request(result.numContacts(), false, request.num_max_cost_sources, true, false); // additional cost request, no contacts
-    OcTreeShapeCollide<Box, NarrowPhaseSolver>(o1, tf1, &box, box_tf, nsolver, only_cost_request, result);
+    OcTreeShapeCollide<T_OCTREE, Box, NarrowPhaseSolver>(o1, tf1, &box, box_tf, nsolver, only_cost_request, result);
   }
   else
   {
-    OcTreeMeshCollisionTraversalNode<T_BVH, NarrowPhaseSolver> node;
-    const OcTree* obj1 = static_cast<const OcTree*>(o1);
+    OcTreeMeshCollisionTraversalNode<T_BVH, NarrowPhaseSolver, T_OCTREE> node;
+    const T_OCTREE* obj1 = static_cast<const T_OCTREE*>(o1);
     const BVHModel<T_BVH>* obj2 = static_cast<const BVHModel<T_BVH>*>(o2);
     OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
@@ -145,7 +147,7 @@ std::size_t OcTreeBVHCollide(const CollisionGeometry* o1, const Transform3f& tf1
   return result.numContacts();
 }
 
-template<typename T_BVH, typename NarrowPhaseSolver>
+template<typename T_BVH, typename T_OCTREE, typename NarrowPhaseSolver>
 std::size_t BVHOcTreeCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2,
                              const NarrowPhaseSolver* nsolver,
                              const CollisionRequest& request, CollisionResult& result)
@@ -157,9 +159,9 @@ std::size_t BVHOcTreeCollide(const CollisionGeometry* o1, const Transform3f& tf1
     CollisionRequest no_cost_request(request); // request remove cost to avoid the exact but expensive cost computation between mesh and octree
     no_cost_request.enable_cost = false; // disable cost computation
 
-    MeshOcTreeCollisionTraversalNode<T_BVH, NarrowPhaseSolver> node;
+    MeshOcTreeCollisionTraversalNode<T_BVH, NarrowPhaseSolver, T_OCTREE> node;
     const BVHModel<T_BVH>* obj1 = static_cast<const BVHModel<T_BVH>*>(o1);
-    const OcTree* obj2 = static_cast<const OcTree*>(o2);
+    const T_OCTREE* obj2 = static_cast<const T_OCTREE*>(o2);
     OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
     initialize(node, *obj1, tf1, *obj2, tf2, &otsolver, no_cost_request, result);
@@ -174,13 +176,13 @@ std::size_t BVHOcTreeCollide(const CollisionGeometry* o1, const Transform3f& tf1
     box.threshold_free = obj1->threshold_free;
 
     CollisionRequest only_cost_request(result.numContacts(), false, request.num_max_cost_sources, true, false);
-    ShapeOcTreeCollide<Box, NarrowPhaseSolver>(&box, box_tf, o2, tf2, nsolver, only_cost_request, result);
+    ShapeOcTreeCollide<Box, T_OCTREE, NarrowPhaseSolver>(&box, box_tf, o2, tf2, nsolver, only_cost_request, result);
   }
   else
   {
-    MeshOcTreeCollisionTraversalNode<T_BVH, NarrowPhaseSolver> node;
+    MeshOcTreeCollisionTraversalNode<T_BVH, NarrowPhaseSolver, T_OCTREE> node;
     const BVHModel<T_BVH>* obj1 = static_cast<const BVHModel<T_BVH>*>(o1);
-    const OcTree* obj2 = static_cast<const OcTree*>(o2);
+    const T_OCTREE* obj2 = static_cast<const T_OCTREE*>(o2);
     OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
     initialize(node, *obj1, tf1, *obj2, tf2, &otsolver, request, result);
@@ -192,6 +194,96 @@ std::size_t BVHOcTreeCollide(const CollisionGeometry* o1, const Transform3f& tf1
 
 #endif
 
+template<typename T_SH, typename NarrowPhaseSolver>
+std::size_t SDFShapeCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2,
+                            const NarrowPhaseSolver* nsolver,
+                            const CollisionRequest& request, CollisionResult& result)
+{
+  if(request.isSatisfied(result)) return result.numContacts();
+
+  const SignedDistanceField* obj1 = static_cast<const SignedDistanceField*>(o1);
+  const T_SH* obj2 = static_cast<const T_SH*>(o2);
+  SDFSolver sdfsolver(obj1, tf1);
+
+  sdfsolver.shapeIntersect(obj1, *obj2, tf2, false, request, result);
+
+  return result.numContacts();
+}
+
+template<typename T_SH, typename NarrowPhaseSolver>
+std::size_t ShapeSDFCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2,
+                            const NarrowPhaseSolver* nsolver,
+                            const CollisionRequest& request, CollisionResult& result)
+{
+  if(request.isSatisfied(result)) return result.numContacts();
+
+  const T_SH* obj1 = static_cast<const T_SH*>(o1);
+  const SignedDistanceField* obj2 = static_cast<const SignedDistanceField*>(o2);
+  SDFSolver sdfsolver(obj2, tf2);
+
+  sdfsolver.shapeIntersect(obj2, *obj1, tf1, true, request, result);
+
+  return result.numContacts();
+}
+
+template<typename T_BVH, typename NarrowPhaseSolver>
+std::size_t SDFBVHCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2,
+                          const NarrowPhaseSolver* nsolver,
+                          const CollisionRequest& request, CollisionResult& result)
+{
+  if(request.isSatisfied(result)) return result.numContacts();
+
+  const SignedDistanceField* obj1 = static_cast<const SignedDistanceField*>(o1);
+  const BVHModel<T_BVH>* obj2 = static_cast<const BVHModel<T_BVH>*>(o2);
+  SDFSolver sdfsolver(obj1, tf1);
+
+  sdfsolver.meshIntersect(obj1, *obj2, tf2, false, request, result);
+
+  return result.numContacts();
+}
+
+template<typename T_BVH, typename NarrowPhaseSolver>
+std::size_t BVHSDFCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2,
+                          const NarrowPhaseSolver* nsolver,
+                          const CollisionRequest& request, CollisionResult& result)
+{
+  if(request.isSatisfied(result)) return result.numContacts();
+
+  const BVHModel<T_BVH>* obj1 = static_cast<const BVHModel<T_BVH>*>(o1);
+  const SignedDistanceField* obj2 = static_cast<const SignedDistanceField*>(o2);
+  SDFSolver sdfsolver(obj2, tf2);
+
+  sdfsolver.meshIntersect(obj2, *obj1, tf1, true, request, result);
+
+  return result.numContacts();
+}
+
+template<typename T_SH, typename NarrowPhaseSolver>
+std::size_t CompactShapeCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2,
+                                const NarrowPhaseSolver* nsolver,
+                                const CollisionRequest& request, CollisionResult& result)
+{
+  if(request.isSatisfied(result)) return result.numContacts();
+
+  const CompactBVHModel* obj1 = static_cast<const CompactBVHModel*>(o1);
+  const T_SH* obj2 = static_cast<const T_SH*>(o2);
+
+  return compactShapeCollide(obj1, tf1, obj2, tf2, nsolver, request, result);
+}
+
+template<typename NarrowPhaseSolver>
+std::size_t CompactCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2,
+                           const NarrowPhaseSolver* nsolver,
+                           const CollisionRequest& request, CollisionResult& result)
+{
+  if(request.isSatisfied(result)) return result.numContacts();
+
+  const CompactBVHModel* obj1 = static_cast<const CompactBVHModel*>(o1);
+  const CompactBVHModel* obj2 = static_cast<const CompactBVHModel*>(o2);
+
+  return compactCollide(obj1, tf1, obj2, tf2, request, result);
+}
+
 template<typename T_SH1, typename T_SH2, typename NarrowPhaseSolver>
 std::size_t ShapeShapeCollide(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2, 
                               const NarrowPhaseSolver* nsolver,
@@ -568,42 +660,120 @@ CollisionFunctionMatrix<NarrowPhaseSolver>::CollisionFunctionMatrix()
   collision_matrix[BV_kIOS][BV_kIOS] = &BVHCollide<kIOS, NarrowPhaseSolver>;
   collision_matrix[BV_OBBRSS][BV_OBBRSS] = &BVHCollide<OBBRSS, NarrowPhaseSolver>;
 
+  collision_matrix[BV_COMPACT][GEOM_BOX] = &CompactShapeCollide<Box, NarrowPhaseSolver>;
+  collision_matrix[BV_COMPACT][GEOM_SPHERE] = &CompactShapeCollide<Sphere, NarrowPhaseSolver>;
+  collision_matrix[BV_COMPACT][GEOM_CAPSULE] = &CompactShapeCollide<Capsule, NarrowPhaseSolver>;
+  collision_matrix[BV_COMPACT][GEOM_CONE] = &CompactShapeCollide<Cone, NarrowPhaseSolver>;
+  collision_matrix[BV_COMPACT][GEOM_CYLINDER] = &CompactShapeCollide<Cylinder, NarrowPhaseSolver>;
+  collision_matrix[BV_COMPACT][GEOM_CONVEX] = &CompactShapeCollide<Convex, NarrowPhaseSolver>;
+  collision_matrix[BV_COMPACT][GEOM_PLANE] = &CompactShapeCollide<Plane, NarrowPhaseSolver>;
+  collision_matrix[BV_COMPACT][BV_COMPACT] = &CompactCollide<NarrowPhaseSolver>;
+
+  collision_matrix[GEOM_SDF][GEOM_BOX] = &SDFShapeCollide<Box, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][GEOM_SPHERE] = &SDFShapeCollide<Sphere, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][GEOM_CAPSULE] = &SDFShapeCollide<Capsule, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][GEOM_CONE] = &SDFShapeCollide<Cone, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][GEOM_CYLINDER] = &SDFShapeCollide<Cylinder, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][GEOM_CONVEX] = &SDFShapeCollide<Convex, NarrowPhaseSolver>;
+
+  collision_matrix[GEOM_BOX][GEOM_SDF] = &ShapeSDFCollide<Box, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SPHERE][GEOM_SDF] = &ShapeSDFCollide<Sphere, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CAPSULE][GEOM_SDF] = &ShapeSDFCollide<Capsule, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CONE][GEOM_SDF] = &ShapeSDFCollide<Cone, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CYLINDER][GEOM_SDF] = &ShapeSDFCollide<Cylinder, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CONVEX][GEOM_SDF] = &ShapeSDFCollide<Convex, NarrowPhaseSolver>;
+
+  collision_matrix[GEOM_SDF][BV_AABB] = &SDFBVHCollide<AABB, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][BV_OBB] = &SDFBVHCollide<OBB, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][BV_RSS] = &SDFBVHCollide<RSS, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][BV_OBBRSS] = &SDFBVHCollide<OBBRSS, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][BV_kIOS] = &SDFBVHCollide<kIOS, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][BV_KDOP16] = &SDFBVHCollide<KDOP<16>, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][BV_KDOP18] = &SDFBVHCollide<KDOP<18>, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SDF][BV_KDOP24] = &SDFBVHCollide<KDOP<24>, NarrowPhaseSolver>;
+
+  collision_matrix[BV_AABB][GEOM_SDF] = &BVHSDFCollide<AABB, NarrowPhaseSolver>;
+  collision_matrix[BV_OBB][GEOM_SDF] = &BVHSDFCollide<OBB, NarrowPhaseSolver>;
+  collision_matrix[BV_RSS][GEOM_SDF] = &BVHSDFCollide<RSS, NarrowPhaseSolver>;
+  collision_matrix[BV_OBBRSS][GEOM_SDF] = &BVHSDFCollide<OBBRSS, NarrowPhaseSolver>;
+  collision_matrix[BV_kIOS][GEOM_SDF] = &BVHSDFCollide<kIOS, NarrowPhaseSolver>;
+  collision_matrix[BV_KDOP16][GEOM_SDF] = &BVHSDFCollide<KDOP<16>, NarrowPhaseSolver>;
+  collision_matrix[BV_KDOP18][GEOM_SDF] = &BVHSDFCollide<KDOP<18>, NarrowPhaseSolver>;
+  collision_matrix[BV_KDOP24][GEOM_SDF] = &BVHSDFCollide<KDOP<24>, NarrowPhaseSolver>;
+
 #if FCL_HAVE_OCTOMAP
-  collision_matrix[GEOM_OCTREE][GEOM_BOX] = &OcTreeShapeCollide<Box, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][GEOM_SPHERE] = &OcTreeShapeCollide<Sphere, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][GEOM_CAPSULE] = &OcTreeShapeCollide<Capsule, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][GEOM_CONE] = &OcTreeShapeCollide<Cone, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][GEOM_CYLINDER] = &OcTreeShapeCollide<Cylinder, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][GEOM_CONVEX] = &OcTreeShapeCollide<Convex, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][GEOM_PLANE] = &OcTreeShapeCollide<Plane, NarrowPhaseSolver>;
-
-  collision_matrix[GEOM_BOX][GEOM_OCTREE] = &ShapeOcTreeCollide<Box, NarrowPhaseSolver>;
-  collision_matrix[GEOM_SPHERE][GEOM_OCTREE] = &ShapeOcTreeCollide<Sphere, NarrowPhaseSolver>;
-  collision_matrix[GEOM_CAPSULE][GEOM_OCTREE] = &ShapeOcTreeCollide<Capsule, NarrowPhaseSolver>;
-  collision_matrix[GEOM_CONE][GEOM_OCTREE] = &ShapeOcTreeCollide<Cone, NarrowPhaseSolver>;
-  collision_matrix[GEOM_CYLINDER][GEOM_OCTREE] = &ShapeOcTreeCollide<Cylinder, NarrowPhaseSolver>;
-  collision_matrix[GEOM_CONVEX][GEOM_OCTREE] = &ShapeOcTreeCollide<Convex, NarrowPhaseSolver>;
-  collision_matrix[GEOM_PLANE][GEOM_OCTREE] = &ShapeOcTreeCollide<Plane, NarrowPhaseSolver>;
-
-  collision_matrix[GEOM_OCTREE][GEOM_OCTREE] = &OcTreeCollide<NarrowPhaseSolver>;
-
-  collision_matrix[GEOM_OCTREE][BV_AABB] = &OcTreeBVHCollide<AABB, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][BV_OBB] = &OcTreeBVHCollide<OBB, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][BV_RSS] = &OcTreeBVHCollide<RSS, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][BV_OBBRSS] = &OcTreeBVHCollide<OBBRSS, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][BV_kIOS] = &OcTreeBVHCollide<kIOS, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][BV_KDOP16] = &OcTreeBVHCollide<KDOP<16>, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][BV_KDOP18] = &OcTreeBVHCollide<KDOP<18>, NarrowPhaseSolver>;
-  collision_matrix[GEOM_OCTREE][BV_KDOP24] = &OcTreeBVHCollide<KDOP<24>, NarrowPhaseSolver>;
-
-  collision_matrix[BV_AABB][GEOM_OCTREE] = &BVHOcTreeCollide<AABB, NarrowPhaseSolver>;
-  collision_matrix[BV_OBB][GEOM_OCTREE] = &BVHOcTreeCollide<OBB, NarrowPhaseSolver>;
-  collision_matrix[BV_RSS][GEOM_OCTREE] = &BVHOcTreeCollide<RSS, NarrowPhaseSolver>;
-  collision_matrix[BV_OBBRSS][GEOM_OCTREE] = &BVHOcTreeCollide<OBBRSS, NarrowPhaseSolver>;
-  collision_matrix[BV_kIOS][GEOM_OCTREE] = &BVHOcTreeCollide<kIOS, NarrowPhaseSolver>;
-  collision_matrix[BV_KDOP16][GEOM_OCTREE] = &BVHOcTreeCollide<KDOP<16>, NarrowPhaseSolver>;
-  collision_matrix[BV_KDOP18][GEOM_OCTREE] = &BVHOcTreeCollide<KDOP<18>, NarrowPhaseSolver>;
-  collision_matrix[BV_KDOP24][GEOM_OCTREE] = &BVHOcTreeCollide<KDOP<24>, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][GEOM_BOX] = &OcTreeShapeCollide<OcTree, Box, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][GEOM_SPHERE] = &OcTreeShapeCollide<OcTree, Sphere, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][GEOM_CAPSULE] = &OcTreeShapeCollide<OcTree, Capsule, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][GEOM_CONE] = &OcTreeShapeCollide<OcTree, Cone, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][GEOM_CYLINDER] = &OcTreeShapeCollide<OcTree, Cylinder, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][GEOM_CONVEX] = &OcTreeShapeCollide<OcTree, Convex, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][GEOM_PLANE] = &OcTreeShapeCollide<OcTree, Plane, NarrowPhaseSolver>;
+
+  collision_matrix[GEOM_BOX][GEOM_OCTREE] = &ShapeOcTreeCollide<Box, OcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SPHERE][GEOM_OCTREE] = &ShapeOcTreeCollide<Sphere, OcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CAPSULE][GEOM_OCTREE] = &ShapeOcTreeCollide<Capsule, OcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CONE][GEOM_OCTREE] = &ShapeOcTreeCollide<Cone, OcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CYLINDER][GEOM_OCTREE] = &ShapeOcTreeCollide<Cylinder, OcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CONVEX][GEOM_OCTREE] = &ShapeOcTreeCollide<Convex, OcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_PLANE][GEOM_OCTREE] = &ShapeOcTreeCollide<Plane, OcTree, NarrowPhaseSolver>;
+
+  collision_matrix[GEOM_LINEAR_OCTREE][GEOM_BOX] = &OcTreeShapeCollide<LinearOcTree, Box, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][GEOM_SPHERE] = &OcTreeShapeCollide<LinearOcTree, Sphere, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][GEOM_CAPSULE] = &OcTreeShapeCollide<LinearOcTree, Capsule, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][GEOM_CONE] = &OcTreeShapeCollide<LinearOcTree, Cone, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][GEOM_CYLINDER] = &OcTreeShapeCollide<LinearOcTree, Cylinder, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][GEOM_CONVEX] = &OcTreeShapeCollide<LinearOcTree, Convex, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][GEOM_PLANE] = &OcTreeShapeCollide<LinearOcTree, Plane, NarrowPhaseSolver>;
+
+  collision_matrix[GEOM_BOX][GEOM_LINEAR_OCTREE] = &ShapeOcTreeCollide<Box, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_SPHERE][GEOM_LINEAR_OCTREE] = &ShapeOcTreeCollide<Sphere, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CAPSULE][GEOM_LINEAR_OCTREE] = &ShapeOcTreeCollide<Capsule, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CONE][GEOM_LINEAR_OCTREE] = &ShapeOcTreeCollide<Cone, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CYLINDER][GEOM_LINEAR_OCTREE] = &ShapeOcTreeCollide<Cylinder, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_CONVEX][GEOM_LINEAR_OCTREE] = &ShapeOcTreeCollide<Convex, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_PLANE][GEOM_LINEAR_OCTREE] = &ShapeOcTreeCollide<Plane, LinearOcTree, NarrowPhaseSolver>;
+
+  collision_matrix[GEOM_OCTREE][GEOM_OCTREE] = &OcTreeCollide<OcTree, OcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][GEOM_LINEAR_OCTREE] = &OcTreeCollide<OcTree, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][GEOM_OCTREE] = &OcTreeCollide<LinearOcTree, OcTree, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][GEOM_LINEAR_OCTREE] = &OcTreeCollide<LinearOcTree, LinearOcTree, NarrowPhaseSolver>;
+
+  collision_matrix[GEOM_OCTREE][BV_AABB] = &OcTreeBVHCollide<OcTree, AABB, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][BV_OBB] = &OcTreeBVHCollide<OcTree, OBB, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][BV_RSS] = &OcTreeBVHCollide<OcTree, RSS, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][BV_OBBRSS] = &OcTreeBVHCollide<OcTree, OBBRSS, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][BV_kIOS] = &OcTreeBVHCollide<OcTree, kIOS, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][BV_KDOP16] = &OcTreeBVHCollide<OcTree, KDOP<16>, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][BV_KDOP18] = &OcTreeBVHCollide<OcTree, KDOP<18>, NarrowPhaseSolver>;
+  collision_matrix[GEOM_OCTREE][BV_KDOP24] = &OcTreeBVHCollide<OcTree, KDOP<24>, NarrowPhaseSolver>;
+
+  collision_matrix[BV_AABB][GEOM_OCTREE] = &BVHOcTreeCollide<AABB, OcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_OBB][GEOM_OCTREE] = &BVHOcTreeCollide<OBB, OcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_RSS][GEOM_OCTREE] = &BVHOcTreeCollide<RSS, OcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_OBBRSS][GEOM_OCTREE] = &BVHOcTreeCollide<OBBRSS, OcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_kIOS][GEOM_OCTREE] = &BVHOcTreeCollide<kIOS, OcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_KDOP16][GEOM_OCTREE] = &BVHOcTreeCollide<KDOP<16>, OcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_KDOP18][GEOM_OCTREE] = &BVHOcTreeCollide<KDOP<18>, OcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_KDOP24][GEOM_OCTREE] = &BVHOcTreeCollide<KDOP<24>, OcTree, NarrowPhaseSolver>;
+
+  collision_matrix[GEOM_LINEAR_OCTREE][BV_AABB] = &OcTreeBVHCollide<LinearOcTree, AABB, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][BV_OBB] = &OcTreeBVHCollide<LinearOcTree, OBB, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][BV_RSS] = &OcTreeBVHCollide<LinearOcTree, RSS, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][BV_OBBRSS] = &OcTreeBVHCollide<LinearOcTree, OBBRSS, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][BV_kIOS] = &OcTreeBVHCollide<LinearOcTree, kIOS, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][BV_KDOP16] = &OcTreeBVHCollide<LinearOcTree, KDOP<16>, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][BV_KDOP18] = &OcTreeBVHCollide<LinearOcTree, KDOP<18>, NarrowPhaseSolver>;
+  collision_matrix[GEOM_LINEAR_OCTREE][BV_KDOP24] = &OcTreeBVHCollide<LinearOcTree, KDOP<24>, NarrowPhaseSolver>;
+
+  collision_matrix[BV_AABB][GEOM_LINEAR_OCTREE] = &BVHOcTreeCollide<AABB, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_OBB][GEOM_LINEAR_OCTREE] = &BVHOcTreeCollide<OBB, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_RSS][GEOM_LINEAR_OCTREE] = &BVHOcTreeCollide<RSS, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_OBBRSS][GEOM_LINEAR_OCTREE] = &BVHOcTreeCollide<OBBRSS, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_kIOS][GEOM_LINEAR_OCTREE] = &BVHOcTreeCollide<kIOS, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_KDOP16][GEOM_LINEAR_OCTREE] = &BVHOcTreeCollide<KDOP<16>, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_KDOP18][GEOM_LINEAR_OCTREE] = &BVHOcTreeCollide<KDOP<18>, LinearOcTree, NarrowPhaseSolver>;
+  collision_matrix[BV_KDOP24][GEOM_LINEAR_OCTREE] = &BVHOcTreeCollide<KDOP<24>, LinearOcTree, NarrowPhaseSolver>;
 #endif
 }
 
@@ -43,6 +43,8 @@ namespace fcl
 
 void collide(CollisionTraversalNodeBase* node, BVHFrontList* front_list)
 {
+  node->query_statistics = details::getQueryStatistics();
+
   if(front_list && front_list->size() > 0)
   {
     propagateBVHFrontListCollisionRecurse(node, front_list);
@@ -55,6 +57,8 @@ void collide(CollisionTraversalNodeBase* node, BVHFrontList* front_list)
 
 void collide2(MeshCollisionTraversalNodeOBB* node, BVHFrontList* front_list)
 {
+  node->query_statistics = details::getQueryStatistics();
+
   if(front_list && front_list->size() > 0)
   {
     propagateBVHFrontListCollisionRecurse(node, front_list);
@@ -75,6 +79,8 @@ void collide2(MeshCollisionTraversalNodeOBB* node, BVHFrontList* front_list)
 
 void collide2(MeshCollisionTraversalNodeRSS* node, BVHFrontList* front_list)
 {
+  node->query_statistics = details::getQueryStatistics();
+
   if(front_list && front_list->size() > 0)
   {
     propagateBVHFrontListCollisionRecurse(node, front_list);
@@ -89,6 +95,7 @@ void collide2(MeshCollisionTraversalNodeRSS* node, BVHFrontList* front_list)
 
 void selfCollide(CollisionTraversalNodeBase* node, BVHFrontList* front_list)
 {
+  node->query_statistics = details::getQueryStatistics();
 
   if(front_list && front_list->size() > 0)
   {
@@ -102,6 +109,7 @@ void selfCollide(CollisionTraversalNodeBase* node, BVHFrontList* front_list)
 
 void distance(DistanceTraversalNodeBase* node, BVHFrontList* front_list, int qsize)
 {
+  node->query_statistics = details::getQueryStatistics();
   node->preprocess();
   
   if(qsize <= 2)
@@ -37,6 +37,7 @@
 #include "fcl/distance.h"
 #include "fcl/distance_func_matrix.h"
 #include "fcl/narrowphase/narrowphase.h"
+#include "fcl/probe.h"
 
 #include <iostream>
 
@@ -64,6 +65,11 @@ FCL_REAL distance(const CollisionGeometry* o1, const Transform3f& tf1,
                   const NarrowPhaseSolver* nsolver_,
                   const DistanceRequest& request, DistanceResult& result)
 {
+  FCL_PROBE_SCOPE(PROBE_DISTANCE);
+  details::QueryStatisticsScope statistics_scope(request.enable_statistics ? &result.statistics : NULL);
+  QueryStatistics* statistics = statistics_scope.statistics();
+  if(statistics) statistics->num_queries++;
+
   const NarrowPhaseSolver* nsolver = nsolver_;
   if(!nsolver_) 
     nsolver = new NarrowPhaseSolver();
@@ -39,19 +39,20 @@
 #include "fcl/collision_node.h"
 #include "fcl/traversal/traversal_node_setup.h"
 #include "fcl/narrowphase/narrowphase.h"
+#include "fcl/sdf_solver.h"
 
 namespace fcl
 {
 
 #if FCL_HAVE_OCTOMAP
-template<typename T_SH, typename NarrowPhaseSolver>
+template<typename T_SH, typename T_OCTREE, typename NarrowPhaseSolver>
 FCL_REAL ShapeOcTreeDistance(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2, const NarrowPhaseSolver* nsolver,
                              const DistanceRequest& request, DistanceResult& result)
 {
   if(request.isSatisfied(result)) return result.min_distance;
-  ShapeOcTreeDistanceTraversalNode<T_SH, NarrowPhaseSolver> node;
+  ShapeOcTreeDistanceTraversalNode<T_SH, NarrowPhaseSolver, T_OCTREE> node;
   const T_SH* obj1 = static_cast<const T_SH*>(o1);
-  const OcTree* obj2 = static_cast<const OcTree*>(o2);
+  const T_OCTREE* obj2 = static_cast<const T_OCTREE*>(o2);
   OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
   initialize(node, *obj1, tf1, *obj2, tf2, &otsolver, request, result);
@@ -60,13 +61,13 @@ FCL_REAL ShapeOcTreeDistance(const CollisionGeometry* o1, const Transform3f& tf1
   return result.min_distance;
 }
 
-template<typename T_SH, typename NarrowPhaseSolver>
+template<typename T_OCTREE, typename T_SH, typename NarrowPhaseSolver>
 FCL_REAL OcTreeShapeDistance(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2, const NarrowPhaseSolver* nsolver,
                              const DistanceRequest& request, DistanceResult& result)
 {
   if(request.isSatisfied(result)) return result.min_distance;
-  OcTreeShapeDistanceTraversalNode<T_SH, NarrowPhaseSolver> node;
-  const OcTree* obj1 = static_cast<const OcTree*>(o1);
+  OcTreeShapeDistanceTraversalNode<T_SH, NarrowPhaseSolver, T_OCTREE> node;
+  const T_OCTREE* obj1 = static_cast<const T_OCTREE*>(o1);
   const T_SH* obj2 = static_cast<const T_SH*>(o2);
   OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
@@ -76,14 +77,14 @@ FCL_REAL OcTreeShapeDistance(const CollisionGeometry* o1, const Transform3f& tf1
   return result.min_distance;
 }
 
-template<typename NarrowPhaseSolver>
+template<typename T_OCTREE1, typename T_OCTREE2, typename NarrowPhaseSolver>
 FCL_REAL OcTreeDistance(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2, const NarrowPhaseSolver* nsolver,
                         const DistanceRequest& request, DistanceResult& result)
 {
   if(request.isSatisfied(result)) return result.min_distance;
-  OcTreeDistanceTraversalNode<NarrowPhaseSolver> node;
-  const OcTree* obj1 = static_cast<const OcTree*>(o1);
-  const OcTree* obj2 = static_cast<const OcTree*>(o2);
+  OcTreeDistanceTraversalNode<NarrowPhaseSolver, T_OCTREE1, T_OCTREE2> node;
+  const T_OCTREE1* obj1 = static_cast<const T_OCTREE1*>(o1);
+  const T_OCTREE2* obj2 = static_cast<const T_OCTREE2*>(o2);
   OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
   initialize(node, *obj1, tf1, *obj2, tf2, &otsolver, request, result);
@@ -92,14 +93,14 @@ FCL_REAL OcTreeDistance(const CollisionGeometry* o1, const Transform3f& tf1, con
   return result.min_distance;
 }
 
-template<typename T_BVH, typename NarrowPhaseSolver>
+template<typename T_BVH, typename T_OCTREE, typename NarrowPhaseSolver>
 FCL_REAL BVHOcTreeDistance(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2, const NarrowPhaseSolver* nsolver,
                            const DistanceRequest& request, DistanceResult& result)
 {
   if(request.isSatisfied(result)) return result.min_distance;
-  MeshOcTreeDistanceTraversalNode<T_BVH, NarrowPhaseSolver> node;
+  MeshOcTreeDistanceTraversalNode<T_BVH, NarrowPhaseSolver, T_OCTREE> node;
   const BVHModel<T_BVH>* obj1 = static_cast<const BVHModel<T_BVH>*>(o1);
-  const OcTree* obj2 = static_cast<const OcTree*>(o2);
+  const T_OCTREE* obj2 = static_cast<const T_OCTREE*>(o2);
   OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
   initialize(node, *obj1, tf1, *obj2, tf2, &otsolver, request, result);
@@ -108,13 +109,13 @@ FCL_REAL BVHOcTreeDistance(const CollisionGeometry* o1, const Transform3f& tf1,
   return result.min_distance;
 }
 
-template<typename T_BVH, typename NarrowPhaseSolver>
+template<typename T_OCTREE, typename T_BVH, typename NarrowPhaseSolver>
 FCL_REAL OcTreeBVHDistance(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2, const NarrowPhaseSolver* nsolver,
                        const DistanceRequest& request, DistanceResult& result)
 {
   if(request.isSatisfied(result)) return result.min_distance;
-  OcTreeMeshDistanceTraversalNode<T_BVH, NarrowPhaseSolver> node;
-  const OcTree* obj1 = static_cast<const OcTree*>(o1);
+  OcTreeMeshDistanceTraversalNode<T_BVH, NarrowPhaseSolver, T_OCTREE> node;
+  const T_OCTREE* obj1 = static_cast<const T_OCTREE*>(o1);
   const BVHModel<T_BVH>* obj2 = static_cast<const BVHModel<T_BVH>*>(o2);
   OcTreeSolver<NarrowPhaseSolver> otsolver(nsolver);
 
@@ -126,6 +127,62 @@ FCL_REAL OcTreeBVHDistance(const CollisionGeometry* o1, const Transform3f& tf1,
 
 #endif
 
+template<typename T_SH, typename NarrowPhaseSolver>
+FCL_REAL SDFShapeDistance(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2, const NarrowPhaseSolver* nsolver,
+                          const DistanceRequest& request, DistanceResult& result)
+{
+  if(request.isSatisfied(result)) return result.min_distance;
+  const SignedDistanceField* obj1 = static_cast<const SignedDistanceField*>(o1);
+  const T_SH* obj2 = static_cast<const T_SH*>(o2);
+  SDFSolver sdfsolver(obj1, tf1);
+
+  sdfsolver.shapeDistance(obj1, *obj2, tf2, false, request, result);
+
+  return result.min_distance;
+}
+
+template<typename T_SH, typename NarrowPhaseSolver>
+FCL_REAL ShapeSDFDistance(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2, const NarrowPhaseSolver* nsolver,
+                          const DistanceRequest& request, DistanceResult& result)
+{
+  if(request.isSatisfied(result)) return result.min_distance;
+  const T_SH* obj1 = static_cast<const T_SH*>(o1);
+  const SignedDistanceField* obj2 = static_cast<const SignedDistanceField*>(o2);
+  SDFSolver sdfsolver(obj2, tf2);
+
+  sdfsolver.shapeDistance(obj2, *obj1, tf1, true, request, result);
+
+  return result.min_distance;
+}
+
+template<typename T_BVH, typename NarrowPhaseSolver>
+FCL_REAL SDFBVHDistance(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2, const NarrowPhaseSolver* nsolver,
+                        const DistanceRequest& request, DistanceResult& result)
+{
+  if(request.isSatisfied(result)) return result.min_distance;
+  const SignedDistanceField* obj1 = static_cast<const SignedDistanceField*>(o1);
+  const BVHModel<T_BVH>* obj2 = static_cast<const BVHModel<T_BVH>*>(o2);
+  SDFSolver sdfsolver(obj1, tf1);
+
+  sdfsolver.meshDistance(obj1, *obj2, tf2, false, request, result);
+
+  return result.min_distance;
+}
+
+template<typename T_BVH, typename NarrowPhaseSolver>
+FCL_REAL BVHSDFDistance(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2, const NarrowPhaseSolver* nsolver,
+                        const DistanceRequest& request, DistanceResult& result)
+{
+  if(request.isSatisfied(result)) return result.min_distance;
+  const BVHModel<T_BVH>* obj1 = static_cast<const BVHModel<T_BVH>*>(o1);
+  const SignedDistanceField* obj2 = static_cast<const SignedDistanceField*>(o2);
+  SDFSolver sdfsolver(obj2, tf2);
+
+  sdfsolver.meshDistance(obj2, *obj1, tf1, true, request, result);
+
+  return result.min_distance;
+}
+
 template<typename T_SH1, typename T_SH2, typename NarrowPhaseSolver>
 FCL_REAL ShapeShapeDistance(const CollisionGeometry* o1, const Transform3f& tf1, const CollisionGeometry* o2, const Transform3f& tf2, const NarrowPhaseSolver* nsolver,
                         const DistanceRequest& request, DistanceResult& result)
@@ -423,42 +480,111 @@ DistanceFunctionMatrix<NarrowPhaseSolver>::DistanceFunctionMatrix()
   distance_matrix[BV_kIOS][BV_kIOS] = &BVHDistance<kIOS, NarrowPhaseSolver>;
   distance_matrix[BV_OBBRSS][BV_OBBRSS] = &BVHDistance<OBBRSS, NarrowPhaseSolver>;
 
+  distance_matrix[GEOM_SDF][GEOM_BOX] = &SDFShapeDistance<Box, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][GEOM_SPHERE] = &SDFShapeDistance<Sphere, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][GEOM_CAPSULE] = &SDFShapeDistance<Capsule, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][GEOM_CONE] = &SDFShapeDistance<Cone, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][GEOM_CYLINDER] = &SDFShapeDistance<Cylinder, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][GEOM_CONVEX] = &SDFShapeDistance<Convex, NarrowPhaseSolver>;
+
+  distance_matrix[GEOM_BOX][GEOM_SDF] = &ShapeSDFDistance<Box, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SPHERE][GEOM_SDF] = &ShapeSDFDistance<Sphere, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CAPSULE][GEOM_SDF] = &ShapeSDFDistance<Capsule, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CONE][GEOM_SDF] = &ShapeSDFDistance<Cone, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CYLINDER][GEOM_SDF] = &ShapeSDFDistance<Cylinder, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CONVEX][GEOM_SDF] = &ShapeSDFDistance<Convex, NarrowPhaseSolver>;
+
+  distance_matrix[GEOM_SDF][BV_AABB] = &SDFBVHDistance<AABB, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][BV_OBB] = &SDFBVHDistance<OBB, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][BV_RSS] = &SDFBVHDistance<RSS, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][BV_OBBRSS] = &SDFBVHDistance<OBBRSS, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][BV_kIOS] = &SDFBVHDistance<kIOS, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][BV_KDOP16] = &SDFBVHDistance<KDOP<16>, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][BV_KDOP18] = &SDFBVHDistance<KDOP<18>, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SDF][BV_KDOP24] = &SDFBVHDistance<KDOP<24>, NarrowPhaseSolver>;
+
+  distance_matrix[BV_AABB][GEOM_SDF] = &BVHSDFDistance<AABB, NarrowPhaseSolver>;
+  distance_matrix[BV_OBB][GEOM_SDF] = &BVHSDFDistance<OBB, NarrowPhaseSolver>;
+  distance_matrix[BV_RSS][GEOM_SDF] = &BVHSDFDistance<RSS, NarrowPhaseSolver>;
+  distance_matrix[BV_OBBRSS][GEOM_SDF] = &BVHSDFDistance<OBBRSS, NarrowPhaseSolver>;
+  distance_matrix[BV_kIOS][GEOM_SDF] = &BVHSDFDistance<kIOS, NarrowPhaseSolver>;
+  distance_matrix[BV_KDOP16][GEOM_SDF] = &BVHSDFDistance<KDOP<16>, NarrowPhaseSolver>;
+  distance_matrix[BV_KDOP18][GEOM_SDF] = &BVHSDFDistance<KDOP<18>, NarrowPhaseSolver>;
+  distance_matrix[BV_KDOP24][GEOM_SDF] = &BVHSDFDistance<KDOP<24>, NarrowPhaseSolver>;
+
 #if FCL_HAVE_OCTOMAP
-  distance_matrix[GEOM_OCTREE][GEOM_BOX] = &OcTreeShapeDistance<Box, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][GEOM_SPHERE] = &OcTreeShapeDistance<Sphere, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][GEOM_CAPSULE] = &OcTreeShapeDistance<Capsule, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][GEOM_CONE] = &OcTreeShapeDistance<Cone, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][GEOM_CYLINDER] = &OcTreeShapeDistance<Cylinder, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][GEOM_CONVEX] = &OcTreeShapeDistance<Convex, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][GEOM_PLANE] = &OcTreeShapeDistance<Plane, NarrowPhaseSolver>;
-
-  distance_matrix[GEOM_BOX][GEOM_OCTREE] = &ShapeOcTreeDistance<Box, NarrowPhaseSolver>;
-  distance_matrix[GEOM_SPHERE][GEOM_OCTREE] = &ShapeOcTreeDistance<Sphere, NarrowPhaseSolver>;
-  distance_matrix[GEOM_CAPSULE][GEOM_OCTREE] = &ShapeOcTreeDistance<Capsule, NarrowPhaseSolver>;
-  distance_matrix[GEOM_CONE][GEOM_OCTREE] = &ShapeOcTreeDistance<Cone, NarrowPhaseSolver>;
-  distance_matrix[GEOM_CYLINDER][GEOM_OCTREE] = &ShapeOcTreeDistance<Cylinder, NarrowPhaseSolver>;
-  distance_matrix[GEOM_CONVEX][GEOM_OCTREE] = &ShapeOcTreeDistance<Convex, NarrowPhaseSolver>;
-  distance_matrix[GEOM_PLANE][GEOM_OCTREE] = &ShapeOcTreeDistance<Plane, NarrowPhaseSolver>;
-
-  distance_matrix[GEOM_OCTREE][GEOM_OCTREE] = &OcTreeDistance<NarrowPhaseSolver>;
-
-  distance_matrix[GEOM_OCTREE][BV_AABB] = &OcTreeBVHDistance<AABB, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][BV_OBB] = &OcTreeBVHDistance<OBB, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][BV_RSS] = &OcTreeBVHDistance<RSS, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][BV_OBBRSS] = &OcTreeBVHDistance<OBBRSS, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][BV_kIOS] = &OcTreeBVHDistance<kIOS, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][BV_KDOP16] = &OcTreeBVHDistance<KDOP<16>, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][BV_KDOP18] = &OcTreeBVHDistance<KDOP<18>, NarrowPhaseSolver>;
-  distance_matrix[GEOM_OCTREE][BV_KDOP24] = &OcTreeBVHDistance<KDOP<24>, NarrowPhaseSolver>;
-
-  distance_matrix[BV_AABB][GEOM_OCTREE] = &BVHOcTreeDistance<AABB, NarrowPhaseSolver>;
-  distance_matrix[BV_OBB][GEOM_OCTREE] = &BVHOcTreeDistance<OBB, NarrowPhaseSolver>;
-  distance_matrix[BV_RSS][GEOM_OCTREE] = &BVHOcTreeDistance<RSS, NarrowPhaseSolver>;
-  distance_matrix[BV_OBBRSS][GEOM_OCTREE] = &BVHOcTreeDistance<OBBRSS, NarrowPhaseSolver>;
-  distance_matrix[BV_kIOS][GEOM_OCTREE] = &BVHOcTreeDistance<kIOS, NarrowPhaseSolver>;
-  distance_matrix[BV_KDOP16][GEOM_OCTREE] = &BVHOcTreeDistance<KDOP<16>, NarrowPhaseSolver>;
-  distance_matrix[BV_KDOP18][GEOM_OCTREE] = &BVHOcTreeDistance<KDOP<18>, NarrowPhaseSolver>;
-  distance_matrix[BV_KDOP24][GEOM_OCTREE] = &BVHOcTreeDistance<KDOP<24>, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][GEOM_BOX] = &OcTreeShapeDistance<OcTree, Box, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][GEOM_SPHERE] = &OcTreeShapeDistance<OcTree, Sphere, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][GEOM_CAPSULE] = &OcTreeShapeDistance<OcTree, Capsule, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][GEOM_CONE] = &OcTreeShapeDistance<OcTree, Cone, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][GEOM_CYLINDER] = &OcTreeShapeDistance<OcTree, Cylinder, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][GEOM_CONVEX] = &OcTreeShapeDistance<OcTree, Convex, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][GEOM_PLANE] = &OcTreeShapeDistance<OcTree, Plane, NarrowPhaseSolver>;
+
+  distance_matrix[GEOM_BOX][GEOM_OCTREE] = &ShapeOcTreeDistance<Box, OcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SPHERE][GEOM_OCTREE] = &ShapeOcTreeDistance<Sphere, OcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CAPSULE][GEOM_OCTREE] = &ShapeOcTreeDistance<Capsule, OcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CONE][GEOM_OCTREE] = &ShapeOcTreeDistance<Cone, OcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CYLINDER][GEOM_OCTREE] = &ShapeOcTreeDistance<Cylinder, OcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CONVEX][GEOM_OCTREE] = &ShapeOcTreeDistance<Convex, OcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_PLANE][GEOM_OCTREE] = &ShapeOcTreeDistance<Plane, OcTree, NarrowPhaseSolver>;
+
+  distance_matrix[GEOM_LINEAR_OCTREE][GEOM_BOX] = &OcTreeShapeDistance<LinearOcTree, Box, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][GEOM_SPHERE] = &OcTreeShapeDistance<LinearOcTree, Sphere, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][GEOM_CAPSULE] = &OcTreeShapeDistance<LinearOcTree, Capsule, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][GEOM_CONE] = &OcTreeShapeDistance<LinearOcTree, Cone, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][GEOM_CYLINDER] = &OcTreeShapeDistance<LinearOcTree, Cylinder, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][GEOM_CONVEX] = &OcTreeShapeDistance<LinearOcTree, Convex, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][GEOM_PLANE] = &OcTreeShapeDistance<LinearOcTree, Plane, NarrowPhaseSolver>;
+
+  distance_matrix[GEOM_BOX][GEOM_LINEAR_OCTREE] = &ShapeOcTreeDistance<Box, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_SPHERE][GEOM_LINEAR_OCTREE] = &ShapeOcTreeDistance<Sphere, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CAPSULE][GEOM_LINEAR_OCTREE] = &ShapeOcTreeDistance<Capsule, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CONE][GEOM_LINEAR_OCTREE] = &ShapeOcTreeDistance<Cone, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CYLINDER][GEOM_LINEAR_OCTREE] = &ShapeOcTreeDistance<Cylinder, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_CONVEX][GEOM_LINEAR_OCTREE] = &ShapeOcTreeDistance<Convex, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_PLANE][GEOM_LINEAR_OCTREE] = &ShapeOcTreeDistance<Plane, LinearOcTree, NarrowPhaseSolver>;
+
+  distance_matrix[GEOM_OCTREE][GEOM_OCTREE] = &OcTreeDistance<OcTree, OcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][GEOM_LINEAR_OCTREE] = &OcTreeDistance<OcTree, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][GEOM_OCTREE] = &OcTreeDistance<LinearOcTree, OcTree, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][GEOM_LINEAR_OCTREE] = &OcTreeDistance<LinearOcTree, LinearOcTree, NarrowPhaseSolver>;
+
+  distance_matrix[GEOM_OCTREE][BV_AABB] = &OcTreeBVHDistance<OcTree, AABB, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][BV_OBB] = &OcTreeBVHDistance<OcTree, OBB, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][BV_RSS] = &OcTreeBVHDistance<OcTree, RSS, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][BV_OBBRSS] = &OcTreeBVHDistance<OcTree, OBBRSS, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][BV_kIOS] = &OcTreeBVHDistance<OcTree, kIOS, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][BV_KDOP16] = &OcTreeBVHDistance<OcTree, KDOP<16>, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][BV_KDOP18] = &OcTreeBVHDistance<OcTree, KDOP<18>, NarrowPhaseSolver>;
+  distance_matrix[GEOM_OCTREE][BV_KDOP24] = &OcTreeBVHDistance<OcTree, KDOP<24>, NarrowPhaseSolver>;
+
+  distance_matrix[BV_AABB][GEOM_OCTREE] = &BVHOcTreeDistance<AABB, OcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_OBB][GEOM_OCTREE] = &BVHOcTreeDistance<OBB, OcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_RSS][GEOM_OCTREE] = &BVHOcTreeDistance<RSS, OcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_OBBRSS][GEOM_OCTREE] = &BVHOcTreeDistance<OBBRSS, OcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_kIOS][GEOM_OCTREE] = &BVHOcTreeDistance<kIOS, OcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_KDOP16][GEOM_OCTREE] = &BVHOcTreeDistance<KDOP<16>, OcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_KDOP18][GEOM_OCTREE] = &BVHOcTreeDistance<KDOP<18>, OcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_KDOP24][GEOM_OCTREE] = &BVHOcTreeDistance<KDOP<24>, OcTree, NarrowPhaseSolver>;
+
+  distance_matrix[GEOM_LINEAR_OCTREE][BV_AABB] = &OcTreeBVHDistance<LinearOcTree, AABB, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][BV_OBB] = &OcTreeBVHDistance<LinearOcTree, OBB, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][BV_RSS] = &OcTreeBVHDistance<LinearOcTree, RSS, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][BV_OBBRSS] = &OcTreeBVHDistance<LinearOcTree, OBBRSS, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][BV_kIOS] = &OcTreeBVHDistance<LinearOcTree, kIOS, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][BV_KDOP16] = &OcTreeBVHDistance<LinearOcTree, KDOP<16>, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][BV_KDOP18] = &OcTreeBVHDistance<LinearOcTree, KDOP<18>, NarrowPhaseSolver>;
+  distance_matrix[GEOM_LINEAR_OCTREE][BV_KDOP24] = &OcTreeBVHDistance<LinearOcTree, KDOP<24>, NarrowPhaseSolver>;
+
+  distance_matrix[BV_AABB][GEOM_LINEAR_OCTREE] = &BVHOcTreeDistance<AABB, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_OBB][GEOM_LINEAR_OCTREE] = &BVHOcTreeDistance<OBB, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_RSS][GEOM_LINEAR_OCTREE] = &BVHOcTreeDistance<RSS, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_OBBRSS][GEOM_LINEAR_OCTREE] = &BVHOcTreeDistance<OBBRSS, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_kIOS][GEOM_LINEAR_OCTREE] = &BVHOcTreeDistance<kIOS, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_KDOP16][GEOM_LINEAR_OCTREE] = &BVHOcTreeDistance<KDOP<16>, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_KDOP18][GEOM_LINEAR_OCTREE] = &BVHOcTreeDistance<KDOP<18>, LinearOcTree, NarrowPhaseSolver>;
+  distance_matrix[BV_KDOP24][GEOM_LINEAR_OCTREE] = &BVHOcTreeDistance<KDOP<24>, LinearOcTree, NarrowPhaseSolver>;
 #endif
 
 
@@ -42,7 +42,11 @@
 
 namespace fcl
 {
+#if FCL_SINGLE_PRECISION
+const FCL_REAL PolySolver::NEAR_ZERO_THRESHOLD = 1e-6;
+#else
 const FCL_REAL PolySolver::NEAR_ZERO_THRESHOLD = 1e-9;
+#endif
 
 
 bool PolySolver::isZero(FCL_REAL v)
@@ -173,9 +177,15 @@ int PolySolver::solveCubic(FCL_REAL c[4], FCL_REAL s[3])
 
 
 
+#if FCL_SINGLE_PRECISION
+const FCL_REAL Intersect::EPSILON = 1e-4;
+const FCL_REAL Intersect::NEAR_ZERO_THRESHOLD = 1e-5;
+const FCL_REAL Intersect::CCD_RESOLUTION = 1e-5;
+#else
 const FCL_REAL Intersect::EPSILON = 1e-5;
 const FCL_REAL Intersect::NEAR_ZERO_THRESHOLD = 1e-7;
 const FCL_REAL Intersect::CCD_RESOLUTION = 1e-7;
+#endif
 
 
 bool Intersect::isZero(FCL_REAL v)
@@ -721,6 +731,175 @@ bool Intersect::intersect_Triangle(const Vec3f& P1, const Vec3f& P2, const Vec3f
 }
 
 
+/// @brief Guigue-Devillers interval check once the vertices are permuted so that p1 (and p2) are alone on their side of the other plane:
+/// the triangles intersect iff the intervals cut on the line of the two planes overlap, which reduces to two orientation tests
+static inline bool triangleIntervalOverlap(const Vec3f& p1, const Vec3f& q1, const Vec3f& r1,
+                                           const Vec3f& p2, const Vec3f& q2, const Vec3f& r2)
+{
+  if((q2 - q1).dot((p2 - q1).cross(p1 - q1)) > 0) return false;
+  if((r2 - p1).dot((p2 - p1).cross(r1 - p1)) > 0) return false;
+  return true;
+}
+
+/// @brief Permute the second triangle according to the signs of its vertex distances to the first plane
+static inline bool triangleIntersectPermuted(const Vec3f& p1, const Vec3f& q1, const Vec3f& r1,
+                                             const Vec3f& p2, const Vec3f& q2, const Vec3f& r2,
+                                             FCL_REAL dp2, FCL_REAL dq2, FCL_REAL dr2)
+{
+  if(dp2 > 0)
+  {
+    if(dq2 > 0) return triangleIntervalOverlap(p1, r1, q1, r2, p2, q2);
+    else if(dr2 > 0) return triangleIntervalOverlap(p1, r1, q1, q2, r2, p2);
+    else return triangleIntervalOverlap(p1, q1, r1, p2, q2, r2);
+  }
+  else if(dp2 < 0)
+  {
+    if(dq2 < 0) return triangleIntervalOverlap(p1, q1, r1, r2, p2, q2);
+    else if(dr2 < 0) return triangleIntervalOverlap(p1, q1, r1, q2, r2, p2);
+    else return triangleIntervalOverlap(p1, r1, q1, p2, q2, r2);
+  }
+  else
+  {
+    if(dq2 < 0)
+    {
+      if(dr2 >= 0) return triangleIntervalOverlap(p1, r1, q1, q2, r2, p2);
+      else return triangleIntervalOverlap(p1, q1, r1, p2, q2, r2);
+    }
+    else if(dq2 > 0)
+    {
+      if(dr2 > 0) return triangleIntervalOverlap(p1, r1, q1, p2, q2, r2);
+      else return triangleIntervalOverlap(p1, q1, r1, q2, r2, p2);
+    }
+    else
+    {
+      if(dr2 > 0) return triangleIntervalOverlap(p1, q1, r1, r2, p2, q2);
+      else return triangleIntervalOverlap(p1, r1, q1, r2, p2, q2);
+    }
+  }
+}
+
+/// @brief Guigue-Devillers test for two non-coplanar triangles, given the distances dp1, dq1, dr1 of the first triangle to the plane of the
+/// second one and dp2, dq2, dr2 of the second triangle to the plane of the first one; both triangles cross or touch the other plane
+static inline bool triangleIntersectNonCoplanar(const Vec3f& p1, const Vec3f& q1, const Vec3f& r1,
+                                                const Vec3f& p2, const Vec3f& q2, const Vec3f& r2,
+                                                FCL_REAL dp1, FCL_REAL dq1, FCL_REAL dr1,
+                                                FCL_REAL dp2, FCL_REAL dq2, FCL_REAL dr2)
+{
+  if(dp1 > 0)
+  {
+    if(dq1 > 0) return triangleIntersectPermuted(r1, p1, q1, p2, r2, q2, dp2, dr2, dq2);
+    else if(dr1 > 0) return triangleIntersectPermuted(q1, r1, p1, p2, r2, q2, dp2, dr2, dq2);
+    else return triangleIntersectPermuted(p1, q1, r1, p2, q2, r2, dp2, dq2, dr2);
+  }
+  else if(dp1 < 0)
+  {
+    if(dq1 < 0) return triangleIntersectPermuted(r1, p1, q1, p2, q2, r2, dp2, dq2, dr2);
+    else if(dr1 < 0) return triangleIntersectPermuted(q1, r1, p1, p2, q2, r2, dp2, dq2, dr2);
+    else return triangleIntersectPermuted(p1, q1, r1, p2, r2, q2, dp2, dr2, dq2);
+  }
+  else
+  {
+    if(dq1 < 0)
+    {
+      if(dr1 >= 0) return triangleIntersectPermuted(q1, r1, p1, p2, r2, q2, dp2, dr2, dq2);
+      else return triangleIntersectPermuted(p1, q1, r1, p2, q2, r2, dp2, dq2, dr2);
+    }
+    else if(dq1 > 0)
+    {
+      if(dr1 > 0) return triangleIntersectPermuted(p1, q1, r1, p2, r2, q2, dp2, dr2, dq2);
+      else return triangleIntersectPermuted(q1, r1, p1, p2, q2, r2, dp2, dq2, dr2);
+    }
+    else
+    {
+      if(dr1 > 0) return triangleIntersectPermuted(r1, p1, q1, p2, q2, r2, dp2, dq2, dr2);
+      else return triangleIntersectPermuted(r1, p1, q1, p2, r2, q2, dp2, dr2, dq2);
+    }
+  }
+}
+
+/// @brief Signed distance to a plane, snapped to zero for vertices lying on the plane up to round-off
+static inline FCL_REAL snappedPlaneDistance(const Vec3f& n, FCL_REAL t, const Vec3f& v, FCL_REAL threshold)
+{
+  FCL_REAL d = n.dot(v) - t;
+  return (std::abs(d) < threshold) ? 0 : d;
+}
+
+/// @brief Whether all three distances are non-zero and of the same sign
+static inline bool sameSideStrictly(FCL_REAL d1, FCL_REAL d2, FCL_REAL d3)
+{
+  return (d1 * d2 > 0) && (d1 * d3 > 0);
+}
+
+bool Intersect::intersect_Triangle(const Vec3f& P1, const Vec3f& P2, const Vec3f& P3, const Vec3f& n1, FCL_REAL t1,
+                                   const Vec3f& Q1, const Vec3f& Q2, const Vec3f& Q3, const Vec3f& n2, FCL_REAL t2,
+                                   Vec3f* contact_points,
+                                   unsigned int* num_contact_points,
+                                   FCL_REAL* penetration_depth,
+                                   Vec3f* normal)
+{
+  FCL_REAL dq1 = snappedPlaneDistance(n1, t1, Q1, NEAR_ZERO_THRESHOLD);
+  FCL_REAL dq2 = snappedPlaneDistance(n1, t1, Q2, NEAR_ZERO_THRESHOLD);
+  FCL_REAL dq3 = snappedPlaneDistance(n1, t1, Q3, NEAR_ZERO_THRESHOLD);
+  if(sameSideStrictly(dq1, dq2, dq3)) return false;
+
+  FCL_REAL dp1 = snappedPlaneDistance(n2, t2, P1, NEAR_ZERO_THRESHOLD);
+  FCL_REAL dp2 = snappedPlaneDistance(n2, t2, P2, NEAR_ZERO_THRESHOLD);
+  FCL_REAL dp3 = snappedPlaneDistance(n2, t2, P3, NEAR_ZERO_THRESHOLD);
+  if(sameSideStrictly(dp1, dp2, dp3)) return false;
+
+  if((dp1 == 0 && dp2 == 0 && dp3 == 0) || (dq1 == 0 && dq2 == 0 && dq3 == 0))
+    return intersect_Triangle(P1, P2, P3, Q1, Q2, Q3, contact_points, num_contact_points, penetration_depth, normal);
+
+  if(!triangleIntersectNonCoplanar(P1, P2, P3, Q1, Q2, Q3, dp1, dp2, dp3, dq1, dq2, dq3))
+    return false;
+
+  if(contact_points && num_contact_points && penetration_depth && normal)
+    computeTriangleContacts(P1, P2, P3, n1, t1, Q1, Q2, Q3, n2, t2, contact_points, num_contact_points, penetration_depth, normal);
+
+  return true;
+}
+
+bool Intersect::intersect_Triangle(const Vec3f& P1, const Vec3f& P2, const Vec3f& P3, const Vec3f& n1, FCL_REAL t1,
+                                   const Vec3f& Q1, const Vec3f& Q2, const Vec3f& Q3, const Vec3f& n2, FCL_REAL t2,
+                                   const Matrix3f& R, const Vec3f& T,
+                                   Vec3f* contact_points,
+                                   unsigned int* num_contact_points,
+                                   FCL_REAL* penetration_depth,
+                                   Vec3f* normal)
+{
+  // plane of P in the frame of Q
+  Vec3f n1_ = R.transposeTimes(n1);
+  FCL_REAL t1_ = t1 - n1.dot(T);
+  FCL_REAL dq1 = snappedPlaneDistance(n1_, t1_, Q1, NEAR_ZERO_THRESHOLD);
+  FCL_REAL dq2 = snappedPlaneDistance(n1_, t1_, Q2, NEAR_ZERO_THRESHOLD);
+  FCL_REAL dq3 = snappedPlaneDistance(n1_, t1_, Q3, NEAR_ZERO_THRESHOLD);
+  if(sameSideStrictly(dq1, dq2, dq3)) return false;
+
+  // plane of Q in the frame of P
+  Vec3f n2_ = R * n2;
+  FCL_REAL t2_ = t2 + n2_.dot(T);
+  FCL_REAL dp1 = snappedPlaneDistance(n2_, t2_, P1, NEAR_ZERO_THRESHOLD);
+  FCL_REAL dp2 = snappedPlaneDistance(n2_, t2_, P2, NEAR_ZERO_THRESHOLD);
+  FCL_REAL dp3 = snappedPlaneDistance(n2_, t2_, P3, NEAR_ZERO_THRESHOLD);
+  if(sameSideStrictly(dp1, dp2, dp3)) return false;
+
+  Vec3f Q1_ = R * Q1 + T;
+  Vec3f Q2_ = R * Q2 + T;
+  Vec3f Q3_ = R * Q3 + T;
+
+  if((dp1 == 0 && dp2 == 0 && dp3 == 0) || (dq1 == 0 && dq2 == 0 && dq3 == 0))
+    return intersect_Triangle(P1, P2, P3, Q1_, Q2_, Q3_, contact_points, num_contact_points, penetration_depth, normal);
+
+  if(!triangleIntersectNonCoplanar(P1, P2, P3, Q1_, Q2_, Q3_, dp1, dp2, dp3, dq1, dq2, dq3))
+    return false;
+
+  if(contact_points && num_contact_points && penetration_depth && normal)
+    computeTriangleContacts(P1, P2, P3, n1, t1, Q1_, Q2_, Q3_, n2_, t2_, contact_points, num_contact_points, penetration_depth, normal);
+
+  return true;
+}
+
+
 #if ODE_STYLE
 bool Intersect::intersect_Triangle(const Vec3f& P1, const Vec3f& P2, const Vec3f& P3,
                                    const Vec3f& Q1, const Vec3f& Q2, const Vec3f& Q3,
@@ -884,46 +1063,56 @@ bool Intersect::intersect_Triangle(const Vec3f& P1, const Vec3f& P2, const Vec3f
     buildTrianglePlane(P1, P2, P3, &n1, &t1);
     buildTrianglePlane(Q1, Q2, Q3, &n2, &t2);
 
-    Vec3f deepest_points1[3];
-    unsigned int num_deepest_points1 = 0;
-    Vec3f deepest_points2[3];
-    unsigned int num_deepest_points2 = 0;
-    FCL_REAL penetration_depth1, penetration_depth2;
+    computeTriangleContacts(P1, P2, P3, n1, t1, Q1, Q2, Q3, n2, t2, contact_points, num_contact_points, penetration_depth, normal);
+  }
+
+  return true;
+}
+#endif
+
+void Intersect::computeTriangleContacts(const Vec3f& P1, const Vec3f& P2, const Vec3f& P3, const Vec3f& n1, FCL_REAL t1,
+                                        const Vec3f& Q1, const Vec3f& Q2, const Vec3f& Q3, const Vec3f& n2, FCL_REAL t2,
+                                        Vec3f* contact_points,
+                                        unsigned int* num_contact_points,
+                                        FCL_REAL* penetration_depth,
+                                        Vec3f* normal)
+{
+  Vec3f deepest_points1[3];
+  unsigned int num_deepest_points1 = 0;
+  Vec3f deepest_points2[3];
+  unsigned int num_deepest_points2 = 0;
+  FCL_REAL penetration_depth1, penetration_depth2;
 
-    Vec3f P[3] = {P1, P2, P3};
-    Vec3f Q[3] = {Q1, Q2, Q3};
+  Vec3f P[3] = {P1, P2, P3};
+  Vec3f Q[3] = {Q1, Q2, Q3};
 
-    computeDeepestPoints(Q, 3, n1, t1, &penetration_depth2, deepest_points2, &num_deepest_points2);
-    computeDeepestPoints(P, 3, n2, t2, &penetration_depth1, deepest_points1, &num_deepest_points1);
+  computeDeepestPoints(Q, 3, n1, t1, &penetration_depth2, deepest_points2, &num_deepest_points2);
+  computeDeepestPoints(P, 3, n2, t2, &penetration_depth1, deepest_points1, &num_deepest_points1);
 
 
-    if(penetration_depth1 > penetration_depth2)
+  if(penetration_depth1 > penetration_depth2)
+  {
+    *num_contact_points = std::min(num_deepest_points2, (unsigned int)2);
+    for(unsigned int i = 0; i < *num_contact_points; ++i)
     {
-      *num_contact_points = std::min(num_deepest_points2, (unsigned int)2);
-      for(unsigned int i = 0; i < num_deepest_points2; ++i)
-      {
-        contact_points[i] = deepest_points2[i];
-      }
-
-      *normal = -n1;
-      *penetration_depth = penetration_depth2;
+      contact_points[i] = deepest_points2[i];
     }
-    else
-    {
-      *num_contact_points = std::min(num_deepest_points1, (unsigned int)2);
-      for(unsigned int i = 0; i < num_deepest_points1; ++i)
-      {
-        contact_points[i] = deepest_points1[i];
-      }
 
-      *normal = n2;
-      *penetration_depth = penetration_depth1;
-    }
+    *normal = -n1;
+    *penetration_depth = penetration_depth2;
   }
+  else
+  {
+    *num_contact_points = std::min(num_deepest_points1, (unsigned int)2);
+    for(unsigned int i = 0; i < *num_contact_points; ++i)
+    {
+      contact_points[i] = deepest_points1[i];
+    }
 
-  return true;
+    *normal = n2;
+    *penetration_depth = penetration_depth1;
+  }
 }
-#endif
 
 
 void Intersect::computeDeepestPoints(Vec3f* clipped_points, unsigned int num_clipped_points, const Vec3f& n, FCL_REAL t, FCL_REAL* penetration_depth, Vec3f* deepest_points, unsigned int* num_deepest_points)
@@ -0,0 +1,176 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "fcl/config.h"
+
+#if FCL_HAVE_OCTOMAP
+
+#include "fcl/linear_octree.h"
+
+namespace fcl
+{
+
+unsigned int LinearOcTree::Node::getDepth() const
+{
+  unsigned int depth = 0;
+  for(FCL_UINT64 code = key; code > 1; code >>= 3)
+    ++depth;
+  return depth;
+}
+
+LinearOcTree::LinearOcTree(const boost::shared_ptr<const octomap::OcTree>& tree)
+{
+  // same defaults as OcTree
+  default_occupancy = tree->getOccupancyThres();
+  occupancy_threshold = tree->getOccupancyThres();
+  free_threshold = 0;
+
+  build(*tree);
+}
+
+LinearOcTree::LinearOcTree(const OcTree& tree)
+{
+  default_occupancy = tree.getDefaultOccupancy();
+  occupancy_threshold = tree.getOccupancyThres();
+  free_threshold = tree.getFreeThres();
+
+  build(*tree.getTree());
+}
+
+void LinearOcTree::build(const octomap::OcTree& tree)
+{
+  FCL_REAL delta = (1 << tree.getTreeDepth()) * tree.getResolution() / 2;
+  root_bv = AABB(Vec3f(-delta, -delta, -delta), Vec3f(delta, delta, delta));
+
+  nodes.clear();
+
+  const octomap::OcTreeNode* root = tree.getRoot();
+  if(!root) return;
+
+  nodes.reserve(tree.size());
+  nodes.resize(1);
+  setNode(nodes[0], root, 1);
+  addChildren(0, root);
+
+  // release the space reserved for the pruned nodes
+  std::vector<Node>(nodes).swap(nodes);
+}
+
+void LinearOcTree::addChildren(std::size_t index, const octomap::OcTreeNode* source)
+{
+  // no query descends into free space, so the subtree below a free node is never visited
+  if(!source->hasChildren() || (nodes[index].flags & Node::FREE)) return;
+
+  const octomap::OcTreeNode* children[8];
+  unsigned int child_ids[8];
+  unsigned int num_children = 0;
+  unsigned char child_mask = 0;
+  for(unsigned int i = 0; i < 8; ++i)
+  {
+    if(source->childExists(i))
+    {
+      children[num_children] = source->getChild(i);
+      child_ids[num_children] = i;
+      ++num_children;
+      child_mask |= (1 << i);
+    }
+  }
+
+  // the children are stored together, right before their own subtrees
+  std::size_t first = nodes.size();
+  nodes.resize(first + num_children);
+  nodes[index].child_mask = child_mask;
+  nodes[index].first_child = first - index;
+
+  FCL_UINT64 key = nodes[index].key;
+  for(unsigned int i = 0; i < num_children; ++i)
+    setNode(nodes[first + i], children[i], (key << 3) | child_ids[i]);
+
+  for(unsigned int i = 0; i < num_children; ++i)
+    addChildren(first + i, children[i]);
+}
+
+void LinearOcTree::setNode(Node& node, const octomap::OcTreeNode* source, FCL_UINT64 key) const
+{
+  FCL_REAL occupancy = source->getOccupancy();
+
+  node.key = key;
+  node.first_child = 0;
+  node.occupancy = occupancy;
+  node.child_mask = 0;
+
+  // same classification as OcTree::isNodeOccupied and OcTree::isNodeFree
+  node.flags = 0;
+  if(occupancy >= occupancy_threshold) node.flags |= Node::OCCUPIED;
+  if(occupancy <= free_threshold) node.flags |= Node::FREE;
+}
+
+AABB LinearOcTree::getNodeBV(const Node* node) const
+{
+  AABB bv = root_bv;
+  FCL_UINT64 key = node->getKey();
+  for(int depth = node->getDepth() - 1; depth >= 0; --depth)
+  {
+    AABB child_bv;
+    computeChildBV(bv, (key >> (3 * depth)) & 7, child_bv);
+    bv = child_bv;
+  }
+
+  return bv;
+}
+
+std::vector<boost::array<FCL_REAL, 6> > LinearOcTree::toBoxes() const
+{
+  std::vector<boost::array<FCL_REAL, 6> > boxes;
+  boxes.reserve(nodes.size() / 2);
+  for(std::size_t i = 0; i < nodes.size(); ++i)
+  {
+    const Node* node = &nodes[i];
+    if(!node->hasChildren() && isNodeOccupied(node))
+    {
+      AABB bv = getNodeBV(node);
+      Vec3f center = bv.center();
+
+      boost::array<FCL_REAL, 6> box = {{center[0], center[1], center[2], bv.width(), node->getOccupancy(), occupancy_threshold}};
+      boxes.push_back(box);
+    }
+  }
+  return boxes;
+}
+
+}
+
+#endif
@@ -0,0 +1,492 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "fcl/math/point_batch.h"
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#  include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#  include <emmintrin.h>
+#  define FCL_POINT_BATCH_SSE 1
+#endif
+
+namespace fcl
+{
+
+namespace details
+{
+
+/// @brief Lane operations used by the kernels; one pack type per instruction set, selected at compile time
+struct ScalarPack
+{
+  typedef FCL_REAL type;
+  typedef bool mask;
+  static const int LANES = 1;
+
+  static inline type set1(FCL_REAL v) { return v; }
+  static inline type load(const FCL_REAL* p) { return *p; }
+  static inline void store(FCL_REAL* p, type a) { *p = a; }
+  static inline type add(type a, type b) { return a + b; }
+  static inline type mul(type a, type b) { return a * b; }
+  static inline type min(type a, type b) { return (b < a) ? b : a; }
+  static inline type max(type a, type b) { return (b > a) ? b : a; }
+  static inline mask greater(type a, type b) { return a > b; }
+  static inline type select(mask m, type a, type b) { return m ? a : b; }
+  static inline mask maskOr(mask a, mask b) { return a || b; }
+  static inline int moveMask(mask m) { return m ? 1 : 0; }
+  static inline type iota() { return 0; }
+};
+
+#if defined(__AVX__) && FCL_SINGLE_PRECISION
+
+struct SIMDPack
+{
+  typedef __m256 type;
+  typedef __m256 mask;
+  static const int LANES = 8;
+
+  static inline type set1(FCL_REAL v) { return _mm256_set1_ps(v); }
+  static inline type load(const FCL_REAL* p) { return _mm256_loadu_ps(p); }
+  static inline void store(FCL_REAL* p, type a) { _mm256_storeu_ps(p, a); }
+  static inline type add(type a, type b) { return _mm256_add_ps(a, b); }
+  static inline type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+  static inline type min(type a, type b) { return _mm256_min_ps(a, b); }
+  static inline type max(type a, type b) { return _mm256_max_ps(a, b); }
+  static inline mask greater(type a, type b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+  static inline type select(mask m, type a, type b) { return _mm256_blendv_ps(b, a, m); }
+  static inline mask maskOr(mask a, mask b) { return _mm256_or_ps(a, b); }
+  static inline int moveMask(mask m) { return _mm256_movemask_ps(m); }
+  static inline type iota() { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+};
+
+#elif defined(__AVX__)
+
+struct SIMDPack
+{
+  typedef __m256d type;
+  typedef __m256d mask;
+  static const int LANES = 4;
+
+  static inline type set1(FCL_REAL v) { return _mm256_set1_pd(v); }
+  static inline type load(const FCL_REAL* p) { return _mm256_loadu_pd(p); }
+  static inline void store(FCL_REAL* p, type a) { _mm256_storeu_pd(p, a); }
+  static inline type add(type a, type b) { return _mm256_add_pd(a, b); }
+  static inline type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+  static inline type min(type a, type b) { return _mm256_min_pd(a, b); }
+  static inline type max(type a, type b) { return _mm256_max_pd(a, b); }
+  static inline mask greater(type a, type b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+  static inline type select(mask m, type a, type b) { return _mm256_blendv_pd(b, a, m); }
+  static inline mask maskOr(mask a, mask b) { return _mm256_or_pd(a, b); }
+  static inline int moveMask(mask m) { return _mm256_movemask_pd(m); }
+  static inline type iota() { return _mm256_setr_pd(0, 1, 2, 3); }
+};
+
+#elif FCL_POINT_BATCH_SSE && FCL_SINGLE_PRECISION
+
+struct SIMDPack
+{
+  typedef __m128 type;
+  typedef __m128 mask;
+  static const int LANES = 4;
+
+  static inline type set1(FCL_REAL v) { return _mm_set1_ps(v); }
+  static inline type load(const FCL_REAL* p) { return _mm_loadu_ps(p); }
+  static inline void store(FCL_REAL* p, type a) { _mm_storeu_ps(p, a); }
+  static inline type add(type a, type b) { return _mm_add_ps(a, b); }
+  static inline type mul(type a, type b) { return _mm_mul_ps(a, b); }
+  static inline type min(type a, type b) { return _mm_min_ps(a, b); }
+  static inline type max(type a, type b) { return _mm_max_ps(a, b); }
+  static inline mask greater(type a, type b) { return _mm_cmpgt_ps(a, b); }
+  static inline type select(mask m, type a, type b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+  static inline mask maskOr(mask a, mask b) { return _mm_or_ps(a, b); }
+  static inline int moveMask(mask m) { return _mm_movemask_ps(m); }
+  static inline type iota() { return _mm_setr_ps(0, 1, 2, 3); }
+};
+
+#elif FCL_POINT_BATCH_SSE
+
+struct SIMDPack
+{
+  typedef __m128d type;
+  typedef __m128d mask;
+  static const int LANES = 2;
+
+  static inline type set1(FCL_REAL v) { return _mm_set1_pd(v); }
+  static inline type load(const FCL_REAL* p) { return _mm_loadu_pd(p); }
+  static inline void store(FCL_REAL* p, type a) { _mm_storeu_pd(p, a); }
+  static inline type add(type a, type b) { return _mm_add_pd(a, b); }
+  static inline type mul(type a, type b) { return _mm_mul_pd(a, b); }
+  static inline type min(type a, type b) { return _mm_min_pd(a, b); }
+  static inline type max(type a, type b) { return _mm_max_pd(a, b); }
+  static inline mask greater(type a, type b) { return _mm_cmpgt_pd(a, b); }
+  static inline type select(mask m, type a, type b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+  static inline mask maskOr(mask a, mask b) { return _mm_or_pd(a, b); }
+  static inline int moveMask(mask m) { return _mm_movemask_pd(m); }
+  static inline type iota() { return _mm_setr_pd(0, 1); }
+};
+
+#else
+
+typedef ScalarPack SIMDPack;
+
+#endif
+
+template<typename P>
+static inline int transformKernel(const Matrix3f& R, const Vec3f& T,
+                                  const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n,
+                                  FCL_REAL* ox, FCL_REAL* oy, FCL_REAL* oz)
+{
+  typename P::type r00 = P::set1(R(0, 0)), r01 = P::set1(R(0, 1)), r02 = P::set1(R(0, 2));
+  typename P::type r10 = P::set1(R(1, 0)), r11 = P::set1(R(1, 1)), r12 = P::set1(R(1, 2));
+  typename P::type r20 = P::set1(R(2, 0)), r21 = P::set1(R(2, 1)), r22 = P::set1(R(2, 2));
+  typename P::type t0 = P::set1(T[0]), t1 = P::set1(T[1]), t2 = P::set1(T[2]);
+
+  int i = 0;
+  for(; i + P::LANES <= n; i += P::LANES)
+  {
+    typename P::type vx = P::load(x + i), vy = P::load(y + i), vz = P::load(z + i);
+    P::store(ox + i, P::add(P::add(P::mul(r00, vx), P::mul(r01, vy)), P::add(P::mul(r02, vz), t0)));
+    P::store(oy + i, P::add(P::add(P::mul(r10, vx), P::mul(r11, vy)), P::add(P::mul(r12, vz), t1)));
+    P::store(oz + i, P::add(P::add(P::mul(r20, vx), P::mul(r21, vy)), P::add(P::mul(r22, vz), t2)));
+  }
+
+  return i;
+}
+
+/// The lane indices are kept as FCL_REAL so that they follow the same select as the values; they are exact up to
+/// 2^24 points per call in single precision, far above the sizes of the blocks and convex shapes passed here.
+template<typename P>
+static inline int maxDotKernel(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n, const Vec3f& dir,
+                               int& best, FCL_REAL& best_dot)
+{
+  if(n < P::LANES) return 0;
+
+  typename P::type d0 = P::set1(dir[0]), d1 = P::set1(dir[1]), d2 = P::set1(dir[2]);
+  typename P::type vmax = P::set1(-std::numeric_limits<FCL_REAL>::max());
+  typename P::type vbest = P::set1(-1);
+  typename P::type vindex = P::iota();
+  typename P::type step = P::set1(P::LANES);
+
+  int i = 0;
+  for(; i + P::LANES <= n; i += P::LANES)
+  {
+    typename P::type dot = P::add(P::add(P::mul(d0, P::load(x + i)), P::mul(d1, P::load(y + i))), P::mul(d2, P::load(z + i)));
+    typename P::mask m = P::greater(dot, vmax);
+    vmax = P::select(m, dot, vmax);
+    vbest = P::select(m, vindex, vbest);
+    vindex = P::add(vindex, step);
+  }
+
+  FCL_REAL lane_max[P::LANES];
+  FCL_REAL lane_best[P::LANES];
+  P::store(lane_max, vmax);
+  P::store(lane_best, vbest);
+  for(int k = 0; k < P::LANES; ++k)
+  {
+    int id = (int)lane_best[k];
+    if(id < 0) continue;
+    if(best < 0 || lane_max[k] > best_dot || (lane_max[k] == best_dot && id < best))
+    {
+      best = id;
+      best_dot = lane_max[k];
+    }
+  }
+
+  return i;
+}
+
+template<typename P>
+static inline int boundKernel(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n, Vec3f& min, Vec3f& max)
+{
+  if(n < P::LANES) return 0;
+
+  typename P::type lx = P::set1(min[0]), ly = P::set1(min[1]), lz = P::set1(min[2]);
+  typename P::type ux = P::set1(max[0]), uy = P::set1(max[1]), uz = P::set1(max[2]);
+
+  int i = 0;
+  for(; i + P::LANES <= n; i += P::LANES)
+  {
+    typename P::type vx = P::load(x + i), vy = P::load(y + i), vz = P::load(z + i);
+    lx = P::min(lx, vx); ly = P::min(ly, vy); lz = P::min(lz, vz);
+    ux = P::max(ux, vx); uy = P::max(uy, vy); uz = P::max(uz, vz);
+  }
+
+  FCL_REAL lanes[6][P::LANES];
+  P::store(lanes[0], lx); P::store(lanes[1], ly); P::store(lanes[2], lz);
+  P::store(lanes[3], ux); P::store(lanes[4], uy); P::store(lanes[5], uz);
+  for(int k = 0; k < P::LANES; ++k)
+  {
+    for(int j = 0; j < 3; ++j)
+    {
+      if(lanes[j][k] < min[j]) min[j] = lanes[j][k];
+      if(lanes[j + 3][k] > max[j]) max[j] = lanes[j + 3][k];
+    }
+  }
+
+  return i;
+}
+
+template<typename P>
+static inline int momentKernel(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n, Vec3f& sum, Matrix3f& sum_squares)
+{
+  if(n < P::LANES) return 0;
+
+  typename P::type zero = P::set1(0);
+  typename P::type sx = zero, sy = zero, sz = zero;
+  typename P::type sxx = zero, syy = zero, szz = zero, sxy = zero, sxz = zero, syz = zero;
+
+  int i = 0;
+  for(; i + P::LANES <= n; i += P::LANES)
+  {
+    typename P::type vx = P::load(x + i), vy = P::load(y + i), vz = P::load(z + i);
+    sx = P::add(sx, vx); sy = P::add(sy, vy); sz = P::add(sz, vz);
+    sxx = P::add(sxx, P::mul(vx, vx)); syy = P::add(syy, P::mul(vy, vy)); szz = P::add(szz, P::mul(vz, vz));
+    sxy = P::add(sxy, P::mul(vx, vy)); sxz = P::add(sxz, P::mul(vx, vz)); syz = P::add(syz, P::mul(vy, vz));
+  }
+
+  FCL_REAL lanes[9][P::LANES];
+  P::store(lanes[0], sx); P::store(lanes[1], sy); P::store(lanes[2], sz);
+  P::store(lanes[3], sxx); P::store(lanes[4], syy); P::store(lanes[5], szz);
+  P::store(lanes[6], sxy); P::store(lanes[7], sxz); P::store(lanes[8], syz);
+
+  FCL_REAL s[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+  for(int j = 0; j < 9; ++j)
+    for(int k = 0; k < P::LANES; ++k)
+      s[j] += lanes[j][k];
+
+  sum[0] += s[0]; sum[1] += s[1]; sum[2] += s[2];
+  sum_squares(0, 0) += s[3]; sum_squares(1, 1) += s[4]; sum_squares(2, 2) += s[5];
+  sum_squares(0, 1) += s[6]; sum_squares(0, 2) += s[7]; sum_squares(1, 2) += s[8];
+  sum_squares(1, 0) += s[6]; sum_squares(2, 0) += s[7]; sum_squares(2, 1) += s[8];
+
+  return i;
+}
+
+/// @brief The separating axes of a cube-triangle pair that depend on the triangle: the 3 box axes, the triangle normal and
+/// the 9 products of the box axes with the triangle edges. Each axis stores the projection interval [lo, hi] of the
+/// triangle and the factor r such that a cube of half size h projects to [-h * r, h * r] around its center
+struct TriangleAxes
+{
+  FCL_REAL axis[13][3];
+  FCL_REAL lo[13];
+  FCL_REAL hi[13];
+  FCL_REAL r[13];
+  int num;
+
+  TriangleAxes(const Vec3f& p1, const Vec3f& p2, const Vec3f& p3) : num(0)
+  {
+    Vec3f edges[3] = {p2 - p1, p3 - p2, p1 - p3};
+    Vec3f units[3] = {Vec3f(1, 0, 0), Vec3f(0, 1, 0), Vec3f(0, 0, 1)};
+
+    for(int i = 0; i < 3; ++i)
+      add(units[i], p1, p2, p3);
+    add(edges[0].cross(edges[1]), p1, p2, p3);
+    for(int i = 0; i < 3; ++i)
+      for(int j = 0; j < 3; ++j)
+        add(units[i].cross(edges[j]), p1, p2, p3);
+  }
+
+  /// degenerate axes (parallel edges, collapsed triangles) separate nothing and are dropped
+  void add(const Vec3f& a, const Vec3f& p1, const Vec3f& p2, const Vec3f& p3)
+  {
+    if(a[0] == 0 && a[1] == 0 && a[2] == 0) return;
+
+    FCL_REAL d1 = a.dot(p1), d2 = a.dot(p2), d3 = a.dot(p3);
+    axis[num][0] = a[0]; axis[num][1] = a[1]; axis[num][2] = a[2];
+    lo[num] = std::min(d1, std::min(d2, d3));
+    hi[num] = std::max(d1, std::max(d2, d3));
+    r[num] = std::abs(a[0]) + std::abs(a[1]) + std::abs(a[2]);
+    ++num;
+  }
+};
+
+template<typename P>
+static inline int cubeTriangleKernel(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, const FCL_REAL* half_size, int n,
+                                     const TriangleAxes& axes, bool* overlap, int& num_overlap)
+{
+  if(n < P::LANES) return 0;
+
+  typename P::type a0[13], a1[13], a2[13], lo[13], hi[13], neg_r[13], r[13];
+  for(int k = 0; k < axes.num; ++k)
+  {
+    a0[k] = P::set1(axes.axis[k][0]); a1[k] = P::set1(axes.axis[k][1]); a2[k] = P::set1(axes.axis[k][2]);
+    lo[k] = P::set1(axes.lo[k]); hi[k] = P::set1(axes.hi[k]);
+    r[k] = P::set1(axes.r[k]); neg_r[k] = P::set1(-axes.r[k]);
+  }
+
+  int i = 0;
+  for(; i + P::LANES <= n; i += P::LANES)
+  {
+    typename P::type vx = P::load(x + i), vy = P::load(y + i), vz = P::load(z + i), vh = P::load(half_size + i);
+
+    // separated along axis k when the projection of the cube center lies outside the triangle interval grown by the
+    // projected cube radius
+    typename P::mask separated = P::greater(P::set1(0), P::set1(0));
+    for(int k = 0; k < axes.num; ++k)
+    {
+      typename P::type d = P::add(P::add(P::mul(a0[k], vx), P::mul(a1[k], vy)), P::mul(a2[k], vz));
+      separated = P::maskOr(separated, P::greater(P::add(lo[k], P::mul(neg_r[k], vh)), d));
+      separated = P::maskOr(separated, P::greater(d, P::add(hi[k], P::mul(r[k], vh))));
+    }
+
+    int bits = P::moveMask(separated);
+    for(int l = 0; l < P::LANES; ++l)
+    {
+      overlap[i + l] = !((bits >> l) & 1);
+      if(overlap[i + l]) ++num_overlap;
+    }
+  }
+
+  return i;
+}
+
+}
+
+void transformPoints(const Matrix3f& R, const Vec3f& T,
+                     const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n,
+                     FCL_REAL* ox, FCL_REAL* oy, FCL_REAL* oz)
+{
+  int i = details::transformKernel<details::SIMDPack>(R, T, x, y, z, n, ox, oy, oz);
+  details::transformKernel<details::ScalarPack>(R, T, x + i, y + i, z + i, n - i, ox + i, oy + i, oz + i);
+}
+
+int maxDotPoint(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n, const Vec3f& dir, FCL_REAL& max_dot)
+{
+  int best = -1;
+  max_dot = -std::numeric_limits<FCL_REAL>::max();
+
+  int i = details::maxDotKernel<details::SIMDPack>(x, y, z, n, dir, best, max_dot);
+  for(; i < n; ++i)
+  {
+    FCL_REAL dot = dir[0] * x[i] + dir[1] * y[i] + dir[2] * z[i];
+    if(dot > max_dot)
+    {
+      best = i;
+      max_dot = dot;
+    }
+  }
+
+  return best;
+}
+
+void boundPoints(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n, Vec3f& min, Vec3f& max)
+{
+  int i = details::boundKernel<details::SIMDPack>(x, y, z, n, min, max);
+  for(; i < n; ++i)
+  {
+    if(x[i] < min[0]) min[0] = x[i];
+    if(y[i] < min[1]) min[1] = y[i];
+    if(z[i] < min[2]) min[2] = z[i];
+    if(x[i] > max[0]) max[0] = x[i];
+    if(y[i] > max[1]) max[1] = y[i];
+    if(z[i] > max[2]) max[2] = z[i];
+  }
+}
+
+void accumulatePointMoments(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, int n, Vec3f& sum, Matrix3f& sum_squares)
+{
+  int i = details::momentKernel<details::SIMDPack>(x, y, z, n, sum, sum_squares);
+  details::momentKernel<details::ScalarPack>(x + i, y + i, z + i, n - i, sum, sum_squares);
+}
+
+int overlapCubesTriangle(const FCL_REAL* x, const FCL_REAL* y, const FCL_REAL* z, const FCL_REAL* half_size, int n,
+                         const Vec3f& p1, const Vec3f& p2, const Vec3f& p3, bool* overlap)
+{
+  if(n == 0) return 0;
+
+  details::TriangleAxes axes(p1, p2, p3);
+  int num_overlap = 0;
+  int i = details::cubeTriangleKernel<details::SIMDPack>(x, y, z, half_size, n, axes, overlap, num_overlap);
+  details::cubeTriangleKernel<details::ScalarPack>(x + i, y + i, z + i, half_size + i, n - i, axes, overlap + i, num_overlap);
+  return num_overlap;
+}
+
+void transformPoints(const Matrix3f& R, const Vec3f& T, const Vec3f* ps, int n, Vec3f* out)
+{
+  PointBlock block;
+  for(int start = 0; start < n; start += PointBlock::CAPACITY)
+  {
+    block.clear();
+    for(int i = start; i < n && block.hasRoom(1); ++i)
+      block.push_back(ps[i]);
+
+    transformPoints(R, T, block, block);
+
+    for(int i = 0; i < block.size; ++i)
+      out[start + i] = block.point(i);
+  }
+}
+
+int maxDotPoint(const Vec3f* ps, int n, const Vec3f& dir, FCL_REAL& max_dot)
+{
+  int best = -1;
+  max_dot = -std::numeric_limits<FCL_REAL>::max();
+
+  PointBlock block;
+  for(int start = 0; start < n; start += PointBlock::CAPACITY)
+  {
+    block.clear();
+    for(int i = start; i < n && block.hasRoom(1); ++i)
+      block.push_back(ps[i]);
+
+    FCL_REAL block_max;
+    int block_best = maxDotPoint(block, dir, block_max);
+    if(block_best >= 0 && (best < 0 || block_max > max_dot))
+    {
+      best = start + block_best;
+      max_dot = block_max;
+    }
+  }
+
+  return best;
+}
+
+void boundPoints(const Vec3f* ps, int n, Vec3f& min, Vec3f& max)
+{
+  PointBlock block;
+  for(int start = 0; start < n; start += PointBlock::CAPACITY)
+  {
+    block.clear();
+    for(int i = start; i < n && block.hasRoom(1); ++i)
+      block.push_back(ps[i]);
+
+    boundPoints(block, min, max);
+  }
+}
+
+}
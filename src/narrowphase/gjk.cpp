@@ -35,6 +35,8 @@
 /** \author Jia Pan */
 
 #include "fcl/narrowphase/gjk.h"
+#include "fcl/collision_data.h"
+#include "fcl/probe.h"
 
 namespace fcl
 {
@@ -138,19 +140,8 @@ Vec3f getSupport(const ShapeBase* shape, const Vec3f& dir)
   case GEOM_CONVEX:
     {
       const Convex* convex = static_cast<const Convex*>(shape);
-      FCL_REAL maxdot = - std::numeric_limits<FCL_REAL>::max();
-      Vec3f* curp = convex->points;
-      Vec3f bestv;
-      for(size_t i = 0; i < convex->num_points; ++i, curp+=1)
-      {
-        FCL_REAL dot = dir.dot(*curp);
-        if(dot > maxdot)
-        {
-          bestv = *curp;
-          maxdot = dot;
-        }
-      }
-      return bestv;
+      int best = convex->supportPointIndex(dir);
+      return (best >= 0) ? convex->points[best] : Vec3f();
     }
     break;
   case GEOM_PLANE:
@@ -398,6 +389,14 @@ GJK::Status GJK::evaluate(const MinkowskiDiff& shape_, const Vec3f& guess)
       
   } while(status == Valid);
 
+  FCL_PROBE_ADD(PROBE_GJK_ITERATION, iterations);
+  QueryStatistics* statistics = getQueryStatistics();
+  if(statistics)
+  {
+    statistics->num_gjk_calls++;
+    statistics->num_gjk_iterations += iterations;
+  }
+
   simplex = &simplices[current];
   switch(status)
   {
@@ -681,6 +680,10 @@ EPA::Status EPA::evaluate(GJK& gjk, const Vec3f& guess)
         }
       }
 
+      FCL_PROBE_ADD(PROBE_EPA_ITERATION, iterations);
+      QueryStatistics* statistics = getQueryStatistics();
+      if(statistics) statistics->num_epa_iterations += iterations;
+
       Vec3f projection = outer.n * outer.d;
       normal = outer.n;
       depth = outer.d;
@@ -36,6 +36,7 @@
 
 
 #include "fcl/narrowphase/gjk_libccd.h"
+#include "fcl/collision_data.h"
 #include <ccd/simplex.h>
 #include <ccd/vec3.h>
 
@@ -380,6 +381,9 @@ static ccd_real_t __ccdGJKDist(const void *obj1, const void *obj2,
   int do_simplex_res;
   ccd_real_t min_dist = -1;
 
+  QueryStatistics* statistics = getQueryStatistics();
+  if(statistics) statistics->num_gjk_calls++;
+
   // initialize simplex struct
   ccdSimplexInit(simplex);
 
@@ -399,6 +403,8 @@ static ccd_real_t __ccdGJKDist(const void *obj1, const void *obj2,
   // start iterations
   for(iterations = 0UL; iterations < ccd->max_iterations; ++iterations)
   {
+    if(statistics) statistics->num_gjk_iterations++;
+
     // obtain support point
     __ccdSupport(obj1, obj2, &dir, ccd, &last);
 
@@ -624,37 +630,17 @@ static void supportSphere(const void* obj, const ccd_vec3_t* dir_, ccd_vec3_t* v
 static void supportConvex(const void* obj, const ccd_vec3_t* dir_, ccd_vec3_t* v)
 {
   const ccd_convex_t* c = (const ccd_convex_t*)obj;
-  ccd_vec3_t dir, p;
-  ccd_real_t maxdot, dot;
-  int i;
-  Vec3f* curp;
-  const Vec3f& center = c->convex->center;
+  ccd_vec3_t dir;
 
   ccdVec3Copy(&dir, dir_);
   ccdQuatRotVec(&dir, &c->rot_inv);
 
-  maxdot = -CCD_REAL_MAX;
-  curp = c->convex->points;
-
-  for(i = 0; i < c->convex->num_points; ++i, curp += 1)
+  // the dot products with the points relative to the center differ by a constant, so the furthest point is the same
+  int best = c->convex->supportPointIndex(Vec3f(ccdVec3X(&dir), ccdVec3Y(&dir), ccdVec3Z(&dir)));
+  if(best >= 0)
   {
-    ccdVec3Set(
-      &p,
-      static_cast<ccd_real_t>( (*curp)[0] - center[0]),
-      static_cast<ccd_real_t>( (*curp)[1] - center[1]),
-      static_cast<ccd_real_t>( (*curp)[2] - center[2])
-	);
-    dot = ccdVec3Dot(&dir, &p);
-    if(dot > maxdot)
-    {
-      ccdVec3Set(
-        v,
-        static_cast<ccd_real_t>( (*curp)[0]),
-        static_cast<ccd_real_t>( (*curp)[1]),
-        static_cast<ccd_real_t>( (*curp)[2])
-      );
-      maxdot = dot;
-    }
+    const Vec3f& p = c->convex->points[best];
+    ccdVec3Set(v, static_cast<ccd_real_t>(p[0]), static_cast<ccd_real_t>(p[1]), static_cast<ccd_real_t>(p[2]));
   }
 
   // transform support vertex
@@ -736,6 +722,9 @@ bool GJKCollide(void* obj1, ccd_support_fn supp1, ccd_center_fn cen1,
   ccd.max_iterations = max_iterations;
   ccd.mpr_tolerance = static_cast<ccd_real_t>(tolerance);
 
+  QueryStatistics* statistics = getQueryStatistics();
+  if(statistics) statistics->num_gjk_calls++;
+
   if(!contact_points)
   {
     return ccdMPRIntersect(obj1, obj2, &ccd) > 0;
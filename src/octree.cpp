@@ -0,0 +1,205 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#include "fcl/config.h"
+
+#if FCL_HAVE_OCTOMAP
+
+#include "fcl/octree.h"
+
+namespace fcl
+{
+
+namespace details
+{
+
+/// @brief whether two octree cells overlap by more than a touching face. Cells are nested, so this holds exactly when
+/// one of them contains the other; eps absorbs the rounding of the cell coordinates
+static inline bool cellsOverlap(const AABB& a, const AABB& b, FCL_REAL eps)
+{
+  for(int i = 0; i < 3; ++i)
+  {
+    if(a.min_[i] >= b.max_[i] - eps) return false;
+    if(b.min_[i] >= a.max_[i] - eps) return false;
+  }
+  return true;
+}
+
+static inline bool cellsOverlap(const AABB& a, const std::vector<AABB>& cells, const AABB& cells_bound, FCL_REAL eps)
+{
+  if(!cellsOverlap(a, cells_bound, eps)) return false;
+
+  for(std::size_t i = 0; i < cells.size(); ++i)
+  {
+    if(cellsOverlap(a, cells[i], eps)) return true;
+  }
+  return false;
+}
+
+static inline AABB boxToAABB(const boost::array<FCL_REAL, 6>& box)
+{
+  FCL_REAL half_size = box[3] * 0.5;
+  return AABB(Vec3f(box[0] - half_size, box[1] - half_size, box[2] - half_size),
+              Vec3f(box[0] + half_size, box[1] + half_size, box[2] + half_size));
+}
+
+}
+
+std::size_t OcTree::collectChanges()
+{
+  FCL_REAL half_size = tree->getResolution() * 0.5;
+  std::size_t num_changes = 0;
+  for(octomap::KeyBoolMap::const_iterator it = tree->changedKeysBegin(), end = tree->changedKeysEnd(); it != end; ++it)
+  {
+    const octomap::OcTreeKey& key = it->first;
+    FCL_UINT64 code = ((FCL_UINT64)key[0] << 32) | ((FCL_UINT64)key[1] << 16) | (FCL_UINT64)key[2];
+    if(!dirty_keys.insert(code).second) continue;
+
+    octomap::point3d center = tree->keyToCoord(key);
+    AABB cell(Vec3f(center.x() - half_size, center.y() - half_size, center.z() - half_size),
+              Vec3f(center.x() + half_size, center.y() + half_size, center.z() + half_size));
+    dirty_cells.push_back(cell);
+    dirty_bound += cell;
+    ++num_changes;
+  }
+
+  return num_changes;
+}
+
+void OcTree::markDirty(const AABB& region)
+{
+  dirty_cells.push_back(region);
+  dirty_bound += region;
+}
+
+void OcTree::clearDirty()
+{
+  dirty_cells.clear();
+  dirty_keys.clear();
+  dirty_bound = AABB();
+}
+
+bool OcTree::overlapDirty(const AABB& bv) const
+{
+  if(dirty_cells.empty() || !dirty_bound.overlap(bv)) return false;
+
+  for(std::size_t i = 0; i < dirty_cells.size(); ++i)
+  {
+    if(dirty_cells[i].overlap(bv)) return true;
+  }
+  return false;
+}
+
+void OcTree::collectLeaves(const OcTreeNode* node, const AABB& bv, const std::vector<AABB>& regions, const AABB& regions_bound,
+                           std::vector<std::pair<const OcTreeNode*, AABB> >& leaves) const
+{
+  FCL_REAL eps = tree->getResolution() * 0.25;
+  if(!details::cellsOverlap(bv, regions, regions_bound, eps)) return;
+
+  if(!node->hasChildren())
+  {
+    leaves.push_back(std::make_pair(node, bv));
+    return;
+  }
+
+  for(unsigned int i = 0; i < 8; ++i)
+  {
+    if(node->childExists(i))
+    {
+      AABB child_bv;
+      computeChildBV(bv, i, child_bv);
+      collectLeaves(node->getChild(i), child_bv, regions, regions_bound, leaves);
+    }
+  }
+}
+
+void OcTree::updateBoxes(std::vector<boost::array<FCL_REAL, 6> >& boxes) const
+{
+  if(dirty_cells.empty()) return;
+
+  FCL_REAL eps = tree->getResolution() * 0.25;
+
+  // an update can merge cells into their parent or split a cell into its children. A merged cell contains a dirty cell,
+  // and the children of a split cell lie inside an old box that contains a dirty cell, so the current leaves to copy
+  // are the ones overlapping the dirty cells or the old boxes containing them
+  std::vector<AABB> regions(dirty_cells);
+  AABB regions_bound = dirty_bound;
+  for(std::size_t i = 0; i < boxes.size(); ++i)
+  {
+    AABB bv = details::boxToAABB(boxes[i]);
+    if(details::cellsOverlap(bv, dirty_cells, dirty_bound, eps))
+    {
+      regions.push_back(bv);
+      regions_bound += bv;
+    }
+  }
+
+  std::vector<std::pair<const OcTreeNode*, AABB> > leaves;
+  if(getRoot())
+    collectLeaves(getRoot(), getRootBV(), regions, regions_bound, leaves);
+
+  // every old box overlapping one of these regions or a copied leaf is replaced
+  for(std::size_t i = 0; i < leaves.size(); ++i)
+  {
+    regions.push_back(leaves[i].second);
+    regions_bound += leaves[i].second;
+  }
+
+  std::size_t num_kept = 0;
+  for(std::size_t i = 0; i < boxes.size(); ++i)
+  {
+    if(!details::cellsOverlap(details::boxToAABB(boxes[i]), regions, regions_bound, eps))
+      boxes[num_kept++] = boxes[i];
+  }
+  boxes.resize(num_kept);
+
+  for(std::size_t i = 0; i < leaves.size(); ++i)
+  {
+    const OcTreeNode* node = leaves[i].first;
+    if(isNodeOccupied(node))
+    {
+      const AABB& bv = leaves[i].second;
+      Vec3f center = bv.center();
+
+      boost::array<FCL_REAL, 6> box = {{center[0], center[1], center[2], bv.width(), node->getOccupancy(), tree->getOccupancyThres()}};
+      boxes.push_back(box);
+    }
+  }
+}
+
+}
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \author Jia Pan */
+
+#include "fcl/probe.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#if FCL_ENABLE_PROBES
+#include "fcl/data_types.h"
+#include <boost/thread/tss.hpp>
+#endif
+
+namespace fcl
+{
+
+namespace tools
+{
+
+static const char* probe_names[NUM_PROBES] = {"broadphase collide",
+                                              "broadphase distance",
+                                              "collide",
+                                              "distance",
+                                              "BV tests",
+                                              "leaf tests",
+                                              "GJK iterations",
+                                              "EPA iterations"};
+
+const char* getProbeName(ProbeId id)
+{
+  return probe_names[id];
+}
+
+ProbeTotals::ProbeTotals()
+{
+  for(int i = 0; i < NUM_PROBES; ++i)
+  {
+    count[i] = 0;
+    ticks[i] = 0;
+  }
+}
+
+double ProbeTotals::seconds(ProbeId id) const
+{
+  return ticks[id] / probeTicksPerSecond();
+}
+
+ProbeTotals ProbeTotals::since(const ProbeTotals& earlier) const
+{
+  ProbeTotals res;
+  for(int i = 0; i < NUM_PROBES; ++i)
+  {
+    res.count[i] = count[i] - earlier.count[i];
+    res.ticks[i] = ticks[i] - earlier.ticks[i];
+  }
+  return res;
+}
+
+void ProbeTotals::print(std::ostream& out) const
+{
+  for(int i = 0; i < NUM_PROBES; ++i)
+  {
+    if(count[i] == 0) continue;
+    out << getProbeName(static_cast<ProbeId>(i)) << ": " << count[i];
+    if(ticks[i] > 0)
+    {
+      double s = seconds(static_cast<ProbeId>(i));
+      out << " calls, " << s << " s (average " << s * 1e6 / count[i] << " us)";
+    }
+    out << std::endl;
+  }
+}
+
+#if FCL_ENABLE_PROBES
+
+namespace details
+{
+
+/// @brief all the blocks ever allocated, most recent first. Blocks are only pushed, never removed
+static boost::atomic<ProbeBlock*> probe_blocks(NULL);
+
+/// @brief block of the thread, NULL until the thread fires its first probe
+static FCL_THREAD_LOCAL ProbeBlock* probe_block = NULL;
+
+static void releaseProbeBlock(ProbeBlock* block)
+{
+  for(int i = 0; i < NUM_PROBES; ++i)
+    block->active[i] = false;
+  if(probe_block == block)
+    probe_block = NULL;
+  block->in_use.store(false, boost::memory_order_release);
+}
+
+/// @brief releases the block of a thread when it exits
+static boost::thread_specific_ptr<ProbeBlock>& getProbeBlockOwner()
+{
+  static boost::thread_specific_ptr<ProbeBlock> owner(&releaseProbeBlock);
+  return owner;
+}
+
+static ProbeBlock* acquireProbeBlock()
+{
+  for(ProbeBlock* block = probe_blocks.load(boost::memory_order_acquire); block; block = block->next)
+  {
+    bool expected = false;
+    if(block->in_use.compare_exchange_strong(expected, true, boost::memory_order_acquire))
+      return block;
+  }
+
+  ProbeBlock* block = new ProbeBlock;
+  for(int i = 0; i < NUM_PROBES; ++i)
+  {
+    block->count[i].store(0, boost::memory_order_relaxed);
+    block->ticks[i].store(0, boost::memory_order_relaxed);
+    block->active[i] = false;
+  }
+  block->in_use.store(true, boost::memory_order_relaxed);
+
+  ProbeBlock* head = probe_blocks.load(boost::memory_order_relaxed);
+  do
+  {
+    block->next = head;
+  } while(!probe_blocks.compare_exchange_weak(head, block, boost::memory_order_release, boost::memory_order_relaxed));
+
+  return block;
+}
+
+ProbeBlock* getProbeBlock()
+{
+  ProbeBlock* block = probe_block;
+  if(block) return block;
+
+  block = acquireProbeBlock();
+  probe_block = block;
+  getProbeBlockOwner().reset(block);
+  return block;
+}
+
+/// @brief the probe clock and the system clock when the library was loaded, to measure the TSC frequency
+struct ProbeClockOrigin
+{
+  ProbeClockOrigin() : ticks(probeTicks()),
+                       time(boost::posix_time::microsec_clock::universal_time())
+  {
+  }
+
+  boost::uint64_t ticks;
+  boost::posix_time::ptime time;
+};
+
+static ProbeClockOrigin probe_clock_origin;
+
+}
+
+bool probesEnabled()
+{
+  return true;
+}
+
+void snapshotProbes(ProbeTotals& totals)
+{
+  totals = ProbeTotals();
+  for(details::ProbeBlock* block = details::probe_blocks.load(boost::memory_order_acquire); block; block = block->next)
+  {
+    for(int i = 0; i < NUM_PROBES; ++i)
+    {
+      totals.count[i] += block->count[i].load(boost::memory_order_relaxed);
+      totals.ticks[i] += block->ticks[i].load(boost::memory_order_relaxed);
+    }
+  }
+}
+
+double probeTicksPerSecond()
+{
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+  boost::uint64_t ticks;
+  double s;
+  do
+  {
+    ticks = details::probeTicks();
+    s = (boost::posix_time::microsec_clock::universal_time() - details::probe_clock_origin.time).total_microseconds() * 1e-6;
+  } while(s < 0.01); // long enough for the system clock resolution
+
+  return (ticks - details::probe_clock_origin.ticks) / s;
+#else
+  return 1e6;
+#endif
+}
+
+#else
+
+bool probesEnabled()
+{
+  return false;
+}
+
+void snapshotProbes(ProbeTotals& totals)
+{
+  totals = ProbeTotals();
+}
+
+double probeTicksPerSecond()
+{
+  return 1e6;
+}
+
+#endif
+
+}
+
+}
@@ -37,6 +37,7 @@
 
 #include "fcl/shape/geometric_shapes.h"
 #include "fcl/shape/geometric_shapes_utility.h"
+#include "fcl/math/point_batch.h"
 
 namespace fcl
 {
@@ -137,6 +138,11 @@ void Box::computeLocalAABB()
   aabb_radius = (aabb_local.min_ - aabb_center).length();
 }
 
+void Box::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  computeBV<AABB>(*this, tf, aabb);
+}
+
 void Sphere::computeLocalAABB()
 {
   computeBV<AABB>(*this, Transform3f(), aabb_local);
@@ -144,6 +150,11 @@ void Sphere::computeLocalAABB()
   aabb_radius = radius;
 }
 
+void Sphere::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  computeBV<AABB>(*this, tf, aabb);
+}
+
 void Capsule::computeLocalAABB()
 {
   computeBV<AABB>(*this, Transform3f(), aabb_local);
@@ -151,6 +162,11 @@ void Capsule::computeLocalAABB()
   aabb_radius = (aabb_local.min_ - aabb_center).length();
 }
 
+void Capsule::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  computeBV<AABB>(*this, tf, aabb);
+}
+
 void Cone::computeLocalAABB()
 {
   computeBV<AABB>(*this, Transform3f(), aabb_local);
@@ -158,6 +174,11 @@ void Cone::computeLocalAABB()
   aabb_radius = (aabb_local.min_ - aabb_center).length();
 }
 
+void Cone::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  computeBV<AABB>(*this, tf, aabb);
+}
+
 void Cylinder::computeLocalAABB()
 {
   computeBV<AABB>(*this, Transform3f(), aabb_local);
@@ -165,6 +186,17 @@ void Cylinder::computeLocalAABB()
   aabb_radius = (aabb_local.min_ - aabb_center).length();
 }
 
+void Cylinder::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  computeBV<AABB>(*this, tf, aabb);
+}
+
+int Convex::supportPointIndex(const Vec3f& dir) const
+{
+  FCL_REAL max_dot;
+  return maxDotPoint(pointsX(), pointsY(), pointsZ(), num_points, dir, max_dot);
+}
+
 void Convex::computeLocalAABB()
 {
   computeBV<AABB>(*this, Transform3f(), aabb_local);
@@ -179,6 +211,11 @@ void Halfspace::computeLocalAABB()
   aabb_radius = (aabb_local.min_ - aabb_center).length();
 }
 
+void Halfspace::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  computeBV<AABB>(*this, tf, aabb);
+}
+
 void Plane::computeLocalAABB()
 {
   computeBV<AABB>(*this, Transform3f(), aabb_local);
@@ -186,6 +223,11 @@ void Plane::computeLocalAABB()
   aabb_radius = (aabb_local.min_ - aabb_center).length();
 }
 
+void Plane::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  computeBV<AABB>(*this, tf, aabb);
+}
+
 void Triangle2::computeLocalAABB()
 {
   computeBV<AABB>(*this, Transform3f(), aabb_local);
@@ -193,5 +235,10 @@ void Triangle2::computeLocalAABB()
   aabb_radius = (aabb_local.min_ - aabb_center).length();
 }
 
+void Triangle2::computeAABB(const Transform3f& tf, AABB& aabb) const
+{
+  computeBV<AABB>(*this, tf, aabb);
+}
+
 
 }
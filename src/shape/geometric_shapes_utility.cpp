@@ -37,6 +37,7 @@
 
 #include "fcl/shape/geometric_shapes_utility.h"
 #include "fcl/BVH/BV_fitter.h"
+#include "fcl/math/point_batch.h"
 
 namespace fcl
 {
@@ -292,13 +293,14 @@ void computeBV<AABB, Cone>(const Cone& s, const Transform3f& tf, AABB& bv)
   const Matrix3f& R = tf.getRotation();
   const Vec3f& T = tf.getTranslation();
 
-  FCL_REAL x_range = fabs(R(0, 0) * s.radius) + fabs(R(0, 1) * s.radius) + 0.5 * fabs(R(0, 2) * s.lz);
-  FCL_REAL y_range = fabs(R(1, 0) * s.radius) + fabs(R(1, 1) * s.radius) + 0.5 * fabs(R(1, 2) * s.lz);
-  FCL_REAL z_range = fabs(R(2, 0) * s.radius) + fabs(R(2, 1) * s.radius) + 0.5 * fabs(R(2, 2) * s.lz);
-
-  Vec3f v_delta(x_range, y_range, z_range);
-  bv.max_ = T + v_delta;
-  bv.min_ = T - v_delta;
+  // the cone is the hull of its apex and its base disk, whose extent along axis i is radius * sin(angle(axis i, z))
+  for(int i = 0; i < 3; ++i)
+  {
+    FCL_REAL apex = 0.5 * R(i, 2) * s.lz;
+    FCL_REAL disk = s.radius * std::sqrt(std::max((FCL_REAL)0, 1 - R(i, 2) * R(i, 2)));
+    bv.max_[i] = T[i] + std::max(apex, disk - apex);
+    bv.min_[i] = T[i] + std::min(apex, -disk - apex);
+  }
 }
 
 template<>
@@ -307,9 +309,10 @@ void computeBV<AABB, Cylinder>(const Cylinder& s, const Transform3f& tf, AABB& b
   const Matrix3f& R = tf.getRotation();
   const Vec3f& T = tf.getTranslation();
 
-  FCL_REAL x_range = fabs(R(0, 0) * s.radius) + fabs(R(0, 1) * s.radius) + 0.5 * fabs(R(0, 2) * s.lz);
-  FCL_REAL y_range = fabs(R(1, 0) * s.radius) + fabs(R(1, 1) * s.radius) + 0.5 * fabs(R(1, 2) * s.lz);
-  FCL_REAL z_range = fabs(R(2, 0) * s.radius) + fabs(R(2, 1) * s.radius) + 0.5 * fabs(R(2, 2) * s.lz);
+  // extent of the cap disks along axis i is radius * sin(angle(axis i, z))
+  FCL_REAL x_range = s.radius * std::sqrt(std::max((FCL_REAL)0, 1 - R(0, 2) * R(0, 2))) + 0.5 * fabs(R(0, 2) * s.lz);
+  FCL_REAL y_range = s.radius * std::sqrt(std::max((FCL_REAL)0, 1 - R(1, 2) * R(1, 2))) + 0.5 * fabs(R(1, 2) * s.lz);
+  FCL_REAL z_range = s.radius * std::sqrt(std::max((FCL_REAL)0, 1 - R(2, 2) * R(2, 2))) + 0.5 * fabs(R(2, 2) * s.lz);
 
   Vec3f v_delta(x_range, y_range, z_range);
   bv.max_ = T + v_delta;
@@ -323,10 +326,13 @@ void computeBV<AABB, Convex>(const Convex& s, const Transform3f& tf, AABB& bv)
   const Vec3f& T = tf.getTranslation();
 
   AABB bv_;
-  for(int i = 0; i < s.num_points; ++i)
+  PointBlock block;
+  for(int start = 0; start < s.num_points; start += PointBlock::CAPACITY)
   {
-    Vec3f new_p = R * s.points[i] + T;
-    bv_ += new_p;
+    int n = std::min(s.num_points - start, (int)PointBlock::CAPACITY);
+    transformPoints(R, T, s.pointsX() + start, s.pointsY() + start, s.pointsZ() + start, n, block.x, block.y, block.z);
+    block.size = n;
+    boundPoints(block, bv_.min_, bv_.max_);
   }
 
   bv = bv_;
@@ -0,0 +1,710 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "fcl/signed_distance_field.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <cmath>
+#include <string.h>
+
+namespace fcl
+{
+
+namespace
+{
+
+/// @brief Header of the on-disk format. All sections start at a multiple of SDF_FILE_ALIGNMENT bytes, so
+/// they can be used directly from a memory mapping.
+struct SDFFileHeader
+{
+  char magic[8];
+  FCL_UINT32 version;
+  FCL_UINT32 byte_order;
+  FCL_UINT32 block_size;
+  FCL_UINT32 num_blocks[3];
+  FCL_UINT32 num_dense_blocks;
+  FCL_UINT32 reserved;
+  double origin[3];
+  double voxel_size;
+  boost::uint64_t table_offset;
+  boost::uint64_t values_offset;
+  boost::uint64_t samples_offset;
+  boost::uint64_t file_size;
+};
+
+const char SDF_FILE_MAGIC[8] = {'F', 'C', 'L', 'S', 'D', 'F', 0, 0};
+const FCL_UINT32 SDF_FILE_VERSION = 1;
+const FCL_UINT32 SDF_FILE_BYTE_ORDER = 0x01020304;
+const boost::uint64_t SDF_FILE_ALIGNMENT = 64;
+
+inline boost::uint64_t alignOffset(boost::uint64_t offset)
+{
+  return (offset + SDF_FILE_ALIGNMENT - 1) / SDF_FILE_ALIGNMENT * SDF_FILE_ALIGNMENT;
+}
+
+/// @brief distance between point p and triangle (a, b, c)
+FCL_REAL pointTriangleDistance(const Vec3f& p, const Vec3f& a, const Vec3f& b, const Vec3f& c)
+{
+  Vec3f ab = b - a;
+  Vec3f ac = c - a;
+  Vec3f ap = p - a;
+  FCL_REAL d1 = ab.dot(ap);
+  FCL_REAL d2 = ac.dot(ap);
+  if(d1 <= 0 && d2 <= 0) return ap.length();
+
+  Vec3f bp = p - b;
+  FCL_REAL d3 = ab.dot(bp);
+  FCL_REAL d4 = ac.dot(bp);
+  if(d3 >= 0 && d4 <= d3) return bp.length();
+
+  FCL_REAL vc = d1 * d4 - d3 * d2;
+  if(vc <= 0 && d1 >= 0 && d3 <= 0)
+  {
+    FCL_REAL v = d1 / (d1 - d3);
+    return (ap - ab * v).length();
+  }
+
+  Vec3f cp = p - c;
+  FCL_REAL d5 = ab.dot(cp);
+  FCL_REAL d6 = ac.dot(cp);
+  if(d6 >= 0 && d5 <= d6) return cp.length();
+
+  FCL_REAL vb = d5 * d2 - d1 * d6;
+  if(vb <= 0 && d2 >= 0 && d6 <= 0)
+  {
+    FCL_REAL w = d2 / (d2 - d6);
+    return (ap - ac * w).length();
+  }
+
+  FCL_REAL va = d3 * d6 - d5 * d4;
+  if(va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+  {
+    FCL_REAL w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    return (bp - (c - b) * w).length();
+  }
+
+  FCL_REAL denom = 1 / (va + vb + vc);
+  FCL_REAL v = vb * denom;
+  FCL_REAL w = vc * denom;
+  return (ap - ab * v - ac * w).length();
+}
+
+/// @brief twice the signed area of triangle (0, 0), (x1, y1), (x2, y2), with a symbolic tie break
+/// so that a point on an edge shared by two triangles is counted in exactly one of them
+int orientation(FCL_REAL x1, FCL_REAL y1, FCL_REAL x2, FCL_REAL y2, FCL_REAL& twice_signed_area)
+{
+  // the sign comes from comparing the products, so that it stays antisymmetric even if the compiler fuses the subtraction
+  FCL_REAL a = y1 * x2;
+  FCL_REAL b = x1 * y2;
+  twice_signed_area = a - b;
+  if(a > b) return 1;
+  else if(a < b) return -1;
+  else if(y2 > y1) return 1;
+  else if(y2 < y1) return -1;
+  else if(x1 > x2) return 1;
+  else if(x1 < x2) return -1;
+  return 0;
+}
+
+/// @brief whether (x0, y0) is in the 2D triangle (x1, y1), (x2, y2), (x3, y3); if so return its barycentric coordinates
+bool pointInTriangle2D(FCL_REAL x0, FCL_REAL y0,
+                       FCL_REAL x1, FCL_REAL y1, FCL_REAL x2, FCL_REAL y2, FCL_REAL x3, FCL_REAL y3,
+                       FCL_REAL& a, FCL_REAL& b, FCL_REAL& c)
+{
+  x1 -= x0; x2 -= x0; x3 -= x0;
+  y1 -= y0; y2 -= y0; y3 -= y0;
+  int sign_a = orientation(x2, y2, x3, y3, a);
+  if(sign_a == 0) return false;
+  int sign_b = orientation(x3, y3, x1, y1, b);
+  if(sign_b != sign_a) return false;
+  int sign_c = orientation(x1, y1, x2, y2, c);
+  if(sign_c != sign_a) return false;
+  FCL_REAL sum = a + b + c;
+  a /= sum;
+  b /= sum;
+  c /= sum;
+  return true;
+}
+
+/// @brief dense grid used while baking
+struct BakeGrid
+{
+  int n[3];
+  Vec3f origin;
+  FCL_REAL voxel_size;
+  std::vector<FCL_REAL> phi;
+  std::vector<int> closest;
+  std::vector<int> crossings;
+
+  inline int index(int i, int j, int k) const { return (k * n[1] + j) * n[0] + i; }
+
+  inline Vec3f position(int i, int j, int k) const
+  {
+    return Vec3f(origin[0] + i * voxel_size, origin[1] + j * voxel_size, origin[2] + k * voxel_size);
+  }
+};
+
+/// @brief try the closest triangle of sample (i1, j1, k1) for sample (i0, j0, k0)
+inline void checkNeighbour(BakeGrid& grid, const Vec3f* vertices, const Triangle* triangles,
+                           int i0, int j0, int k0, int i1, int j1, int k1)
+{
+  int t = grid.closest[grid.index(i1, j1, k1)];
+  if(t < 0) return;
+
+  int id = grid.index(i0, j0, k0);
+  if(grid.closest[id] == t) return;
+
+  const Triangle& tri = triangles[t];
+  FCL_REAL d = pointTriangleDistance(grid.position(i0, j0, k0), vertices[tri[0]], vertices[tri[1]], vertices[tri[2]]);
+  if(d < grid.phi[id])
+  {
+    grid.phi[id] = d;
+    grid.closest[id] = t;
+  }
+}
+
+/// @brief propagate the closest triangles through the grid in one sweep direction
+void sweep(BakeGrid& grid, const Vec3f* vertices, const Triangle* triangles, int di, int dj, int dk)
+{
+  int i0 = (di > 0) ? 1 : grid.n[0] - 2, i1 = (di > 0) ? grid.n[0] : -1;
+  int j0 = (dj > 0) ? 1 : grid.n[1] - 2, j1 = (dj > 0) ? grid.n[1] : -1;
+  int k0 = (dk > 0) ? 1 : grid.n[2] - 2, k1 = (dk > 0) ? grid.n[2] : -1;
+
+  for(int k = k0; k != k1; k += dk)
+  {
+    for(int j = j0; j != j1; j += dj)
+    {
+      for(int i = i0; i != i1; i += di)
+      {
+        checkNeighbour(grid, vertices, triangles, i, j, k, i - di, j, k);
+        checkNeighbour(grid, vertices, triangles, i, j, k, i, j - dj, k);
+        checkNeighbour(grid, vertices, triangles, i, j, k, i - di, j - dj, k);
+        checkNeighbour(grid, vertices, triangles, i, j, k, i, j, k - dk);
+        checkNeighbour(grid, vertices, triangles, i, j, k, i - di, j, k - dk);
+        checkNeighbour(grid, vertices, triangles, i, j, k, i, j - dj, k - dk);
+        checkNeighbour(grid, vertices, triangles, i, j, k, i - di, j - dj, k - dk);
+      }
+    }
+  }
+}
+
+inline int clampIndex(int i, int n)
+{
+  return std::max(0, std::min(i, n - 1));
+}
+
+}
+
+SignedDistanceField::SignedDistanceField() : voxel_size_(0),
+                                             num_blocks_total_(0),
+                                             num_dense_blocks_(0),
+                                             block_table_(NULL),
+                                             block_values_(NULL),
+                                             samples_(NULL)
+{
+  for(int i = 0; i < 3; ++i)
+  {
+    num_blocks_[i] = 0;
+    num_samples_[i] = 0;
+  }
+}
+
+SignedDistanceField::SignedDistanceField(const SignedDistanceField& other) : CollisionGeometry(other)
+{
+  *this = other;
+}
+
+SignedDistanceField& SignedDistanceField::operator = (const SignedDistanceField& other)
+{
+  if(this == &other) return *this;
+
+  CollisionGeometry::operator = (other);
+  origin_ = other.origin_;
+  voxel_size_ = other.voxel_size_;
+  for(int i = 0; i < 3; ++i)
+  {
+    num_blocks_[i] = other.num_blocks_[i];
+    num_samples_[i] = other.num_samples_[i];
+  }
+  num_blocks_total_ = other.num_blocks_total_;
+  num_dense_blocks_ = other.num_dense_blocks_;
+
+  block_table_storage_ = other.block_table_storage_;
+  block_values_storage_ = other.block_values_storage_;
+  samples_storage_ = other.samples_storage_;
+  region_ = other.region_;
+
+  if(region_)
+  {
+    block_table_ = other.block_table_;
+    block_values_ = other.block_values_;
+    samples_ = other.samples_;
+  }
+  else
+    bindStorage();
+
+  return *this;
+}
+
+SignedDistanceField::~SignedDistanceField()
+{
+}
+
+void SignedDistanceField::clear()
+{
+  region_.reset();
+  block_table_storage_.clear();
+  block_values_storage_.clear();
+  samples_storage_.clear();
+  block_table_ = NULL;
+  block_values_ = NULL;
+  samples_ = NULL;
+  num_blocks_total_ = 0;
+  num_dense_blocks_ = 0;
+}
+
+void SignedDistanceField::bindStorage()
+{
+  block_table_ = block_table_storage_.empty() ? NULL : &block_table_storage_[0];
+  block_values_ = block_values_storage_.empty() ? NULL : &block_values_storage_[0];
+  samples_ = samples_storage_.empty() ? NULL : &samples_storage_[0];
+}
+
+bool SignedDistanceField::bake(const Vec3f* vertices, int num_vertices, const Triangle* triangles, int num_triangles,
+                               FCL_REAL voxel_size, int padding, FCL_REAL band)
+{
+  if(!vertices || !triangles || num_vertices <= 0 || num_triangles <= 0)
+  {
+    std::cerr << "SDF Error! The mesh is empty." << std::endl;
+    return false;
+  }
+
+  if(voxel_size <= 0)
+  {
+    std::cerr << "SDF Error! The voxel size must be positive." << std::endl;
+    return false;
+  }
+
+  clear();
+
+  Vec3f lo = vertices[0];
+  Vec3f hi = vertices[0];
+  for(int i = 1; i < num_vertices; ++i)
+  {
+    lo = min(lo, vertices[i]);
+    hi = max(hi, vertices[i]);
+  }
+
+  padding = std::max(padding, 1);
+  voxel_size_ = voxel_size;
+  origin_ = lo - Vec3f(padding * voxel_size, padding * voxel_size, padding * voxel_size);
+
+  BakeGrid grid;
+  grid.origin = origin_;
+  grid.voxel_size = voxel_size;
+  for(int i = 0; i < 3; ++i)
+  {
+    int n = (int)std::ceil((hi[i] - lo[i]) / voxel_size) + 1 + 2 * padding;
+    num_blocks_[i] = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    num_samples_[i] = num_blocks_[i] * BLOCK_SIZE;
+    grid.n[i] = num_samples_[i];
+  }
+
+  const int num_grid_samples = grid.n[0] * grid.n[1] * grid.n[2];
+  const FCL_REAL far_distance = (grid.n[0] + grid.n[1] + grid.n[2]) * voxel_size;
+  grid.phi.assign(num_grid_samples, far_distance);
+  grid.closest.assign(num_grid_samples, -1);
+  grid.crossings.assign(num_grid_samples, 0);
+
+  // exact distances in a thin shell around each triangle, and crossings of the x-aligned grid lines for the sign
+  const int exact_band = 1;
+  for(int t = 0; t < num_triangles; ++t)
+  {
+    const Triangle& tri = triangles[t];
+    const Vec3f& p = vertices[tri[0]];
+    const Vec3f& q = vertices[tri[1]];
+    const Vec3f& r = vertices[tri[2]];
+
+    Vec3f fp = (p - origin_) / voxel_size;
+    Vec3f fq = (q - origin_) / voxel_size;
+    Vec3f fr = (r - origin_) / voxel_size;
+
+    int lo_id[3], hi_id[3];
+    for(int i = 0; i < 3; ++i)
+    {
+      lo_id[i] = clampIndex((int)std::floor(std::min(fp[i], std::min(fq[i], fr[i]))) - exact_band, grid.n[i]);
+      hi_id[i] = clampIndex((int)std::ceil(std::max(fp[i], std::max(fq[i], fr[i]))) + exact_band, grid.n[i]);
+    }
+
+    for(int k = lo_id[2]; k <= hi_id[2]; ++k)
+    {
+      for(int j = lo_id[1]; j <= hi_id[1]; ++j)
+      {
+        for(int i = lo_id[0]; i <= hi_id[0]; ++i)
+        {
+          int id = grid.index(i, j, k);
+          FCL_REAL d = pointTriangleDistance(grid.position(i, j, k), p, q, r);
+          if(d < grid.phi[id])
+          {
+            grid.phi[id] = d;
+            grid.closest[id] = t;
+          }
+        }
+      }
+    }
+
+    int j_begin = clampIndex((int)std::ceil(std::min(fp[1], std::min(fq[1], fr[1]))), grid.n[1]);
+    int j_end = clampIndex((int)std::floor(std::max(fp[1], std::max(fq[1], fr[1]))), grid.n[1]);
+    int k_begin = clampIndex((int)std::ceil(std::min(fp[2], std::min(fq[2], fr[2]))), grid.n[2]);
+    int k_end = clampIndex((int)std::floor(std::max(fp[2], std::max(fq[2], fr[2]))), grid.n[2]);
+
+    for(int k = k_begin; k <= k_end; ++k)
+    {
+      for(int j = j_begin; j <= j_end; ++j)
+      {
+        FCL_REAL a, b, c;
+        if(pointInTriangle2D(j, k, fp[1], fp[2], fq[1], fq[2], fr[1], fr[2], a, b, c))
+        {
+          FCL_REAL fi = a * fp[0] + b * fq[0] + c * fr[0];
+          int i_interval = (int)std::ceil(fi);
+          if(i_interval < 0)
+            ++grid.crossings[grid.index(0, j, k)];
+          else if(i_interval < grid.n[0])
+            ++grid.crossings[grid.index(i_interval, j, k)];
+        }
+      }
+    }
+  }
+
+  // propagate the closest triangles to the rest of the grid
+  for(int pass = 0; pass < 2; ++pass)
+  {
+    sweep(grid, vertices, triangles, +1, +1, +1);
+    sweep(grid, vertices, triangles, -1, -1, -1);
+    sweep(grid, vertices, triangles, +1, +1, -1);
+    sweep(grid, vertices, triangles, -1, -1, +1);
+    sweep(grid, vertices, triangles, +1, -1, +1);
+    sweep(grid, vertices, triangles, -1, +1, -1);
+    sweep(grid, vertices, triangles, +1, -1, -1);
+    sweep(grid, vertices, triangles, -1, +1, +1);
+  }
+
+  // samples after an odd number of crossings along x are inside the mesh
+  for(int k = 0; k < grid.n[2]; ++k)
+  {
+    for(int j = 0; j < grid.n[1]; ++j)
+    {
+      int total = 0;
+      for(int i = 0; i < grid.n[0]; ++i)
+      {
+        int id = grid.index(i, j, k);
+        total += grid.crossings[id];
+        if(total % 2 == 1)
+          grid.phi[id] = -grid.phi[id];
+      }
+    }
+  }
+
+  // keep full resolution only for the blocks in the narrow band
+  const int block_samples = BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE;
+  const FCL_REAL band_distance = band * voxel_size;
+  num_blocks_total_ = num_blocks_[0] * num_blocks_[1] * num_blocks_[2];
+  block_table_storage_.resize(num_blocks_total_);
+  block_values_storage_.resize(num_blocks_total_);
+
+  for(int bk = 0; bk < num_blocks_[2]; ++bk)
+  {
+    for(int bj = 0; bj < num_blocks_[1]; ++bj)
+    {
+      for(int bi = 0; bi < num_blocks_[0]; ++bi)
+      {
+        int block = (bk * num_blocks_[1] + bj) * num_blocks_[0] + bi;
+        FCL_REAL min_abs = std::numeric_limits<FCL_REAL>::max();
+        FCL_REAL sign = 1;
+        for(int k = 0; k < BLOCK_SIZE; ++k)
+        {
+          for(int j = 0; j < BLOCK_SIZE; ++j)
+          {
+            for(int i = 0; i < BLOCK_SIZE; ++i)
+            {
+              FCL_REAL v = grid.phi[grid.index(bi * BLOCK_SIZE + i, bj * BLOCK_SIZE + j, bk * BLOCK_SIZE + k)];
+              if(std::abs(v) < min_abs)
+              {
+                min_abs = std::abs(v);
+                sign = (v < 0) ? -1 : 1;
+              }
+            }
+          }
+        }
+
+        block_values_storage_[block] = (float)(sign * min_abs);
+        if(min_abs >= band_distance)
+        {
+          block_table_storage_[block] = -1;
+          continue;
+        }
+
+        block_table_storage_[block] = num_dense_blocks_;
+        samples_storage_.resize(samples_storage_.size() + block_samples);
+        float* dense = &samples_storage_[num_dense_blocks_ * block_samples];
+        for(int k = 0; k < BLOCK_SIZE; ++k)
+        {
+          for(int j = 0; j < BLOCK_SIZE; ++j)
+          {
+            for(int i = 0; i < BLOCK_SIZE; ++i)
+              *dense++ = (float)grid.phi[grid.index(bi * BLOCK_SIZE + i, bj * BLOCK_SIZE + j, bk * BLOCK_SIZE + k)];
+          }
+        }
+        ++num_dense_blocks_;
+      }
+    }
+  }
+
+  bindStorage();
+  computeLocalAABB();
+
+  return true;
+}
+
+bool SignedDistanceField::save(const std::string& filename) const
+{
+  if(isEmpty())
+  {
+    std::cerr << "SDF Error! Cannot save an empty field." << std::endl;
+    return false;
+  }
+
+  const boost::uint64_t block_samples = BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE;
+
+  SDFFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SDF_FILE_MAGIC, sizeof(header.magic));
+  header.version = SDF_FILE_VERSION;
+  header.byte_order = SDF_FILE_BYTE_ORDER;
+  header.block_size = BLOCK_SIZE;
+  for(int i = 0; i < 3; ++i)
+  {
+    header.num_blocks[i] = num_blocks_[i];
+    header.origin[i] = origin_[i];
+  }
+  header.num_dense_blocks = num_dense_blocks_;
+  header.voxel_size = voxel_size_;
+  header.table_offset = alignOffset(sizeof(SDFFileHeader));
+  header.values_offset = alignOffset(header.table_offset + sizeof(FCL_INT32) * num_blocks_total_);
+  header.samples_offset = alignOffset(header.values_offset + sizeof(float) * num_blocks_total_);
+  header.file_size = header.samples_offset + sizeof(float) * block_samples * num_dense_blocks_;
+
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!out)
+  {
+    std::cerr << "SDF Error! Cannot open " << filename << " for writing." << std::endl;
+    return false;
+  }
+
+  const char zeros[SDF_FILE_ALIGNMENT] = {0};
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(zeros, header.table_offset - sizeof(header));
+  out.write(reinterpret_cast<const char*>(block_table_), sizeof(FCL_INT32) * num_blocks_total_);
+  out.write(zeros, header.values_offset - header.table_offset - sizeof(FCL_INT32) * num_blocks_total_);
+  out.write(reinterpret_cast<const char*>(block_values_), sizeof(float) * num_blocks_total_);
+  out.write(zeros, header.samples_offset - header.values_offset - sizeof(float) * num_blocks_total_);
+  if(num_dense_blocks_ > 0)
+    out.write(reinterpret_cast<const char*>(samples_), sizeof(float) * block_samples * num_dense_blocks_);
+
+  if(!out)
+  {
+    std::cerr << "SDF Error! Failed to write " << filename << "." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool SignedDistanceField::load(const std::string& filename)
+{
+  boost::shared_ptr<boost::interprocess::mapped_region> region;
+  try
+  {
+    boost::interprocess::file_mapping mapping(filename.c_str(), boost::interprocess::read_only);
+    region.reset(new boost::interprocess::mapped_region(mapping, boost::interprocess::read_only));
+  }
+  catch(const boost::interprocess::interprocess_exception& e)
+  {
+    std::cerr << "SDF Error! Cannot map " << filename << ": " << e.what() << std::endl;
+    return false;
+  }
+
+  const char* data = static_cast<const char*>(region->get_address());
+  const boost::uint64_t size = region->get_size();
+  if(size < sizeof(SDFFileHeader))
+  {
+    std::cerr << "SDF Error! " << filename << " is too small." << std::endl;
+    return false;
+  }
+
+  const SDFFileHeader& header = *reinterpret_cast<const SDFFileHeader*>(data);
+  if(memcmp(header.magic, SDF_FILE_MAGIC, sizeof(header.magic)) != 0 || header.byte_order != SDF_FILE_BYTE_ORDER)
+  {
+    std::cerr << "SDF Error! " << filename << " is not a signed distance field of this platform." << std::endl;
+    return false;
+  }
+
+  if(header.version != SDF_FILE_VERSION || header.block_size != (FCL_UINT32)BLOCK_SIZE)
+  {
+    std::cerr << "SDF Error! " << filename << " has an unsupported version or block size." << std::endl;
+    return false;
+  }
+
+  const boost::uint64_t num_blocks_total = (boost::uint64_t)header.num_blocks[0] * header.num_blocks[1] * header.num_blocks[2];
+  const boost::uint64_t block_samples = BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE;
+  if(header.file_size > size ||
+     header.table_offset + sizeof(FCL_INT32) * num_blocks_total > header.values_offset ||
+     header.values_offset + sizeof(float) * num_blocks_total > header.samples_offset ||
+     header.samples_offset + sizeof(float) * block_samples * header.num_dense_blocks > header.file_size ||
+     header.table_offset % SDF_FILE_ALIGNMENT || header.values_offset % SDF_FILE_ALIGNMENT || header.samples_offset % SDF_FILE_ALIGNMENT)
+  {
+    std::cerr << "SDF Error! " << filename << " is truncated or corrupted." << std::endl;
+    return false;
+  }
+
+  clear();
+
+  region_ = region;
+  origin_.setValue(header.origin[0], header.origin[1], header.origin[2]);
+  voxel_size_ = header.voxel_size;
+  for(int i = 0; i < 3; ++i)
+  {
+    num_blocks_[i] = header.num_blocks[i];
+    num_samples_[i] = num_blocks_[i] * BLOCK_SIZE;
+  }
+  num_blocks_total_ = (int)num_blocks_total;
+  num_dense_blocks_ = header.num_dense_blocks;
+  block_table_ = reinterpret_cast<const FCL_INT32*>(data + header.table_offset);
+  block_values_ = reinterpret_cast<const float*>(data + header.values_offset);
+  samples_ = reinterpret_cast<const float*>(data + header.samples_offset);
+
+  computeLocalAABB();
+
+  return true;
+}
+
+FCL_REAL SignedDistanceField::distance(const Vec3f& p) const
+{
+  Vec3f gradient;
+  return distance(p, gradient);
+}
+
+FCL_REAL SignedDistanceField::distance(const Vec3f& p, Vec3f& gradient) const
+{
+  if(isEmpty())
+  {
+    gradient.setValue(0);
+    return std::numeric_limits<FCL_REAL>::max();
+  }
+
+  // points outside the sampled region are evaluated on its boundary; as the mesh lies inside the region,
+  // the distance to the boundary and the boundary value are orthogonal and give a lower bound
+  Vec3f q = p;
+  q.lbound(aabb_local.min_);
+  q.ubound(aabb_local.max_);
+
+  int id[3];
+  FCL_REAL t[3];
+  for(int i = 0; i < 3; ++i)
+  {
+    FCL_REAL f = (q[i] - origin_[i]) / voxel_size_;
+    id[i] = std::max(0, std::min((int)std::floor(f), num_samples_[i] - 2));
+    t[i] = std::max((FCL_REAL)0, std::min(f - id[i], (FCL_REAL)1));
+  }
+
+  FCL_REAL c000 = sample(id[0], id[1], id[2]);
+  FCL_REAL c100 = sample(id[0] + 1, id[1], id[2]);
+  FCL_REAL c010 = sample(id[0], id[1] + 1, id[2]);
+  FCL_REAL c110 = sample(id[0] + 1, id[1] + 1, id[2]);
+  FCL_REAL c001 = sample(id[0], id[1], id[2] + 1);
+  FCL_REAL c101 = sample(id[0] + 1, id[1], id[2] + 1);
+  FCL_REAL c011 = sample(id[0], id[1] + 1, id[2] + 1);
+  FCL_REAL c111 = sample(id[0] + 1, id[1] + 1, id[2] + 1);
+
+  FCL_REAL c00 = c000 + (c100 - c000) * t[0];
+  FCL_REAL c10 = c010 + (c110 - c010) * t[0];
+  FCL_REAL c01 = c001 + (c101 - c001) * t[0];
+  FCL_REAL c11 = c011 + (c111 - c011) * t[0];
+  FCL_REAL c0 = c00 + (c10 - c00) * t[1];
+  FCL_REAL c1 = c01 + (c11 - c01) * t[1];
+  FCL_REAL d = c0 + (c1 - c0) * t[2];
+
+  FCL_REAL inv_voxel = 1 / voxel_size_;
+  gradient[0] = ((c100 - c000) * (1 - t[1]) * (1 - t[2]) + (c110 - c010) * t[1] * (1 - t[2]) +
+                 (c101 - c001) * (1 - t[1]) * t[2] + (c111 - c011) * t[1] * t[2]) * inv_voxel;
+  gradient[1] = ((c10 - c00) * (1 - t[2]) + (c11 - c01) * t[2]) * inv_voxel;
+  gradient[2] = (c1 - c0) * inv_voxel;
+
+  Vec3f outside = p - q;
+  FCL_REAL outside_distance = outside.length();
+  if(outside_distance > 0)
+  {
+    gradient = outside;
+    if(d > 0)
+      return std::sqrt(outside_distance * outside_distance + d * d);
+    return outside_distance + d;
+  }
+
+  return d;
+}
+
+void SignedDistanceField::computeLocalAABB()
+{
+  Vec3f extent((num_samples_[0] - 1) * voxel_size_, (num_samples_[1] - 1) * voxel_size_, (num_samples_[2] - 1) * voxel_size_);
+  aabb_local = AABB(origin_, origin_ + extent);
+  aabb_center = aabb_local.center();
+  aabb_radius = (aabb_local.min_ - aabb_center).length();
+}
+
+std::size_t SignedDistanceField::memUsage() const
+{
+  return sizeof(FCL_INT32) * num_blocks_total_ + sizeof(float) * num_blocks_total_ +
+    sizeof(float) * BLOCK_SIZE * BLOCK_SIZE * BLOCK_SIZE * num_dense_blocks_;
+}
+
+}
@@ -79,7 +79,7 @@ static inline void meshCollisionOrientedNodeLeafTesting(int bv_node1_id, int bv_
 
     if(!request.enable_contact) // only interested in collision or not
     {
-      if(Intersect::intersect_Triangle(p1, p2, p3, q1, q2, q3, R, T))
+      if(meshTriangleIntersect(model1, primitive_id1, p1, p2, p3, model2, primitive_id2, q1, q2, q3, R, T))
       {
         is_intersect = true;
         if(result.numContacts() < request.num_max_contacts)
@@ -93,12 +93,12 @@ static inline void meshCollisionOrientedNodeLeafTesting(int bv_node1_id, int bv_
       unsigned int n_contacts;
       Vec3f contacts[2];
 
-      if(Intersect::intersect_Triangle(p1, p2, p3, q1, q2, q3,
-                                       R, T,
-                                       contacts,
-                                       &n_contacts,
-                                       &penetration,
-                                       &normal))
+      if(meshTriangleIntersect(model1, primitive_id1, p1, p2, p3, model2, primitive_id2, q1, q2, q3,
+                               R, T,
+                               contacts,
+                               &n_contacts,
+                               &penetration,
+                               &normal))
       {
         is_intersect = true;
         
@@ -121,7 +121,7 @@ static inline void meshCollisionOrientedNodeLeafTesting(int bv_node1_id, int bv_
   }
   else if((!model1->isFree() && !model2->isFree()) && request.enable_cost)
   {
-    if(Intersect::intersect_Triangle(p1, p2, p3, q1, q2, q3, R, T))
+    if(meshTriangleIntersect(model1, primitive_id1, p1, p2, p3, model2, primitive_id2, q1, q2, q3, R, T))
     {
       AABB overlap_part;
       AABB(tf1.transform(p1), tf1.transform(p2), tf1.transform(p3)).overlap(AABB(tf2.transform(q1), tf2.transform(q2), tf2.transform(q3)), overlap_part);
@@ -0,0 +1,176 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "fcl/traversal/traversal_node_compact.h"
+#include "fcl/BV/OBB.h"
+#include "fcl/intersect.h"
+
+namespace fcl
+{
+
+namespace details
+{
+
+struct CompactCollisionData
+{
+  const CompactBVHModel* model1;
+  const CompactBVHModel* model2;
+  Transform3f tf1;
+  Transform3f tf2;
+  Matrix3f R;
+  Vec3f T;
+  const CollisionRequest* request;
+  CollisionResult* result;
+  QueryStatistics* statistics;
+};
+
+/// @brief Box test in the frame of model1, the same separating axis test as for OBBs
+static inline bool compactBoxDisjoint(const CompactCollisionData& data, const AABB& box1, const AABB& box2)
+{
+  Vec3f a = (box1.max_ - box1.min_) * 0.5;
+  Vec3f b = (box2.max_ - box2.min_) * 0.5;
+  Vec3f T = data.R * box2.center() + data.T - box1.center();
+  return obbDisjoint(data.R, T, a, b);
+}
+
+static void compactLeafTesting(const CompactCollisionData& data, int primitive_id1, int primitive_id2)
+{
+  const CollisionRequest& request = *data.request;
+  CollisionResult& result = *data.result;
+
+  Vec3f p1, p2, p3, q1, q2, q3;
+  data.model1->getTriangle(primitive_id1, p1, p2, p3);
+  data.model2->getTriangle(primitive_id2, q1, q2, q3);
+
+  bool is_intersect = false;
+  if(!request.enable_contact)
+  {
+    if(Intersect::intersect_Triangle(p1, p2, p3, q1, q2, q3, data.R, data.T))
+    {
+      is_intersect = true;
+      if(result.numContacts() < request.num_max_contacts)
+        result.addContact(Contact(data.model1, data.model2, primitive_id1, primitive_id2));
+    }
+  }
+  else
+  {
+    FCL_REAL penetration;
+    Vec3f normal;
+    unsigned int n_contacts;
+    Vec3f contacts[2];
+
+    if(Intersect::intersect_Triangle(p1, p2, p3, q1, q2, q3, data.R, data.T, contacts, &n_contacts, &penetration, &normal))
+    {
+      is_intersect = true;
+
+      if(request.num_max_contacts < result.numContacts() + n_contacts)
+        n_contacts = static_cast<unsigned int>((request.num_max_contacts > result.numContacts()) ? (request.num_max_contacts - result.numContacts()) : 0);
+
+      for(unsigned int i = 0; i < n_contacts; ++i)
+        result.addContact(Contact(data.model1, data.model2, primitive_id1, primitive_id2, data.tf1.transform(contacts[i]), data.tf1.getQuatRotation().transform(normal), penetration));
+    }
+  }
+
+  if(is_intersect && request.enable_cost)
+  {
+    AABB overlap_part;
+    AABB(data.tf1.transform(p1), data.tf1.transform(p2), data.tf1.transform(p3)).overlap(AABB(data.tf2.transform(q1), data.tf2.transform(q2), data.tf2.transform(q3)), overlap_part);
+    result.addCostSource(CostSource(overlap_part, data.model1->cost_density * data.model2->cost_density), request.num_max_cost_sources);
+  }
+}
+
+static void compactCollisionRecurse(const CompactCollisionData& data, int b1, const AABB& box1, int b2, const AABB& box2)
+{
+  if(data.statistics) data.statistics->num_bv_tests++;
+  if(compactBoxDisjoint(data, box1, box2)) return;
+
+  const CompactBVHModel::Node& node1 = data.model1->getNode(b1);
+  const CompactBVHModel::Node& node2 = data.model2->getNode(b2);
+
+  if(node1.isLeaf() && node2.isLeaf())
+  {
+    if(data.statistics) data.statistics->num_leaf_tests++;
+    compactLeafTesting(data, node1.primitiveId(), node2.primitiveId());
+    return;
+  }
+
+  AABB child_box;
+  if(node2.isLeaf() || (!node1.isLeaf() && box1.size() > box2.size()))
+  {
+    data.model1->decodeBox(data.model1->getNode(node1.leftChild()), box1, child_box);
+    compactCollisionRecurse(data, node1.leftChild(), child_box, b2, box2);
+
+    if(data.request->isSatisfied(*data.result)) return;
+
+    data.model1->decodeBox(data.model1->getNode(node1.rightChild()), box1, child_box);
+    compactCollisionRecurse(data, node1.rightChild(), child_box, b2, box2);
+  }
+  else
+  {
+    data.model2->decodeBox(data.model2->getNode(node2.leftChild()), box2, child_box);
+    compactCollisionRecurse(data, b1, box1, node2.leftChild(), child_box);
+
+    if(data.request->isSatisfied(*data.result)) return;
+
+    data.model2->decodeBox(data.model2->getNode(node2.rightChild()), box2, child_box);
+    compactCollisionRecurse(data, b1, box1, node2.rightChild(), child_box);
+  }
+}
+
+}
+
+std::size_t compactCollide(const CompactBVHModel* model1, const Transform3f& tf1,
+                           const CompactBVHModel* model2, const Transform3f& tf2,
+                           const CollisionRequest& request, CollisionResult& result)
+{
+  if(model1->getNumNodes() == 0 || model2->getNumNodes() == 0) return result.numContacts();
+  if(!model1->isOccupied() || !model2->isOccupied()) return result.numContacts();
+
+  details::CompactCollisionData data;
+  data.model1 = model1;
+  data.model2 = model2;
+  data.tf1 = tf1;
+  data.tf2 = tf2;
+  relativeTransform(tf1.getRotation(), tf1.getTranslation(), tf2.getRotation(), tf2.getTranslation(), data.R, data.T);
+  data.request = &request;
+  data.result = &result;
+  data.statistics = details::getQueryStatistics();
+
+  details::compactCollisionRecurse(data, 0, model1->getRootBox(), 0, model2->getRootBox());
+
+  return result.numContacts();
+}
+
+}
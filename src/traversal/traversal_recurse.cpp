@@ -36,9 +36,25 @@
 
 
 #include "fcl/traversal/traversal_recurse.h"
+#include "fcl/probe.h"
+#include <algorithm>
 
 namespace fcl
 {
+
+/// @brief Count BV tests in the probes and in the statistics of the query
+static inline void countBVTests(const TraversalNodeBase* node, std::size_t n)
+{
+  FCL_PROBE_ADD(PROBE_BV_TEST, n);
+  if(node->query_statistics) node->query_statistics->num_bv_tests += n;
+}
+
+/// @brief Count leaf tests in the probes and in the statistics of the query
+static inline void countLeafTests(const TraversalNodeBase* node, std::size_t n)
+{
+  FCL_PROBE_ADD(PROBE_LEAF_TEST, n);
+  if(node->query_statistics) node->query_statistics->num_leaf_tests += n;
+}
 void collisionRecurse(CollisionTraversalNodeBase* node, int bv_node1_id, int bv_node2_id, BVHFrontList* front_list)
 {
   bool is_first_node_leaf = node->isFirstNodeLeaf(bv_node1_id);
@@ -48,12 +64,15 @@ void collisionRecurse(CollisionTraversalNodeBase* node, int bv_node1_id, int bv_
   {
     updateFrontList(front_list, bv_node1_id, bv_node2_id);
 
+    countBVTests(node, 1);
     if(node->BVTesting(bv_node1_id, bv_node2_id)) return;
 
+    countLeafTests(node, 1);
     node->leafTesting(bv_node1_id, bv_node2_id);
     return;
   }
 
+  countBVTests(node, 1);
   if(node->BVTesting(bv_node1_id, bv_node2_id))
   {
     updateFrontList(front_list, bv_node1_id, bv_node2_id);
@@ -94,12 +113,15 @@ void collisionRecurse(MeshCollisionTraversalNodeOBB* node, int bv_node1_id, int
   {
     updateFrontList(front_list, bv_node1_id, bv_node2_id);
 
+    countBVTests(node, 1);
     if(node->BVTesting(bv_node1_id, bv_node2_id, R, T)) return;
 
+    countLeafTests(node, 1);
     node->leafTesting(bv_node1_id, bv_node2_id, R, T);
     return;
   }
 
+  countBVTests(node, 1);
   if(node->BVTesting(bv_node1_id, bv_node2_id, R, T))
   {
     updateFrontList(front_list, bv_node1_id, bv_node2_id);
@@ -201,6 +223,7 @@ void distanceRecurse(DistanceTraversalNodeBase* node, int bv_node1_id, int bv_no
   {
     updateFrontList(front_list, bv_node1_id, bv_node2_id);
 
+    countLeafTests(node, 1);
     node->leafTesting(bv_node1_id, bv_node2_id);
     return;
   }
@@ -223,6 +246,7 @@ void distanceRecurse(DistanceTraversalNodeBase* node, int bv_node1_id, int bv_no
     c2 = node->getSecondRightChild(bv_node2_id);
   }
 
+  countBVTests(node, 2);
   FCL_REAL distance_a = node->BVTesting(a1, a2);
   FCL_REAL distance_c = node->BVTesting(c1, c2);
 
@@ -341,6 +365,7 @@ void distanceQueueRecurse(DistanceTraversalNodeBase* node, int bv_node1_id, int
     {
       updateFrontList(front_list, min_test.bv_node1_id, min_test.bv_node2_id);
 
+      countLeafTests(node, 1);
       node->leafTesting(min_test.bv_node1_id, min_test.bv_node2_id);
     }
     else if(bvtq.full())
@@ -361,10 +386,12 @@ void distanceQueueRecurse(DistanceTraversalNodeBase* node, int bv_node1_id, int
 
         bvt1.bv_node1_id = c1;
         bvt1.bv_node2_id = min_test.bv_node2_id;
+        countBVTests(node, 1);
         bvt1.d = node->BVTesting(bvt1.bv_node1_id, bvt1.bv_node2_id);
 
         bvt2.bv_node1_id = c2;
         bvt2.bv_node2_id = min_test.bv_node2_id;
+        countBVTests(node, 1);
         bvt2.d = node->BVTesting(bvt2.bv_node1_id, bvt2.bv_node2_id);
       }
       else
@@ -374,10 +401,12 @@ void distanceQueueRecurse(DistanceTraversalNodeBase* node, int bv_node1_id, int
 
         bvt1.bv_node1_id = min_test.bv_node1_id;
         bvt1.bv_node2_id = c1;
+        countBVTests(node, 1);
         bvt1.d = node->BVTesting(bvt1.bv_node1_id, bvt1.bv_node2_id);
 
         bvt2.bv_node1_id = min_test.bv_node1_id;
         bvt2.bv_node2_id = c2;
+        countBVTests(node, 1);
         bvt2.d = node->BVTesting(bvt2.bv_node1_id, bvt2.bv_node2_id);
       }	  
 
@@ -415,6 +444,35 @@ void distanceQueueRecurse(DistanceTraversalNodeBase* node, int bv_node1_id, int
   }
 }
 
+void propagateBVHFrontListDistanceRecurse(DistanceTraversalNodeBase* node, BVHFrontList* front_list)
+{
+  BVHFrontList old_front;
+  old_front.swap(*front_list);
+
+  // test the front nodes nearest first, so that the traversal below them stops as early as possible
+  std::vector<BVT> tests;
+  tests.reserve(old_front.size());
+  for(BVHFrontList::const_iterator front_iter = old_front.begin(); front_iter != old_front.end(); ++front_iter)
+  {
+    BVT test;
+    test.bv_node1_id = front_iter->left;
+    test.bv_node2_id = front_iter->right;
+    countBVTests(node, 1);
+    test.d = node->BVTesting(test.bv_node1_id, test.bv_node2_id);
+    tests.push_back(test);
+  }
+
+  std::sort(tests.begin(), tests.end(), BVT_Comparer());
+
+  for(std::vector<BVT>::const_reverse_iterator it = tests.rbegin(); it != tests.rend(); ++it)
+  {
+    if(!node->canStop(it->d))
+      distanceRecurse(node, it->bv_node1_id, it->bv_node2_id, front_list);
+    else
+      updateFrontList(front_list, it->bv_node1_id, it->bv_node2_id);
+  }
+}
+
 void propagateBVHFrontListCollisionRecurse(CollisionTraversalNodeBase* node, BVHFrontList* front_list)
 {
   BVHFrontList::iterator front_iter;
@@ -433,6 +491,7 @@ void propagateBVHFrontListCollisionRecurse(CollisionTraversalNodeBase* node, BVH
     }
     else
     {
+      countBVTests(node, 1);
       if(!node->BVTesting(bv_node1_id, bv_node2_id))
       {
         front_iter->valid = false;
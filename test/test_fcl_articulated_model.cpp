@@ -10,6 +10,9 @@
 #include "fcl/articulated_model/model.h"
 #include "fcl/articulated_model/model_config.h"
 #include "fcl/articulated_model/link_bound.h"
+#include "fcl/articulated_model/compiled_model.h"
+#include "fcl/articulated_model/motion_bound_table.h"
+#include "fcl/ccd/motion.h"
 
 #include "fcl/BV/BV.h"
 #include "fcl/BVH/BVH_model.h"
@@ -1294,6 +1297,162 @@ BOOST_FIXTURE_TEST_CASE(test_get_bounded_link_global_transform, LinkBoundFixture
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_SUITE(test_compiled_model)
+
+void checkCompiledModel(const Model& model, const boost::shared_ptr<const ModelConfig>& model_cfg)
+{
+	CompiledModel compiled(model);
+
+	std::vector<FCL_REAL> dofs;
+	compiled.getDofs(*model_cfg, dofs);
+	BOOST_REQUIRE_EQUAL(dofs.size(), model.getNumDofs() );
+
+	KinematicsResult result;
+	compiled.forwardKinematics(dofs, result);
+
+	std::vector<boost::shared_ptr<const Joint> > joints = model.getJoints();
+	for (std::size_t i = 0; i < joints.size(); ++i)
+	{
+		int id = compiled.getJointId(joints[i]->getName() );
+		BOOST_REQUIRE(id >= 0);
+		BOOST_CHECK(compiled.getParent(id) < id);
+
+		Transform3f expected_transform = model.getGlobalTransform(joints[i], model_cfg);
+		Transform3f transform = result.getTransform(id);
+
+		BOOST_CHECK((expected_transform.getTranslation() - transform.getTranslation() ).length() < 1e-10);
+
+		Matrix3f difference = expected_transform.getRotation() - transform.getRotation();
+		for (std::size_t j = 0; j < 3; ++j)
+			BOOST_CHECK(difference.getRow(j).length() < 1e-10);
+
+		BOOST_CHECK_EQUAL(compiled.getLinkJointId(joints[i]->getChildLink()->getName() ), id);
+	}
+
+	ModelConfig copy_cfg(*model_cfg);
+	std::vector<FCL_REAL> zero_dofs(dofs.size(), 0);
+	compiled.setDofs(zero_dofs, copy_cfg);
+	compiled.setDofs(dofs, copy_cfg);
+	BOOST_CHECK(copy_cfg == *model_cfg);
+}
+
+BOOST_FIXTURE_TEST_CASE(test_forward_kinematics, ModelConfigFixture)
+{
+	checkCompiledModel(*model_, cfg_start_);
+	checkCompiledModel(*model_, cfg_end_);
+
+	CompiledModel compiled(*model_);
+	BOOST_CHECK_EQUAL(compiled.getNumJoints(), model_->getNumJoints() );
+	BOOST_CHECK_EQUAL(compiled.getNumDofs(), model_->getNumDofs() );
+	BOOST_CHECK_EQUAL(compiled.getJointId("NO JOINT"), -1);
+	BOOST_CHECK_EQUAL(compiled.getLinkJointId(body_name_), -1);
+	BOOST_CHECK_EQUAL(compiled.getParent(compiled.getJointId(shoulder_joint_name_) ), -1);
+	BOOST_CHECK_EQUAL(compiled.getParent(compiled.getJointId(finger_joint_name_) ),
+		compiled.getJointId(wrist_joint_name_) );
+}
+
+BOOST_AUTO_TEST_CASE(test_forward_kinematics_branching)
+{
+	boost::shared_ptr<Link> base(new Link("BASE") );
+	boost::shared_ptr<Link> left(new Link("LEFT") );
+	boost::shared_ptr<Link> right(new Link("RIGHT") );
+	boost::shared_ptr<Link> tip(new Link("TIP") );
+
+	Quaternion3f rotation;
+	rotation.fromAxisAngle(Vec3f(0.0, 0.0, 1.0), 0.3);
+
+	boost::shared_ptr<Joint> left_joint(new BallEulerJoint(base, left,
+		Transform3f(rotation, Vec3f(1, 0, 0) ), "LEFT JOINT") );
+	boost::shared_ptr<Joint> right_joint(new RevoluteJoint(base, right,
+		Transform3f(Vec3f(-1, 0, 0) ), "RIGHT JOINT", Vec3f(0.0, 1.0, 0.0) ) );
+	boost::shared_ptr<Joint> tip_joint(new PrismaticJoint(left, tip,
+		Transform3f(rotation, Vec3f(0, 2, 0) ), "TIP JOINT", Vec3f(1.0, 0.0, 0.0) ) );
+
+	boost::shared_ptr<Model> model(new Model() );
+	model->addLink(base);
+	model->addLink(left);
+	model->addLink(right);
+	model->addLink(tip);
+	model->addJoint(left_joint);
+	model->addJoint(right_joint);
+	model->addJoint(tip_joint);
+	model->initTree();
+
+	boost::shared_ptr<ModelConfig> model_cfg(new ModelConfig(model) );
+	model_cfg->getJointConfig(left_joint)[0] = 0.2;
+	model_cfg->getJointConfig(left_joint)[1] = -0.7;
+	model_cfg->getJointConfig(left_joint)[2] = 1.1;
+	model_cfg->getJointConfig(right_joint)[0] = 0.9;
+	model_cfg->getJointConfig(tip_joint)[0] = 3;
+
+	checkCompiledModel(*model, model_cfg);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(test_motion_bound_table)
+
+BOOST_FIXTURE_TEST_CASE(test_get_motion_bound, LinkBoundFixture)
+{
+	MotionBoundTable table(movement_, 4);
+	BOOST_REQUIRE_EQUAL(table.getNumIntervals(), 4);
+	BOOST_CHECK_EQUAL(table.getIntervalIndex(0.0), 0);
+	BOOST_CHECK_EQUAL(table.getIntervalIndex(0.3), 1);
+	BOOST_CHECK_EQUAL(table.getIntervalIndex(1.0), 3);
+
+	boost::shared_ptr<const Link> links[] = {arm_, forearm_, hand_, finger_};
+	Vec3f directions[] = {Vec3f(0.0, 0.0, 0.0), direction_, Vec3f(1.0, 1.0, 0.0).normalize()};
+
+	std::vector<FCL_REAL> bounds;
+	table.getMotionBounds(direction_, distance_from_center_, bounds);
+
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		LinkBound link_bound(movement_, links[i]);
+		int joint_id = table.getCompiledModel().getLinkJointId(links[i]->getName() );
+		BOOST_REQUIRE(joint_id >= 0);
+
+		for (std::size_t k = 0; k < table.getNumIntervals(); ++k)
+		{
+			FCL_REAL start_time = table.getTimes()[k];
+			FCL_REAL end_time = table.getTimes()[k + 1];
+
+			for (std::size_t j = 0; j < 3; ++j)
+			{
+				FCL_REAL expected_bound = link_bound.getMotionBound(start_time, end_time,
+					directions[j], distance_from_center_);
+
+				BOOST_CHECK_CLOSE(table.getMotionBound(joint_id, k, directions[j], distance_from_center_),
+					expected_bound, 1e-8);
+				BOOST_CHECK_CLOSE(table.getMotionBound(joint_id, start_time, end_time, directions[j], distance_from_center_),
+					expected_bound, 1e-8);
+			}
+
+			BOOST_CHECK_CLOSE(bounds[k * table.getNumJoints() + joint_id],
+				link_bound.getMotionBound(start_time, end_time, direction_, distance_from_center_), 1e-8);
+		}
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(test_articular_motion_with_table, LinkBoundFixture)
+{
+	boost::shared_ptr<const MotionBoundTable> table(new MotionBoundTable(movement_, 8) );
+
+	ArticularMotion motion(link_bound_);
+	ArticularMotion table_motion(link_bound_);
+	table_motion.setMotionBoundTable(table);
+
+	motion.integrate(0.25, 0.5);
+	table_motion.integrate(0.25, 0.5);
+
+	BOOST_CHECK_CLOSE(table_motion.getMotionBound(direction_, distance_from_center_),
+		motion.getMotionBound(direction_, distance_from_center_), 1e-8);
+	BOOST_CHECK_CLOSE(table_motion.getNonDirectionalMotionBound(distance_from_center_),
+		motion.getNonDirectionalMotionBound(distance_from_center_), 1e-8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 ////////////////////////////////////////////////////////////////////////////////
 
 }
\ No newline at end of file
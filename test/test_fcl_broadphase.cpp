@@ -51,7 +51,7 @@
 
 #include <boost/math/constants/constants.hpp>
 #include <iostream>
-#include <iomanip>
+#include <algorithm>
 
 using namespace fcl;
 
@@ -164,6 +164,213 @@ BOOST_AUTO_TEST_CASE(test_core_bf_broad_phase_collision)
   broad_phase_collision_test(2000, 1000, 1000, 10, false);
 }
 
+/// check that the tight AABBs of rotated objects contain the geometry and are not larger than the bounding sphere boxes
+BOOST_AUTO_TEST_CASE(test_tight_aabb)
+{
+  std::vector<boost::shared_ptr<CollisionGeometry> > geometries;
+  std::vector<boost::shared_ptr<BVHModel<OBBRSS> > > meshes;
+
+  Box box(5, 10, 40);
+  Sphere sphere(7);
+  Cone cone(4, 25);
+  Cylinder cylinder(3, 50);
+  geometries.push_back(boost::shared_ptr<CollisionGeometry>(new Box(box)));
+  geometries.push_back(boost::shared_ptr<CollisionGeometry>(new Sphere(sphere)));
+  geometries.push_back(boost::shared_ptr<CollisionGeometry>(new Cone(cone)));
+  geometries.push_back(boost::shared_ptr<CollisionGeometry>(new Cylinder(cylinder)));
+
+  // the same shapes as meshes
+  for(int i = 0; i < 4; ++i)
+    meshes.push_back(boost::shared_ptr<BVHModel<OBBRSS> >(new BVHModel<OBBRSS>()));
+  generateBVHModel(*meshes[0], box, Transform3f());
+  generateBVHModel(*meshes[1], sphere, Transform3f(), 16, 16);
+  generateBVHModel(*meshes[2], cone, Transform3f(), 16, 16);
+  generateBVHModel(*meshes[3], cylinder, Transform3f(), 16, 16);
+
+  // a beam along a diagonal of its local frame, only the mesh BV is aligned with it
+  BVHModel<OBBRSS>* beam = new BVHModel<OBBRSS>();
+  generateBVHModel(*beam, box, Transform3f(Quaternion3f(0.9238795, 0.3826834, 0, 0)));
+  meshes.push_back(boost::shared_ptr<BVHModel<OBBRSS> >(beam));
+
+  // points on each shape; the cone mesh has full rings at every height, so the cone uses its apex and base
+  std::vector<std::vector<Vec3f> > mesh_points(meshes.size());
+  for(std::size_t i = 0; i < meshes.size(); ++i)
+    mesh_points[i].assign(meshes[i]->vertices, meshes[i]->vertices + meshes[i]->num_vertices);
+  std::vector<std::vector<Vec3f> > shape_points(mesh_points.begin(), mesh_points.begin() + geometries.size());
+  shape_points[2].assign(1, Vec3f(0, 0, 0.5 * cone.lz));
+  for(int i = 0; i < 64; ++i)
+    shape_points[2].push_back(Vec3f(cone.radius * std::cos(i * 0.1), cone.radius * std::sin(i * 0.1), -0.5 * cone.lz));
+
+  FCL_REAL extents[] = {-100, 100, -100, 100, -100, 100};
+  std::vector<Transform3f> transforms;
+  generateRandomTransforms(extents, transforms, 100);
+
+  FCL_REAL tight_volume = 0, sphere_volume = 0;
+  for(std::size_t i = 0; i < meshes.size(); ++i)
+  {
+    std::vector<boost::shared_ptr<CollisionGeometry> > objects;
+    std::vector<const std::vector<Vec3f>*> object_points;
+    objects.push_back(meshes[i]);
+    object_points.push_back(&mesh_points[i]);
+    if(i < geometries.size())
+    {
+      objects.push_back(geometries[i]);
+      object_points.push_back(&shape_points[i]);
+    }
+
+    for(std::size_t j = 0; j < objects.size(); ++j)
+    {
+      CollisionObject obj(objects[j]);
+      for(std::size_t k = 0; k < transforms.size(); ++k)
+      {
+        obj.setTransform(transforms[k]);
+        obj.useTightAABB(false);
+        obj.computeAABB();
+        AABB sphere_aabb = obj.getAABB();
+        obj.useTightAABB(true);
+        obj.computeAABB();
+        AABB tight_aabb = obj.getAABB();
+
+        for(int l = 0; l < 3; ++l)
+        {
+          BOOST_CHECK(tight_aabb.min_[l] >= sphere_aabb.min_[l] - 1e-8);
+          BOOST_CHECK(tight_aabb.max_[l] <= sphere_aabb.max_[l] + 1e-8);
+        }
+
+        AABB inflated(tight_aabb.min_ - Vec3f(1e-8, 1e-8, 1e-8), tight_aabb.max_ + Vec3f(1e-8, 1e-8, 1e-8));
+        const std::vector<Vec3f>& check_points = *object_points[j];
+        for(std::size_t v = 0; v < check_points.size(); ++v)
+          BOOST_CHECK(inflated.contain(transforms[k].transform(check_points[v])));
+
+        tight_volume += tight_aabb.volume();
+        sphere_volume += sphere_aabb.volume();
+      }
+    }
+  }
+
+  BOOST_CHECK(tight_volume < 0.5 * sphere_volume);
+}
+
+/// check that bulk pose updates give the same AABBs and collisions as setting the poses one by one
+BOOST_AUTO_TEST_CASE(test_update_poses)
+{
+  std::vector<boost::shared_ptr<CollisionGeometry> > geometries;
+  Box box(5, 10, 20);
+  Cylinder cylinder(10, 40);
+  geometries.push_back(boost::shared_ptr<CollisionGeometry>(new Box(box)));
+  geometries.push_back(boost::shared_ptr<CollisionGeometry>(new Sphere(30)));
+  geometries.push_back(boost::shared_ptr<CollisionGeometry>(new Cylinder(cylinder)));
+  BVHModel<AABB>* box_mesh = new BVHModel<AABB>();
+  generateBVHModel(*box_mesh, box, Transform3f());
+  geometries.push_back(boost::shared_ptr<CollisionGeometry>(box_mesh));
+  BVHModel<AABB>* cylinder_mesh = new BVHModel<AABB>();
+  generateBVHModel(*cylinder_mesh, cylinder, Transform3f(), 16, 16);
+  geometries.push_back(boost::shared_ptr<CollisionGeometry>(cylinder_mesh));
+
+  std::size_t n = 300;
+  FCL_REAL extents[] = {-200, 200, -200, 200, -200, 200};
+  std::vector<Transform3f> transforms;
+  generateRandomTransforms(extents, transforms, n);
+
+  std::vector<Quaternion3f> rotations(n);
+  std::vector<Matrix3f> matrices(n);
+  std::vector<Vec3f> translations(n);
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    // some objects are only translated
+    if(i % 7 != 0)
+      rotations[i] = transforms[i].getQuatRotation();
+    translations[i] = transforms[i].getTranslation();
+    matrices[i] = Transform3f(rotations[i], translations[i]).getRotation();
+  }
+
+  // objects moved one by one, in a naive manager
+  std::vector<CollisionObject*> ref_env;
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    ref_env.push_back(new CollisionObject(geometries[i % geometries.size()]));
+    ref_env.back()->useTightAABB(i % 3 != 0);
+  }
+  NaiveCollisionManager ref_manager;
+  ref_manager.registerObjects(ref_env);
+  ref_manager.setup();
+
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    ref_env[i]->setTransform(Transform3f(rotations[i], translations[i]));
+    ref_env[i]->computeAABB();
+  }
+  ref_manager.update();
+
+  CollisionData ref_data;
+  ref_data.request.num_max_contacts = 100000;
+  ref_manager.collide(&ref_data, defaultCollisionFunction);
+  BOOST_CHECK(ref_data.result.numContacts() > 0);
+
+  std::vector<BroadPhaseCollisionManager*> managers;
+  managers.push_back(new NaiveCollisionManager());
+  managers.push_back(new SSaPCollisionManager());
+  managers.push_back(new SaPCollisionManager());
+  managers.push_back(new IntervalTreeCollisionManager());
+  managers.push_back(new DynamicAABBTreeCollisionManager());
+  managers.push_back(new DynamicAABBTreeCollisionManager_Array());
+
+  for(std::size_t m = 0; m < managers.size(); ++m)
+  {
+    std::vector<CollisionObject*> env;
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      env.push_back(new CollisionObject(geometries[i % geometries.size()]));
+      env.back()->useTightAABB(i % 3 != 0);
+    }
+    managers[m]->registerObjects(env);
+    managers[m]->setup();
+
+    managers[m]->updatePoses(&env[0], &rotations[0], &translations[0], n);
+
+    // the AABBs agree up to rounding: with FMA contraction, the inlined extents may round differently
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      BOOST_CHECK(env[i]->getAABB().min_.equal(ref_env[i]->getAABB().min_, 1e-8));
+      BOOST_CHECK(env[i]->getAABB().max_.equal(ref_env[i]->getAABB().max_, 1e-8));
+      for(int j = 0; j < 3; ++j)
+        BOOST_CHECK(env[i]->getTransform().getRotation().getRow(j).equal(ref_env[i]->getTransform().getRotation().getRow(j), 1e-15));
+    }
+
+    CollisionData data;
+    data.request.num_max_contacts = 100000;
+    managers[m]->collide(&data, defaultCollisionFunction);
+    BOOST_CHECK(data.result.numContacts() == ref_data.result.numContacts());
+
+    // the same poses again change nothing, the poses as matrices give the same AABBs
+    std::vector<CollisionObject*> changed_objs;
+    BOOST_CHECK(setPoses(&env[0], &rotations[0], &translations[0], n, changed_objs) == 0);
+    BOOST_CHECK(changed_objs.empty());
+    setPoses(&env[0], &matrices[0], &translations[0], n, changed_objs);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      BOOST_CHECK(env[i]->getAABB().min_.equal(ref_env[i]->getAABB().min_, 1e-8));
+      BOOST_CHECK(env[i]->getAABB().max_.equal(ref_env[i]->getAABB().max_, 1e-8));
+    }
+    setPoses(&env[0], &rotations[0], &translations[0], n, changed_objs);
+    changed_objs.clear();
+
+    // moving a few objects reports only those
+    std::vector<Vec3f> moved = translations;
+    moved[5] += Vec3f(1, 0, 0);
+    moved[100] += Vec3f(0, 0, -1);
+    BOOST_CHECK(setPoses(&env[0], &rotations[0], &moved[0], n, changed_objs) == 2);
+    BOOST_CHECK(changed_objs.size() == 2 && changed_objs[0] == env[5] && changed_objs[1] == env[100]);
+
+    delete managers[m];
+    for(std::size_t i = 0; i < n; ++i)
+      delete env[i];
+  }
+
+  for(std::size_t i = 0; i < n; ++i)
+    delete ref_env[i];
+}
+
 /// check broad phase update, in mesh, only return collision or not
 BOOST_AUTO_TEST_CASE(test_core_mesh_bf_broad_phase_update_collision_mesh_binary)
 {
@@ -223,6 +430,247 @@ BOOST_AUTO_TEST_CASE(test_core_mesh_bf_broad_phase_collision_mesh_exhaustive)
   broad_phase_collision_test(2000, 1000, 1000, 1, true, true);
 }
 
+/// @brief Pairs of objects with overlapping AABBs reported by a broadphase manager
+struct PairData
+{
+  std::set<std::pair<CollisionObject*, CollisionObject*> > pairs;
+};
+
+bool pairCollisionFunction(CollisionObject* o1, CollisionObject* o2, void* cdata)
+{
+  PairData* data = static_cast<PairData*>(cdata);
+  if(o1->getAABB().overlap(o2->getAABB()))
+  {
+    if(o1 < o2) data->pairs.insert(std::make_pair(o1, o2));
+    else data->pairs.insert(std::make_pair(o2, o1));
+  }
+  return false;
+}
+
+/// check that the managers report only the pairs passing the category, mask and disabled pair filter
+BOOST_AUTO_TEST_CASE(test_collision_filter)
+{
+  std::vector<CollisionObject*> env;
+  generateEnvironments(env, 200, 100);
+
+  // four categories; category 0 ignores category 1, and the objects of category 3 only collide with category 2
+  for(std::size_t i = 0; i < env.size(); ++i)
+  {
+    env[i]->setCollisionCategory(1 << (i % 4));
+    if(i % 4 == 0) env[i]->setCollisionMask(~FCL_UINT32(2));
+    if(i % 4 == 3) env[i]->setCollisionMask(4);
+  }
+
+  std::vector<BroadPhaseCollisionManager*> managers;
+  managers.push_back(new NaiveCollisionManager());
+  managers.push_back(new SSaPCollisionManager());
+  managers.push_back(new SaPCollisionManager());
+  managers.push_back(new IntervalTreeCollisionManager());
+  Vec3f lower_limit, upper_limit;
+  SpatialHashingCollisionManager<>::computeBound(env, lower_limit, upper_limit);
+  managers.push_back(new SpatialHashingCollisionManager<>((upper_limit[0] - lower_limit[0]) / 20, lower_limit, upper_limit));
+  managers.push_back(new DynamicAABBTreeCollisionManager());
+  managers.push_back(new DynamicAABBTreeCollisionManager_Array());
+
+  // all the overlapping pairs, then the expected ones
+  PairData all_data;
+  managers[0]->registerObjects(env);
+  managers[0]->setup();
+  managers[0]->collide(&all_data, pairCollisionFunction);
+
+  std::vector<std::pair<CollisionObject*, CollisionObject*> > disabled;
+  std::size_t k = 0;
+  for(std::set<std::pair<CollisionObject*, CollisionObject*> >::const_iterator it = all_data.pairs.begin(); it != all_data.pairs.end(); ++it, ++k)
+  {
+    if(k % 5 == 0) disabled.push_back(*it);
+  }
+
+  PairData expected_data;
+  for(std::set<std::pair<CollisionObject*, CollisionObject*> >::const_iterator it = all_data.pairs.begin(); it != all_data.pairs.end(); ++it)
+  {
+    if(CollisionObject::canCollide(it->first, it->second) && std::find(disabled.begin(), disabled.end(), *it) == disabled.end())
+      expected_data.pairs.insert(*it);
+  }
+  BOOST_CHECK(expected_data.pairs.size() > 0);
+  BOOST_CHECK(expected_data.pairs.size() < all_data.pairs.size());
+
+  CollisionObject* query = env[1];
+  for(std::size_t i = 0; i < managers.size(); ++i)
+  {
+    if(i > 0)
+    {
+      managers[i]->registerObjects(env);
+      managers[i]->setup();
+    }
+    for(std::size_t j = 0; j < disabled.size(); ++j)
+      managers[i]->disablePair(disabled[j].second, disabled[j].first);
+
+    PairData data;
+    managers[i]->collide(&data, pairCollisionFunction);
+    BOOST_CHECK(data.pairs == expected_data.pairs);
+
+    // a single object, against the pairs it makes
+    PairData query_data;
+    managers[i]->collide(query, &query_data, pairCollisionFunction);
+    for(std::set<std::pair<CollisionObject*, CollisionObject*> >::const_iterator it = all_data.pairs.begin(); it != all_data.pairs.end(); ++it)
+    {
+      if(it->first == query || it->second == query)
+        BOOST_CHECK(query_data.pairs.count(*it) == expected_data.pairs.count(*it));
+    }
+
+    // filter bits changed after registration take effect after update
+    FCL_UINT32 mask = query->getCollisionMask();
+    query->setCollisionMask(0);
+    managers[i]->update(query);
+    PairData masked_data;
+    managers[i]->collide(&masked_data, pairCollisionFunction);
+    for(std::set<std::pair<CollisionObject*, CollisionObject*> >::const_iterator it = masked_data.pairs.begin(); it != masked_data.pairs.end(); ++it)
+      BOOST_CHECK(it->first != query && it->second != query);
+    query->setCollisionMask(mask);
+    managers[i]->update(query);
+
+    managers[i]->clearDisabledPairs();
+    PairData enabled_data;
+    managers[i]->collide(&enabled_data, pairCollisionFunction);
+    BOOST_CHECK(enabled_data.pairs.size() >= expected_data.pairs.size());
+    for(std::size_t j = 0; j < disabled.size(); ++j)
+    {
+      if(CollisionObject::canCollide(disabled[j].first, disabled[j].second))
+        BOOST_CHECK(enabled_data.pairs.count(disabled[j]) == 1);
+    }
+  }
+
+  for(std::size_t i = 0; i < managers.size(); ++i)
+    delete managers[i];
+  for(std::size_t i = 0; i < env.size(); ++i)
+    delete env[i];
+}
+
+struct CountingCollisionData
+{
+  CountingCollisionData() : num_calls(0)
+  {
+  }
+
+  CollisionData data;
+  std::size_t num_calls;
+};
+
+bool countingCollisionFunction(CollisionObject* o1, CollisionObject* o2, void* cdata)
+{
+  CountingCollisionData* counting_data = static_cast<CountingCollisionData*>(cdata);
+  counting_data->num_calls++;
+  return defaultCollisionFunction(o1, o2, &counting_data->data);
+}
+
+/// check that the managers gather the statistics of the queries made by their callbacks, once each
+BOOST_AUTO_TEST_CASE(test_broadphase_statistics)
+{
+  // a row of spheres, each overlapping its two neighbours only
+  std::vector<CollisionObject*> env;
+  boost::shared_ptr<CollisionGeometry> sphere(new Sphere(1));
+  for(int i = 0; i < 10; ++i)
+    env.push_back(new CollisionObject(sphere, Transform3f(Vec3f(1.5 * i, 0, 0))));
+
+  std::vector<BroadPhaseCollisionManager*> managers;
+  managers.push_back(new NaiveCollisionManager());
+  managers.push_back(new SSaPCollisionManager());
+  managers.push_back(new SaPCollisionManager());
+  managers.push_back(new IntervalTreeCollisionManager());
+  Vec3f lower_limit, upper_limit;
+  SpatialHashingCollisionManager<>::computeBound(env, lower_limit, upper_limit);
+  managers.push_back(new SpatialHashingCollisionManager<>(2, lower_limit, upper_limit));
+  managers.push_back(new DynamicAABBTreeCollisionManager());
+  managers.push_back(new DynamicAABBTreeCollisionManager_Array());
+
+  for(std::size_t i = 0; i < managers.size(); ++i)
+  {
+    managers[i]->registerObjects(env);
+    managers[i]->setup();
+
+    CountingCollisionData disabled_data;
+    disabled_data.data.request.num_max_contacts = 1000;
+    managers[i]->collide(&disabled_data, countingCollisionFunction);
+    BOOST_CHECK(managers[i]->getStatistics().num_queries == 0);
+
+    managers[i]->enableStatistics(true);
+    CountingCollisionData data;
+    data.data.request.num_max_contacts = 1000;
+    managers[i]->collide(&data, countingCollisionFunction);
+    BOOST_CHECK(data.num_calls >= 9);
+    BOOST_CHECK(managers[i]->getStatistics().num_queries == data.num_calls);
+    BOOST_CHECK(managers[i]->getStatistics().num_leaf_tests == data.num_calls);
+    BOOST_CHECK(managers[i]->getStatistics().time >= 0);
+    BOOST_CHECK(data.data.result.statistics.num_queries == 0);
+
+    // queries requesting statistics get their own, and the manager still counts them once, also when it collides with
+    // itself through the call with another manager
+    managers[i]->clearStatistics();
+    CountingCollisionData self_data;
+    self_data.data.request.num_max_contacts = 1000;
+    self_data.data.request.enable_statistics = true;
+    managers[i]->collide(managers[i], &self_data, countingCollisionFunction);
+    BOOST_CHECK(self_data.data.result.statistics.num_queries == self_data.num_calls);
+    BOOST_CHECK(managers[i]->getStatistics().num_queries == self_data.num_calls);
+    BOOST_CHECK(managers[i]->getStatistics().num_leaf_tests == self_data.data.result.statistics.num_leaf_tests);
+  }
+
+  for(std::size_t i = 0; i < managers.size(); ++i)
+    delete managers[i];
+  for(std::size_t i = 0; i < env.size(); ++i)
+    delete env[i];
+}
+
+BOOST_AUTO_TEST_CASE(test_node_pool)
+{
+  NodePool<NodeBase<AABB> > pool(4);
+
+  std::vector<NodeBase<AABB>*> nodes;
+  for(int i = 0; i < 10; ++i)
+    nodes.push_back(pool.allocate());
+  BOOST_CHECK(pool.size() == 10);
+  BOOST_CHECK(reinterpret_cast<std::size_t>(nodes[0]) % NodePool<NodeBase<AABB> >::ALIGNMENT == 0);
+  BOOST_CHECK(nodes[1] == nodes[0] + 1);
+
+  // released nodes are reused before the blocks grow
+  std::size_t capacity = pool.capacity();
+  pool.deallocate(nodes[3]);
+  pool.deallocate(nodes[7]);
+  BOOST_CHECK(pool.size() == 8);
+  NodeBase<AABB>* a = pool.allocate();
+  NodeBase<AABB>* b = pool.allocate();
+  BOOST_CHECK((a == nodes[7] && b == nodes[3]));
+  BOOST_CHECK(pool.capacity() == capacity);
+
+  // the blocks are kept by clear() and filled again in order
+  pool.clear();
+  BOOST_CHECK(pool.size() == 0);
+  BOOST_CHECK(pool.allocate() == nodes[0]);
+  for(std::size_t i = 1; i < capacity; ++i)
+    pool.allocate();
+  BOOST_CHECK(pool.capacity() == capacity);
+
+  // insert and remove churn in a tree built from pooled leaves
+  HierarchyTree<AABB> tree;
+  std::vector<NodeBase<AABB>*> leaves;
+  for(int i = 0; i < 100; ++i)
+    leaves.push_back(tree.createLeaf(AABB(Vec3f(i, 0, 0), Vec3f(i + 1, 1, 1)), NULL));
+  std::vector<NodeBase<AABB>*> tree_leaves(leaves);
+  tree.init(tree_leaves, 2);
+  BOOST_CHECK(tree.size() == 100);
+
+  for(int k = 0; k < 1000; ++k)
+  {
+    std::size_t i = (k * 37) % leaves.size();
+    AABB bv = leaves[i]->bv;
+    tree.remove(leaves[i]);
+    leaves[i] = tree.insert(bv, NULL);
+  }
+  BOOST_CHECK(tree.size() == 100);
+  BOOST_CHECK(tree.getRoot()->bv.equal(AABB(Vec3f(0, 0, 0), Vec3f(100, 1, 1))));
+  BOOST_CHECK(tree.getMaxHeight() < 100);
+}
+
 void generateEnvironments(std::vector<CollisionObject*>& env, double env_scale, std::size_t n)
 {
   FCL_REAL extents[] = {-env_scale, env_scale, -env_scale, env_scale, -env_scale, env_scale};
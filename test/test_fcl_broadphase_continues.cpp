@@ -3,6 +3,7 @@
 
 #include "fcl/broadphase/broadphase.h"
 #include "fcl/broadphase/broadphase_bruteforce_continues.h"
+#include "fcl/broadphase/broadphase_dynamic_AABB_tree_continues.h"
 
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
@@ -398,6 +399,7 @@ public:
 
 		managers_list_.clear();
 		managers_list_.addManager(boost::make_shared<NaiveContinuesCollisionManager>() );
+		managers_list_.addManager(boost::make_shared<DynamicAABBTreeContinuousCollisionManager>() );
 
 		managers_list_.addContinuousCollisionObject(continuous_collision_environment_);
 		managers_list_.addContinuousCollisionObject(continuous_collision_robot_);
@@ -1088,4 +1090,89 @@ BOOST_FIXTURE_TEST_CASE(test_correctnes_third_order_interpolation, ArticularColl
 BOOST_AUTO_TEST_SUITE_END()
 	////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_SUITE(test_broad_phase_dynamic_AABB_tree)
+
+static bool countPair(ContinuousCollisionObject* o1, ContinuousCollisionObject* o2, void* cdata)
+{
+	++*static_cast<int*>(cdata);
+	return false;
+}
+
+static boost::shared_ptr<ContinuousCollisionObject> createMovingSphere(FCL_REAL radius, const Vec3f& start, const Vec3f& end)
+{
+	boost::shared_ptr<CollisionGeometry> sphere(new Sphere(radius) );
+	boost::shared_ptr<MotionBase> motion(new InterpMotion(Transform3f(start), Transform3f(end) ) );
+
+	return boost::make_shared<ContinuousCollisionObject>(sphere, motion);
+}
+
+BOOST_AUTO_TEST_CASE(test_collide_earliest)
+{
+	std::vector<boost::shared_ptr<ContinuousCollisionObject> > objects;
+
+	// two crossing pairs, the second one touches first at t = (5 - 0.8) / 10
+	objects.push_back(createMovingSphere(0.4, Vec3f(0, 0, 0), Vec3f(0, 0, 0) ) );
+	objects.push_back(createMovingSphere(0.4, Vec3f(-10, 0, 0), Vec3f(10, 0, 0) ) );
+	objects.push_back(createMovingSphere(0.4, Vec3f(0, 5, 0), Vec3f(0, 5, 0) ) );
+	objects.push_back(createMovingSphere(0.4, Vec3f(5, 5, 0), Vec3f(-5, 5, 0) ) );
+
+	// slowly moving spheres far from each other
+	for(int i = 0; i < 8; ++i)
+	{
+		for(int j = 0; j < 8; ++j)
+		{
+			Vec3f p(3.0 * i - 10, 3.0 * j - 10, 20);
+			objects.push_back(createMovingSphere(0.4, p, p + Vec3f(1, 0, 0) ) );
+		}
+	}
+
+	std::vector<ContinuousCollisionObject*> objs;
+	for(std::size_t i = 0; i < objects.size(); ++i)
+		objs.push_back(objects[i].get() );
+
+	DynamicAABBTreeContinuousCollisionManager manager;
+	manager.registerObjects(objs);
+	manager.setup();
+
+	NaiveContinuesCollisionManager naive_manager;
+	naive_manager.registerObjects(objs);
+	naive_manager.setup();
+
+	int num_pairs = 0, naive_num_pairs = 0;
+	manager.collide(&num_pairs, countPair);
+	naive_manager.collide(&naive_num_pairs, countPair);
+	BOOST_CHECK_EQUAL(num_pairs, naive_num_pairs);
+
+	ContinuousCollisionRequest request;
+
+	for(int num_threads = 1; num_threads <= 4; num_threads += 3)
+	{
+		manager.num_threads = num_threads;
+
+		ContinuousCollisionResult result;
+		ContinuousCollisionObject* o1 = NULL;
+		ContinuousCollisionObject* o2 = NULL;
+
+		BOOST_CHECK_EQUAL(1, manager.collideEarliest(request, result, o1, o2) );
+		BOOST_CHECK_CLOSE(0.42, result.getTimeOfContact(), 0.01);
+		BOOST_CHECK(result.getTimeOfContact() <= 0.42 + 1e-9);
+		BOOST_CHECK( (o1 == objs[2] && o2 == objs[3]) || (o1 == objs[3] && o2 == objs[2]) );
+	}
+
+	// without the second pair the first one is the earliest
+	manager.unregisterObject(objs[3]);
+
+	ContinuousCollisionResult result;
+	ContinuousCollisionObject* o1 = NULL;
+	ContinuousCollisionObject* o2 = NULL;
+	BOOST_CHECK_EQUAL(1, manager.collideEarliest(request, result, o1, o2) );
+	BOOST_CHECK_CLOSE(0.46, result.getTimeOfContact(), 0.01);
+
+	manager.unregisterObject(objs[1]);
+	BOOST_CHECK_EQUAL(0, manager.collideEarliest(request, result, o1, o2) );
+	BOOST_CHECK(o1 == NULL && o2 == NULL);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 }
\ No newline at end of file
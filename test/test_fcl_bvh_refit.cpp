@@ -0,0 +1,233 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define BOOST_TEST_MODULE "FCL_BVH_REFIT"
+#include <boost/test/unit_test.hpp>
+
+#include "fcl/BVH/BVH_model.h"
+#include "fcl/collision.h"
+#include <cmath>
+
+using namespace fcl;
+
+/// @brief A square sheet of n x n vertices, like a piece of cloth
+static void generateSheet(int n, std::vector<Vec3f>& points, std::vector<Triangle>& triangles)
+{
+  points.clear();
+  triangles.clear();
+  for(int i = 0; i < n; ++i)
+    for(int j = 0; j < n; ++j)
+      points.push_back(Vec3f(i, j, 0) * (1.0 / n));
+
+  for(int i = 0; i + 1 < n; ++i)
+  {
+    for(int j = 0; j + 1 < n; ++j)
+    {
+      triangles.push_back(Triangle(i * n + j, (i + 1) * n + j, i * n + j + 1));
+      triangles.push_back(Triangle((i + 1) * n + j, (i + 1) * n + j + 1, i * n + j + 1));
+    }
+  }
+}
+
+template<typename BV>
+static void buildSheet(BVHModel<BV>& model, int n)
+{
+  std::vector<Vec3f> points;
+  std::vector<Triangle> triangles;
+  generateSheet(n, points, triangles);
+  model.beginModel();
+  model.addSubModel(points, triangles);
+  model.endModel();
+}
+
+/// @brief Check that every node has the BV a full bottom-up refit would compute
+template<typename BV>
+static void checkRefit(const BVHModel<BV>& model)
+{
+  int errors = 0;
+  for(int i = model.getNumBVs() - 1; i >= 0; --i)
+  {
+    const BVNode<BV>& node = model.getBV(i);
+    BV bv;
+    if(node.isLeaf())
+    {
+      const Triangle& t = model.tri_indices[node.primitiveId()];
+      Vec3f v[6];
+      for(int j = 0; j < 3; ++j)
+      {
+        v[j] = model.vertices[t[j]];
+        v[j + 3] = model.prev_vertices ? model.prev_vertices[t[j]] : model.vertices[t[j]];
+      }
+      fit(v, model.prev_vertices ? 6 : 3, bv);
+    }
+    else
+      bv = model.getBV(node.leftChild()).bv + model.getBV(node.rightChild()).bv;
+
+    if(!node.bv.center().equal(bv.center(), 1e-12) || std::abs(node.bv.size() - bv.size()) > 1e-12)
+      errors++;
+  }
+
+  BOOST_CHECK_EQUAL(errors, 0);
+}
+
+BOOST_AUTO_TEST_CASE(selective_refit)
+{
+  int n = 40;
+  BVHModel<AABB> model;
+  buildSheet(model, n);
+  std::vector<Vec3f> points(model.vertices, model.vertices + model.num_vertices);
+
+  // a small patch of the sheet is lifted and released over several frames, the rest does not move
+  for(int frame = 0; frame < 6; ++frame)
+  {
+    FCL_REAL height = (frame % 3) * 0.1;
+    model.beginUpdateModel();
+    for(int i = 0; i < model.num_vertices; ++i)
+    {
+      Vec3f p = points[i];
+      int x = i / n, y = i % n;
+      if(x >= 10 && x < 14 && y >= 20 && y < 25)
+        p[2] = height * (1 + frame);
+      model.updateVertex(p);
+    }
+    model.endUpdateModel();
+    checkRefit(model);
+  }
+
+  // replacing refits selectively as well
+  BVHModel<AABB> replaced;
+  buildSheet(replaced, n);
+  replaced.beginReplaceModel();
+  for(int i = 0; i < replaced.num_vertices; ++i)
+    replaced.replaceVertex((i == n + 1) ? points[i] + Vec3f(0, 0, 1) : points[i]);
+  replaced.endReplaceModel();
+  checkRefit(replaced);
+  BOOST_CHECK_EQUAL(replaced.getBV(0).bv.max_[2], 1);
+
+  replaced.beginReplaceModel();
+  for(int i = 0; i < replaced.num_vertices; ++i)
+    replaced.replaceVertex(points[i]);
+  replaced.endReplaceModel();
+  checkRefit(replaced);
+  BOOST_CHECK_EQUAL(replaced.getBV(0).bv.max_[2], 0);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_refit)
+{
+  int n = 160;
+  BVHModel<OBBRSS> model;
+  model.refit_num_threads = 4;
+  buildSheet(model, n);
+
+  for(int frame = 1; frame < 4; ++frame)
+  {
+    model.beginUpdateModel();
+    for(int i = 0; i < model.num_vertices; ++i)
+    {
+      Vec3f p = model.prev_vertices[i];
+      p[2] = 0.05 * std::sin(frame + p[0] * 10) * std::cos(p[1] * 7);
+      model.updateVertex(p);
+    }
+    model.endUpdateModel();
+  }
+
+  // compare with the serial refit of the same motion
+  BVHModel<OBBRSS> serial(model);
+  serial.refit_num_threads = 1;
+  std::vector<Vec3f> current(model.vertices, model.vertices + model.num_vertices);
+  for(int i = 0; i < model.num_vertices; ++i)
+    current[i][2] += 0.01 * i / model.num_vertices;
+
+  model.beginUpdateModel();
+  model.updateSubModel(current);
+  model.endUpdateModel();
+  serial.beginUpdateModel();
+  serial.updateSubModel(current);
+  serial.endUpdateModel();
+
+  BOOST_REQUIRE_EQUAL(model.getNumBVs(), serial.getNumBVs());
+  int errors = 0;
+  for(int i = 0; i < model.getNumBVs(); ++i)
+  {
+    const OBBRSS& a = static_cast<const BVHModel<OBBRSS>&>(model).getBV(i).bv;
+    const OBBRSS& b = static_cast<const BVHModel<OBBRSS>&>(serial).getBV(i).bv;
+    if(!a.center().equal(b.center(), 1e-12) || a.size() != b.size())
+      errors++;
+  }
+  BOOST_CHECK_EQUAL(errors, 0);
+}
+
+BOOST_AUTO_TEST_CASE(rebuild_on_degradation)
+{
+  int n = 30;
+  BVHModel<AABB> model, degraded;
+  model.rebuild_threshold = 1.5;
+  degraded.rebuild_threshold = 1e6; // only track the cost
+  buildSheet(model, n);
+  buildSheet(degraded, n);
+  BOOST_CHECK_CLOSE(model.getRelativeTreeCost(), 1, 1e-8);
+
+  // mirror every other row of the sheet, which stretches the subtrees built for the flat sheet across all of it
+  std::vector<Vec3f> folded(model.vertices, model.vertices + model.num_vertices);
+  for(std::size_t i = 0; i < folded.size(); ++i)
+  {
+    if((i % n) % 2)
+      folded[i][0] = 1 - folded[i][0];
+  }
+
+  model.beginReplaceModel();
+  model.replaceSubModel(folded);
+  model.endReplaceModel();
+  degraded.beginReplaceModel();
+  degraded.replaceSubModel(folded);
+  degraded.endReplaceModel();
+
+  BOOST_CHECK(model.getRelativeTreeCost() <= model.rebuild_threshold);
+  BOOST_CHECK(degraded.getRelativeTreeCost() > model.rebuild_threshold);
+  checkRefit(model);
+
+  // both hierarchies find the same contacts
+  BVHModel<AABB> probe;
+  buildSheet(probe, 8);
+  CollisionRequest request(100000, true);
+  for(int i = 0; i < 5; ++i)
+  {
+    Transform3f tf(Quaternion3f(std::cos(0.3 * i), std::sin(0.3 * i), 0, 0), Vec3f(0.1 * i, 0.2, 0));
+    CollisionResult result1, result2;
+    collide(&model, Transform3f(), &probe, tf, request, result1);
+    collide(&degraded, Transform3f(), &probe, tf, request, result2);
+    BOOST_CHECK_EQUAL(result1.numContacts(), result2.numContacts());
+  }
+}
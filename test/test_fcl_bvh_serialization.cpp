@@ -0,0 +1,223 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define BOOST_TEST_MODULE "FCL_BVH_SERIALIZATION"
+#include <boost/test/unit_test.hpp>
+
+#include "fcl/BVH/BVH_serialization.h"
+#include "fcl/shape/geometric_shape_to_BVH_model.h"
+#include "fcl/collision.h"
+#include "fcl/distance.h"
+#include <fstream>
+#include <cstdio>
+
+using namespace fcl;
+
+static const char* FILE_NAME = "test_fcl_bvh_serialization.bvh";
+static const char* OTHER_FILE_NAME = "test_fcl_bvh_serialization_other.bvh";
+
+template<typename BV>
+static void checkSameModel(const BVHModel<BV>& model, const BVHModel<BV>& loaded)
+{
+  BOOST_REQUIRE_EQUAL(loaded.num_vertices, model.num_vertices);
+  BOOST_REQUIRE_EQUAL(loaded.num_tris, model.num_tris);
+  BOOST_REQUIRE_EQUAL(loaded.getNumBVs(), model.getNumBVs());
+  BOOST_CHECK_EQUAL(loaded.build_state, BVH_BUILD_STATE_PROCESSED);
+  BOOST_CHECK(loaded.aabb_local.equal(model.aabb_local));
+
+  for(int i = 0; i < model.num_vertices; ++i)
+    BOOST_CHECK(loaded.vertices[i].equal(model.vertices[i], 1e-12));
+  for(int i = 0; i < model.num_tris; ++i)
+    for(int j = 0; j < 3; ++j)
+      BOOST_CHECK_EQUAL(loaded.tri_indices[i][j], model.tri_indices[i][j]);
+  for(int i = 0; i < model.getNumBVs(); ++i)
+  {
+    BOOST_CHECK_EQUAL(loaded.getBV(i).first_child, model.getBV(i).first_child);
+    BOOST_CHECK(loaded.getBV(i).getCenter().equal(model.getBV(i).getCenter(), 1e-12));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(save_and_load)
+{
+  BVHModel<OBBRSS> model;
+  generateBVHModel(model, Sphere(1), Transform3f(), 16, 16);
+  BOOST_REQUIRE_EQUAL(saveBVHModel(model, FILE_NAME), BVH_OK);
+
+  BVHModel<OBBRSS> loaded;
+  BOOST_REQUIRE_EQUAL(loadBVHModel(FILE_NAME, loaded), BVH_OK);
+  checkSameModel(model, loaded);
+
+  // a loaded model can be loaded again and copied
+  BOOST_REQUIRE_EQUAL(loadBVHModel(FILE_NAME, loaded), BVH_OK);
+  BVHModel<OBBRSS> copy(loaded);
+  checkSameModel(model, copy);
+
+  BVHModel<AABB> model_aabb;
+  generateBVHModel(model_aabb, Box(1, 2, 3), Transform3f());
+  BOOST_REQUIRE_EQUAL(saveBVHModel(model_aabb, OTHER_FILE_NAME), BVH_OK);
+  BVHModel<AABB> loaded_aabb;
+  BOOST_REQUIRE_EQUAL(loadBVHModel(OTHER_FILE_NAME, loaded_aabb), BVH_OK);
+  checkSameModel(model_aabb, loaded_aabb);
+
+  std::remove(FILE_NAME);
+  std::remove(OTHER_FILE_NAME);
+}
+
+BOOST_AUTO_TEST_CASE(load_errors)
+{
+  BVHModel<OBBRSS> unfinished;
+  unfinished.beginModel();
+  BOOST_CHECK_EQUAL(saveBVHModel(unfinished, FILE_NAME), BVH_ERR_BUILD_EMPTY_MODEL);
+
+  BVHModel<OBBRSS> loaded;
+  BOOST_CHECK_EQUAL(loadBVHModel("no_such_file.bvh", loaded), BVH_ERR_FILE_IO);
+
+  BVHModel<OBBRSS> model;
+  generateBVHModel(model, Box(1, 1, 1), Transform3f());
+  BOOST_REQUIRE_EQUAL(saveBVHModel(model, FILE_NAME), BVH_OK);
+
+  // another BV type
+  BVHModel<RSS> loaded_rss;
+  BOOST_CHECK_EQUAL(loadBVHModel(FILE_NAME, loaded_rss), BVH_ERR_INCORRECT_DATA);
+
+  // a truncated file
+  std::ifstream in(FILE_NAME, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream out(FILE_NAME, std::ios::binary | std::ios::trunc);
+  out.write(content.data(), content.size() - 8);
+  out.close();
+  BOOST_CHECK_EQUAL(loadBVHModel(FILE_NAME, loaded), BVH_ERR_INCORRECT_DATA);
+  BOOST_CHECK_EQUAL(loaded.build_state, BVH_BUILD_STATE_EMPTY);
+
+  std::remove(FILE_NAME);
+}
+
+BOOST_AUTO_TEST_CASE(loaded_collision_and_update)
+{
+  BVHModel<OBBRSS> model1, model2;
+  generateBVHModel(model1, Box(2, 1, 1), Transform3f());
+  generateBVHModel(model2, Sphere(0.7), Transform3f(), 12, 12);
+  BOOST_REQUIRE_EQUAL(saveBVHModel(model2, FILE_NAME), BVH_OK);
+
+  BVHModel<OBBRSS> loaded;
+  BOOST_REQUIRE_EQUAL(loadBVHModel(FILE_NAME, loaded), BVH_OK);
+  std::remove(FILE_NAME);
+
+  CollisionRequest request(100, true);
+  for(int i = 0; i < 20; ++i)
+  {
+    Transform3f tf(Vec3f(0.15 * i - 1.5, 0.3, -0.2));
+
+    CollisionResult result, loaded_result;
+    collide(&model1, Transform3f(), &model2, tf, request, result);
+    collide(&model1, Transform3f(), &loaded, tf, request, loaded_result);
+    BOOST_CHECK_EQUAL(result.numContacts(), loaded_result.numContacts());
+
+    DistanceResult distance_result, loaded_distance_result;
+    distance(&model1, Transform3f(), &model2, tf, DistanceRequest(), distance_result);
+    distance(&model1, Transform3f(), &loaded, tf, DistanceRequest(), loaded_distance_result);
+    BOOST_CHECK_EQUAL(distance_result.min_distance, loaded_distance_result.min_distance);
+  }
+
+  // updating copies the mapped arrays first
+  std::vector<Vec3f> moved(loaded.vertices, loaded.vertices + loaded.num_vertices);
+  for(std::size_t i = 0; i < moved.size(); ++i)
+    moved[i] += Vec3f(5, 0, 0);
+
+  BOOST_REQUIRE_EQUAL(loaded.beginUpdateModel(), BVH_OK);
+  loaded.updateSubModel(moved);
+  BOOST_REQUIRE_EQUAL(loaded.endUpdateModel(), BVH_OK);
+  BOOST_CHECK(loaded.vertices[0].equal(moved[0], 1e-12));
+
+  CollisionResult result;
+  collide(&model1, Transform3f(), &loaded, Transform3f(Vec3f(-5, 0, 0)), request, result);
+  BOOST_CHECK(result.numContacts() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(copies_share_storage)
+{
+  BVHModel<OBBRSS> model;
+  model.use_triangle_cache = true;
+  generateBVHModel(model, Sphere(1), Transform3f(), 16, 16);
+
+  std::vector<BVHModel<OBBRSS>*> copies;
+  for(int i = 0; i < 10; ++i)
+    copies.push_back(new BVHModel<OBBRSS>(model));
+
+  for(std::size_t i = 0; i < copies.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(copies[i]->vertices, model.vertices);
+    BOOST_CHECK_EQUAL(copies[i]->tri_indices, model.tri_indices);
+    const BVHModel<OBBRSS>& shared = *copies[i];
+    const BVHModel<OBBRSS>& original = model;
+    BOOST_CHECK_EQUAL(&shared.getBV(0), &original.getBV(0));
+    BOOST_CHECK_EQUAL(copies[i]->triangle_cache.normal_x(), model.triangle_cache.normal_x());
+  }
+
+  // the copy stops sharing when it is modified
+  BVHModel<OBBRSS>* copy = copies.back();
+  copies.pop_back();
+  std::vector<Vec3f> moved(copy->vertices, copy->vertices + copy->num_vertices);
+  for(std::size_t i = 0; i < moved.size(); ++i)
+    moved[i] += Vec3f(5, 0, 0);
+
+  BOOST_REQUIRE_EQUAL(copy->beginUpdateModel(), BVH_OK);
+  copy->updateSubModel(moved);
+  BOOST_REQUIRE_EQUAL(copy->endUpdateModel(), BVH_OK);
+
+  BOOST_CHECK(copy->vertices != model.vertices);
+  BOOST_CHECK(copy->triangle_cache.normal_x() != model.triangle_cache.normal_x());
+  BOOST_CHECK(copy->vertices[0].equal(moved[0], 1e-12));
+  BOOST_CHECK(!model.vertices[0].equal(moved[0], 1e-12));
+  BOOST_CHECK(copies[0]->vertices[0].equal(model.vertices[0], 1e-12));
+
+  CollisionRequest request(100, true);
+  CollisionResult result;
+  collide(copy, Transform3f(Vec3f(-5, 0, 0)), &model, Transform3f(), request, result);
+  BOOST_CHECK(result.numContacts() > 0);
+
+  // the last user of the arrays takes them back without copying
+  for(std::size_t i = 0; i < copies.size(); ++i)
+    delete copies[i];
+  const Vec3f* vertices = model.vertices;
+  BOOST_REQUIRE_EQUAL(model.beginReplaceModel(), BVH_OK);
+  BOOST_CHECK(model.vertices == vertices);
+  for(int i = 0; i < model.num_vertices; ++i)
+    model.replaceVertex(model.vertices[i]);
+  BOOST_REQUIRE_EQUAL(model.endReplaceModel(), BVH_OK);
+
+  delete copy;
+}
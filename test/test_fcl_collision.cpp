@@ -41,9 +41,12 @@
 #include "fcl/traversal/traversal_node_setup.h"
 #include "fcl/collision_node.h"
 #include "fcl/collision.h"
+#include "fcl/distance.h"
 #include "fcl/BV/BV.h"
 #include "fcl/shape/geometric_shapes.h"
 #include "fcl/narrowphase/narrowphase.h"
+#include "fcl/shape/geometric_shape_to_BVH_model.h"
+#include "fcl/probe.h"
 #include "test_fcl_utility.h"
 #include "fcl_resources/config.h"
 #include <boost/filesystem.hpp>
@@ -802,6 +805,200 @@ BOOST_AUTO_TEST_CASE(mesh_mesh)
 }
 
 
+BOOST_AUTO_TEST_CASE(triangle_plane_test)
+{
+  FCL_REAL extents[] = {-1, -1, -1, 1, 1, 1};
+  std::size_t n = 10000;
+
+  std::vector<Transform3f> transforms;
+  generateRandomTransforms(extents, transforms, 6 * n);
+
+  std::vector<Vec3f> vertices(6);
+  std::vector<Triangle> triangles(2);
+  triangles[0].set(0, 1, 2);
+  triangles[1].set(3, 4, 5);
+
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    for(int j = 0; j < 6; ++j)
+      vertices[j] = transforms[6 * i + j].getTranslation();
+
+    TriangleCache cache;
+    cache.build(&vertices[0], &triangles[0], 2);
+    if(!cache.valid(0) || !cache.valid(1)) continue;
+
+    bool expected = Intersect::intersect_Triangle(vertices[0], vertices[1], vertices[2], vertices[3], vertices[4], vertices[5]);
+    bool result = Intersect::intersect_Triangle(vertices[0], vertices[1], vertices[2], cache.normal(0), cache.offset(0),
+                                                vertices[3], vertices[4], vertices[5], cache.normal(1), cache.offset(1));
+    BOOST_CHECK(expected == result);
+
+    // the same pair with the second triangle given in another frame
+    const Transform3f& tf = transforms[6 * i];
+    Vec3f Q[3];
+    for(int j = 0; j < 3; ++j)
+      Q[j] = tf.getRotation().transposeTimes(vertices[3 + j] - tf.getTranslation());
+    Vec3f n2 = tf.getRotation().transposeTimes(cache.normal(1));
+    FCL_REAL t2 = n2.dot(Q[0]);
+    result = Intersect::intersect_Triangle(vertices[0], vertices[1], vertices[2], cache.normal(0), cache.offset(0),
+                                           Q[0], Q[1], Q[2], n2, t2, tf.getRotation(), tf.getTranslation());
+    BOOST_CHECK(expected == result);
+  }
+
+  // coplanar triangles
+  Vec3f n1(0, 0, 1);
+  BOOST_CHECK(Intersect::intersect_Triangle(Vec3f(0, 0, 0), Vec3f(1, 0, 0), Vec3f(0, 1, 0), n1, 0,
+                                            Vec3f(0.2, 0.2, 0), Vec3f(2, 0.2, 0), Vec3f(0.2, 2, 0), n1, 0));
+  BOOST_CHECK(!Intersect::intersect_Triangle(Vec3f(0, 0, 0), Vec3f(1, 0, 0), Vec3f(0, 1, 0), n1, 0,
+                                             Vec3f(1, 1, 0), Vec3f(2, 1, 0), Vec3f(1, 2, 0), n1, 0));
+}
+
+template<typename BV>
+static void collideWithTriangleCache(const Transform3f& tf,
+                                     const std::vector<Vec3f>& vertices1, const std::vector<Triangle>& triangles1,
+                                     const std::vector<Vec3f>& vertices2, const std::vector<Triangle>& triangles2)
+{
+  BVHModel<BV> m1, m2, m1_cached, m2_cached;
+  m1_cached.use_triangle_cache = true;
+  m2_cached.use_triangle_cache = true;
+
+  m1.beginModel(); m1.addSubModel(vertices1, triangles1); m1.endModel();
+  m2.beginModel(); m2.addSubModel(vertices2, triangles2); m2.endModel();
+  m1_cached.beginModel(); m1_cached.addSubModel(vertices1, triangles1); m1_cached.endModel();
+  m2_cached.beginModel(); m2_cached.addSubModel(vertices2, triangles2); m2_cached.endModel();
+
+  BOOST_CHECK(m1.triangle_cache.empty());
+  BOOST_CHECK_EQUAL(m1_cached.triangle_cache.size(), m1_cached.num_tris);
+
+  for(int k = 0; k < 2; ++k)
+  {
+    CollisionRequest request(num_max_contacts, k == 1);
+    CollisionResult result, cached_result;
+    collide(&m1, Transform3f(), &m2, tf, request, result);
+    collide(&m1_cached, Transform3f(), &m2_cached, tf, request, cached_result);
+
+    BOOST_CHECK_EQUAL(result.numContacts(), cached_result.numContacts());
+    for(std::size_t j = 0; j < std::min(result.numContacts(), cached_result.numContacts()); ++j)
+    {
+      BOOST_CHECK(result.getContact(j).b1 == cached_result.getContact(j).b1);
+      BOOST_CHECK(result.getContact(j).b2 == cached_result.getContact(j).b2);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(mesh_mesh_triangle_cache)
+{
+  std::vector<Vec3f> p1, p2;
+  std::vector<Triangle> t1, t2;
+  boost::filesystem::path path(TEST_RESOURCES_DIR);
+
+  loadOBJFile((path / "env.obj").string().c_str(), p1, t1);
+  loadOBJFile((path / "rob.obj").string().c_str(), p2, t2);
+
+  std::vector<Transform3f> transforms;
+  FCL_REAL extents[] = {-3000, -3000, 0, 3000, 3000, 3000};
+  std::size_t n = 10;
+
+  generateRandomTransforms(extents, transforms, n);
+
+  for(std::size_t i = 0; i < transforms.size(); ++i)
+  {
+    collideWithTriangleCache<AABB>(transforms[i], p1, t1, p2, t2);
+    collideWithTriangleCache<OBBRSS>(transforms[i], p1, t1, p2, t2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(probe_counts)
+{
+  tools::ProbeTotals before, after;
+  tools::snapshotProbes(before);
+
+  Box box(1, 1, 1);
+  BVHModel<OBBRSS> m1, m2;
+  generateBVHModel(m1, box, Transform3f());
+  generateBVHModel(m2, box, Transform3f());
+
+  CollisionRequest request(1, true);
+  CollisionResult result;
+  collide(&m1, Transform3f(), &m2, Transform3f(Vec3f(0.5, 0, 0)), request, result);
+  BOOST_CHECK(result.isCollision());
+
+  Cylinder c1(1, 2), c2(1, 2);
+  GJKSolver_indep solver;
+  result.clear();
+  collide(&c1, Transform3f(), &c2, Transform3f(Vec3f(1, 0.2, 0)), &solver, request, result);
+  BOOST_CHECK(result.isCollision());
+
+  tools::snapshotProbes(after);
+  tools::ProbeTotals diff = after.since(before);
+
+  if(tools::probesEnabled())
+  {
+    BOOST_CHECK(diff.count[tools::PROBE_COLLIDE] == 2);
+    BOOST_CHECK(diff.count[tools::PROBE_BV_TEST] > 0);
+    BOOST_CHECK(diff.count[tools::PROBE_LEAF_TEST] > 0);
+    BOOST_CHECK(diff.count[tools::PROBE_GJK_ITERATION] > 0);
+    BOOST_CHECK(diff.count[tools::PROBE_EPA_ITERATION] > 0);
+    BOOST_CHECK(diff.count[tools::PROBE_BROADPHASE_COLLIDE] == 0);
+    BOOST_CHECK(diff.seconds(tools::PROBE_COLLIDE) >= 0);
+  }
+  else
+  {
+    for(int i = 0; i < tools::NUM_PROBES; ++i)
+      BOOST_CHECK(after.count[i] == 0 && after.ticks[i] == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(query_statistics)
+{
+  Box box(1, 1, 1);
+  BVHModel<OBBRSS> m1, m2;
+  generateBVHModel(m1, box, Transform3f());
+  generateBVHModel(m2, box, Transform3f());
+
+  CollisionRequest request(1000, true);
+  CollisionResult result;
+  collide(&m1, Transform3f(), &m2, Transform3f(Vec3f(0.5, 0, 0)), request, result);
+  BOOST_CHECK(result.isCollision());
+  BOOST_CHECK(result.statistics.num_queries == 0);
+  BOOST_CHECK(result.statistics.num_bv_tests == 0);
+
+  request.enable_statistics = true;
+  result.clear();
+  collide(&m1, Transform3f(), &m2, Transform3f(Vec3f(0.5, 0, 0)), request, result);
+  BOOST_CHECK(result.statistics.num_queries == 1);
+  BOOST_CHECK(result.statistics.num_bv_tests > 0);
+  BOOST_CHECK(result.statistics.num_leaf_tests > 0);
+  BOOST_CHECK(result.statistics.time >= 0);
+
+  // the statistics accumulate until the result is cleared. The contacts never reach the maximum, so the second query
+  // runs the same traversal
+  QueryStatistics first = result.statistics;
+  collide(&m1, Transform3f(), &m2, Transform3f(Vec3f(0.5, 0, 0)), request, result);
+  BOOST_CHECK(result.statistics.num_queries == 2);
+  BOOST_CHECK(result.statistics.num_bv_tests == 2 * first.num_bv_tests);
+  BOOST_CHECK(result.statistics.num_leaf_tests == 2 * first.num_leaf_tests);
+  result.clear();
+  BOOST_CHECK(result.statistics.num_queries == 0);
+
+  Cylinder c1(1, 2), c2(1, 2);
+  GJKSolver_indep solver_indep;
+  collide(&c1, Transform3f(), &c2, Transform3f(Vec3f(1, 0.2, 0)), &solver_indep, request, result);
+  BOOST_CHECK(result.isCollision());
+  BOOST_CHECK(result.statistics.num_leaf_tests == 1);
+  BOOST_CHECK(result.statistics.num_gjk_calls > 0);
+  BOOST_CHECK(result.statistics.num_gjk_iterations > 0);
+  BOOST_CHECK(result.statistics.num_epa_iterations > 0);
+
+  DistanceRequest drequest(false, true);
+  DistanceResult dresult;
+  GJKSolver_libccd solver_libccd;
+  distance(&c1, Transform3f(), &c2, Transform3f(Vec3f(3, 0.2, 0)), &solver_libccd, drequest, dresult);
+  BOOST_CHECK(dresult.min_distance > 0);
+  BOOST_CHECK(dresult.statistics.num_queries == 1);
+  BOOST_CHECK(dresult.statistics.num_gjk_calls > 0);
+  BOOST_CHECK(dresult.statistics.num_gjk_iterations > 0);
+}
+
 template<typename BV>
 bool collide_Test2(const Transform3f& tf,
                    const std::vector<Vec3f>& vertices1, const std::vector<Triangle>& triangles1,
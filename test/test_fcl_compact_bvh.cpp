@@ -0,0 +1,132 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define BOOST_TEST_MODULE "FCL_COMPACT_BVH"
+#include <boost/test/unit_test.hpp>
+
+#include "fcl/BVH/BVH_compact.h"
+#include "fcl/shape/geometric_shape_to_BVH_model.h"
+#include "fcl/collision.h"
+
+using namespace fcl;
+
+static void checkBoxes(const CompactBVHModel& model, int b, const AABB& box)
+{
+  const CompactBVHModel::Node& node = model.getNode(b);
+  if(node.isLeaf())
+  {
+    Vec3f p1, p2, p3;
+    model.getTriangle(node.primitiveId(), p1, p2, p3);
+    BOOST_CHECK(box.contain(p1) && box.contain(p2) && box.contain(p3));
+    return;
+  }
+
+  for(int c = node.leftChild(); c <= node.rightChild(); ++c)
+  {
+    AABB child_box;
+    model.decodeBox(model.getNode(c), box, child_box);
+    BOOST_CHECK(box.contain(child_box.min_) && box.contain(child_box.max_));
+    checkBoxes(model, c, child_box);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(compact_build)
+{
+  BVHModel<OBBRSS> model;
+  generateBVHModel(model, Sphere(1), Transform3f(), 16, 16);
+
+  CompactBVHModel compact(model);
+  BOOST_CHECK_EQUAL(compact.getNumNodes(), model.getNumBVs());
+  BOOST_CHECK_EQUAL(compact.getNumTriangles(), model.num_tris);
+  BOOST_CHECK(compact.hasShortIndices());
+  BOOST_CHECK_EQUAL(compact.getNodeType(), BV_COMPACT);
+
+  checkBoxes(compact, 0, compact.getRootBox());
+
+  BOOST_CHECK(compact.memUsage(0) * 3 < model.memUsage(0));
+
+  BVHModel<OBBRSS> unfinished;
+  unfinished.beginModel();
+  CompactBVHModel empty(unfinished);
+  BOOST_CHECK_EQUAL(empty.getNumNodes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(compact_collision)
+{
+  // box vertices are exact in single precision, so the triangle tests match the full model exactly
+  BVHModel<OBBRSS> model1, model2;
+  generateBVHModel(model1, Box(2, 1, 1), Transform3f());
+  generateBVHModel(model2, Box(1, 2, 0.5), Transform3f());
+  CompactBVHModel compact1(model1), compact2(model2);
+
+  CollisionRequest request(100, true);
+  for(int i = 0; i < 40; ++i)
+  {
+    Quaternion3f q;
+    q.fromAxisAngle(Vec3f(1, -0.5, 0.2).normalize(), 0.1 * i);
+    Transform3f tf(q, Vec3f(0.05 * i - 1, 0.3, -0.2));
+
+    CollisionResult result, compact_result;
+    collide(&model1, Transform3f(), &model2, tf, request, result);
+    collide(&compact1, Transform3f(), &compact2, tf, request, compact_result);
+    BOOST_CHECK_EQUAL(result.numContacts(), compact_result.numContacts());
+  }
+
+  CollisionResult result;
+  collide(&compact1, Transform3f(), &compact2, Transform3f(Vec3f(3, 0, 0)), request, result);
+  BOOST_CHECK_EQUAL(result.numContacts(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(compact_shape_collision)
+{
+  BVHModel<OBBRSS> model;
+  generateBVHModel(model, Box(2, 2, 2), Transform3f());
+  CompactBVHModel compact(model);
+
+  Sphere sphere(0.3);
+  CollisionRequest request;
+  CollisionResult result;
+  collide(&compact, Transform3f(Vec3f(1, 0, 0)), &sphere, Transform3f(Vec3f(2.2, 0.1, 0)), request, result);
+  BOOST_CHECK(result.isCollision());
+
+  result.clear();
+  collide(&sphere, Transform3f(Vec3f(2.5, 0.1, 0)), &compact, Transform3f(Vec3f(1, 0, 0)), request, result);
+  BOOST_CHECK(!result.isCollision());
+
+  // a shape inside the closed mesh does not touch any triangle
+  result.clear();
+  collide(&compact, Transform3f(), &sphere, Transform3f(), request, result);
+  BOOST_CHECK(!result.isCollision());
+}
@@ -9,6 +9,8 @@
 #include <cmath>
 
 #include "fcl/ccd/conservative_advancement.h"
+#include "fcl/ccd/shape_conservative_advancement.h"
+#include "fcl/shape/geometric_shape_to_BVH_model.h"
 #include "fcl/articulated_model/model.h"
 #include "fcl/articulated_model/model_config.h"
 #include "fcl/ccd/motion.h"
@@ -287,6 +289,44 @@ BOOST_FIXTURE_TEST_CASE(test_collide_boolean, ConservativeAdvancementFixture)
 	BOOST_CHECK_EQUAL(false, collide);
 }
 
+BOOST_FIXTURE_TEST_CASE(test_adaptive_collide, ConservativeAdvancementFixture)
+{
+	ContinuousCollisionRequest request;
+	ContinuousCollisionResult result;
+
+	request.adaptive = true;
+	request.toc_tolerance = 0.0001;
+
+	// the boxes touch when the moving one reaches x = -1
+	int collisions_number = advancement_collision_->collide(request, result);
+	BOOST_CHECK_LT(0, collisions_number);
+	BOOST_CHECK_LE(result.getTimeOfContact(), 0.45);
+	BOOST_CHECK_GT(result.getTimeOfContact(), 0.45 - 0.001);
+	BOOST_CHECK_LT(0, result.getNumDistanceQueries() );
+
+	result.clear();
+	collisions_number = advancement_collision_free_->collide(request, result);
+	BOOST_CHECK_EQUAL(0, collisions_number);
+	BOOST_CHECK_EQUAL(1.0, result.getTimeOfContact() );
+
+	// passing the static box with a small clearance
+	InterpMotion near_miss_motion(
+		Transform3f(Vec3f(-10, box_side_ + 0.01, 0) ), Transform3f(Vec3f(10, box_side_ + 0.01, 0) ) );
+	ConservativeAdvancementType near_miss_advancement(
+		box_static_.get(), static_motion_.get(), box_moving_.get(), &near_miss_motion);
+
+	result.clear();
+	collisions_number = near_miss_advancement.collide(request, result);
+	BOOST_CHECK_EQUAL(0, collisions_number);
+	int adaptive_distance_queries = result.getNumDistanceQueries();
+
+	request.adaptive = false;
+	result.clear();
+	collisions_number = near_miss_advancement.collide(request, result);
+	BOOST_CHECK_EQUAL(0, collisions_number);
+	BOOST_CHECK_LT(adaptive_distance_queries, result.getNumDistanceQueries() );
+}
+
 BOOST_FIXTURE_TEST_CASE(test_backward_compability, ConservativeAdvancementFixture)
 {
 	CollisionRequest request;
@@ -348,6 +388,79 @@ BOOST_FIXTURE_TEST_CASE(test_discrete_detection_in_time, ConservativeAdvancement
 	BOOST_CHECK_EQUAL(0, collisions_number);
 }
 
+BOOST_AUTO_TEST_CASE(test_shape_collide)
+{
+	typedef ShapeConservativeAdvancement<GJKSolver_indep> ShapeConservativeAdvancementType;
+
+	Sphere sphere_static(0.5);
+	Sphere sphere_moving(0.5);
+	sphere_static.computeLocalAABB();
+	sphere_moving.computeLocalAABB();
+
+	Transform3f identity;
+	InterpMotion static_motion(identity, identity);
+	InterpMotion collision_motion(Transform3f(Vec3f(-10, 0, 0) ), Transform3f(Vec3f(10, 0, 0) ) );
+	InterpMotion collision_free_motion(Transform3f(Vec3f(-10, 1.5, 0) ), Transform3f(Vec3f(10, 1.5, 0) ) );
+
+	ContinuousCollisionRequest request;
+	ContinuousCollisionResult result;
+
+	// the spheres touch when the moving one is at x = -1
+	ShapeConservativeAdvancementType advancement_collision(&sphere_static, &static_motion, &sphere_moving, &collision_motion);
+	BOOST_CHECK_EQUAL(1, advancement_collision.collide(request, result) );
+	BOOST_CHECK(result.getTimeOfContact() <= 0.45);
+	BOOST_CHECK_CLOSE(0.45, result.getTimeOfContact(), 0.01);
+
+	ShapeConservativeAdvancementType advancement_collision_free(&sphere_static, &static_motion, &sphere_moving, &collision_free_motion);
+	BOOST_CHECK_EQUAL(0, advancement_collision_free.collide(request, result) );
+	BOOST_CHECK_EQUAL(request.end_time, result.getTimeOfContact() );
+
+	// a capsule rotating about its center sweeps the sphere standing next to its tip
+	Capsule capsule(0.2, 4);
+	capsule.computeLocalAABB();
+
+	Quaternion3f q;
+	q.fromAxisAngle(Vec3f(1, 0, 0), boost::math::constants::pi<FCL_REAL>() / 2);
+	InterpMotion rotation_motion(identity, Transform3f(q) );
+	InterpMotion sphere_motion(Transform3f(Vec3f(0, 1.5, 0) ), Transform3f(Vec3f(0, 1.5, 0) ) );
+
+	ShapeConservativeAdvancementType advancement_rotation(&capsule, &rotation_motion, &sphere_moving, &sphere_motion);
+	BOOST_CHECK_EQUAL(1, advancement_rotation.collide(request, result) );
+	BOOST_CHECK(result.getTimeOfContact() > 0.0 && result.getTimeOfContact() < 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(test_shape_mesh_collide)
+{
+	typedef ShapeConservativeAdvancement<GJKSolver_indep> ShapeConservativeAdvancementType;
+
+	BVHModel<RSS> box_mesh;
+	generateBVHModel(box_mesh, Box(1, 1, 1), Transform3f() );
+	box_mesh.computeLocalAABB();
+
+	Capsule capsule(0.25, 2);
+	capsule.computeLocalAABB();
+
+	Transform3f identity;
+	InterpMotion static_motion(identity, identity);
+	InterpMotion collision_motion(Transform3f(Vec3f(-10, 0, 0) ), Transform3f(Vec3f(10, 0, 0) ) );
+	InterpMotion collision_free_motion(Transform3f(Vec3f(-10, 1, 0) ), Transform3f(Vec3f(10, 1, 0) ) );
+
+	ContinuousCollisionRequest request;
+	ContinuousCollisionResult result;
+
+	// the capsule touches the box when its axis is at x = -0.75
+	ShapeConservativeAdvancementType advancement_collision(&box_mesh, &static_motion, &capsule, &collision_motion);
+	BOOST_CHECK_EQUAL(1, advancement_collision.collide(request, result) );
+	BOOST_CHECK(result.getTimeOfContact() <= 0.4625);
+	BOOST_CHECK_CLOSE(0.4625, result.getTimeOfContact(), 0.01);
+
+	ShapeConservativeAdvancementType advancement_collision_free(&capsule, &collision_free_motion, &box_mesh, &static_motion);
+	BOOST_CHECK_EQUAL(0, advancement_collision_free.collide(request, result) );
+
+	BOOST_CHECK(ShapeConservativeAdvancementType::isSupported(&capsule, &box_mesh) );
+	BOOST_CHECK(!ShapeConservativeAdvancementType::isSupported(&box_mesh, &box_mesh) );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 ////////////////////////////////////////////////////////////////////////////////
 
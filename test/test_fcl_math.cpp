@@ -41,7 +41,11 @@
 #endif
 #include "fcl/math/vec_3f.h"
 #include "fcl/math/matrix_3f.h"
+#include "fcl/math/point_batch.h"
+#include "fcl/narrowphase/narrowphase.h"
 #include "fcl/broadphase/morton.h"
+#include "fcl/ccd/taylor_vector.h"
+#include "fcl/ccd/taylor_kernels.h"
 #include "fcl/config.h"
 
 using namespace fcl;
@@ -640,3 +644,172 @@ BOOST_AUTO_TEST_CASE(morton)
   std::cout << std::hex << F4(p) << std::endl;
   
 }
+
+static void generatePoints(std::vector<Vec3f>& ps, int n)
+{
+  ps.resize(n);
+  for(int i = 0; i < n; ++i)
+    ps[i].setValue(rand() / (FCL_REAL)RAND_MAX - 0.5, rand() / (FCL_REAL)RAND_MAX * 2, -rand() / (FCL_REAL)RAND_MAX);
+}
+
+BOOST_AUTO_TEST_CASE(point_batch_kernels)
+{
+  // sizes covering empty input, only the scalar tail, whole SIMD packs and several point blocks
+  int sizes[] = {0, 1, 7, 64, 100, 257};
+  Matrix3f R;
+  R.setEulerZYX(0.3, -1.2, 2.1);
+  Vec3f T(1, -2, 0.5);
+  Vec3f dir(0.2, -0.7, 0.4);
+
+  for(int k = 0; k < 6; ++k)
+  {
+    int n = sizes[k];
+    std::vector<Vec3f> ps;
+    generatePoints(ps, n);
+    const Vec3f* data = n ? &ps[0] : NULL;
+
+    std::vector<Vec3f> out(n + 1);
+    transformPoints(R, T, data, n, &out[0]);
+    for(int i = 0; i < n; ++i)
+      BOOST_CHECK((out[i] - (R * ps[i] + T)).length() < 1e-5);
+
+    Vec3f min(std::numeric_limits<FCL_REAL>::max()), max(-std::numeric_limits<FCL_REAL>::max());
+    boundPoints(data, n, min, max);
+    Vec3f min_ref(std::numeric_limits<FCL_REAL>::max()), max_ref(-std::numeric_limits<FCL_REAL>::max());
+    for(int i = 0; i < n; ++i)
+    {
+      min_ref.ubound(ps[i]);
+      max_ref.lbound(ps[i]);
+    }
+    BOOST_CHECK(min.equal(min_ref) && max.equal(max_ref));
+
+    FCL_REAL max_dot;
+    int best = maxDotPoint(data, n, dir, max_dot);
+    int best_ref = -1;
+    FCL_REAL max_dot_ref = -std::numeric_limits<FCL_REAL>::max();
+    for(int i = 0; i < n; ++i)
+    {
+      FCL_REAL dot = dir.dot(ps[i]);
+      if(dot > max_dot_ref) { max_dot_ref = dot; best_ref = i; }
+    }
+    BOOST_CHECK_EQUAL(best, best_ref);
+    if(n > 0) BOOST_CHECK(std::abs(max_dot - max_dot_ref) < 1e-5);
+
+    PointBlock block;
+    Vec3f sum, sum_ref;
+    Matrix3f sum_squares(0, 0, 0, 0, 0, 0, 0, 0, 0), sum_squares_ref(0, 0, 0, 0, 0, 0, 0, 0, 0);
+    for(int i = 0; i < n && block.hasRoom(1); ++i)
+    {
+      block.push_back(ps[i]);
+      sum_ref += ps[i];
+      for(int a = 0; a < 3; ++a)
+        for(int b = 0; b < 3; ++b)
+          sum_squares_ref(a, b) += ps[i][a] * ps[i][b];
+    }
+    accumulatePointMoments(block, sum, sum_squares);
+    BOOST_CHECK((sum - sum_ref).length() < 1e-4);
+    for(int a = 0; a < 3; ++a)
+      for(int b = 0; b < 3; ++b)
+        BOOST_CHECK(std::abs(sum_squares(a, b) - sum_squares_ref(a, b)) < 1e-4);
+  }
+
+  // ties resolve to the first point, whichever SIMD lane holds it
+  std::vector<Vec3f> ps(37, Vec3f(0, 0, 0));
+  ps[5].setValue(1, 0, 0);
+  ps[22].setValue(1, 3, 0);
+  ps[30].setValue(1, -1, 0);
+  FCL_REAL max_dot;
+  BOOST_CHECK_EQUAL(maxDotPoint(&ps[0], 37, Vec3f(1, 0, 0), max_dot), 5);
+  BOOST_CHECK_EQUAL(max_dot, 1);
+}
+
+BOOST_AUTO_TEST_CASE(cube_triangle_overlap)
+{
+  GJKSolver_indep solver;
+  int sizes[] = {1, 7, 64, 100};
+
+  for(int k = 0; k < 4; ++k)
+  {
+    int n = sizes[k];
+    std::vector<Vec3f> centers, tri;
+    generatePoints(centers, n);
+    generatePoints(tri, 3);
+
+    PointBlock block;
+    std::vector<FCL_REAL> half_sizes(n);
+    for(int i = 0; i < n && block.hasRoom(1); ++i)
+    {
+      block.push_back(centers[i]);
+      half_sizes[i] = 0.02 + 0.1 * rand() / (FCL_REAL)RAND_MAX;
+    }
+
+    bool overlap[PointBlock::CAPACITY];
+    int num_overlap = overlapCubesTriangle(block, &half_sizes[0], tri[0], tri[1], tri[2], overlap);
+
+    int num_overlap_ref = 0;
+    for(int i = 0; i < block.size; ++i)
+    {
+      FCL_REAL size = 2 * half_sizes[i];
+      bool overlap_ref = solver.shapeTriangleIntersect(Box(size, size, size), Transform3f(centers[i]), tri[0], tri[1], tri[2], NULL, NULL, NULL);
+      BOOST_CHECK_EQUAL(overlap[i], overlap_ref);
+      if(overlap_ref) ++num_overlap_ref;
+    }
+    BOOST_CHECK_EQUAL(num_overlap, num_overlap_ref);
+  }
+
+  // a cube crossed by a large triangle whose vertices are all outside of it, and one beside a triangle's plane
+  Vec3f p1(-2, -2, 0.1), p2(2, -2, 0.1), p3(0, 3, 0.1);
+  FCL_REAL x[] = {0, 0}, y[] = {0, 0}, z[] = {0, 0.5}, half_size[] = {0.5, 0.3};
+  bool overlap[2];
+  BOOST_CHECK_EQUAL(overlapCubesTriangle(x, y, z, half_size, 2, p1, p2, p3, overlap), 1);
+  BOOST_CHECK(overlap[0] && !overlap[1]);
+}
+
+BOOST_AUTO_TEST_CASE(taylor_model_enclosure)
+{
+  // outward rounded interval products contain all the products of the end points
+  Interval a(-1.3, 2.1), b(0.7, 3.9);
+  Interval ab = details::multiplyOutward(a, b);
+  Interval ab_ref = a * b;
+  BOOST_CHECK(ab[0] < ab_ref[0] && ab[1] > ab_ref[1]);
+  BOOST_CHECK(ab_ref[0] - ab[0] < 1e-10 && ab[1] - ab_ref[1] < 1e-10);
+
+  boost::shared_ptr<TimeInterval> time_interval(new TimeInterval(0.2, 0.7));
+  BOOST_CHECK(time_interval->powers_[0] == Interval(1));
+  BOOST_CHECK(time_interval->powers_[3].contains(0.2 * 0.2 * 0.2) && time_interval->powers_[3].contains(0.7 * 0.7 * 0.7));
+
+  TaylorModel c(time_interval), s(time_interval), l(time_interval);
+  generateTaylorModelForCosFunc(c, 2.0, 0.3);
+  generateTaylorModelForSinFunc(s, 2.0, 0.3);
+  generateTaylorModelForLinearFunc(l, 0.5, -1.5);
+
+  TVector3 u(c, s, l);
+  TVector3 v(s, l, c);
+  TaylorModel dot = u.dot(v);
+  TaylorModel square_length = u.squareLength();
+  TVector3 cross = u.cross(v);
+
+  Interval dot_bound = dot.getBound();
+  for(int i = 0; i <= 100; ++i)
+  {
+    FCL_REAL t = 0.2 + 0.5 * i / 100;
+    Vec3f u_ref(std::cos(2.0 * t + 0.3), std::sin(2.0 * t + 0.3), 0.5 - 1.5 * t);
+    Vec3f v_ref(u_ref[1], u_ref[2], u_ref[0]);
+
+    BOOST_CHECK(dot_bound.contains(u_ref.dot(v_ref)));
+    BOOST_CHECK(dot.getBound(t).contains(u_ref.dot(v_ref)));
+    BOOST_CHECK(square_length.getBound(t).contains(u_ref.sqrLength()));
+
+    Vec3f cross_ref = u_ref.cross(v_ref);
+    for(int j = 0; j < 3; ++j)
+      BOOST_CHECK(cross[j].getBound(t).contains(cross_ref[j]));
+  }
+
+  // on a short interval the remainder shrinks with the Taylor expansion error
+  time_interval->setValue(0.2, 0.25);
+  generateTaylorModelForCosFunc(c, 2.0, 0.3);
+  generateTaylorModelForSinFunc(s, 2.0, 0.3);
+  TaylorModel cs = c * s;
+  BOOST_CHECK(cs.remainder().diameter() < 2e-2);
+  BOOST_CHECK(cs.getBound().contains(0.5 * std::sin(2 * (2.0 * 0.22 + 0.3))));
+}
@@ -38,7 +38,10 @@
 #include <boost/test/unit_test.hpp>
 
 #include "fcl/octree.h"
+#include "fcl/linear_octree.h"
 #include "fcl/traversal/traversal_node_octree.h"
+#include "fcl/collision.h"
+#include "fcl/distance.h"
 #include "fcl/broadphase/broadphase.h"
 #include "fcl/shape/geometric_shape_to_BVH_model.h"
 #include "fcl/math/transform.h"
@@ -171,6 +174,212 @@ BOOST_AUTO_TEST_CASE(test_octomap_bvh_kios_d_distance_kios)
   octomap_distance_test_BVH<kIOS>(5);
 }
 
+BOOST_AUTO_TEST_CASE(test_octomap_linear)
+{
+  OcTree* tree = new OcTree(boost::shared_ptr<const octomap::OcTree>(generateOcTree()));
+  boost::shared_ptr<CollisionGeometry> tree_ptr(tree);
+  tree->setFreeThres(0.3); // lets the snapshot drop the subtrees below free nodes
+
+  LinearOcTree* linear_tree = new LinearOcTree(*tree);
+  boost::shared_ptr<CollisionGeometry> linear_tree_ptr(linear_tree);
+  BOOST_CHECK(linear_tree->size() < tree->getTree()->size());
+  BOOST_CHECK_EQUAL(linear_tree->getNodeType(), GEOM_LINEAR_OCTREE);
+
+  std::vector<boost::array<FCL_REAL, 6> > boxes = tree->toBoxes();
+  std::vector<boost::array<FCL_REAL, 6> > linear_boxes = linear_tree->toBoxes();
+  BOOST_CHECK_EQUAL(boxes.size(), linear_boxes.size());
+  std::sort(boxes.begin(), boxes.end());
+  std::sort(linear_boxes.begin(), linear_boxes.end());
+  for(std::size_t i = 0; i < boxes.size() && i < linear_boxes.size(); ++i)
+  {
+    for(std::size_t j = 0; j < 5; ++j)
+      BOOST_CHECK(std::abs(boxes[i][j] - linear_boxes[i][j]) < 1e-5);
+  }
+
+  boost::shared_ptr<CollisionGeometry> box_ptr(new Box(0.5, 0.3, 0.8));
+  BVHModel<OBBRSS>* mesh = new BVHModel<OBBRSS>();
+  generateBVHModel(*mesh, Sphere(0.4), Transform3f(), 8, 8);
+  boost::shared_ptr<CollisionGeometry> mesh_ptr(mesh);
+
+  std::vector<Transform3f> transforms;
+  FCL_REAL extents[] = {-1.5, -1.5, -1.5, 1.5, 1.5, 1.5};
+  generateRandomTransforms(extents, transforms, 20);
+
+  CollisionRequest request(100000, true);
+  for(std::size_t i = 0; i < transforms.size(); ++i)
+  {
+    CollisionObject* others[] = {new CollisionObject(box_ptr, transforms[i]),
+                                 new CollisionObject(mesh_ptr, transforms[i]),
+                                 new CollisionObject(tree_ptr, transforms[i])};
+    CollisionObject obj(tree_ptr), linear_obj(linear_tree_ptr);
+
+    for(std::size_t j = 0; j < 3; ++j)
+    {
+      CollisionResult result, linear_result;
+      collide(&obj, others[j], request, result);
+      collide(&linear_obj, others[j], request, linear_result);
+      BOOST_CHECK_EQUAL(result.numContacts(), linear_result.numContacts());
+
+      DistanceResult dist_result, linear_dist_result;
+      distance(others[j], &obj, DistanceRequest(), dist_result);
+      distance(others[j], &linear_obj, DistanceRequest(), linear_dist_result);
+      BOOST_CHECK(std::abs(dist_result.min_distance - linear_dist_result.min_distance) < 1e-6);
+
+      delete others[j];
+    }
+  }
+}
+
+static bool collectOtherObject(CollisionObject* o1, CollisionObject* o2, void* cdata)
+{
+  std::vector<CollisionObject*>* objs = static_cast<std::vector<CollisionObject*>*>(cdata);
+  objs->push_back((o1->getNodeType() == GEOM_OCTREE) ? o2 : o1);
+  return false;
+}
+
+BOOST_AUTO_TEST_CASE(test_octomap_dirty)
+{
+  boost::shared_ptr<octomap::OcTree> octree(new octomap::OcTree(0.1));
+  for(int i = -10; i < 10; ++i)
+  {
+    for(int j = -10; j < 10; ++j)
+      octree->updateNode(octomap::point3d(i * 0.1 + 0.05, j * 0.1 + 0.05, 0.05), true);
+  }
+
+  OcTree* tree = new OcTree(octree);
+  boost::shared_ptr<CollisionGeometry> tree_ptr(tree);
+  std::vector<boost::array<FCL_REAL, 6> > boxes = tree->toBoxes();
+  BOOST_CHECK(!tree->isDirty());
+
+  // carve a hole into the plane and add a few cells above it
+  octree->enableChangeDetection(true);
+  for(int k = 0; k < 3; ++k)
+  {
+    for(int i = 0; i < 3; ++i)
+    {
+      for(int j = 0; j < 3; ++j)
+        octree->updateNode(octomap::point3d(i * 0.1 + 0.05, j * 0.1 + 0.05, 0.05), false);
+    }
+  }
+  for(int i = 0; i < 4; ++i)
+    octree->updateNode(octomap::point3d(-0.55, -0.55, i * 0.1 + 0.15), true);
+
+  BOOST_CHECK_EQUAL(tree->collectChanges(), 13);
+  octree->resetChangeDetection();
+  BOOST_CHECK(tree->isDirty());
+  BOOST_CHECK_EQUAL(tree->collectChanges(), 0);
+
+  tree->updateBoxes(boxes);
+  std::vector<boost::array<FCL_REAL, 6> > new_boxes = tree->toBoxes();
+  BOOST_CHECK_EQUAL(boxes.size(), new_boxes.size());
+  std::sort(boxes.begin(), boxes.end());
+  std::sort(new_boxes.begin(), new_boxes.end());
+  for(std::size_t i = 0; i < boxes.size() && i < new_boxes.size(); ++i)
+  {
+    for(std::size_t j = 0; j < 4; ++j)
+      BOOST_CHECK(std::abs(boxes[i][j] - new_boxes[i][j]) < 1e-5);
+  }
+
+  // cubes resting on the plane: collideDirty only reports the ones next to the changed cells
+  std::vector<CollisionObject*> env;
+  boost::shared_ptr<CollisionGeometry> box_ptr(new Box(0.08, 0.08, 0.08));
+  for(int i = -9; i < 10; i += 2)
+  {
+    for(int j = -9; j < 10; j += 2)
+      env.push_back(new CollisionObject(box_ptr, Transform3f(Vec3f(i * 0.1 + 0.05, j * 0.1 + 0.05, 0.1))));
+  }
+
+  CollisionObject tree_obj(tree_ptr);
+  DynamicAABBTreeCollisionManager manager;
+  DynamicAABBTreeCollisionManager_Array manager_array;
+  manager.registerObjects(env);
+  manager.setup();
+  manager_array.registerObjects(env);
+  manager_array.setup();
+
+  std::vector<CollisionObject*> all_objs, dirty_objs, dirty_objs_array;
+  manager.collide(&tree_obj, &all_objs, collectOtherObject);
+  manager.collideDirty(&tree_obj, &dirty_objs, collectOtherObject);
+  manager_array.collideDirty(&tree_obj, &dirty_objs_array, collectOtherObject);
+
+  BOOST_CHECK(dirty_objs.size() < all_objs.size());
+  BOOST_CHECK_EQUAL(dirty_objs.size(), dirty_objs_array.size());
+  for(std::size_t i = 0; i < dirty_objs.size(); ++i)
+  {
+    BOOST_CHECK(std::find(all_objs.begin(), all_objs.end(), dirty_objs[i]) != all_objs.end());
+    BOOST_CHECK(tree->overlapDirty(dirty_objs[i]->getAABB()));
+  }
+
+  tree->clearDirty();
+  dirty_objs.clear();
+  manager.collideDirty(&tree_obj, &dirty_objs, collectOtherObject);
+  BOOST_CHECK(dirty_objs.empty());
+
+  for(std::size_t i = 0; i < env.size(); ++i)
+    delete env[i];
+}
+
+BOOST_AUTO_TEST_CASE(test_octomap_cost_query)
+{
+  OcTree* tree = new OcTree(boost::shared_ptr<const octomap::OcTree>(generateOcTree()));
+  boost::shared_ptr<CollisionGeometry> tree_ptr(tree);
+  boost::shared_ptr<CollisionGeometry> linear_tree_ptr(new LinearOcTree(*tree));
+  Box* box = new Box(0.4, 0.6, 0.3);
+  box->cost_density = 2;
+  boost::shared_ptr<CollisionGeometry> box_ptr(box);
+
+  std::vector<Transform3f> transforms;
+  FCL_REAL extents[] = {-1.5, -1.5, -1.5, 1.5, 1.5, 1.5};
+  generateRandomTransforms(extents, transforms, 20);
+
+  CollisionObject tree_obj(tree_ptr), linear_tree_obj(linear_tree_ptr);
+  for(std::size_t i = 0; i < transforms.size(); ++i)
+  {
+    CollisionObject box_obj(box_ptr, Transform3f(transforms[i].getTranslation()));
+
+    // reference: the leaves overlapping the box, and the default occupancy for the rest of the box
+    const AABB& box_aabb = box_obj.getAABB();
+    FCL_REAL total_cost = 0;
+    FCL_REAL known_volume = 0;
+    const octomap::OcTree* octree = tree->getTree().get();
+    for(octomap::OcTree::iterator it = octree->begin(octree->getTreeDepth()), end = octree->end(); it != end; ++it)
+    {
+      FCL_REAL half_size = it.getSize() * 0.5;
+      AABB cell(Vec3f(it.getX() - half_size, it.getY() - half_size, it.getZ() - half_size),
+                Vec3f(it.getX() + half_size, it.getY() + half_size, it.getZ() + half_size));
+      AABB overlap_part;
+      if(cell.overlap(box_aabb, overlap_part))
+      {
+        total_cost += (*it).getOccupancy() * box->cost_density * overlap_part.volume();
+        known_volume += overlap_part.volume();
+      }
+    }
+    total_cost += tree->getDefaultOccupancy() * box->cost_density * (box_aabb.volume() - known_volume);
+
+    CostResult cost_result;
+    FCL_REAL cost = computeCost(&tree_obj, &box_obj, CostRequest(), cost_result);
+    BOOST_CHECK(std::abs(cost - total_cost) < 1e-6);
+    BOOST_CHECK_EQUAL(cost_result.lower_bound, cost_result.upper_bound);
+
+    CostResult linear_cost_result;
+    computeCost(&box_obj, &linear_tree_obj, CostRequest(), linear_cost_result);
+    BOOST_CHECK(std::abs(linear_cost_result.lower_bound - total_cost) < 1e-6);
+
+    if(total_cost > 0)
+    {
+      CostResult above_result;
+      computeCost(&tree_obj, &box_obj, CostRequest(0.5 * total_cost), above_result);
+      BOOST_CHECK(above_result.isAbove(0.5 * total_cost));
+      BOOST_CHECK(above_result.lower_bound <= total_cost + 1e-6 && above_result.upper_bound >= total_cost - 1e-6);
+    }
+
+    CostResult below_result;
+    computeCost(&tree_obj, &box_obj, CostRequest(2 * total_cost + 1e-3), below_result);
+    BOOST_CHECK(below_result.isBelow(2 * total_cost + 1e-3));
+    BOOST_CHECK(below_result.lower_bound <= total_cost + 1e-6 && below_result.upper_bound >= total_cost - 1e-6);
+  }
+}
+
 template<typename BV>
 void octomap_collision_test_BVH(std::size_t n, bool exhaustive)
 {
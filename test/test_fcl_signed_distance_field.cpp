@@ -0,0 +1,182 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2011, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#define BOOST_TEST_MODULE "FCL_SIGNED_DISTANCE_FIELD"
+#include <boost/test/unit_test.hpp>
+
+#include "fcl/signed_distance_field.h"
+#include "fcl/shape/geometric_shape_to_BVH_model.h"
+#include "fcl/collision.h"
+#include "fcl/distance.h"
+#include <boost/filesystem.hpp>
+
+using namespace fcl;
+
+static const FCL_REAL voxel = 0.05;
+
+static void bakeBox(SignedDistanceField& sdf)
+{
+  BVHModel<OBBRSS> model;
+  generateBVHModel(model, Box(2, 2, 2), Transform3f());
+  BOOST_REQUIRE(sdf.bake(model, voxel));
+}
+
+BOOST_AUTO_TEST_CASE(sdf_bake)
+{
+  SignedDistanceField sdf;
+  BOOST_CHECK(sdf.isEmpty());
+  bakeBox(sdf);
+  BOOST_CHECK(!sdf.isEmpty());
+
+  // the center lies in a collapsed block, which keeps the smallest distance magnitude of its samples
+  FCL_REAL center = sdf.distance(Vec3f(0, 0, 0));
+  BOOST_CHECK(center <= -SignedDistanceField::BLOCK_SIZE * voxel);
+  BOOST_CHECK(center >= -1 - voxel);
+  BOOST_CHECK_SMALL(FCL_REAL(sdf.distance(Vec3f(0.5, 0.2, -0.1)) + 0.5), voxel);
+  BOOST_CHECK_SMALL(FCL_REAL(sdf.distance(Vec3f(1.2, 0, 0)) - 0.2), voxel);
+  BOOST_CHECK_SMALL(sdf.distance(Vec3f(0, -1, 0)), voxel);
+
+  // outside the sampled region the field only gives a lower bound
+  FCL_REAL far = sdf.distance(Vec3f(5, 0, 0));
+  BOOST_CHECK(far > 1);
+  BOOST_CHECK(far <= 4 + voxel);
+
+  Vec3f gradient;
+  sdf.distance(Vec3f(1.1, 0.3, 0.2), gradient);
+  gradient.normalize();
+  BOOST_CHECK(gradient[0] > 0.9);
+
+  int num_blocks = sdf.getNumBlocks(0) * sdf.getNumBlocks(1) * sdf.getNumBlocks(2);
+  BOOST_CHECK(sdf.getNumDenseBlocks() > 0);
+  BOOST_CHECK(sdf.getNumDenseBlocks() <= num_blocks);
+  BOOST_CHECK(sdf.memUsage() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(sdf_save_load)
+{
+  SignedDistanceField sdf;
+  bakeBox(sdf);
+
+  boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("fcl_sdf_%%%%%%%%.bin");
+  BOOST_REQUIRE(sdf.save(path.string()));
+
+  {
+    SignedDistanceField loaded;
+    BOOST_REQUIRE(loaded.load(path.string()));
+    BOOST_CHECK(loaded.isMapped());
+    BOOST_CHECK_EQUAL(loaded.getNumDenseBlocks(), sdf.getNumDenseBlocks());
+    BOOST_CHECK_EQUAL(loaded.getVoxelSize(), sdf.getVoxelSize());
+
+    SignedDistanceField copy(loaded);
+    BOOST_CHECK(copy.isMapped());
+
+    Vec3f points[] = {Vec3f(0, 0, 0), Vec3f(0.93, -0.4, 0.21), Vec3f(1.3, 1.1, -0.7), Vec3f(-2, 0.5, 0.5)};
+    for(int i = 0; i < 4; ++i)
+    {
+      BOOST_CHECK_EQUAL(loaded.distance(points[i]), sdf.distance(points[i]));
+      BOOST_CHECK_EQUAL(copy.distance(points[i]), sdf.distance(points[i]));
+    }
+  }
+
+  boost::filesystem::remove(path);
+
+  SignedDistanceField missing;
+  BOOST_CHECK(!missing.load(path.string()));
+}
+
+BOOST_AUTO_TEST_CASE(sdf_shape_queries)
+{
+  SignedDistanceField sdf;
+  bakeBox(sdf);
+  Sphere sphere(0.5);
+
+  CollisionRequest request(1, true);
+  CollisionResult result;
+  collide(&sdf, Transform3f(), &sphere, Transform3f(Vec3f(1.3, 0, 0)), request, result);
+  BOOST_REQUIRE_EQUAL(result.numContacts(), 1);
+  BOOST_CHECK_SMALL(FCL_REAL(result.getContact(0).penetration_depth - 0.2), 2 * voxel);
+  BOOST_CHECK(result.getContact(0).normal[0] > 0.9);
+
+  result.clear();
+  collide(&sphere, Transform3f(Vec3f(1.3, 0, 0)), &sdf, Transform3f(), request, result);
+  BOOST_REQUIRE_EQUAL(result.numContacts(), 1);
+  BOOST_CHECK(result.getContact(0).normal[0] < -0.9);
+
+  result.clear();
+  collide(&sdf, Transform3f(), &sphere, Transform3f(Vec3f(1.7, 0, 0)), request, result);
+  BOOST_CHECK_EQUAL(result.numContacts(), 0);
+
+  // the field follows its transform
+  Box box(0.2, 0.2, 0.2);
+  result.clear();
+  collide(&sdf, Transform3f(Vec3f(10, 0, 0)), &box, Transform3f(Vec3f(10, 0.95, 0)), request, result);
+  BOOST_CHECK_EQUAL(result.numContacts(), 1);
+
+  DistanceRequest dist_request(true);
+  DistanceResult dist_result;
+  Sphere small(0.1);
+  distance(&sdf, Transform3f(), &small, Transform3f(Vec3f(0, 0, 1.2)), dist_request, dist_result);
+  BOOST_CHECK_SMALL(FCL_REAL(dist_result.min_distance - 0.1), voxel);
+  BOOST_CHECK_SMALL(dist_result.nearest_points[0][2] - 1, voxel);
+  BOOST_CHECK_SMALL(FCL_REAL(dist_result.nearest_points[1][2] - 1.1), voxel);
+}
+
+BOOST_AUTO_TEST_CASE(sdf_mesh_queries)
+{
+  SignedDistanceField sdf;
+  bakeBox(sdf);
+
+  BVHModel<OBBRSS> model;
+  generateBVHModel(model, Box(0.5, 0.5, 0.5), Transform3f());
+
+  CollisionRequest request(100, true);
+  CollisionResult result;
+  collide(&model, Transform3f(Vec3f(1.1, 0, 0)), &sdf, Transform3f(), request, result);
+  BOOST_CHECK_EQUAL(result.numContacts(), 4);
+  for(std::size_t i = 0; i < result.numContacts(); ++i)
+  {
+    BOOST_CHECK(result.getContact(i).b1 >= 0);
+    BOOST_CHECK(result.getContact(i).normal[0] < -0.9);
+  }
+
+  result.clear();
+  collide(&sdf, Transform3f(), &model, Transform3f(Vec3f(1.5, 0, 0)), request, result);
+  BOOST_CHECK_EQUAL(result.numContacts(), 0);
+
+  DistanceRequest dist_request;
+  DistanceResult dist_result;
+  distance(&sdf, Transform3f(), &model, Transform3f(Vec3f(1.5, 0, 0)), dist_request, dist_result);
+  BOOST_CHECK_SMALL(FCL_REAL(dist_result.min_distance - 0.25), voxel);
+}